@@ -0,0 +1,102 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <filesystem>
+#include <chrono>
+#include <type_traits>
+
+namespace bench {
+
+	class Benchmark;
+	class BenchmarkModule;
+
+	using BenchmarkFunc = std::function<void(Benchmark&)>;
+
+	struct BenchmarkResult {
+		std::string module;
+		std::string benchmark;
+		std::string metric;
+		double value = 0.0;
+		std::string unit;
+	};
+
+	struct BenchmarkSettings {
+		size_t min_runs = 3;
+		size_t max_runs = 1000;
+		double min_time = 0.2;
+		std::string filter;
+	};
+
+	class Benchmark {
+	public:
+		Benchmark(const std::string& name, BenchmarkModule* module);
+		const std::string& getName() const;
+		const std::vector<BenchmarkResult>& getResults() const;
+		double measure(const std::function<void(void)>& func);
+		double measure(const std::function<void(void)>& func, size_t min_runs);
+		double measureWithSetup(const std::function<void(void)>& setup, const std::function<void(void)>& func);
+		void report(const std::string& metric, double value, const std::string& unit);
+		void reportTime(const std::string& stage, double seconds);
+		void reportThroughput(const std::string& stage, double seconds, size_t bytes, size_t objects);
+		void reportRate(const std::string& stage, double seconds, size_t operations);
+
+	private:
+		std::string name;
+		BenchmarkModule* module = nullptr;
+		std::vector<BenchmarkResult> results;
+
+		double measure(
+			const std::function<void(void)>& setup, const std::function<void(void)>& func, size_t min_runs
+		);
+
+	};
+
+	class BenchmarkModule {
+	public:
+		BenchmarkModule(const std::string& name, const BenchmarkSettings& settings);
+		virtual ~BenchmarkModule();
+		const std::string& getName() const;
+		const BenchmarkSettings& getSettings() const;
+		void addBenchmark(const std::string& name, BenchmarkFunc func);
+		std::vector<BenchmarkResult> run();
+
+	protected:
+		virtual void beforeRunModule();
+		virtual void afterRunModule();
+
+	private:
+		struct Entry {
+			std::string name;
+			BenchmarkFunc func;
+		};
+		std::string name;
+		BenchmarkSettings settings;
+		std::vector<Entry> benchmarks;
+
+	};
+
+	// keeps the compiler from dropping the measured work
+	template<typename T> requires (!std::is_arithmetic_v<T>)
+	void do_not_optimize(const T& value);
+	// numbers are written out, since taking the address of a local is not enough
+	template<typename T> requires std::is_arithmetic_v<T>
+	void do_not_optimize(T value);
+
+	std::string results_to_json(const std::vector<BenchmarkResult>& results);
+	void write_results(const std::vector<BenchmarkResult>& results, const std::filesystem::path& path);
+
+	template<typename T> requires (!std::is_arithmetic_v<T>)
+	inline void do_not_optimize(const T& value) {
+		static const void* volatile sink;
+		sink = &value;
+	}
+
+	template<typename T> requires std::is_arithmetic_v<T>
+	inline void do_not_optimize(T value) {
+		static volatile T sink;
+		sink = value;
+	}
+
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "compvector_benchmarks.h"
+#include "decomposition_benchmarks.h"
+#include "event_benchmarks.h"
+#include "geometry_benchmarks.h"
+#include "logging_benchmarks.h"
+#include "serializer_benchmarks.h"
+#include "transform_benchmarks.h"
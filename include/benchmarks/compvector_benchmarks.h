@@ -0,0 +1,16 @@
+#pragma once
+
+#include "benchmarks/benchmark.h"
+#include "common/compvector.h"
+#include "common/indexed_compvector.h"
+
+class CompVectorBenchmarks : public bench::BenchmarkModule {
+public:
+	CompVectorBenchmarks(const std::string& name, const bench::BenchmarkSettings& settings);
+
+private:
+	template<typename TVec>
+	void containerBenchmark(bench::Benchmark& benchmark, size_t value_count);
+
+	static std::vector<int*> createValues(std::vector<int>& storage, size_t value_count);
+};
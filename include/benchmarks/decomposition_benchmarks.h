@@ -0,0 +1,13 @@
+#pragma once
+
+#include "benchmarks/benchmark.h"
+#include "simulation/polygon.h"
+
+class DecompositionBenchmarks : public bench::BenchmarkModule {
+public:
+	DecompositionBenchmarks(const std::string& name, const bench::BenchmarkSettings& settings);
+	static SplittablePolygon createTerrain(size_t vertex_count);
+
+private:
+	void terrainBenchmark(bench::Benchmark& benchmark, size_t vertex_count);
+};
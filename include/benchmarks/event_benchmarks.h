@@ -0,0 +1,35 @@
+#pragma once
+
+#include "benchmarks/benchmark.h"
+#include "common/event.h"
+
+class EventBenchmarks : public bench::BenchmarkModule {
+public:
+	EventBenchmarks(const std::string& name, const bench::BenchmarkSettings& settings);
+
+private:
+	template<typename TEvent>
+	void eventBenchmark(bench::Benchmark& benchmark, size_t handler_count);
+};
+
+// what Event used to be, a list of std::function, kept as a baseline
+class FunctionListEvent {
+public:
+	template<typename TFunc>
+	void operator+=(TFunc&& func);
+	void operator()(int arg);
+
+private:
+	std::vector<std::function<void(int)>> funcs;
+};
+
+template<typename TFunc>
+inline void FunctionListEvent::operator+=(TFunc&& func) {
+	funcs.push_back(std::forward<TFunc>(func));
+}
+
+inline void FunctionListEvent::operator()(int arg) {
+	for (std::function<void(int)>& func : funcs) {
+		func(arg);
+	}
+}
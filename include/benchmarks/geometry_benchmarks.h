@@ -0,0 +1,22 @@
+#pragma once
+
+#include "benchmarks/benchmark.h"
+#include "common/batch_geometry.h"
+#include "simulation/instanced_shapes.h"
+#include "simulation/polyline_simplification.h"
+#include "simulation/simulation.h"
+
+class GeometryBenchmarks : public bench::BenchmarkModule {
+public:
+	GeometryBenchmarks(const std::string& name, const bench::BenchmarkSettings& settings);
+
+private:
+	void transformBenchmark(bench::Benchmark& benchmark, size_t point_count);
+	void sideBenchmark(bench::Benchmark& benchmark, size_t point_count);
+	void intersectBenchmark(bench::Benchmark& benchmark, size_t point_count);
+	void vertexQueryBenchmark(bench::Benchmark& benchmark, size_t point_count);
+	void simplifyBenchmark(bench::Benchmark& benchmark, size_t point_count);
+	void instancingBenchmark(bench::Benchmark& benchmark, size_t shape_count);
+
+	static utils::batch::Points createPoints(size_t point_count);
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "benchmarks/benchmark.h"
+#include "common/log.h"
+
+// stages are "logged" and "tag_disabled" in a normal build,
+// and "compiled_out" in a build with B2E_LOGGING=OFF
+class LoggingBenchmarks : public bench::BenchmarkModule {
+public:
+	LoggingBenchmarks(const std::string& name, const bench::BenchmarkSettings& settings);
+
+private:
+	void recutBenchmark(bench::Benchmark& benchmark);
+	void serializeBenchmark(bench::Benchmark& benchmark);
+	void historyBenchmark(bench::Benchmark& benchmark);
+
+	static void measureStages(bench::Benchmark& benchmark, const std::string& tag, const std::function<double(void)>& measure);
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "benchmarks/benchmark.h"
+#include "simulation/simulation.h"
+
+class SerializerBenchmarks : public bench::BenchmarkModule {
+public:
+	SerializerBenchmarks(const std::string& name, const bench::BenchmarkSettings& settings);
+	static std::string createSyntheticLevel(size_t object_count);
+
+private:
+	void levelBenchmark(bench::Benchmark& benchmark, const std::string& str);
+	void fileBenchmark(bench::Benchmark& benchmark, const std::filesystem::path& path);
+	void syntheticBenchmark(bench::Benchmark& benchmark, size_t object_count);
+
+	static ptrdiff_t findSimulationToken(const std::vector<WordToken>& tokens);
+};
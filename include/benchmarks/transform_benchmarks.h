@@ -0,0 +1,12 @@
+#pragma once
+
+#include "benchmarks/benchmark.h"
+#include "simulation/simulation.h"
+
+class TransformBenchmarks : public bench::BenchmarkModule {
+public:
+	TransformBenchmarks(const std::string& name, const bench::BenchmarkSettings& settings);
+
+private:
+	void transformBenchmark(bench::Benchmark& benchmark, size_t object_count);
+};
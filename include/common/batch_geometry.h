@@ -0,0 +1,101 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+#include "box2d/box2d.h"
+
+// versions of utils geometry functions that process whole arrays of points,
+// with SSE2 and AVX2 paths picked by what the CPU supports and a scalar fallback,
+// results are the same as calling the utils function for each point
+namespace utils::batch {
+
+	enum class InstructionSet {
+		SCALAR,
+		SSE2,
+		AVX2,
+	};
+
+	// points as separate coordinate arrays, so several of them can be loaded at once
+	struct Points {
+		std::vector<float> x;
+		std::vector<float> y;
+
+		Points() = default;
+		Points(size_t size);
+		size_t size() const;
+		void resize(size_t size);
+		void set(size_t index, float px, float py);
+		void push_back(float px, float py);
+		b2Vec2 getb2(size_t index) const;
+		sf::Vector2f getsf(size_t index) const;
+	};
+
+	// name of the instruction set the kernels currently use
+	const char* get_instruction_set();
+	// instruction sets that were compiled in and are supported by the CPU, scalar is always there
+	std::vector<InstructionSet> get_supported_instruction_sets();
+	// best supported one is used by default, returns false if the set is not supported,
+	// not thread-safe, meant for tests and benchmarks
+	bool set_instruction_set(InstructionSet instruction_set);
+
+	// utils::get_line_D(p, p1, p2) of each point p
+	void get_line_D(
+		std::span<const float> x, std::span<const float> y,
+		float p1x, float p1y, float p2x, float p2y,
+		std::span<float> result
+	);
+	// utils::left_side(p, p1, p2) of each point p, 1 if true
+	void left_side(
+		std::span<const float> x, std::span<const float> y,
+		float p1x, float p1y, float p2x, float p2y,
+		std::span<uint8_t> result
+	);
+	// utils::right_side(p, p1, p2) of each point p, 1 if true
+	void right_side(
+		std::span<const float> x, std::span<const float> y,
+		float p1x, float p1y, float p2x, float p2y,
+		std::span<uint8_t> result
+	);
+	// utils::distance_to_line(p, p1, p2) of each point p
+	void distance_to_line(
+		std::span<const float> x, std::span<const float> y,
+		float p1x, float p1y, float p2x, float p2y,
+		std::span<float> result
+	);
+	// utils::line_project(p, p1, p2) of each point p
+	void line_project(
+		std::span<const float> x, std::span<const float> y,
+		float p1x, float p1y, float p2x, float p2y,
+		std::span<float> result_x, std::span<float> result_y
+	);
+	// utils::line_intersect of segment v1-v2 with each segment (x1, y1)-(x2, y2),
+	// returns index of the first one it intersects or -1
+	ptrdiff_t line_intersect_first(
+		float v1x, float v1y, float v2x, float v2y,
+		std::span<const float> x1, std::span<const float> y1,
+		std::span<const float> x2, std::span<const float> y2,
+		float epsilon, sf::Vector2f& intersection
+	);
+	// rotation around the pivot, like utils::rotate_point but sine
+	// and cosine are calculated once instead of per point
+	void rotate_points(
+		std::span<const float> x, std::span<const float> y,
+		float pivot_x, float pivot_y, float angle,
+		std::span<float> result_x, std::span<float> result_y
+	);
+	// b2Mul(transform, p) of each point p
+	void transform_points(
+		std::span<const float> x, std::span<const float> y,
+		const b2Transform& transform,
+		std::span<float> result_x, std::span<float> result_y
+	);
+	// utils::contains_point(rect, p) of each point p, 1 if true
+	void contains_point(
+		std::span<const float> x, std::span<const float> y,
+		const sf::FloatRect& rect,
+		std::span<uint8_t> result
+	);
+
+}
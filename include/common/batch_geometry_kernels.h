@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// vector loops of the batch geometry functions for one instruction set,
+// every loop starts at the first point, processes whole vectors and returns
+// how many points it processed, the rest is done by the scalar loop,
+// source files of the kernels are compiled with their own instruction set flags,
+// so only raw pointers are passed to keep library code out of them
+namespace utils::batch {
+
+	struct Kernels {
+		size_t (*get_line_D)(
+			const float* x, const float* y, size_t count,
+			float p1x, float p1y, float p2x, float p2y,
+			float* result
+		);
+		size_t (*line_side)(
+			const float* x, const float* y, size_t count,
+			float p1x, float p1y, float p2x, float p2y,
+			bool left, uint8_t* result
+		);
+		size_t (*distance_to_line)(
+			const float* x, const float* y, size_t count,
+			float p1x, float p1y, float p2x, float p2y, float length,
+			float* result
+		);
+		size_t (*line_project)(
+			const float* x, const float* y, size_t count,
+			float p1x, float p1y, float p2x, float p2y,
+			float* result_x, float* result_y
+		);
+		// stops at the first vector with a hit, which is then found by the scalar loop
+		size_t (*line_intersect_first)(
+			float v1x, float v1y, float v2x, float v2y,
+			const float* x1, const float* y1, const float* x2, const float* y2, size_t count,
+			float epsilon
+		);
+		size_t (*rotate_points)(
+			const float* x, const float* y, size_t count,
+			float pivot_x, float pivot_y, float c, float s,
+			float* result_x, float* result_y
+		);
+		size_t (*transform_points)(
+			const float* x, const float* y, size_t count,
+			float c, float s, float px, float py,
+			float* result_x, float* result_y
+		);
+		size_t (*contains_point)(
+			const float* x, const float* y, size_t count,
+			float left, float right, float top, float bottom,
+			uint8_t* result
+		);
+	};
+
+	// null if the kernels were not compiled in
+	const Kernels* get_sse2_kernels();
+	const Kernels* get_avx2_kernels();
+
+}
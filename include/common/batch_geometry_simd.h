@@ -0,0 +1,224 @@
+#pragma once
+
+#include "common/batch_geometry_kernels.h"
+
+// vector loops written once for every vector width, V wraps the intrinsics of
+// one instruction set, included only by the kernel source files,
+// everything is in an anonymous namespace, so code compiled with different
+// instruction set flags is never merged by the linker
+namespace utils::batch {
+	namespace {
+
+		template<typename V>
+		inline void vstore_mask(uint8_t* ptr, typename V::vfloat mask) {
+			int bits = V::vmask(mask);
+			for (size_t i = 0; i < V::WIDTH; i++) {
+				ptr[i] = (bits >> i) & 1;
+			}
+		}
+
+		template<typename V>
+		inline typename V::vfloat vline_D(
+			typename V::vfloat x, typename V::vfloat y,
+			typename V::vfloat p1x, typename V::vfloat p1y, typename V::vfloat dx, typename V::vfloat dy
+		) {
+			return V::vsub(V::vmul(dx, V::vsub(y, p1y)), V::vmul(dy, V::vsub(x, p1x)));
+		}
+
+		template<typename V>
+		size_t get_line_D_kernel(
+			const float* x, const float* y, size_t count,
+			float p1x, float p1y, float p2x, float p2y,
+			float* result
+		) {
+			typename V::vfloat vdx = V::vset(p2x - p1x);
+			typename V::vfloat vdy = V::vset(p2y - p1y);
+			typename V::vfloat vp1x = V::vset(p1x);
+			typename V::vfloat vp1y = V::vset(p1y);
+			size_t i = 0;
+			for (; i + V::WIDTH <= count; i += V::WIDTH) {
+				typename V::vfloat D = vline_D<V>(V::vload(&x[i]), V::vload(&y[i]), vp1x, vp1y, vdx, vdy);
+				V::vstore(&result[i], D);
+			}
+			return i;
+		}
+
+		template<typename V>
+		size_t line_side_kernel(
+			const float* x, const float* y, size_t count,
+			float p1x, float p1y, float p2x, float p2y,
+			bool left, uint8_t* result
+		) {
+			typename V::vfloat vdx = V::vset(p2x - p1x);
+			typename V::vfloat vdy = V::vset(p2y - p1y);
+			typename V::vfloat vp1x = V::vset(p1x);
+			typename V::vfloat vp1y = V::vset(p1y);
+			typename V::vfloat zero = V::vset(0.0f);
+			size_t i = 0;
+			for (; i + V::WIDTH <= count; i += V::WIDTH) {
+				typename V::vfloat D = vline_D<V>(V::vload(&x[i]), V::vload(&y[i]), vp1x, vp1y, vdx, vdy);
+				vstore_mask<V>(&result[i], left ? V::vgt(D, zero) : V::vlt(D, zero));
+			}
+			return i;
+		}
+
+		template<typename V>
+		size_t distance_to_line_kernel(
+			const float* x, const float* y, size_t count,
+			float p1x, float p1y, float p2x, float p2y, float length,
+			float* result
+		) {
+			typename V::vfloat vdx = V::vset(p2x - p1x);
+			typename V::vfloat vdy = V::vset(p2y - p1y);
+			typename V::vfloat vp1x = V::vset(p1x);
+			typename V::vfloat vp1y = V::vset(p1y);
+			typename V::vfloat vlength = V::vset(length);
+			size_t i = 0;
+			for (; i + V::WIDTH <= count; i += V::WIDTH) {
+				typename V::vfloat D = vline_D<V>(V::vload(&x[i]), V::vload(&y[i]), vp1x, vp1y, vdx, vdy);
+				V::vstore(&result[i], V::vdiv(V::vabs(D), vlength));
+			}
+			return i;
+		}
+
+		template<typename V>
+		size_t line_project_kernel(
+			const float* x, const float* y, size_t count,
+			float p1x, float p1y, float p2x, float p2y,
+			float* result_x, float* result_y
+		) {
+			float bx = p2x - p1x;
+			float by = p2y - p1y;
+			typename V::vfloat vbx = V::vset(bx);
+			typename V::vfloat vby = V::vset(by);
+			typename V::vfloat vbb = V::vset(bx * bx + by * by);
+			typename V::vfloat vp1x = V::vset(p1x);
+			typename V::vfloat vp1y = V::vset(p1y);
+			size_t i = 0;
+			for (; i + V::WIDTH <= count; i += V::WIDTH) {
+				typename V::vfloat ax = V::vsub(V::vload(&x[i]), vp1x);
+				typename V::vfloat ay = V::vsub(V::vload(&y[i]), vp1y);
+				typename V::vfloat t = V::vdiv(V::vadd(V::vmul(ax, vbx), V::vmul(ay, vby)), vbb);
+				V::vstore(&result_x[i], V::vadd(vp1x, V::vmul(t, vbx)));
+				V::vstore(&result_y[i], V::vadd(vp1y, V::vmul(t, vby)));
+			}
+			return i;
+		}
+
+		template<typename V>
+		size_t line_intersect_first_kernel(
+			float v1x, float v1y, float v2x, float v2y,
+			const float* x1, const float* y1, const float* x2, const float* y2, size_t count,
+			float epsilon
+		) {
+			float abs_epsilon = epsilon < 0.0f ? -epsilon : epsilon;
+			typename V::vfloat vrx = V::vset(v2x - v1x);
+			typename V::vfloat vry = V::vset(v2y - v1y);
+			typename V::vfloat vv1x = V::vset(v1x);
+			typename V::vfloat vv1y = V::vset(v1y);
+			typename V::vfloat vepsilon = V::vset(epsilon);
+			typename V::vfloat vabs_epsilon = V::vset(abs_epsilon);
+			typename V::vfloat vt_min = V::vset(0.0f + epsilon);
+			typename V::vfloat vt_max = V::vset(1.0f - epsilon);
+			size_t i = 0;
+			for (; i + V::WIDTH <= count; i += V::WIDTH) {
+				typename V::vfloat ex1 = V::vload(&x1[i]);
+				typename V::vfloat ey1 = V::vload(&y1[i]);
+				typename V::vfloat sx = V::vsub(V::vload(&x2[i]), ex1);
+				typename V::vfloat sy = V::vsub(V::vload(&y2[i]), ey1);
+				typename V::vfloat qpx = V::vsub(ex1, vv1x);
+				typename V::vfloat qpy = V::vsub(ey1, vv1y);
+				typename V::vfloat rs = V::vsub(V::vmul(vrx, sy), V::vmul(vry, sx));
+				typename V::vfloat qps = V::vsub(V::vmul(qpx, sy), V::vmul(qpy, sx));
+				typename V::vfloat qpr = V::vsub(V::vmul(qpx, vry), V::vmul(qpy, vrx));
+				typename V::vfloat t = V::vdiv(qps, rs);
+				typename V::vfloat u = V::vdiv(qpr, rs);
+				typename V::vfloat hit = V::vgt(V::vsqrt(V::vadd(V::vmul(sx, sx), V::vmul(sy, sy))), vabs_epsilon);
+				hit = V::vand(hit, V::vge(V::vabs(rs), vepsilon));
+				hit = V::vand(hit, V::vand(V::vge(t, vt_min), V::vle(t, vt_max)));
+				hit = V::vand(hit, V::vand(V::vge(u, vt_min), V::vle(u, vt_max)));
+				if (V::vmask(hit) != 0) {
+					break;
+				}
+			}
+			return i;
+		}
+
+		template<typename V>
+		size_t rotate_points_kernel(
+			const float* x, const float* y, size_t count,
+			float pivot_x, float pivot_y, float c, float s,
+			float* result_x, float* result_y
+		) {
+			typename V::vfloat vc = V::vset(c);
+			typename V::vfloat vs = V::vset(s);
+			typename V::vfloat vpx = V::vset(pivot_x);
+			typename V::vfloat vpy = V::vset(pivot_y);
+			size_t i = 0;
+			for (; i + V::WIDTH <= count; i += V::WIDTH) {
+				typename V::vfloat rx = V::vsub(V::vload(&x[i]), vpx);
+				typename V::vfloat ry = V::vsub(V::vload(&y[i]), vpy);
+				V::vstore(&result_x[i], V::vadd(V::vsub(V::vmul(vc, rx), V::vmul(vs, ry)), vpx));
+				V::vstore(&result_y[i], V::vadd(V::vadd(V::vmul(vs, rx), V::vmul(vc, ry)), vpy));
+			}
+			return i;
+		}
+
+		template<typename V>
+		size_t transform_points_kernel(
+			const float* x, const float* y, size_t count,
+			float c, float s, float px, float py,
+			float* result_x, float* result_y
+		) {
+			typename V::vfloat vc = V::vset(c);
+			typename V::vfloat vs = V::vset(s);
+			typename V::vfloat vpx = V::vset(px);
+			typename V::vfloat vpy = V::vset(py);
+			size_t i = 0;
+			for (; i + V::WIDTH <= count; i += V::WIDTH) {
+				typename V::vfloat lx = V::vload(&x[i]);
+				typename V::vfloat ly = V::vload(&y[i]);
+				V::vstore(&result_x[i], V::vadd(V::vsub(V::vmul(vc, lx), V::vmul(vs, ly)), vpx));
+				V::vstore(&result_y[i], V::vadd(V::vadd(V::vmul(vs, lx), V::vmul(vc, ly)), vpy));
+			}
+			return i;
+		}
+
+		template<typename V>
+		size_t contains_point_kernel(
+			const float* x, const float* y, size_t count,
+			float left, float right, float top, float bottom,
+			uint8_t* result
+		) {
+			typename V::vfloat vleft = V::vset(left);
+			typename V::vfloat vright = V::vset(right);
+			typename V::vfloat vtop = V::vset(top);
+			typename V::vfloat vbottom = V::vset(bottom);
+			size_t i = 0;
+			for (; i + V::WIDTH <= count; i += V::WIDTH) {
+				typename V::vfloat vx = V::vload(&x[i]);
+				typename V::vfloat vy = V::vload(&y[i]);
+				typename V::vfloat inside = V::vand(V::vge(vx, vleft), V::vle(vx, vright));
+				inside = V::vand(inside, V::vand(V::vge(vy, vtop), V::vle(vy, vbottom)));
+				vstore_mask<V>(&result[i], inside);
+			}
+			return i;
+		}
+
+		template<typename V>
+		const Kernels* make_kernels() {
+			static const Kernels kernels = {
+				&get_line_D_kernel<V>,
+				&line_side_kernel<V>,
+				&distance_to_line_kernel<V>,
+				&line_project_kernel<V>,
+				&line_intersect_first_kernel<V>,
+				&rotate_points_kernel<V>,
+				&transform_points_kernel<V>,
+				&contains_point_kernel<V>,
+			};
+			return &kernels;
+		}
+
+	}
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+
+// fast LZ77 compression in the spirit of LZ4,
+// good enough for text with a lot of repeating lines
+namespace compression {
+
+	std::string compress(const std::string& str);
+	std::string decompress(const std::string& str);
+
+}
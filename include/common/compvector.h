@@ -44,6 +44,8 @@ public:
 	void moveValueToValue(const T& src, const T& dst);
 	ptrdiff_t remove(const T& value);
 	void removeAt(size_t index);
+	template<typename TPred>
+	size_t removeIf(const TPred& pred);
 	void reverse();
 	std::vector<T>::iterator begin();
 	std::vector<T>::iterator end();
@@ -102,6 +104,8 @@ public:
 	size_t insert(const std::vector<T*>::const_iterator& where, const TIter& first, const TIter& last);
 	ptrdiff_t remove(T* value);
 	void removeAt(size_t index);
+	template<typename TPred>
+	size_t removeIf(const TPred& pred);
 	void reverse();
 	std::vector<T*>::iterator begin();
 	std::vector<T*>::iterator end();
@@ -279,6 +283,20 @@ inline void CompVector<T, TCmp>::removeAt(size_t index) {
 	set.erase(value);
 }
 
+template<typename T, typename TCmp>
+template<typename TPred>
+inline size_t CompVector<T, TCmp>::removeIf(const TPred& pred) {
+	// single pass, removing many values one by one is quadratic
+	size_t removed = std::erase_if(vector, [&](const T& value) {
+		if (pred(value)) {
+			set.erase(value);
+			return true;
+		}
+		return false;
+	});
+	return removed;
+}
+
 template<typename T, typename TCmp>
 inline void CompVector<T, TCmp>::reverse() {
 	std::reverse(vector.begin(), vector.end());
@@ -539,6 +557,19 @@ inline void CompVectorUptr<T, TCmp>::removeAt(size_t index) {
 	comp.removeAt(index);
 }
 
+template<typename T, typename TCmp>
+template<typename TPred>
+inline size_t CompVectorUptr<T, TCmp>::removeIf(const TPred& pred) {
+	// predicate is checked before any of the values are deleted
+	size_t removed = comp.removeIf(pred);
+	if (removed > 0) {
+		std::erase_if(uptrs, [&](const dp::DataPointerUnique<T>& uptr) {
+			return !comp.contains(uptr.get());
+		});
+	}
+	return removed;
+}
+
 template<typename T, typename TCmp>
 inline void CompVectorUptr<T, TCmp>::reverse() {
 	std::reverse(uptrs.begin(), uptrs.end());
@@ -2,20 +2,61 @@
 
 #include <format>
 #include <iostream>
-#include <map>
+#include <memory>
+#include <atomic>
+#include <optional>
+#include <vector>
 #include <cassert>
 #include <string>
+#include "memory_stats.h"
+
+// set to 0 by B2E_DATA_POINTER_TRACKING=OFF, then data pointers don't touch the registry at all
+#ifndef DATA_POINTER_TRACKING
+#define DATA_POINTER_TRACKING 1
+#endif
 
 namespace dp {
 
+	inline const std::string UNNAMED_BLOCK_NAME = "<unnamed>";
+
 	struct DataBlock {
-		DataBlock(const std::string& name, void* ptr, size_t size);
-		std::string name = "<unnamed>";
+		DataBlock(const std::string* name, void* ptr, size_t size);
+		// interned, stays valid while the block is in the registry
+		const std::string* name = &UNNAMED_BLOCK_NAME;
 		void* ptr = nullptr;
 		size_t size = 0;
+		MemoryCategory category = MemoryCategory::OTHER;
+	};
+
+	// blocks are split between shards by address,
+	// so threads allocating different objects rarely wait for each other
+	class DataBlockRegistry {
+	public:
+		static const size_t SHARD_COUNT = 16;
+
+		DataBlockRegistry();
+		~DataBlockRegistry();
+		void add(const DataBlock& block);
+		bool remove(void* ptr);
+		std::optional<DataBlock> find(void* ptr) const;
+		bool contains(void* ptr) const;
+		bool setName(void* ptr, const std::string* name);
+		size_t size() const;
+		std::vector<DataBlock> getBlocks() const;
+		void clear();
+
+	private:
+		struct Shard;
+		std::unique_ptr<Shard[]> shards;
+		std::atomic<size_t> block_count = 0;
+
+		Shard& getShard(void* ptr);
+		const Shard& getShard(void* ptr) const;
+
 	};
 
-	extern std::map<void*, DataBlock> data_blocks;
+	extern DataBlockRegistry data_blocks;
+	extern std::atomic<bool> tracking_flag;
 
 	template<typename T>
 	class DataPointerDefaultDelete {
@@ -27,7 +68,23 @@ namespace dp {
 
 	};
 
+	// pointers created while tracking is disabled are never added to the registry
+	// and don't keep their names, the ones that were added are still removed
+	inline bool is_tracking_enabled() {
+#if DATA_POINTER_TRACKING
+		return tracking_flag.load(std::memory_order_relaxed);
+#else
+		return false;
+#endif
+	}
+	void set_tracking_enabled(bool value);
+	// interned names are counted, every call adds a reference which is passed
+	// to the registry together with the block and released when the block is removed
+	const std::string* intern_name(const std::string& name);
+	void release_name(const std::string* name);
+	size_t get_interned_name_count();
 	void add_to_data_blocks(const DataBlock& block);
+	void add_to_data_blocks(const std::string* name, void* ptr, size_t size);
 	void add_to_data_blocks(const std::string& name, void* ptr, size_t size);
 	void remove_from_data_blocks(void* ptr);
 	std::string pointer_to_str(void* ptr);
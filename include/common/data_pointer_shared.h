@@ -37,7 +37,8 @@ namespace dp {
 		operator bool();
 	private:
 		template<typename T2, typename D2> friend class DataPointerShared;
-		std::string name = "<unnamed>";
+		// interned registry name, nullptr if the pointer is not tracked
+		const std::string* name = nullptr;
 		T* ptr = nullptr;
 		ref_count_t* ref_count = nullptr;
 		D deleter;
@@ -61,13 +62,11 @@ namespace dp {
 
 	template<typename T, typename D>
 	inline DataPointerShared<T, D>::DataPointerShared(const std::string& name, T* ptr) {
-		this->name = name;
 		create(name, ptr);
 	}
 
 	template<typename T, typename D>
 	inline DataPointerShared<T, D>::DataPointerShared(const std::string& name, T* ptr, const D& deleter) : deleter(deleter) {
-		this->name = name;
 		create(name, ptr);
 	}
 
@@ -162,14 +161,15 @@ namespace dp {
 
 	template<typename T, typename D>
 	inline const std::string& DataPointerShared<T, D>::getName() const {
-		return name;
+		return name ? *name : UNNAMED_BLOCK_NAME;
 	}
 
 	template<typename T, typename D>
 	inline void DataPointerShared<T, D>::setName(const std::string& name) {
-		this->name = name;
-		auto it = data_blocks.find(ptr);
-		it->second.name = name;
+		if (this->name) {
+			this->name = intern_name(name);
+			data_blocks.setName(reinterpret_cast<void*>(ptr), this->name);
+		}
 	}
 
 	template<typename T, typename D>
@@ -185,8 +185,8 @@ namespace dp {
 	template<typename T, typename D>
 	inline DataPointerShared<T, D>& DataPointerShared<T, D>::operator=(const DataPointerShared& right) {
 		if (right.ptr != this->ptr) {
-			this->name = right.name;
 			dispose();
+			this->name = right.name;
 			this->ptr = right.ptr;
 			this->deleter = right.deleter;
 			this->ref_count = right.ref_count;
@@ -200,8 +200,8 @@ namespace dp {
 	template<typename T, typename D>
 	inline DataPointerShared<T, D>& DataPointerShared<T, D>::operator=(DataPointerShared&& right) {
 		if (right.ptr != this->ptr) {
-			this->name = right.name;
 			dispose();
+			this->name = right.name;
 			this->ptr = right.ptr;
 			right.ptr = nullptr;
 			this->deleter = right.deleter;
@@ -214,8 +214,8 @@ namespace dp {
 	template<typename T2, typename D2>
 	inline DataPointerShared<T, D>& DataPointerShared<T, D>::operator=(DataPointerShared<T2, D2>&& right) {
 		if (right.ptr != this->ptr) {
-			this->name = right.name;
 			dispose();
+			this->name = right.name;
 			this->ptr = right.ptr;
 			right.ptr = nullptr;
 			this->deleter = right.deleter;
@@ -227,7 +227,11 @@ namespace dp {
 	template<typename T, typename D>
 	inline void DataPointerShared<T, D>::create(const std::string& new_name, T* new_ptr) {
 		if (new_ptr) {
-			add_to_data_blocks(new_name, reinterpret_cast<void*>(new_ptr), sizeof(T));
+			this->name = nullptr;
+			if (is_tracking_enabled()) {
+				this->name = intern_name(new_name);
+				add_to_data_blocks(this->name, reinterpret_cast<void*>(new_ptr), sizeof(T));
+			}
 			ref_count = new ref_count_t(1);
 			this->ptr = new_ptr;
 		}
@@ -238,11 +242,14 @@ namespace dp {
 		if (ptr) {
 			--(*ref_count);
 			if (*ref_count == 0) {
-				remove_from_data_blocks(reinterpret_cast<void*>(ptr));
+				if (name) {
+					remove_from_data_blocks(reinterpret_cast<void*>(ptr));
+				}
 				deleter(ptr);
 				delete ref_count;
 			}
 			ptr = nullptr;
+			name = nullptr;
 		}
 	}
 
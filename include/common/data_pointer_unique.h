@@ -34,7 +34,8 @@ namespace dp {
 
 	private:
 		template<typename T2, typename D2> friend class DataPointerUnique;
-		std::string name = "<unnamed>";
+		// interned registry name, nullptr if the pointer is not tracked
+		const std::string* name = nullptr;
 		T* ptr = nullptr;
 		D deleter;
 
@@ -57,13 +58,11 @@ namespace dp {
 
 	template<typename T, typename D>
 	inline DataPointerUnique<T, D>::DataPointerUnique(const std::string& name, T* ptr) : deleter(D()) {
-		this->name = name;
 		create(name, ptr);
 	}
 
 	template<typename T, typename D>
 	inline DataPointerUnique<T, D>::DataPointerUnique(const std::string& name, T* ptr, const D& deleter) : deleter(deleter) {
-		this->name = name;
 		create(name, ptr);
 	}
 
@@ -97,10 +96,11 @@ namespace dp {
 	template<typename T, typename D>
 	inline T* DataPointerUnique<T, D>::release() {
 		T* result = ptr;
-		if (ptr) {
+		if (ptr && name) {
 			remove_from_data_blocks(reinterpret_cast<void*>(ptr));
 		}
 		ptr = nullptr;
+		name = nullptr;
 		return result;
 	}
 
@@ -132,14 +132,15 @@ namespace dp {
 
 	template<typename T, typename D>
 	inline const std::string& DataPointerUnique<T, D>::getName() const {
-		return name;
+		return name ? *name : UNNAMED_BLOCK_NAME;
 	}
 
 	template<typename T, typename D>
 	inline void DataPointerUnique<T, D>::setName(const std::string& name) {
-		this->name = name;
-		auto it = data_blocks.find(ptr);
-		it->second.name = name;
+		if (this->name) {
+			this->name = intern_name(name);
+			data_blocks.setName(reinterpret_cast<void*>(ptr), this->name);
+		}
 	}
 
 	template<typename T, typename D>
@@ -155,8 +156,8 @@ namespace dp {
 	template<typename T, typename D>
 	inline DataPointerUnique<T, D>& DataPointerUnique<T, D>::operator=(DataPointerUnique&& right) {
 		if (right.ptr != this->ptr) {
-			this->name = right.name;
 			dispose();
+			this->name = right.name;
 			this->ptr = right.ptr;
 			right.ptr = nullptr;
 			this->deleter = right.deleter;
@@ -168,8 +169,8 @@ namespace dp {
 	template<typename T2, typename D2>
 	inline DataPointerUnique<T, D>& DataPointerUnique<T, D>::operator=(DataPointerUnique<T2, D2>&& right) {
 		if (right.ptr != this->ptr) {
-			this->name = right.name;
 			dispose();
+			this->name = right.name;
 			this->ptr = right.ptr;
 			right.ptr = nullptr;
 			this->deleter = right.deleter;
@@ -185,7 +186,11 @@ namespace dp {
 	template<typename T, typename D>
 	inline void DataPointerUnique<T, D>::create(const std::string& new_name, T* new_ptr) {
 		if (new_ptr) {
-			add_to_data_blocks(new_name, reinterpret_cast<void*>(new_ptr), sizeof(T));
+			this->name = nullptr;
+			if (is_tracking_enabled()) {
+				this->name = intern_name(new_name);
+				add_to_data_blocks(this->name, reinterpret_cast<void*>(new_ptr), sizeof(T));
+			}
 			this->ptr = new_ptr;
 		}
 	}
@@ -193,9 +198,12 @@ namespace dp {
 	template<typename T, typename D>
 	inline void DataPointerUnique<T, D>::dispose() {
 		if (ptr) {
-			remove_from_data_blocks(reinterpret_cast<void*>(ptr));
+			if (name) {
+				remove_from_data_blocks(reinterpret_cast<void*>(ptr));
+			}
 			deleter(ptr);
 			ptr = nullptr;
+			name = nullptr;
 		}
 	}
 
@@ -2,8 +2,15 @@
 
 #include <vector>
 #include <functional>
+#include <concepts>
+#include <type_traits>
+#include <new>
+#include <cstring>
+#include <utility>
 #include <cassert>
-#include "common/data_pointer_shared.h"
+#include <span>
+#include <tuple>
+#include <exception>
 
 template<typename ...TArgs>
 class Event;
@@ -13,7 +20,6 @@ class EventTarget {
 public:
 	EventTarget();
 	virtual ptrdiff_t getId() const;
-	virtual void operator()(TArgs... args) = 0;
 
 private:
 	ptrdiff_t id = -1;
@@ -21,119 +27,652 @@ private:
 
 };
 
+// type-erased callable, stored in place if it is small enough,
+// so most handlers don't need a separate allocation
 template<typename ...TArgs>
-class EventHandlerFunc : public EventTarget<TArgs...> {
+class EventDelegate {
 public:
-	EventHandlerFunc(const std::function<void(TArgs...)>& func);
-	void operator()(TArgs... args) override;
+	static const size_t INLINE_SIZE = 4 * sizeof(void*);
+
+	EventDelegate();
+	template<typename TFunc>
+	requires (!std::same_as<std::decay_t<TFunc>, EventDelegate<TArgs...>>)
+	EventDelegate(TFunc&& func);
+	EventDelegate(const EventDelegate& other);
+	EventDelegate(EventDelegate&& other) noexcept;
+	~EventDelegate();
+	bool isInline() const;
+	void operator()(TArgs... args);
+	explicit operator bool() const;
+	EventDelegate& operator=(const EventDelegate& other);
+	EventDelegate& operator=(EventDelegate&& other) noexcept;
 
 private:
-	std::function<void(TArgs...)> func;
+	enum class Operation {
+		COPY,
+		MOVE,
+		DESTROY,
+	};
+	using InvokeFunc = void(*)(void* storage, TArgs... args);
+	using ManageFunc = void(*)(Operation operation, void* dst, void* src);
+	alignas(void*) unsigned char storage[INLINE_SIZE];
+	InvokeFunc invoke_func = nullptr;
+	// null for trivially copyable functions stored inline
+	ManageFunc manage_func = nullptr;
+	bool is_inline = false;
+
+	template<typename TFunc>
+	static constexpr bool fitsInline();
+	template<typename TFunc>
+	static void invokeInline(void* storage, TArgs... args);
+	template<typename TFunc>
+	static void invokeHeap(void* storage, TArgs... args);
+	template<typename TFunc>
+	static void manageInline(Operation operation, void* dst, void* src);
+	template<typename TFunc>
+	static void manageHeap(Operation operation, void* dst, void* src);
+	void copyFrom(const EventDelegate& other);
+	void moveFrom(EventDelegate& other);
+	void reset();
+
 };
 
 template<typename ...TArgs>
-class EventHandlerEvent : public EventTarget<TArgs...> {
+class EventHandlerFunc : public EventTarget<TArgs...> {
 public:
-	EventHandlerEvent(const Event<TArgs...>& event);
-	ptrdiff_t getId() const override;
-	void operator()(TArgs... args) override;
+	template<typename TFunc>
+	requires (!std::derived_from<std::decay_t<TFunc>, EventTarget<TArgs...>>)
+	EventHandlerFunc(TFunc&& func);
+	const EventDelegate<TArgs...>& getDelegate() const;
+	void operator()(TArgs... args);
 
 private:
-	Event<TArgs...>* event;
+	EventDelegate<TArgs...> delegate;
 };
 
+// handlers are stored contiguously,
+// handlers added during dispatch are called starting from the next one,
+// removed ones are skipped right away and erased when dispatch ends
+template<typename TDelegate>
+class EventHandlerList {
+public:
+	struct Handler {
+		ptrdiff_t id = -1;
+		bool removed = false;
+		TDelegate delegate;
+	};
+	std::vector<Handler> handlers;
+
+	size_t size() const;
+	void add(ptrdiff_t id, TDelegate&& delegate, bool dispatching);
+	void remove(ptrdiff_t id, bool dispatching);
+	void clear(bool dispatching);
+	void copyFrom(const EventHandlerList& other);
+	bool hasPending() const;
+	void applyPending();
+
+private:
+	std::vector<Handler> pending_handlers;
+	bool has_removed = false;
+
+};
+
+// reference arguments are batched by reference, so they have to outlive the batch
+template<typename T>
+using EventBatchValue = std::conditional_t<
+	std::is_reference_v<T>,
+	std::reference_wrapper<std::remove_reference_t<T>>,
+	std::remove_cv_t<T>
+>;
+
+// events with one argument are batched as a list of that argument
+template<typename ...TArgs>
+struct EventBatchArg {
+	using type = std::tuple<EventBatchValue<TArgs>...>;
+};
+
+template<typename TArg>
+struct EventBatchArg<TArg> {
+	using type = EventBatchValue<TArg>;
+};
+
+// handlers are called through a function pointer,
+// batch handlers get all calls made between beginBatch and endBatch at once,
+// outside of a batch they get every call as a batch of one
 template<typename ...TArgs>
 class Event : public EventTarget<TArgs...> {
 public:
-	const std::vector<dp::DataPointerShared<EventTarget<TArgs...>>>& getTargets() const;
-	void operator+=(const std::function<void(TArgs...)>& func);
+	using BatchArg = typename EventBatchArg<TArgs...>::type;
+	using BatchDelegate = EventDelegate<std::span<const BatchArg>>;
+
+	Event();
+	Event(const Event& other);
+	size_t size() const;
+	bool empty() const;
+	bool isBatching() const;
+	template<typename TFunc>
+	requires (!std::derived_from<std::decay_t<TFunc>, EventTarget<TArgs...>>)
+	void operator+=(TFunc&& func);
 	void operator+=(const Event<TArgs...>& event);
 	void operator+=(const EventHandlerFunc<TArgs...>& handler);
 	void operator-=(const EventTarget<TArgs...>& target);
+	template<typename TFunc>
+	void addBatchHandler(TFunc&& func);
+	void beginBatch();
+	void endBatch();
+	void cancelBatch();
 	void operator()(TArgs... args);
 	void clear();
+	Event& operator=(const Event& other);
 
 private:
-	std::vector<dp::DataPointerShared<EventTarget<TArgs...>>> targets;
+	EventHandlerList<EventDelegate<TArgs...>> handlers;
+	EventHandlerList<BatchDelegate> batch_handlers;
+	std::vector<BatchArg> batch_queue;
+	size_t dispatch_depth = 0;
+	size_t batch_depth = 0;
+
+	void dispatch(TArgs... args);
+	void dispatchBatch(std::span<const BatchArg> batch);
+	void applyPending();
+
+};
+
+// batches events until end is called,
+// if the scope is left by an exception the batches are dropped instead
+template<typename ...TEvents>
+class EventBatchScope {
+public:
+	EventBatchScope(TEvents&... events);
+	EventBatchScope(const EventBatchScope& other) = delete;
+	~EventBatchScope() noexcept(false);
+	EventBatchScope& operator=(const EventBatchScope& other) = delete;
+	void end();
+
+private:
+	std::tuple<TEvents&...> events;
+	int uncaught_exceptions = 0;
+	bool ended = false;
+
+	void cancel();
 
 };
 
 template<typename ...TArgs>
-inline const std::vector<dp::DataPointerShared<EventTarget<TArgs...>>>& Event<TArgs...>::getTargets() const {
-	return targets;
+inline EventTarget<TArgs...>::EventTarget() {
+	this->id = event_target_id++;
+}
+
+template<typename ...TArgs>
+inline ptrdiff_t EventTarget<TArgs...>::getId() const {
+	return id;
+}
+
+template<typename ...TArgs>
+inline EventDelegate<TArgs...>::EventDelegate() { }
+
+template<typename ...TArgs>
+template<typename TFunc>
+requires (!std::same_as<std::decay_t<TFunc>, EventDelegate<TArgs...>>)
+inline EventDelegate<TArgs...>::EventDelegate(TFunc&& func) {
+	using TStored = std::decay_t<TFunc>;
+	if constexpr (fitsInline<TStored>()) {
+		new (storage) TStored(std::forward<TFunc>(func));
+		invoke_func = &invokeInline<TStored>;
+		// lambdas capturing pointers and references are just copied bytewise
+		if constexpr (!std::is_trivially_copyable_v<TStored>) {
+			manage_func = &manageInline<TStored>;
+		}
+		is_inline = true;
+	} else {
+		*reinterpret_cast<TStored**>(storage) = new TStored(std::forward<TFunc>(func));
+		invoke_func = &invokeHeap<TStored>;
+		manage_func = &manageHeap<TStored>;
+		is_inline = false;
+	}
+}
+
+template<typename ...TArgs>
+inline EventDelegate<TArgs...>::EventDelegate(const EventDelegate& other) {
+	copyFrom(other);
+}
+
+template<typename ...TArgs>
+inline EventDelegate<TArgs...>::EventDelegate(EventDelegate&& other) noexcept {
+	moveFrom(other);
+}
+
+template<typename ...TArgs>
+inline EventDelegate<TArgs...>::~EventDelegate() {
+	reset();
+}
+
+template<typename ...TArgs>
+inline bool EventDelegate<TArgs...>::isInline() const {
+	return is_inline;
+}
+
+template<typename ...TArgs>
+inline void EventDelegate<TArgs...>::operator()(TArgs... args) {
+	assert(invoke_func);
+	invoke_func(storage, args...);
+}
+
+template<typename ...TArgs>
+inline EventDelegate<TArgs...>::operator bool() const {
+	return invoke_func != nullptr;
+}
+
+template<typename ...TArgs>
+inline EventDelegate<TArgs...>& EventDelegate<TArgs...>::operator=(const EventDelegate& other) {
+	if (this != &other) {
+		reset();
+		copyFrom(other);
+	}
+	return *this;
+}
+
+template<typename ...TArgs>
+inline EventDelegate<TArgs...>& EventDelegate<TArgs...>::operator=(EventDelegate&& other) noexcept {
+	if (this != &other) {
+		reset();
+		moveFrom(other);
+	}
+	return *this;
+}
+
+template<typename ...TArgs>
+template<typename TFunc>
+inline constexpr bool EventDelegate<TArgs...>::fitsInline() {
+	// moving has to be noexcept, since handlers are moved when the vector grows
+	return sizeof(TFunc) <= INLINE_SIZE
+		&& alignof(TFunc) <= alignof(void*)
+		&& std::is_nothrow_move_constructible_v<TFunc>;
+}
+
+template<typename ...TArgs>
+template<typename TFunc>
+inline void EventDelegate<TArgs...>::invokeInline(void* storage, TArgs... args) {
+	(*std::launder(reinterpret_cast<TFunc*>(storage)))(args...);
+}
+
+template<typename ...TArgs>
+template<typename TFunc>
+inline void EventDelegate<TArgs...>::invokeHeap(void* storage, TArgs... args) {
+	(**reinterpret_cast<TFunc**>(storage))(args...);
+}
+
+template<typename ...TArgs>
+template<typename TFunc>
+inline void EventDelegate<TArgs...>::manageInline(Operation operation, void* dst, void* src) {
+	TFunc* src_func = std::launder(reinterpret_cast<TFunc*>(src));
+	switch (operation) {
+		case Operation::COPY: new (dst) TFunc(*src_func); break;
+		case Operation::MOVE: new (dst) TFunc(std::move(*src_func)); src_func->~TFunc(); break;
+		case Operation::DESTROY: src_func->~TFunc(); break;
+	}
+}
+
+template<typename ...TArgs>
+template<typename TFunc>
+inline void EventDelegate<TArgs...>::manageHeap(Operation operation, void* dst, void* src) {
+	TFunc*& src_ptr = *reinterpret_cast<TFunc**>(src);
+	switch (operation) {
+		case Operation::COPY: *reinterpret_cast<TFunc**>(dst) = new TFunc(*src_ptr); break;
+		case Operation::MOVE: *reinterpret_cast<TFunc**>(dst) = src_ptr; src_ptr = nullptr; break;
+		case Operation::DESTROY: delete src_ptr; src_ptr = nullptr; break;
+	}
+}
+
+template<typename ...TArgs>
+inline void EventDelegate<TArgs...>::copyFrom(const EventDelegate& other) {
+	if (other.manage_func) {
+		other.manage_func(Operation::COPY, storage, const_cast<unsigned char*>(other.storage));
+	} else {
+		std::memcpy(storage, other.storage, INLINE_SIZE);
+	}
+	invoke_func = other.invoke_func;
+	manage_func = other.manage_func;
+	is_inline = other.is_inline;
+}
+
+template<typename ...TArgs>
+inline void EventDelegate<TArgs...>::moveFrom(EventDelegate& other) {
+	if (other.manage_func) {
+		other.manage_func(Operation::MOVE, storage, other.storage);
+	} else {
+		std::memcpy(storage, other.storage, INLINE_SIZE);
+	}
+	invoke_func = other.invoke_func;
+	manage_func = other.manage_func;
+	is_inline = other.is_inline;
+	other.invoke_func = nullptr;
+	other.manage_func = nullptr;
+}
+
+template<typename ...TArgs>
+inline void EventDelegate<TArgs...>::reset() {
+	if (manage_func) {
+		manage_func(Operation::DESTROY, nullptr, storage);
+	}
+	invoke_func = nullptr;
+	manage_func = nullptr;
+}
+
+template<typename ...TArgs>
+template<typename TFunc>
+requires (!std::derived_from<std::decay_t<TFunc>, EventTarget<TArgs...>>)
+inline EventHandlerFunc<TArgs...>::EventHandlerFunc(TFunc&& func)
+	: EventTarget<TArgs...>(), delegate(std::forward<TFunc>(func)) { }
+
+template<typename ...TArgs>
+inline const EventDelegate<TArgs...>& EventHandlerFunc<TArgs...>::getDelegate() const {
+	return delegate;
+}
+
+template<typename ...TArgs>
+inline void EventHandlerFunc<TArgs...>::operator()(TArgs...args) {
+	delegate(args...);
+}
+
+template<typename TDelegate>
+inline size_t EventHandlerList<TDelegate>::size() const {
+	size_t result = pending_handlers.size();
+	for (const Handler& handler : handlers) {
+		result += handler.removed ? 0 : 1;
+	}
+	return result;
+}
+
+template<typename TDelegate>
+inline void EventHandlerList<TDelegate>::add(ptrdiff_t id, TDelegate&& delegate, bool dispatching) {
+	Handler handler;
+	handler.id = id;
+	handler.delegate = std::move(delegate);
+	// growing the vector would move the handler that is being called
+	if (dispatching) {
+		pending_handlers.push_back(std::move(handler));
+	} else {
+		handlers.push_back(std::move(handler));
+	}
+}
+
+template<typename TDelegate>
+inline void EventHandlerList<TDelegate>::remove(ptrdiff_t id, bool dispatching) {
+	std::erase_if(pending_handlers, [&](const Handler& handler) {
+		return handler.id == id;
+	});
+	if (dispatching) {
+		for (Handler& handler : handlers) {
+			if (handler.id == id) {
+				handler.removed = true;
+				has_removed = true;
+			}
+		}
+	} else {
+		std::erase_if(handlers, [&](const Handler& handler) {
+			return handler.id == id;
+		});
+	}
+}
+
+template<typename TDelegate>
+inline void EventHandlerList<TDelegate>::clear(bool dispatching) {
+	pending_handlers = std::vector<Handler>();
+	if (dispatching) {
+		for (Handler& handler : handlers) {
+			handler.removed = true;
+		}
+		has_removed = true;
+	} else {
+		handlers = std::vector<Handler>();
+	}
+}
+
+template<typename TDelegate>
+inline void EventHandlerList<TDelegate>::copyFrom(const EventHandlerList& other) {
+	for (const Handler& handler : other.handlers) {
+		if (!handler.removed) {
+			add(handler.id, TDelegate(handler.delegate), false);
+		}
+	}
+	for (const Handler& handler : other.pending_handlers) {
+		add(handler.id, TDelegate(handler.delegate), false);
+	}
+}
+
+template<typename TDelegate>
+inline bool EventHandlerList<TDelegate>::hasPending() const {
+	return has_removed || pending_handlers.size() > 0;
+}
+
+template<typename TDelegate>
+inline void EventHandlerList<TDelegate>::applyPending() {
+	if (has_removed) {
+		std::erase_if(handlers, [](const Handler& handler) {
+			return handler.removed;
+		});
+		has_removed = false;
+	}
+	for (Handler& handler : pending_handlers) {
+		handlers.push_back(std::move(handler));
+	}
+	pending_handlers.clear();
+}
+
+template<typename ...TArgs>
+inline Event<TArgs...>::Event() : EventTarget<TArgs...>() { }
+
+template<typename ...TArgs>
+inline Event<TArgs...>::Event(const Event& other) : EventTarget<TArgs...>(other) {
+	*this = other;
 }
 
 template<typename ...TArgs>
-inline void Event<TArgs...>::operator+=(const std::function<void(TArgs...)>& func) {
-	dp::DataPointerShared<EventTarget<TArgs...>> uptr = dp::make_shared_data_pointer<EventHandlerFunc<TArgs...>>("EventHandler func", func);
-	targets.push_back(std::move(uptr));
+inline size_t Event<TArgs...>::size() const {
+	return handlers.size() + batch_handlers.size();
+}
+
+template<typename ...TArgs>
+inline bool Event<TArgs...>::empty() const {
+	return size() == 0;
+}
+
+template<typename ...TArgs>
+inline bool Event<TArgs...>::isBatching() const {
+	return batch_depth > 0;
+}
+
+template<typename ...TArgs>
+template<typename TFunc>
+requires (!std::derived_from<std::decay_t<TFunc>, EventTarget<TArgs...>>)
+inline void Event<TArgs...>::operator+=(TFunc&& func) {
+	// anonymous handlers can't be removed one by one
+	handlers.add(-1, EventDelegate<TArgs...>(std::forward<TFunc>(func)), dispatch_depth > 0);
 }
 
 template<typename ...TArgs>
 inline void Event<TArgs...>::operator+=(const Event<TArgs...>& event) {
-	dp::DataPointerShared<EventTarget<TArgs...>> uptr = dp::make_shared_data_pointer<EventHandlerEvent<TArgs...>>("EventHandler event", event);
-	targets.push_back(std::move(uptr));
+	Event<TArgs...>* event_ptr = const_cast<Event<TArgs...>*>(&event);
+	EventDelegate<TArgs...> delegate([=](TArgs... args) {
+		(*event_ptr)(args...);
+	});
+	handlers.add(event.getId(), std::move(delegate), dispatch_depth > 0);
 }
 
 template<typename ...TArgs>
 inline void Event<TArgs...>::operator+=(const EventHandlerFunc<TArgs...>& handler) {
-	dp::DataPointerShared<EventTarget<TArgs...>> uptr = dp::make_shared_data_pointer<EventHandlerFunc<TArgs...>>("EventHandler EventHandlerFunc", handler);
-	targets.push_back(std::move(uptr));
+	handlers.add(handler.getId(), EventDelegate<TArgs...>(handler.getDelegate()), dispatch_depth > 0);
 }
 
 template<typename ...TArgs>
 inline void Event<TArgs...>::operator-=(const EventTarget<TArgs...>& target) {
-	auto pred = [&](const dp::DataPointerShared<EventTarget<TArgs...>>& element) {
-		return element->getId() == target.getId();
-	};
-	std::erase_if(targets, pred);
+	handlers.remove(target.getId(), dispatch_depth > 0);
 }
 
 template<typename ...TArgs>
-inline void Event<TArgs...>::operator()(TArgs ...args) {
-	for (dp::DataPointerShared<EventTarget<TArgs...>>& target : targets) {
-		EventTarget<TArgs...>* ptr = target.get();
-		(*ptr)(args...);
-	}
+template<typename TFunc>
+inline void Event<TArgs...>::addBatchHandler(TFunc&& func) {
+	batch_handlers.add(-1, BatchDelegate(std::forward<TFunc>(func)), dispatch_depth > 0);
 }
 
 template<typename ...TArgs>
-inline void Event<TArgs...>::clear() {
-	targets = std::vector<dp::DataPointerShared<EventTarget<TArgs...>>>();
+inline void Event<TArgs...>::beginBatch() {
+	batch_depth++;
 }
 
 template<typename ...TArgs>
-inline EventTarget<TArgs...>::EventTarget() {
-	this->id = event_target_id++;
+inline void Event<TArgs...>::endBatch() {
+	assert(batch_depth > 0);
+	batch_depth--;
+	if (batch_depth > 0 || batch_queue.empty()) {
+		return;
+	}
+	// handlers might start a new batch on the same event
+	std::vector<BatchArg> batch = std::move(batch_queue);
+	batch_queue = std::vector<BatchArg>();
+	dispatch_depth++;
+	try {
+		dispatchBatch(batch);
+	} catch (...) {
+		dispatch_depth--;
+		throw;
+	}
+	dispatch_depth--;
+	if (dispatch_depth == 0) {
+		applyPending();
+	}
 }
 
 template<typename ...TArgs>
-inline ptrdiff_t EventTarget<TArgs...>::getId() const {
-	return id;
+inline void Event<TArgs...>::cancelBatch() {
+	assert(batch_depth > 0);
+	batch_depth--;
+	if (batch_depth == 0) {
+		batch_queue = std::vector<BatchArg>();
+	}
 }
 
 template<typename ...TArgs>
-inline EventHandlerFunc<TArgs...>::EventHandlerFunc(const std::function<void(TArgs...)>& func) : EventTarget<TArgs...>() {
-	this->func = func;
+inline void Event<TArgs...>::operator()(TArgs ...args) {
+	// most events of most widgets have no handlers
+	if (handlers.handlers.empty() && batch_handlers.handlers.empty()) {
+		return;
+	}
+	dispatch(args...);
 }
 
 template<typename ...TArgs>
-inline void EventHandlerFunc<TArgs...>::operator()(TArgs...args) {
-	func(args...);
+inline void Event<TArgs...>::clear() {
+	handlers.clear(dispatch_depth > 0);
+	batch_handlers.clear(dispatch_depth > 0);
+	batch_queue = std::vector<BatchArg>();
 }
 
 template<typename ...TArgs>
-inline EventHandlerEvent<TArgs...>::EventHandlerEvent(const Event<TArgs...>& event) : EventTarget<TArgs...>() {
-	this->event = const_cast<Event<TArgs...>*>(&event);
+inline Event<TArgs...>& Event<TArgs...>::operator=(const Event& other) {
+	if (this == &other) {
+		return *this;
+	}
+	EventTarget<TArgs...>::operator=(other);
+	clear();
+	handlers.copyFrom(other.handlers);
+	batch_handlers.copyFrom(other.batch_handlers);
+	return *this;
 }
 
 template<typename ...TArgs>
-inline ptrdiff_t EventHandlerEvent<TArgs...>::getId() const {
-	return event->getId();
+inline void Event<TArgs...>::dispatch(TArgs... args) {
+	dispatch_depth++;
+	size_t count = handlers.handlers.size();
+	for (size_t i = 0; i < count; i++) {
+		auto& handler = handlers.handlers[i];
+		if (!handler.removed) {
+			handler.delegate(args...);
+		}
+	}
+	if (batch_handlers.handlers.size() > 0) {
+		if (batch_depth > 0) {
+			batch_queue.push_back(BatchArg(args...));
+		} else {
+			BatchArg arg(args...);
+			dispatchBatch(std::span<const BatchArg>(&arg, 1));
+		}
+	}
+	dispatch_depth--;
+	if (dispatch_depth == 0) {
+		applyPending();
+	}
 }
 
 template<typename ...TArgs>
-inline void EventHandlerEvent<TArgs...>::operator()(TArgs...args) {
-	Event<TArgs...>* ptr = this->event;
-	(*ptr)(args...);
+inline void Event<TArgs...>::dispatchBatch(std::span<const BatchArg> batch) {
+	size_t count = batch_handlers.handlers.size();
+	for (size_t i = 0; i < count; i++) {
+		auto& handler = batch_handlers.handlers[i];
+		if (!handler.removed) {
+			handler.delegate(batch);
+		}
+	}
+}
+
+template<typename ...TArgs>
+inline void Event<TArgs...>::applyPending() {
+	if (handlers.hasPending()) {
+		handlers.applyPending();
+	}
+	if (batch_handlers.hasPending()) {
+		batch_handlers.applyPending();
+	}
+}
+
+template<typename ...TEvents>
+inline EventBatchScope<TEvents...>::EventBatchScope(TEvents&... events) : events(events...) {
+	uncaught_exceptions = std::uncaught_exceptions();
+	std::apply([](TEvents&... events) {
+		(events.beginBatch(), ...);
+	}, this->events);
+}
+
+template<typename ...TEvents>
+inline EventBatchScope<TEvents...>::~EventBatchScope() noexcept(false) {
+	if (ended) {
+		return;
+	}
+	// calls made before the exception might refer to a half-built state
+	if (std::uncaught_exceptions() > uncaught_exceptions) {
+		cancel();
+	} else {
+		end();
+	}
+}
+
+template<typename ...TEvents>
+inline void EventBatchScope<TEvents...>::end() {
+	if (ended) {
+		return;
+	}
+	ended = true;
+	// batches are delivered in the order the events were passed,
+	// if a handler throws, batches of the events after it are dropped
+	size_t ended_count = 0;
+	try {
+		std::apply([&](TEvents&... events) {
+			((events.endBatch(), ended_count++), ...);
+		}, this->events);
+	} catch (...) {
+		size_t index = 0;
+		std::apply([&](TEvents&... events) {
+			((index++ > ended_count ? events.cancelBatch() : void()), ...);
+		}, this->events);
+		throw;
+	}
+}
+
+template<typename ...TEvents>
+inline void EventBatchScope<TEvents...>::cancel() {
+	ended = true;
+	std::apply([](TEvents&... events) {
+		(events.cancelBatch(), ...);
+	}, this->events);
 }
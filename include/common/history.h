@@ -2,7 +2,15 @@
 
 #include <string>
 #include <functional>
-#include "logger/logger.h"
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include "common/log.h"
+#include "common/string_delta.h"
+#include "common/spill_file.h"
+#include "common/compression.h"
+#include "common/data_pointer_unique.h"
 
 template<typename T>
 class HistoryEntry {
@@ -10,9 +18,64 @@ public:
 	std::string tag;
     T value;
 
+	HistoryEntry();
 	HistoryEntry(const T& value, const std::string& tag);
 };
 
+// converts values to bytes and back, needed to spill entries to disk
+template<typename T>
+struct HistoryCodec {
+	std::function<void(const T& value, std::string& out)> encode;
+	std::function<T(const std::string& str)> decode;
+};
+
+// describes how history entries of type T are stored,
+// by default every entry is stored as a full copy
+template<typename T>
+struct HistoryDelta {
+	using Delta = T;
+	static const bool enabled = false;
+	static Delta create(const T& from, const T& to) { return to; }
+	static T apply(const T& from, const Delta& delta) { return delta; }
+	static size_t getValueMemorySize(const T& value) { return sizeof(T); }
+	static size_t getDeltaMemorySize(const Delta& delta) { return sizeof(Delta); }
+	static HistoryCodec<T> getCodec() { return HistoryCodec<T>(); }
+	static void encodeDelta(const Delta& delta, const HistoryCodec<T>& codec, std::string& out) { codec.encode(delta, out); }
+	static Delta decodeDelta(const std::string& str, const HistoryCodec<T>& codec) { return codec.decode(str); }
+};
+
+// serialized levels mostly differ in a few lines between entries
+template<>
+struct HistoryDelta<std::string> {
+	using Delta = StringDelta;
+	static const bool enabled = true;
+	static Delta create(const std::string& from, const std::string& to) { return StringDelta::create(from, to); }
+	static std::string apply(const std::string& from, const Delta& delta) { return delta.apply(from); }
+	static size_t getValueMemorySize(const std::string& value) { return sizeof(std::string) + value.capacity(); }
+	static size_t getDeltaMemorySize(const Delta& delta) { return delta.getMemorySize(); }
+	static HistoryCodec<std::string> getCodec() {
+		HistoryCodec<std::string> codec;
+		codec.encode = [](const std::string& value, std::string& out) { out += value; };
+		codec.decode = [](const std::string& str) { return str; };
+		return codec;
+	}
+	static void encodeDelta(const Delta& delta, const HistoryCodec<std::string>& codec, std::string& out) { delta.serialize(out); }
+	static Delta decodeDelta(const std::string& str, const HistoryCodec<std::string>& codec) { return StringDelta::deserialize(str); }
+};
+
+// applies the change between an entry and the previous one directly,
+// so undo and redo don't have to go through the setter,
+// memory_size is the size of the data captured by the functions,
+// with encode and decode set the action is spilled together with the entry,
+// and decode shouldn't capture anything big since it stays in memory
+struct HistoryAction {
+	std::function<void(void)> undo;
+	std::function<void(void)> redo;
+	size_t memory_size = 0;
+	std::function<void(std::string& out)> encode;
+	std::function<HistoryAction(const std::string& str)> decode;
+};
+
 template<typename T>
 class History {
 public:
@@ -22,25 +85,84 @@ public:
 		std::function<T(void)> get,
 		std::function<void(const T&)> set
 	);
+	History(const History& other);
+	History(History&& other) = default;
 	size_t size() const;
     bool isAtBase() const;
     void updateCurrent();
 	void updateCurrent(const std::string& tag);
 	void save(const std::string& tag);
+	void save(const std::string& tag, const HistoryAction& action);
 	void undo();
 	void redo();
 	void clear();
 	const HistoryEntry<T>& getCurrent() const;
+	size_t getMemorySize() const;
+	size_t getKeyframeInterval() const;
+	size_t getMemoryLimit() const;
+	void setKeyframeInterval(size_t interval);
+	void setMemoryLimit(size_t limit);
+	size_t getSpillWindow() const;
+	size_t getSpilledCount() const;
+	void enableSpill(size_t window);
+	void enableSpill(size_t window, const HistoryCodec<T>& codec);
+	History& operator=(const History& other);
+	History& operator=(History&& other) = default;
 
 private:
+	using Delta = typename HistoryDelta<T>::Delta;
+	struct Record {
+		std::string tag;
+		bool keyframe = true;
+		T value;
+		Delta delta;
+		HistoryAction action;
+		size_t memory_size = 0;
+		bool in_memory = true;
+		// spill_size is 0 if the record wasn't written to the spill file yet
+		size_t spill_offset = 0;
+		size_t spill_size = 0;
+		// action is written separately, only if it can be decoded back
+		size_t action_spill_offset = 0;
+		size_t action_spill_size = 0;
+	};
 	std::string name = "<unnamed>";
 	std::function<T(void)> get;
 	std::function<void(const T&)> set;
-	std::vector<HistoryEntry<T>> history;
+	// entries are stored as deltas from the previous entry,
+	// with a full copy every keyframe_interval entries
+	std::vector<Record> history;
+	// full value of the current entry
+	HistoryEntry<T> current_entry;
 	ptrdiff_t current = 0;
+	size_t keyframe_interval = 16;
+	size_t memory_limit = 0;
+	size_t memory_size = 0;
+	// entries farther than spill_window from the current one
+	// are compressed and moved to a temporary file
+	size_t spill_window = 0;
+	HistoryCodec<T> codec;
+	dp::DataPointerUnique<SpillFile> spill_file;
+
+	const Record& loadRecord(ptrdiff_t index, Record& buffer) const;
+	T getValue(ptrdiff_t index) const;
+	bool needsKeyframe(ptrdiff_t index) const;
+	void setRecordValue(ptrdiff_t index, const T& value, const T* prev_value);
+	void setRecordAction(ptrdiff_t index, const HistoryAction& action);
+	HistoryAction loadAction(const Record& record) const;
+	void updateMemorySize(ptrdiff_t index);
+	void eraseRecords(ptrdiff_t begin, ptrdiff_t end);
+	void enforceMemoryLimit();
+	void spillRecord(ptrdiff_t index);
+	void pageInRecord(ptrdiff_t index);
+	void updateSpill();
+	void copyFrom(const History& other);
 
 };
 
+template<typename T>
+HistoryEntry<T>::HistoryEntry() { }
+
 template<typename T>
 HistoryEntry<T>::HistoryEntry(const T& value, const std::string& tag) {
     this->value = value;
@@ -62,6 +184,11 @@ History<T>::History(
     current = -1;
 }
 
+template<typename T>
+History<T>::History(const History& other) {
+    copyFrom(other);
+}
+
 template<typename T>
 size_t History<T>::size() const {
     return history.size();
@@ -79,59 +206,422 @@ void History<T>::updateCurrent() {
 
 template<typename T>
 void History<T>::updateCurrent(const std::string& tag) {
-    LoggerTag tag_history("history");
+    LOG_TAG("history");
     T state = get();
-    history[current].value = state;
-    logger << "History " << name << ": updateCurrent " << tag << ", current: " << current << ", size : " << history.size() << "\n";
+    ptrdiff_t next = current + 1;
+    if (next < (ptrdiff_t)history.size()) {
+        // next delta was made against the old value, so it has to be remade
+        if (!history[next].keyframe) {
+            Record buffer;
+            T next_value = HistoryDelta<T>::apply(current_entry.value, loadRecord(next, buffer).delta);
+            setRecordValue(next, next_value, &state);
+        }
+        setRecordAction(next, HistoryAction());
+    }
+    setRecordAction(current, HistoryAction());
+    if (history[current].keyframe) {
+        setRecordValue(current, state, nullptr);
+    } else {
+        T prev_value = getValue(current - 1);
+        setRecordValue(current, state, &prev_value);
+    }
+    current_entry.value = state;
+    updateSpill();
+    LOG("History " << name << ": updateCurrent " << tag << ", current: " << current << ", size : " << history.size() << "\n");
 }
 
 template<typename T>
 void History<T>::save(const std::string& tag) {
-    LoggerTag tag_history("history");
+    save(tag, HistoryAction());
+}
+
+template<typename T>
+void History<T>::save(const std::string& tag, const HistoryAction& action) {
+    LOG_TAG("history");
     if (current >= 0 && current < (ptrdiff_t)history.size()) {
-        history.erase(history.begin() + current + 1, history.end());
+        eraseRecords(current + 1, history.size());
     }
     T state = get();
-    HistoryEntry entry(state, tag);
-    history.push_back(entry);
-    current++;
-    logger << "History " << name << ": save " << tag << ", current: " << current << ", size : " << history.size() << "\n";
+    Record record;
+    record.tag = tag;
+    record.action = action;
+    history.push_back(record);
+    current = history.size() - 1;
+    if (needsKeyframe(current)) {
+        setRecordValue(current, state, nullptr);
+    } else {
+        setRecordValue(current, state, &current_entry.value);
+    }
+    current_entry = HistoryEntry<T>(state, tag);
+    enforceMemoryLimit();
+    updateSpill();
+    LOG("History " << name << ": save " << tag << ", current: " << current << ", size : " << history.size() << "\n");
 }
 
 template<typename T>
 void History<T>::undo() {
-    LoggerTag tag_history("history");
+    LOG_TAG("history");
     if (current > 0) {
+        HistoryAction action = history[current].action;
         current--;
-        T state = history[current].value;
-        set(state);
-        logger << "History " << name << ": undo, current: " << current << ", size: " << history.size() << "\n";
+        current_entry = HistoryEntry<T>(getValue(current), history[current].tag);
+        if (action.undo) {
+            action.undo();
+        } else {
+            set(current_entry.value);
+        }
+        updateSpill();
+        LOG("History " << name << ": undo, current: " << current << ", size: " << history.size() << "\n");
     } else {
-        logger << "History " << name << ": can't undo\n";
+        LOG("History " << name << ": can't undo\n");
     }
 }
 
 template<typename T>
 void History<T>::redo() {
-    LoggerTag tag_history("history");
+    LOG_TAG("history");
     if (current < (ptrdiff_t)history.size() - 1) {
         current++;
-        T state = history[current].value;
-        set(state);
-        logger << "History " << name << ": redo, current: " << current << ", size: " << history.size() << "\n";
+        Record buffer;
+        const Record& record = loadRecord(current, buffer);
+        if (record.keyframe) {
+            current_entry = HistoryEntry<T>(record.value, record.tag);
+        } else {
+            current_entry = HistoryEntry<T>(HistoryDelta<T>::apply(current_entry.value, record.delta), record.tag);
+        }
+        if (record.action.redo) {
+            record.action.redo();
+        } else {
+            set(current_entry.value);
+        }
+        updateSpill();
+        LOG("History " << name << ": redo, current: " << current << ", size: " << history.size() << "\n");
     } else {
-        logger << "History " << name << ": can't redo\n";
+        LOG("History " << name << ": can't redo\n");
     }
 }
 
 template<typename T>
 void History<T>::clear() {
     if (history.size() > 1) {
-        history.erase(history.begin() + 1, history.end());
+        eraseRecords(1, history.size());
     }
+    if (current >= (ptrdiff_t)history.size()) {
+        current = history.size() - 1;
+        current_entry = HistoryEntry<T>(getValue(current), history[current].tag);
+    }
+    updateSpill();
 }
 
 template<typename T>
 const HistoryEntry<T>& History<T>::getCurrent() const {
-    return history[current];
+    return current_entry;
+}
+
+template<typename T>
+inline size_t History<T>::getMemorySize() const {
+    return memory_size;
+}
+
+template<typename T>
+inline size_t History<T>::getKeyframeInterval() const {
+    return keyframe_interval;
+}
+
+template<typename T>
+inline size_t History<T>::getMemoryLimit() const {
+    return memory_limit;
+}
+
+template<typename T>
+inline void History<T>::setKeyframeInterval(size_t interval) {
+    keyframe_interval = std::max(interval, (size_t)1);
+}
+
+template<typename T>
+inline void History<T>::setMemoryLimit(size_t limit) {
+    memory_limit = limit;
+    enforceMemoryLimit();
+}
+
+template<typename T>
+inline size_t History<T>::getSpillWindow() const {
+    return spill_window;
+}
+
+template<typename T>
+size_t History<T>::getSpilledCount() const {
+    size_t count = 0;
+    for (const Record& record : history) {
+        if (!record.in_memory) {
+            count++;
+        }
+    }
+    return count;
+}
+
+template<typename T>
+void History<T>::enableSpill(size_t window) {
+    enableSpill(window, HistoryDelta<T>::getCodec());
+}
+
+template<typename T>
+void History<T>::enableSpill(size_t window, const HistoryCodec<T>& codec) {
+    if (!codec.encode || !codec.decode) {
+        throw std::runtime_error(__FUNCTION__": History " + name + ": codec is not set");
+    }
+    this->spill_window = std::max(window, (size_t)1);
+    this->codec = codec;
+    if (!spill_file) {
+        spill_file = dp::make_data_pointer<SpillFile>("History " + name + " spill file", name);
+    }
+    updateSpill();
+}
+
+template<typename T>
+History<T>& History<T>::operator=(const History& other) {
+    if (this != &other) {
+        copyFrom(other);
+    }
+    return *this;
+}
+
+template<typename T>
+const typename History<T>::Record& History<T>::loadRecord(ptrdiff_t index, Record& buffer) const {
+    const Record& record = history[index];
+    if (record.in_memory) {
+        return record;
+    }
+    try {
+        std::string data = compression::decompress(spill_file->read(record.spill_offset, record.spill_size));
+        buffer.tag = record.tag;
+        buffer.keyframe = record.keyframe;
+        if (record.keyframe) {
+            buffer.value = codec.decode(data);
+        } else {
+            buffer.delta = HistoryDelta<T>::decodeDelta(data, codec);
+        }
+        buffer.action = loadAction(record);
+        return buffer;
+    } catch (std::exception exc) {
+        throw std::runtime_error(__FUNCTION__": History " + name + ": " + std::string(exc.what()));
+    }
+}
+
+template<typename T>
+T History<T>::getValue(ptrdiff_t index) const {
+    ptrdiff_t keyframe = index;
+    while (!history[keyframe].keyframe) {
+        keyframe--;
+    }
+    Record buffer;
+    T value = loadRecord(keyframe, buffer).value;
+    for (ptrdiff_t i = keyframe + 1; i <= index; i++) {
+        value = HistoryDelta<T>::apply(value, loadRecord(i, buffer).delta);
+    }
+    return value;
+}
+
+template<typename T>
+bool History<T>::needsKeyframe(ptrdiff_t index) const {
+    if (!HistoryDelta<T>::enabled || index == 0) {
+        return true;
+    }
+    for (ptrdiff_t i = index - 1; i >= 0; i--) {
+        if (history[i].keyframe) {
+            return index - i >= (ptrdiff_t)keyframe_interval;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+void History<T>::setRecordValue(ptrdiff_t index, const T& value, const T* prev_value) {
+    Record& record = history[index];
+    if (prev_value) {
+        record.keyframe = false;
+        record.value = T();
+        record.delta = HistoryDelta<T>::create(*prev_value, value);
+    } else {
+        record.keyframe = true;
+        record.value = value;
+        record.delta = Delta();
+    }
+    // copy in the spill file is outdated now
+    record.in_memory = true;
+    record.spill_size = 0;
+    updateMemorySize(index);
+}
+
+template<typename T>
+void History<T>::setRecordAction(ptrdiff_t index, const HistoryAction& action) {
+    Record& record = history[index];
+    record.action = action;
+    // copy in the spill file is outdated now
+    record.action_spill_size = 0;
+    updateMemorySize(index);
+}
+
+template<typename T>
+HistoryAction History<T>::loadAction(const Record& record) const {
+    if (record.in_memory || record.action_spill_size == 0) {
+        return record.action;
+    }
+    std::string data = compression::decompress(spill_file->read(record.action_spill_offset, record.action_spill_size));
+    return record.action.decode(data);
+}
+
+template<typename T>
+void History<T>::updateMemorySize(ptrdiff_t index) {
+    Record& record = history[index];
+    memory_size -= record.memory_size;
+    if (!record.in_memory) {
+        record.memory_size = 0;
+    } else if (record.keyframe) {
+        record.memory_size = HistoryDelta<T>::getValueMemorySize(record.value) + record.action.memory_size;
+    } else {
+        record.memory_size = HistoryDelta<T>::getDeltaMemorySize(record.delta) + record.action.memory_size;
+    }
+    memory_size += record.memory_size;
+}
+
+template<typename T>
+void History<T>::eraseRecords(ptrdiff_t begin, ptrdiff_t end) {
+    for (ptrdiff_t i = begin; i < end; i++) {
+        memory_size -= history[i].memory_size;
+    }
+    history.erase(history.begin() + begin, history.begin() + end);
+}
+
+template<typename T>
+void History<T>::enforceMemoryLimit() {
+    if (memory_limit == 0) {
+        return;
+    }
+    // oldest entries are dropped first, current entry is always kept
+    ptrdiff_t drop_count = 0;
+    while (current > 0 && memory_size > memory_limit) {
+        if (current == 1) {
+            setRecordValue(1, current_entry.value, nullptr);
+        } else if (!history[1].keyframe) {
+            setRecordValue(1, getValue(1), nullptr);
+        }
+        setRecordAction(1, HistoryAction());
+        eraseRecords(0, 1);
+        current--;
+        drop_count++;
+    }
+    if (drop_count > 0) {
+        LOG_TAG("history");
+        LOG("History " << name << ": dropped " << drop_count << " entries, memory size: " << memory_size << "\n");
+    }
+}
+
+template<typename T>
+void History<T>::spillRecord(ptrdiff_t index) {
+    Record& record = history[index];
+    if (!record.in_memory) {
+        return;
+    }
+    // record might have been spilled before and paged back in unchanged
+    if (record.spill_size == 0) {
+        std::string data;
+        if (record.keyframe) {
+            codec.encode(record.value, data);
+        } else {
+            HistoryDelta<T>::encodeDelta(record.delta, codec, data);
+        }
+        std::string compressed = compression::compress(data);
+        record.spill_offset = spill_file->append(compressed);
+        record.spill_size = compressed.size();
+    }
+    // actions which can't be encoded stay in memory
+    if (record.action.encode && record.action.decode) {
+        if (record.action_spill_size == 0) {
+            std::string data;
+            record.action.encode(data);
+            std::string compressed = compression::compress(data);
+            record.action_spill_offset = spill_file->append(compressed);
+            record.action_spill_size = compressed.size();
+        }
+        HistoryAction decoder;
+        decoder.decode = record.action.decode;
+        record.action = decoder;
+    }
+    record.value = T();
+    record.delta = Delta();
+    record.in_memory = false;
+    updateMemorySize(index);
+}
+
+template<typename T>
+void History<T>::pageInRecord(ptrdiff_t index) {
+    Record& record = history[index];
+    if (record.in_memory) {
+        return;
+    }
+    Record buffer;
+    loadRecord(index, buffer);
+    record.value = std::move(buffer.value);
+    record.delta = std::move(buffer.delta);
+    record.action = std::move(buffer.action);
+    record.in_memory = true;
+    updateMemorySize(index);
+}
+
+template<typename T>
+void History<T>::updateSpill() {
+    if (spill_window == 0) {
+        return;
+    }
+    // only entries around the current one are kept in memory,
+    // so that undo and redo don't have to read the file
+    bool file_used = false;
+    for (ptrdiff_t i = 0; i < (ptrdiff_t)history.size(); i++) {
+        if (std::abs(i - current) <= (ptrdiff_t)spill_window) {
+            pageInRecord(i);
+        } else {
+            spillRecord(i);
+        }
+        file_used |= history[i].spill_size > 0 || history[i].action_spill_size > 0;
+    }
+    if (!file_used && spill_file->size() > 0) {
+        spill_file->clear();
+    }
+}
+
+template<typename T>
+void History<T>::copyFrom(const History& other) {
+    name = other.name;
+    get = other.get;
+    set = other.set;
+    history = other.history;
+    current_entry = other.current_entry;
+    current = other.current;
+    keyframe_interval = other.keyframe_interval;
+    memory_limit = other.memory_limit;
+    memory_size = other.memory_size;
+    spill_window = other.spill_window;
+    codec = other.codec;
+    // spill file can't be shared, so spilled records are read back
+    // and the copy writes them to its own file
+    for (ptrdiff_t i = 0; i < (ptrdiff_t)history.size(); i++) {
+        Record& record = history[i];
+        if (!record.in_memory) {
+            Record buffer;
+            other.loadRecord(i, buffer);
+            record.value = std::move(buffer.value);
+            record.delta = std::move(buffer.delta);
+            record.action = std::move(buffer.action);
+            record.in_memory = true;
+        }
+        record.spill_size = 0;
+        record.action_spill_size = 0;
+        updateMemorySize(i);
+    }
+    spill_file.reset();
+    if (spill_window > 0) {
+        spill_file = dp::make_data_pointer<SpillFile>("History " + name + " spill file", name);
+        updateSpill();
+    }
 }
@@ -0,0 +1,419 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include "compvector.h"
+
+// open addressing hash map from values to their indices,
+// uses linear probing with backward shift deletion
+template<typename T, typename THash = std::hash<T>>
+class CompVectorIndexMap {
+public:
+	CompVectorIndexMap();
+	size_t size() const;
+	ptrdiff_t get(const T& value) const;
+	bool insert(const T& value, size_t index);
+	void set(const T& value, size_t index);
+	bool erase(const T& value);
+	void clear();
+
+private:
+	struct Slot {
+		T value = T();
+		size_t index = 0;
+		bool used = false;
+	};
+	std::vector<Slot> slots;
+	size_t count = 0;
+	size_t shift = 64;
+	THash hash;
+
+	size_t getHome(const T& value) const;
+	size_t findSlot(const T& value) const;
+	void rehash(size_t new_capacity);
+
+};
+
+// same as CompVector, but contains and getIndex are O(1),
+// values have to be hashable instead of comparable
+template<typename T, typename THash = std::hash<T>>
+class IndexedCompVector {
+public:
+	using value_type = T;
+	using pointer = T*;
+	using const_pointer = const T*;
+	using reference = T&;
+	using const_reference = const T&;
+	using size_type = size_t;
+	using difference_type = ptrdiff_t;
+
+	IndexedCompVector();
+	IndexedCompVector(const std::initializer_list<T>& list);
+	IndexedCompVector(const std::vector<T>& vec);
+	size_t size() const;
+	bool empty() const;
+	bool add(const T& value);
+	bool insert(const std::vector<T>::const_iterator& where, const T& value);
+	template<std::incrementable TIter>
+	size_t insert(const std::vector<T>::const_iterator& where, const TIter& first, const TIter& last);
+	void moveIndexToIndex(size_t old_index, size_t new_index);
+	void moveValueToIndex(const T& value, size_t new_index);
+	void moveValueToValue(const T& src, const T& dst);
+	ptrdiff_t remove(const T& value);
+	ptrdiff_t removeSwap(const T& value);
+	void removeAt(size_t index);
+	void reverse();
+	std::vector<T>::const_iterator begin() const;
+	std::vector<T>::const_iterator end() const;
+	std::vector<T>::const_reverse_iterator rbegin() const;
+	std::vector<T>::const_reverse_iterator rend() const;
+	const T& front() const;
+	const T& back() const;
+	const T& at(size_t index) const;
+	ptrdiff_t getIndex(const T& value) const;
+	const std::vector<T>& getVector() const;
+	const T& operator[](size_t index) const;
+	bool contains(const T& value) const;
+	void clear();
+	operator std::vector<T>() const;
+	template<Vectorlike TCont>
+	bool operator==(const TCont& other) const;
+
+private:
+	// values are not modifiable in place, since that would break the index map
+	std::vector<T> vector;
+	CompVectorIndexMap<T, THash> indices;
+
+	void updateIndices(size_t begin, size_t end);
+
+};
+
+template<typename T, typename THash>
+inline CompVectorIndexMap<T, THash>::CompVectorIndexMap() { }
+
+template<typename T, typename THash>
+inline size_t CompVectorIndexMap<T, THash>::size() const {
+	return count;
+}
+
+template<typename T, typename THash>
+inline ptrdiff_t CompVectorIndexMap<T, THash>::get(const T& value) const {
+	if (count == 0) {
+		return -1;
+	}
+	const Slot& slot = slots[findSlot(value)];
+	return slot.used ? slot.index : -1;
+}
+
+template<typename T, typename THash>
+inline bool CompVectorIndexMap<T, THash>::insert(const T& value, size_t index) {
+	// load factor is kept at 1/2 or lower
+	if ((count + 1) * 2 > slots.size()) {
+		rehash(std::max(slots.size() * 2, (size_t)16));
+	}
+	Slot& slot = slots[findSlot(value)];
+	if (slot.used) {
+		return false;
+	}
+	slot.value = value;
+	slot.index = index;
+	slot.used = true;
+	count++;
+	return true;
+}
+
+template<typename T, typename THash>
+inline void CompVectorIndexMap<T, THash>::set(const T& value, size_t index) {
+	Slot& slot = slots[findSlot(value)];
+	assert(slot.used);
+	slot.index = index;
+}
+
+template<typename T, typename THash>
+inline bool CompVectorIndexMap<T, THash>::erase(const T& value) {
+	if (count == 0) {
+		return false;
+	}
+	size_t hole = findSlot(value);
+	if (!slots[hole].used) {
+		return false;
+	}
+	// following entries are moved back so that probe chains stay unbroken
+	size_t mask = slots.size() - 1;
+	size_t i = hole;
+	while (true) {
+		i = (i + 1) & mask;
+		if (!slots[i].used) {
+			break;
+		}
+		size_t home = getHome(slots[i].value);
+		if (((i - home) & mask) >= ((i - hole) & mask)) {
+			slots[hole] = slots[i];
+			hole = i;
+		}
+	}
+	slots[hole] = Slot();
+	count--;
+	return true;
+}
+
+template<typename T, typename THash>
+inline void CompVectorIndexMap<T, THash>::clear() {
+	slots = std::vector<Slot>();
+	count = 0;
+	shift = 64;
+}
+
+template<typename T, typename THash>
+inline size_t CompVectorIndexMap<T, THash>::getHome(const T& value) const {
+	// fibonacci hashing, pointer hashes have zeroes in the lower bits
+	uint64_t h = (uint64_t)hash(value) * 11400714819323198485ull;
+	return (size_t)(h >> shift);
+}
+
+template<typename T, typename THash>
+inline size_t CompVectorIndexMap<T, THash>::findSlot(const T& value) const {
+	size_t mask = slots.size() - 1;
+	size_t i = getHome(value);
+	while (slots[i].used && !(slots[i].value == value)) {
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+template<typename T, typename THash>
+inline void CompVectorIndexMap<T, THash>::rehash(size_t new_capacity) {
+	std::vector<Slot> old_slots = std::move(slots);
+	slots = std::vector<Slot>(new_capacity);
+	shift = 64;
+	while (new_capacity > 1) {
+		new_capacity >>= 1;
+		shift--;
+	}
+	for (Slot& slot : old_slots) {
+		if (slot.used) {
+			slots[findSlot(slot.value)] = slot;
+		}
+	}
+}
+
+template<typename T, typename THash>
+inline IndexedCompVector<T, THash>::IndexedCompVector() { }
+
+template<typename T, typename THash>
+inline IndexedCompVector<T, THash>::IndexedCompVector(const std::initializer_list<T>& list) {
+	for (const T& value : list) {
+		add(value);
+	}
+}
+
+template<typename T, typename THash>
+inline IndexedCompVector<T, THash>::IndexedCompVector(const std::vector<T>& vec) {
+	for (const T& value : vec) {
+		add(value);
+	}
+}
+
+template<typename T, typename THash>
+inline size_t IndexedCompVector<T, THash>::size() const {
+	return vector.size();
+}
+
+template<typename T, typename THash>
+inline bool IndexedCompVector<T, THash>::empty() const {
+	return size() == 0;
+}
+
+template<typename T, typename THash>
+inline bool IndexedCompVector<T, THash>::add(const T& value) {
+	if (indices.insert(value, vector.size())) {
+		vector.push_back(value);
+		return true;
+	}
+	return false;
+}
+
+template<typename T, typename THash>
+inline bool IndexedCompVector<T, THash>::insert(const std::vector<T>::const_iterator& where, const T& value) {
+	size_t offset = where - vector.begin();
+	if (indices.insert(value, offset)) {
+		vector.insert(where, value);
+		updateIndices(offset + 1, vector.size());
+		return true;
+	}
+	return false;
+}
+
+template<typename T, typename THash>
+template<std::incrementable TIter>
+inline size_t IndexedCompVector<T, THash>::insert(const std::vector<T>::const_iterator& where, const TIter& first, const TIter& last) {
+	size_t offset = where - vector.begin();
+	TIter iter_other(first);
+	size_t inserted_count = 0;
+	while (iter_other != last) {
+		if (insert(vector.begin() + offset, *iter_other)) {
+			inserted_count++;
+			offset++;
+		}
+		iter_other++;
+	}
+	return inserted_count;
+}
+
+template<typename T, typename THash>
+inline void IndexedCompVector<T, THash>::moveIndexToIndex(size_t src_index, size_t dst_index) {
+	assert(src_index >= 0 && src_index <= vector.size());
+	assert(dst_index >= 0 && dst_index <= vector.size());
+	if (dst_index == src_index || dst_index == src_index + 1) {
+		return;
+	}
+	T value = vector[src_index];
+	vector.erase(vector.begin() + src_index);
+	size_t insert_pos = dst_index;
+	if (dst_index > src_index) {
+		insert_pos--;
+	}
+	vector.insert(vector.begin() + insert_pos, value);
+	updateIndices(std::min(src_index, insert_pos), std::max(src_index, insert_pos) + 1);
+}
+
+template<typename T, typename THash>
+inline void IndexedCompVector<T, THash>::moveValueToIndex(const T& value, size_t dst_index) {
+	assert(dst_index >= 0 && dst_index <= vector.size());
+	ptrdiff_t src_index = getIndex(value);
+	assert(src_index >= 0);
+	if (src_index == dst_index) {
+		return;
+	}
+	moveIndexToIndex(src_index, dst_index);
+}
+
+template<typename T, typename THash>
+inline void IndexedCompVector<T, THash>::moveValueToValue(const T& src, const T& dst) {
+	if (src == dst) {
+		return;
+	}
+	ptrdiff_t src_index = getIndex(src);
+	ptrdiff_t dst_index = getIndex(dst);
+	assert(src_index >= 0 && dst_index >= 0);
+	moveIndexToIndex(src_index, dst_index);
+}
+
+template<typename T, typename THash>
+inline ptrdiff_t IndexedCompVector<T, THash>::remove(const T& value) {
+	ptrdiff_t index = getIndex(value);
+	if (index >= 0) {
+		removeAt(index);
+	}
+	return index;
+}
+
+template<typename T, typename THash>
+inline ptrdiff_t IndexedCompVector<T, THash>::removeSwap(const T& value) {
+	// last value takes place of the removed one, so order is not preserved
+	ptrdiff_t index = getIndex(value);
+	if (index >= 0) {
+		indices.erase(value);
+		if (index != (ptrdiff_t)vector.size() - 1) {
+			vector[index] = vector.back();
+			indices.set(vector[index], index);
+		}
+		vector.pop_back();
+	}
+	return index;
+}
+
+template<typename T, typename THash>
+inline void IndexedCompVector<T, THash>::removeAt(size_t index) {
+	indices.erase(vector[index]);
+	vector.erase(vector.begin() + index);
+	updateIndices(index, vector.size());
+}
+
+template<typename T, typename THash>
+inline void IndexedCompVector<T, THash>::reverse() {
+	std::reverse(vector.begin(), vector.end());
+	updateIndices(0, vector.size());
+}
+
+template<typename T, typename THash>
+inline std::vector<T>::const_iterator IndexedCompVector<T, THash>::begin() const {
+	return vector.begin();
+}
+
+template<typename T, typename THash>
+inline std::vector<T>::const_iterator IndexedCompVector<T, THash>::end() const {
+	return vector.end();
+}
+
+template<typename T, typename THash>
+inline std::vector<T>::const_reverse_iterator IndexedCompVector<T, THash>::rbegin() const {
+	return vector.rbegin();
+}
+
+template<typename T, typename THash>
+inline std::vector<T>::const_reverse_iterator IndexedCompVector<T, THash>::rend() const {
+	return vector.rend();
+}
+
+template<typename T, typename THash>
+inline const T& IndexedCompVector<T, THash>::front() const {
+	return vector.front();
+}
+
+template<typename T, typename THash>
+inline const T& IndexedCompVector<T, THash>::back() const {
+	return vector.back();
+}
+
+template<typename T, typename THash>
+inline const T& IndexedCompVector<T, THash>::at(size_t index) const {
+	return vector[index];
+}
+
+template<typename T, typename THash>
+inline ptrdiff_t IndexedCompVector<T, THash>::getIndex(const T& value) const {
+	return indices.get(value);
+}
+
+template<typename T, typename THash>
+inline const std::vector<T>& IndexedCompVector<T, THash>::getVector() const {
+	return vector;
+}
+
+template<typename T, typename THash>
+inline const T& IndexedCompVector<T, THash>::operator[](size_t index) const {
+	return at(index);
+}
+
+template<typename T, typename THash>
+inline bool IndexedCompVector<T, THash>::contains(const T& value) const {
+	return indices.get(value) >= 0;
+}
+
+template<typename T, typename THash>
+inline void IndexedCompVector<T, THash>::clear() {
+	vector = std::vector<T>();
+	indices.clear();
+}
+
+template<typename T, typename THash>
+inline IndexedCompVector<T, THash>::operator std::vector<T>() const {
+	return vector;
+}
+
+template<typename T, typename THash>
+template<Vectorlike TCont>
+inline bool IndexedCompVector<T, THash>::operator==(const TCont& other) const {
+	return compare(*this, other);
+}
+
+template<typename T, typename THash>
+inline void IndexedCompVector<T, THash>::updateIndices(size_t begin, size_t end) {
+	for (size_t i = begin; i < end; i++) {
+		indices.set(vector[i], i);
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+#include "logger/logger.h"
+
+// set to 0 by B2E_LOGGING=OFF, then LOG and LOG_INDENT compile to nothing
+#ifndef LOGGING
+#define LOGGING 1
+#endif
+
+namespace logging {
+
+	// tag disabled with DisableTag, messages under it are skipped
+	// before their arguments are evaluated
+	bool is_tag_disabled(const std::string& tag);
+	// whether messages are written under the innermost Tag of this thread
+	bool is_enabled();
+
+	// LoggerTag that also remembers if its messages are written
+	class Tag {
+	public:
+		Tag(const std::string& tag);
+		~Tag();
+
+	private:
+		LoggerTag logger_tag;
+		bool prev_enabled = true;
+
+	};
+
+	// LoggerDisableTag that is also visible to is_tag_disabled
+	class DisableTag {
+	public:
+		DisableTag(const std::string& tag);
+		~DisableTag();
+
+	private:
+		LoggerDisableTag logger_disable_tag;
+		std::string tag;
+
+	};
+
+	// lifts DisableTag for the tag while it exists, messages are built and
+	// passed to the logger again, used to measure the cost of logging
+	class EnableTag {
+	public:
+		EnableTag(const std::string& tag);
+		~EnableTag();
+
+	private:
+		std::string tag;
+		size_t disable_count = 0;
+
+	};
+
+	// LoggerIndent that is only created if messages are written
+	class Indent {
+	public:
+		Indent();
+
+	private:
+		std::optional<LoggerIndent> indent;
+
+	};
+
+}
+
+#define LOG_CONCAT_INNER(a, b) a##b
+#define LOG_CONCAT(a, b) LOG_CONCAT_INNER(a, b)
+
+// tags are still set when logging is compiled out,
+// since code outside of the hot paths logs with logger directly
+#define LOG_TAG(tag) logging::Tag LOG_CONCAT(log_tag_, __LINE__)(tag)
+
+#if LOGGING
+#define LOG(...) do { if (logging::is_enabled()) { logger << __VA_ARGS__; } } while (false)
+#define LOG_INDENT() logging::Indent LOG_CONCAT(log_indent_, __LINE__)
+#else
+#define LOG(...) do { } while (false)
+#define LOG_INDENT() do { } while (false)
+#endif
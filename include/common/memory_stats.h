@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+
+namespace dp {
+
+	enum class MemoryCategory {
+		WIDGETS,
+		GAME_OBJECTS,
+		SHAPES,
+		TEXTURES,
+		WORLD,
+		OTHER,
+		COUNT,
+	};
+
+	const size_t MEMORY_CATEGORY_COUNT = (size_t)MemoryCategory::COUNT;
+
+	struct MemoryCategoryStats {
+		size_t count = 0;
+		size_t bytes = 0;
+		size_t peak_bytes = 0;
+	};
+
+	struct MemorySnapshot {
+		std::array<MemoryCategoryStats, MEMORY_CATEGORY_COUNT> categories;
+		size_t count = 0;
+		size_t bytes = 0;
+		size_t peak_bytes = 0;
+
+		const MemoryCategoryStats& get(MemoryCategory category) const;
+		std::string toJson() const;
+	};
+
+	// current and peak usage per category, updated by the data block registry
+	// and by memory that is allocated elsewhere, like textures
+	class MemoryStats {
+	public:
+		void add(MemoryCategory category, size_t bytes);
+		void remove(MemoryCategory category, size_t bytes);
+		void move(MemoryCategory from, MemoryCategory to, size_t bytes);
+		MemorySnapshot getSnapshot() const;
+		void resetPeaks();
+
+	private:
+		struct Counters {
+			std::atomic<size_t> count = 0;
+			std::atomic<size_t> bytes = 0;
+			std::atomic<size_t> peak_bytes = 0;
+		};
+		std::array<Counters, MEMORY_CATEGORY_COUNT> counters;
+		std::atomic<size_t> total_bytes = 0;
+		std::atomic<size_t> peak_total_bytes = 0;
+
+		static void updatePeak(std::atomic<size_t>& peak, size_t value);
+
+	};
+
+	// memory that is not owned by a data pointer, size is set by the owner
+	class ExternalMemoryBlock {
+	public:
+		ExternalMemoryBlock(MemoryCategory category);
+		ExternalMemoryBlock(const ExternalMemoryBlock& other);
+		~ExternalMemoryBlock();
+		size_t getSize() const;
+		void setSize(size_t new_size);
+		ExternalMemoryBlock& operator=(const ExternalMemoryBlock& other);
+
+	private:
+		MemoryCategory category = MemoryCategory::OTHER;
+		size_t size = 0;
+
+	};
+
+	extern MemoryStats memory_stats;
+
+	// category is guessed from the block name, since names start with the type of the object
+	MemoryCategory get_memory_category(const std::string& name);
+	std::string memory_category_to_str(MemoryCategory category);
+	MemorySnapshot get_memory_snapshot();
+
+}
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include "searchindex.h"
+
+// same as SearchIndexMultiple, but also finds names by prefix and substring,
+// these queries and match() are case-insensitive and go through trigrams of lowercase names
+template<typename TData>
+class NameIndex : SearchIndex<std::string, TData> {
+public:
+	NameIndex();
+	bool add(const std::string& key, const TData& data);
+	size_t size() const;
+	TData find(const std::string& key) const;
+	std::string min() const;
+	std::string max() const;
+	bool contains(const std::string& key) const;
+	void remove(const std::string& key, const TData& data);
+	void clear();
+	std::vector<TData> findPrefix(const std::string& prefix) const;
+	std::vector<TData> findSuffix(const std::string& suffix) const;
+	std::vector<TData> findSubstring(const std::string& str) const;
+	std::vector<TData> match(const std::string& pattern) const;
+
+private:
+	struct Name {
+		std::string str;
+		std::string lower;
+		std::set<TData> values;
+	};
+	// ids of removed names are not reused until the index is rebuilt,
+	// so trigram lists stay sorted when new ids are appended to them
+	std::vector<Name> names;
+	std::map<std::string, uint32_t> name_ids;
+	std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams;
+	size_t value_count = 0;
+	size_t removed_count = 0;
+
+	static std::string toLower(const std::string& str);
+	static uint32_t getTrigram(const std::string& str, size_t pos);
+	void addTrigrams(uint32_t id);
+	std::vector<uint32_t> getCandidates(const std::string& lower) const;
+	std::vector<TData> findMatching(const std::string& str, const std::function<bool(const std::string&, const std::string&)>& filter) const;
+	void rebuild();
+
+};
+
+template<typename TData>
+inline NameIndex<TData>::NameIndex() { }
+
+template<typename TData>
+inline bool NameIndex<TData>::add(const std::string& key, const TData& data) {
+	auto it = name_ids.find(key);
+	if (it == name_ids.end()) {
+		uint32_t id = (uint32_t)names.size();
+		Name name;
+		name.str = key;
+		name.lower = toLower(key);
+		names.push_back(name);
+		it = name_ids.insert({ key, id }).first;
+		addTrigrams(id);
+	}
+	auto inserted = names[it->second].values.insert(data);
+	if (inserted.second) {
+		value_count++;
+	}
+	return inserted.second;
+}
+
+template<typename TData>
+inline size_t NameIndex<TData>::size() const {
+	return value_count;
+}
+
+template<typename TData>
+inline TData NameIndex<TData>::find(const std::string& key) const {
+	auto it = name_ids.find(key);
+	if (it != name_ids.end()) {
+		return *names[it->second].values.begin();
+	}
+	return TData();
+}
+
+template<typename TData>
+inline std::string NameIndex<TData>::min() const {
+	return name_ids.begin()->first;
+}
+
+template<typename TData>
+inline std::string NameIndex<TData>::max() const {
+	return name_ids.rbegin()->first;
+}
+
+template<typename TData>
+inline bool NameIndex<TData>::contains(const std::string& key) const {
+	return name_ids.contains(key);
+}
+
+template<typename TData>
+inline void NameIndex<TData>::remove(const std::string& key, const TData& data) {
+	auto it = name_ids.find(key);
+	if (it == name_ids.end()) {
+		return;
+	}
+	Name& name = names[it->second];
+	if (name.values.erase(data) == 0) {
+		return;
+	}
+	value_count--;
+	if (name.values.empty()) {
+		name.str = std::string();
+		name.lower = std::string();
+		name_ids.erase(it);
+		removed_count++;
+		// trigram lists still point to removed names, so they are cleaned up
+		// when there are too many of them
+		if (removed_count > 1024 && removed_count > names.size() / 2) {
+			rebuild();
+		}
+	}
+}
+
+template<typename TData>
+inline void NameIndex<TData>::clear() {
+	names = std::vector<Name>();
+	name_ids = std::map<std::string, uint32_t>();
+	trigrams = std::unordered_map<uint32_t, std::vector<uint32_t>>();
+	value_count = 0;
+	removed_count = 0;
+}
+
+template<typename TData>
+inline std::vector<TData> NameIndex<TData>::findPrefix(const std::string& prefix) const {
+	return findMatching(prefix, [](const std::string& name, const std::string& str) {
+		return name.starts_with(str);
+	});
+}
+
+template<typename TData>
+inline std::vector<TData> NameIndex<TData>::findSuffix(const std::string& suffix) const {
+	return findMatching(suffix, [](const std::string& name, const std::string& str) {
+		return name.ends_with(str);
+	});
+}
+
+template<typename TData>
+inline std::vector<TData> NameIndex<TData>::findSubstring(const std::string& str) const {
+	return findMatching(str, [](const std::string& name, const std::string& str) {
+		return name.find(str) != std::string::npos;
+	});
+}
+
+template<typename TData>
+inline std::vector<TData> NameIndex<TData>::match(const std::string& pattern) const {
+	// "name*" - prefix, "*name" - suffix, "*name*" - substring, "name" - exact match
+	bool star_begin = pattern.starts_with("*");
+	bool star_end = pattern.size() > 1 && pattern.ends_with("*");
+	std::string str = pattern.substr(star_begin ? 1 : 0);
+	str = str.substr(0, str.size() - (star_end ? 1 : 0));
+	if (star_begin && star_end) {
+		return findSubstring(str);
+	} else if (star_begin) {
+		return findSuffix(str);
+	} else if (star_end) {
+		return findPrefix(str);
+	}
+	// case-insensitive like the other patterns, so it can match several names
+	return findMatching(str, [](const std::string& name, const std::string& str) {
+		return name == str;
+	});
+}
+
+template<typename TData>
+inline std::string NameIndex<TData>::toLower(const std::string& str) {
+	std::string result = str;
+	for (char& c : result) {
+		if (c >= 'A' && c <= 'Z') {
+			c = c - 'A' + 'a';
+		}
+	}
+	return result;
+}
+
+template<typename TData>
+inline uint32_t NameIndex<TData>::getTrigram(const std::string& str, size_t pos) {
+	return
+		((uint32_t)(unsigned char)str[pos] << 16)
+		| ((uint32_t)(unsigned char)str[pos + 1] << 8)
+		| (uint32_t)(unsigned char)str[pos + 2];
+}
+
+template<typename TData>
+inline void NameIndex<TData>::addTrigrams(uint32_t id) {
+	const std::string& lower = names[id].lower;
+	if (lower.size() < 3) {
+		return;
+	}
+	std::vector<uint32_t> name_trigrams;
+	for (size_t i = 0; i + 3 <= lower.size(); i++) {
+		name_trigrams.push_back(getTrigram(lower, i));
+	}
+	std::sort(name_trigrams.begin(), name_trigrams.end());
+	name_trigrams.erase(std::unique(name_trigrams.begin(), name_trigrams.end()), name_trigrams.end());
+	for (uint32_t trigram : name_trigrams) {
+		trigrams[trigram].push_back(id);
+	}
+}
+
+template<typename TData>
+inline std::vector<uint32_t> NameIndex<TData>::getCandidates(const std::string& lower) const {
+	std::vector<uint32_t> result;
+	// short strings have no trigrams, so all names are checked
+	if (lower.size() < 3) {
+		for (uint32_t i = 0; i < names.size(); i++) {
+			result.push_back(i);
+		}
+		return result;
+	}
+	std::vector<const std::vector<uint32_t>*> lists;
+	for (size_t i = 0; i + 3 <= lower.size(); i++) {
+		auto it = trigrams.find(getTrigram(lower, i));
+		if (it == trigrams.end()) {
+			return result;
+		}
+		lists.push_back(&it->second);
+	}
+	std::sort(lists.begin(), lists.end(), [](const std::vector<uint32_t>* left, const std::vector<uint32_t>* right) {
+		return left->size() < right->size();
+	});
+	result = *lists[0];
+	for (size_t i = 1; i < lists.size() && result.size() > 0; i++) {
+		std::vector<uint32_t> intersection;
+		std::set_intersection(
+			result.begin(), result.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(intersection)
+		);
+		result = std::move(intersection);
+	}
+	return result;
+}
+
+template<typename TData>
+inline std::vector<TData> NameIndex<TData>::findMatching(
+	const std::string& str, const std::function<bool(const std::string&, const std::string&)>& filter
+) const {
+	std::string lower = toLower(str);
+	std::vector<TData> result;
+	// candidates contain all trigrams of the string, but still have to be checked
+	for (uint32_t id : getCandidates(lower)) {
+		const Name& name = names[id];
+		if (!name.values.empty() && filter(name.lower, lower)) {
+			result.insert(result.end(), name.values.begin(), name.values.end());
+		}
+	}
+	return result;
+}
+
+template<typename TData>
+inline void NameIndex<TData>::rebuild() {
+	std::vector<Name> old_names = std::move(names);
+	names = std::vector<Name>();
+	name_ids = std::map<std::string, uint32_t>();
+	trigrams = std::unordered_map<uint32_t, std::vector<uint32_t>>();
+	removed_count = 0;
+	for (Name& name : old_names) {
+		if (name.values.empty()) {
+			continue;
+		}
+		uint32_t id = (uint32_t)names.size();
+		name_ids.insert({ name.str, id });
+		names.push_back(std::move(name));
+		addTrigrams(id);
+	}
+}
@@ -2,6 +2,11 @@
 
 #include <set>
 #include <map>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <concepts>
 
 template<typename TKey, typename TData>
 class SearchIndex {
@@ -50,6 +55,54 @@ private:
 
 };
 
+// keys are used as indices in an array, so they should be small integers,
+// keys far above the number of stored ones are kept in a map instead,
+// so that a single huge key doesn't allocate a huge array,
+// every slot has a generation, which allows to detect handles to removed keys
+template<std::integral TKey, typename TData>
+class SearchIndexDense : SearchIndex<TKey, TData> {
+public:
+	// array grows up to this many slots per stored key, plus the constant
+	static const size_t MAX_SLOTS_PER_KEY = 4;
+	static const size_t MAX_SLOTS_EXTRA = 4096;
+	struct Handle {
+		TKey key = TKey();
+		uint32_t generation = 0;
+	};
+
+	SearchIndexDense();
+	bool add(const TKey& key, const TData& data);
+	size_t size() const;
+	TData find(const TKey& key) const;
+	TData find(const Handle& handle) const;
+	TKey min() const;
+	TKey max() const;
+	bool contains(const TKey& key) const;
+	bool isValid(const Handle& handle) const;
+	Handle getHandle(const TKey& key) const;
+	void remove(const TKey& key);
+	void clear();
+
+private:
+	struct Slot {
+		TData data = TData();
+		uint32_t generation = 0;
+		bool used = false;
+	};
+	std::vector<Slot> slots;
+	// keys not less than slots.size(), removed keys stay to keep their generation
+	std::map<size_t, Slot> sparse_slots;
+	size_t count = 0;
+	size_t min_index = 0;
+	size_t max_index = 0;
+
+	const Slot* getSlot(const TKey& key) const;
+	Slot& getOrCreateSlot(size_t index);
+	size_t findUsedAfter(size_t index) const;
+	size_t findUsedBefore(size_t index) const;
+
+};
+
 template<typename TKey, typename TData>
 inline SearchIndexUnique<TKey, TData>::SearchIndexUnique() { }
 
@@ -164,3 +217,197 @@ inline void SearchIndexMultiple<TKey, TData>::clear() {
 	map = std::map<TKey, std::set<TData>>();
 }
 
+template<std::integral TKey, typename TData>
+inline SearchIndexDense<TKey, TData>::SearchIndexDense() { }
+
+template<std::integral TKey, typename TData>
+inline bool SearchIndexDense<TKey, TData>::add(const TKey& key, const TData& data) {
+	if (std::cmp_less(key, 0)) {
+		return false;
+	}
+	size_t index = (size_t)key;
+	Slot& slot = getOrCreateSlot(index);
+	if (slot.used) {
+		return false;
+	}
+	slot.data = data;
+	slot.used = true;
+	if (count == 0) {
+		min_index = index;
+		max_index = index;
+	} else {
+		min_index = std::min(min_index, index);
+		max_index = std::max(max_index, index);
+	}
+	count++;
+	return true;
+}
+
+template<std::integral TKey, typename TData>
+inline size_t SearchIndexDense<TKey, TData>::size() const {
+	return count;
+}
+
+template<std::integral TKey, typename TData>
+inline TData SearchIndexDense<TKey, TData>::find(const TKey& key) const {
+	const Slot* slot = getSlot(key);
+	if (slot) {
+		return slot->data;
+	}
+	return TData();
+}
+
+template<std::integral TKey, typename TData>
+inline TData SearchIndexDense<TKey, TData>::find(const Handle& handle) const {
+	if (isValid(handle)) {
+		return getSlot(handle.key)->data;
+	}
+	return TData();
+}
+
+template<std::integral TKey, typename TData>
+inline TKey SearchIndexDense<TKey, TData>::min() const {
+	return (TKey)min_index;
+}
+
+template<std::integral TKey, typename TData>
+inline TKey SearchIndexDense<TKey, TData>::max() const {
+	return (TKey)max_index;
+}
+
+template<std::integral TKey, typename TData>
+inline bool SearchIndexDense<TKey, TData>::contains(const TKey& key) const {
+	return getSlot(key) != nullptr;
+}
+
+template<std::integral TKey, typename TData>
+inline bool SearchIndexDense<TKey, TData>::isValid(const Handle& handle) const {
+	const Slot* slot = getSlot(handle.key);
+	return slot && slot->generation == handle.generation;
+}
+
+template<std::integral TKey, typename TData>
+inline typename SearchIndexDense<TKey, TData>::Handle SearchIndexDense<TKey, TData>::getHandle(const TKey& key) const {
+	Handle handle;
+	handle.key = key;
+	const Slot* slot = getSlot(key);
+	if (slot) {
+		handle.generation = slot->generation;
+	}
+	return handle;
+}
+
+template<std::integral TKey, typename TData>
+inline void SearchIndexDense<TKey, TData>::remove(const TKey& key) {
+	if (!getSlot(key)) {
+		return;
+	}
+	size_t index = (size_t)key;
+	Slot& slot = index < slots.size() ? slots[index] : sparse_slots[index];
+	slot.data = TData();
+	slot.used = false;
+	slot.generation++;
+	count--;
+	if (count == 0) {
+		min_index = 0;
+		max_index = 0;
+		return;
+	}
+	// bounds move to the nearest used slot, which is usually close
+	if (index == min_index) {
+		min_index = findUsedAfter(index);
+	}
+	if (index == max_index) {
+		max_index = findUsedBefore(index);
+	}
+}
+
+template<std::integral TKey, typename TData>
+inline void SearchIndexDense<TKey, TData>::clear() {
+	// slots are kept so that generations keep growing and old handles stay invalid
+	auto clear_slot = [](Slot& slot) {
+		if (slot.used) {
+			slot.data = TData();
+			slot.used = false;
+			slot.generation++;
+		}
+	};
+	for (Slot& slot : slots) {
+		clear_slot(slot);
+	}
+	for (auto& [index, slot] : sparse_slots) {
+		clear_slot(slot);
+	}
+	count = 0;
+	min_index = 0;
+	max_index = 0;
+}
+
+template<std::integral TKey, typename TData>
+inline const typename SearchIndexDense<TKey, TData>::Slot* SearchIndexDense<TKey, TData>::getSlot(const TKey& key) const {
+	if (std::cmp_less(key, 0)) {
+		return nullptr;
+	}
+	size_t index = (size_t)key;
+	const Slot* slot = nullptr;
+	if (index < slots.size()) {
+		slot = &slots[index];
+	} else {
+		auto it = sparse_slots.find(index);
+		if (it == sparse_slots.end()) {
+			return nullptr;
+		}
+		slot = &it->second;
+	}
+	return slot->used ? slot : nullptr;
+}
+
+template<std::integral TKey, typename TData>
+inline typename SearchIndexDense<TKey, TData>::Slot& SearchIndexDense<TKey, TData>::getOrCreateSlot(size_t index) {
+	if (index < slots.size()) {
+		return slots[index];
+	}
+	size_t max_slots = (count + 1) * MAX_SLOTS_PER_KEY + MAX_SLOTS_EXTRA;
+	if (index >= max_slots) {
+		return sparse_slots[index];
+	}
+	// sparse slots that are now in the array range are moved into it
+	slots.resize(index + 1);
+	auto end_it = sparse_slots.lower_bound(slots.size());
+	for (auto it = sparse_slots.begin(); it != end_it; it++) {
+		slots[it->first] = it->second;
+	}
+	sparse_slots.erase(sparse_slots.begin(), end_it);
+	return slots[index];
+}
+
+template<std::integral TKey, typename TData>
+inline size_t SearchIndexDense<TKey, TData>::findUsedAfter(size_t index) const {
+	for (size_t i = index + 1; i < slots.size(); i++) {
+		if (slots[i].used) {
+			return i;
+		}
+	}
+	for (auto it = sparse_slots.upper_bound(index); it != sparse_slots.end(); it++) {
+		if (it->second.used) {
+			return it->first;
+		}
+	}
+	return index;
+}
+
+template<std::integral TKey, typename TData>
+inline size_t SearchIndexDense<TKey, TData>::findUsedBefore(size_t index) const {
+	for (auto it = sparse_slots.lower_bound(index); it != sparse_slots.begin();) {
+		it--;
+		if (it->second.used) {
+			return it->first;
+		}
+	}
+	for (size_t i = std::min(index, slots.size()); i > 0; i--) {
+		if (slots[i - 1].used) {
+			return i - 1;
+		}
+	}
+	return index;
+}
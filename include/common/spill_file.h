@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <filesystem>
+
+// append-only temporary file, removed when closed
+class SpillFile {
+public:
+	SpillFile(const std::string& name);
+	~SpillFile();
+	const std::filesystem::path& getPath() const;
+	size_t size() const;
+	size_t append(const std::string& data);
+	std::string read(size_t offset, size_t size);
+	void clear();
+
+private:
+	std::filesystem::path path;
+	std::fstream file;
+	size_t file_size = 0;
+
+	void open();
+
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// line-based delta between two strings,
+// unchanged runs are stored as ranges of the base string
+class StringDelta {
+public:
+	StringDelta();
+	static StringDelta create(const std::string& from, const std::string& to);
+	std::string apply(const std::string& from) const;
+	size_t getBaseSize() const;
+	size_t getResultSize() const;
+	size_t getOpCount() const;
+	size_t getMemorySize() const;
+	void serialize(std::string& out) const;
+	static StringDelta deserialize(const std::string& str);
+	bool operator==(const StringDelta& other) const;
+
+private:
+	struct Op {
+		bool copy = false;
+		size_t offset = 0;
+		size_t length = 0;
+
+		bool operator==(const Op& other) const;
+	};
+	size_t base_size = 0;
+	size_t result_size = 0;
+	std::vector<Op> ops;
+	std::string literals;
+
+	void addCopy(size_t offset, size_t length);
+	void addInsert(const char* str, size_t length);
+
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "widgets/rectangle_widget.h"
+#include "common/memory_stats.h"
+
+const float MEMORY_OVERLAY_PADDING = 5.0f;
+const int MEMORY_OVERLAY_TEXT_SIZE = 12;
+// text is rebuilt only this often, since stats change on every allocation
+const int MEMORY_OVERLAY_UPDATE_FRAMES = 15;
+
+class Editor;
+namespace fw {
+	class TextWidget;
+}
+
+// table of current and peak memory usage per category,
+// "load" column shows the change since the level was loaded, to catch leaks across reloads
+class MemoryOverlay : public fw::RectangleWidget {
+public:
+	MemoryOverlay(fw::WidgetList& widget_list, Editor& p_app);
+	const dp::MemorySnapshot& getBaseline() const;
+	void requestBaseline();
+	void updateStats(bool force = false);
+	std::string getTableStr(const dp::MemorySnapshot& snapshot) const;
+
+private:
+	Editor& app;
+	fw::TextWidget* text_widget = nullptr;
+	dp::MemorySnapshot baseline;
+	bool baseline_requested = true;
+	int frames_until_update = 0;
+
+};
@@ -2,8 +2,10 @@
 
 #include "widgets/scroll_area_widget.h"
 #include "widgets/tree_view_widget.h"
+#include "widgets/textbox_widget.h"
 #include "simulation/objectlist.h"
 #include <map>
+#include <span>
 
 class Editor;
 
@@ -12,22 +14,31 @@ public:
 	
 	const sf::Color OUTLINER_BACKGROUND_COLOR = sf::Color(128, 128, 128);
 	const sf::Color OUTLINER_SCROLLBAR_COLOR = sf::Color(110, 110, 110);
+	const float OUTLINER_SEARCH_HEIGHT = 20.0f;
 
 	Outliner(fw::WidgetList& widget_list, float width, float height, Editor& p_app);
 	Outliner(fw::WidgetList& widget_list, const sf::Vector2f& size, Editor& p_app);
+	const std::string& getFilter() const;
+	fw::TextBoxWidget* getSearchWidget() const;
+	fw::TreeViewEntry* getEntry(GameObject* object) const;
+	void setFilter(const std::string& filter);
 
 private:
 	Editor& app;
 	GameObjectList& object_list;
 	fw::TreeViewWidget* treeview_widget = nullptr;
+	fw::TextBoxWidget* search_widget = nullptr;
+	std::string filter;
+	bool filter_dirty = false;
 	std::map<GameObject*, fw::TreeViewEntry*> object_entry;
 	std::map<fw::TreeViewEntry*, GameObject*> entry_object;
 
 	void addObject(GameObject* object);
 	void moveObject(GameObject* object, size_t index);
-	void removeObject(GameObject* object);
+	void removeObjects(std::span<GameObject* const> objects);
 	void setParentToObject(GameObject* object, GameObject* parent);
 	void selectEntry(GameObject* object);
 	void deselectEntry(GameObject* object);
 	void clear();
+	void applyFilter();
 };
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+
+struct FileWriteResult {
+	std::string tag;
+	std::filesystem::path path;
+	bool success = true;
+	std::string error;
+};
+
+// writes files on a worker thread, new file replaces the old one
+// only after it was fully written, so a crash can't leave a half-written level
+class BackgroundFileWriter {
+public:
+	BackgroundFileWriter();
+	~BackgroundFileWriter();
+	void write(const std::string& tag, std::string str, const std::filesystem::path& path);
+	bool isBusy() const;
+	std::vector<FileWriteResult> takeResults();
+	void wait();
+	static void writeAtomic(const std::string& str, const std::filesystem::path& path);
+
+private:
+	struct Job {
+		std::string tag;
+		std::string str;
+		std::filesystem::path path;
+	};
+	std::thread thread;
+	mutable std::mutex mutex;
+	std::condition_variable job_added;
+	std::condition_variable job_done;
+	std::deque<Job> jobs;
+	std::vector<FileWriteResult> results;
+	bool busy = false;
+	bool stopping = false;
+
+	void run();
+
+};
+
+// takes a snapshot at a frame boundary once per interval
+// and passes it to the file writer if it changed since the last autosave
+class Autosave {
+public:
+	Autosave();
+	Autosave(BackgroundFileWriter* writer, std::function<std::string(void)> get);
+	const std::filesystem::path& getPath() const;
+	void setPath(const std::filesystem::path& path);
+	float getInterval() const;
+	void setInterval(float seconds);
+	bool isEnabled() const;
+	void setEnabled(bool enabled);
+	bool update();
+	void reset();
+
+private:
+	BackgroundFileWriter* writer = nullptr;
+	std::function<std::string(void)> get;
+	std::filesystem::path path = "levels/autosave.txt";
+	float interval = 60.0f;
+	bool enabled = true;
+	std::chrono::steady_clock::time_point last_time = std::chrono::steady_clock::now();
+	std::string last_snapshot;
+
+};
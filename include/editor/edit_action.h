@@ -0,0 +1,120 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include "simulation/simulation.h"
+#include "common/data_pointer_unique.h"
+
+class Editor;
+
+// change made to the scene by one of the tools,
+// objects are referenced by id since undo might recreate them,
+// changes are serialized when history moves them to disk
+class EditChange {
+public:
+	virtual ~EditChange();
+	virtual void undo(Editor& editor) = 0;
+	virtual void redo(Editor& editor) = 0;
+	virtual size_t getMemorySize() const = 0;
+	virtual void serialize(std::string& out) const = 0;
+	static dp::DataPointerUnique<EditChange> deserialize(const std::string& str, size_t& pos);
+
+protected:
+	enum Type {
+		TRANSFORM,
+		VERTICES,
+		EXISTENCE,
+	};
+
+	static GameObject* getObject(Editor& editor, ptrdiff_t id);
+	static void removeObject(Editor& editor, GameObject* object);
+	static GameObjectList& getObjectList(Editor& editor);
+
+};
+
+class TransformChange : public EditChange {
+public:
+	TransformChange();
+	TransformChange(GameObject* object, const b2Vec2& before_pos, float before_angle);
+	void undo(Editor& editor) override;
+	void redo(Editor& editor) override;
+	size_t getMemorySize() const override;
+	void serialize(std::string& out) const override;
+	static dp::DataPointerUnique<TransformChange> deserialize(const std::string& str, size_t& pos);
+
+private:
+	ptrdiff_t id = -1;
+	b2Vec2 before_pos = b2Vec2_zero;
+	float before_angle = 0.0f;
+	b2Vec2 after_pos = b2Vec2_zero;
+	float after_angle = 0.0f;
+
+	void apply(Editor& editor, const b2Vec2& pos, float angle);
+
+};
+
+class VerticesChange : public EditChange {
+public:
+	VerticesChange();
+	VerticesChange(GameObject* object, const std::vector<b2Vec2>& before);
+	void undo(Editor& editor) override;
+	void redo(Editor& editor) override;
+	size_t getMemorySize() const override;
+	void serialize(std::string& out) const override;
+	static dp::DataPointerUnique<VerticesChange> deserialize(const std::string& str, size_t& pos);
+	static std::vector<b2Vec2> getPositions(const GameObject* object);
+
+private:
+	ptrdiff_t id = -1;
+	std::vector<b2Vec2> before;
+	std::vector<b2Vec2> after;
+
+};
+
+// object is added or removed together with its joints
+class ExistenceChange : public EditChange {
+public:
+	ExistenceChange();
+	ExistenceChange(GameObject* object, bool added);
+	void undo(Editor& editor) override;
+	void redo(Editor& editor) override;
+	size_t getMemorySize() const override;
+	void serialize(std::string& out) const override;
+	static dp::DataPointerUnique<ExistenceChange> deserialize(const std::string& str, size_t& pos);
+
+private:
+	struct JointRecord {
+		ptrdiff_t object1_id = -1;
+		ptrdiff_t object2_id = -1;
+		std::string str;
+	};
+	bool added = false;
+	ptrdiff_t id = -1;
+	std::string str;
+	size_t index = 0;
+	std::vector<ptrdiff_t> children;
+	std::vector<JointRecord> joints;
+
+	void restore(Editor& editor);
+	void remove(Editor& editor);
+
+};
+
+// all changes made by a single tool operation
+class EditAction {
+public:
+	EditAction();
+	size_t size() const;
+	bool empty() const;
+	void add(dp::DataPointerUnique<EditChange> change);
+	void undo(Editor& editor);
+	void redo(Editor& editor);
+	void clear();
+	size_t getMemorySize() const;
+	void serialize(std::string& out) const;
+	static EditAction deserialize(const std::string& str);
+
+private:
+	std::vector<dp::DataPointerUnique<EditChange>> changes;
+
+};
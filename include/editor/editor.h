@@ -3,7 +3,12 @@
 #include <functional>
 #include <set>
 #include "tools.h"
+#include "autosave.h"
+#include "edit_action.h"
+#include "simulation/background_decomposer.h"
+#include "simulation/instanced_shapes.h"
 #include "simulation/simulation.h"
+#include "common/data_pointer_shared.h"
 #include "common/history.h"
 #include "logger/logger.h"
 #include "widgets/application.h"
@@ -22,6 +27,7 @@ const sf::Glsl::Vec3 HOVER_OUTLINE_COLOR = sf::Glsl::Vec3(1.0f, 1.0f, 0.0f);
 const int SELECTION_OUTLINE_THICKNESS = 3;
 const int HOVER_OUTLINE_THICKNESS = 1;
 const int MOUSE_DRAG_THRESHOLD = 10;
+const size_t HISTORY_RAM_WINDOW = 32;
 
 Logger& operator<<(Logger& lg, const b2Vec2& value);
 
@@ -81,6 +87,7 @@ namespace fw {
 class Outliner;
 class Toolbox;
 class Menu;
+class MemoryOverlay;
 
 class Editor : public fw::Application {
 public:
@@ -144,8 +151,10 @@ private:
 	friend class CreatePanel;
 	friend class Outliner;
 	friend class Menu;
+	friend class MemoryOverlay;
 	friend class EditorTests;
 	friend class Camera;
+	friend class EditChange;
 	fw::CanvasWidget* world_widget = nullptr;
 	fw::CanvasWidget* ui_widget = nullptr;
 	fw::CanvasWidget* selection_mask_widget = nullptr;
@@ -182,11 +191,13 @@ private:
 	fw::TextWidget* logger_text_widget = nullptr;
 	fw::TextWidget* step_widget = nullptr;
 	sf::CircleShape origin_shape;
+	InstancedShapes instanced_shapes; // balls and boxes of the current frame
 	sf::Text object_info_text;
 	sf::Text id_text;
 	Outliner* outliner_widget = nullptr;
 	Menu* menu_widget = nullptr;
 	fw::TextWidget* debug_release_widget = nullptr;
+	MemoryOverlay* memory_overlay_widget = nullptr;
 
 	const float MOUSE_FORCE_SCALE = 50.0f;
 	float timeStep = 1.0f / FPS;
@@ -198,7 +209,11 @@ private:
 
 	sf::Vector2f mouse_world_pos;
 	History<std::string> history;
+	BackgroundFileWriter file_writer;
+	Autosave autosave;
+	BackgroundDecomposer decomposer;
 	bool commit_action = false;
+	EditAction pending_action;
 	struct LoadRequest {
 		bool requested = false;
 		std::filesystem::path path;
@@ -226,6 +241,9 @@ private:
 	void processDragGestureLeft(const sf::Vector2f& pos);
 	void processDragGestureRight(const sf::Vector2f& pos);
 	void onAfterProcessInput() override;
+	void commitAction(const std::string& tag);
+	HistoryAction createHistoryAction(const std::string& tag, const dp::DataPointerShared<EditAction>& action);
+	void applyEditAction(EditAction& action, bool undo);
 	void onProcessWorld() override;
 	void onRender() override;
 	void initTools();
@@ -237,10 +255,14 @@ private:
 	void deserialize(const std::string& str, bool set_camera);
 	void save();
 	void saveToFile(const std::filesystem::path& path);
+	void processFileWriteResults();
+	void processDecompositionResults();
+	void finishDecomposition(GameObject* object);
 	void requestLoad(const std::filesystem::path& path);
 	void loadFromFile(const std::filesystem::path& path);
 	void quicksave();
 	void quickload();
+	void exportMemoryStats(const std::filesystem::path& path);
 	void showOpenFileMenu();
 	void showSaveFileMenu();
 	Tool* trySelectToolByIndex(size_t index);
@@ -276,6 +298,7 @@ private:
 	void endMove(bool confirm);
 	void endRotate(bool confirm);
 	void deleteObject(GameObject* object, bool remove_children);
+	void recordAdded(const CompVector<GameObject*>& objects);
 	void viewSelectedObjects();
 	void checkDebugbreak();
 	void canvasDraw(fw::CanvasWidget* canvas, const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default);
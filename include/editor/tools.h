@@ -2,6 +2,7 @@
 
 #include "simulation/gameobject.h"
 #include "common/event.h"
+#include "common/indexed_compvector.h"
 #include <set>
 
 const float TOOL_RECT_WIDTH = 60.0f;
@@ -62,7 +63,7 @@ public:
 
 	SelectTool();
 	size_t selectedCount() const;
-	const CompVector<GameObject*>& getSelectedObjects() const;
+	const IndexedCompVector<GameObject*>& getSelectedObjects() const;
 	void setSelected(const CompVector<GameObject*>& vec);
 	void selectObject(GameObject* object, bool with_children = false);
 	void deselectObject(GameObject* object, bool with_children = false);
@@ -75,7 +76,7 @@ public:
 	void reset() override;
 
 private:
-	CompVector<GameObject*> selected_objects;
+	IndexedCompVector<GameObject*> selected_objects;
 
 };
 
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "convex_decomposition.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+struct DecompositionResult {
+	size_t object_id = 0;
+	// points the pieces were made for, result is stale if the polygon doesn't have them anymore
+	std::vector<sf::Vector2f> points;
+	std::vector<decomposition::ConvexPiece> pieces;
+};
+
+// decomposes polygons into convex pieces on a worker thread,
+// new job for an object cancels its pending and running jobs,
+// so only the result for its latest points is returned
+class BackgroundDecomposer {
+public:
+	BackgroundDecomposer();
+	~BackgroundDecomposer();
+	void decompose(size_t object_id, std::vector<sf::Vector2f> points, size_t max_vertices);
+	void cancel(size_t object_id);
+	bool isBusy() const;
+	std::vector<DecompositionResult> takeResults();
+	void wait();
+
+private:
+	struct Job {
+		size_t object_id = 0;
+		std::vector<sf::Vector2f> points;
+		size_t max_vertices = 0;
+	};
+	std::thread thread;
+	mutable std::mutex mutex;
+	std::condition_variable job_added;
+	std::condition_variable job_done;
+	std::deque<Job> jobs;
+	std::vector<DecompositionResult> results;
+	bool busy = false;
+	size_t running_id = 0;
+	bool running_cancelled = false;
+	bool stopping = false;
+
+	void cancelLocked(size_t object_id);
+	void run();
+
+};
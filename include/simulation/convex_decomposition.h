@@ -0,0 +1,38 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <vector>
+
+// alternative to SplittablePolygon's recursive best cut splitting,
+// polygon is triangulated by ear clipping and then triangles are merged
+// back into convex pieces by removing diagonals (Hertel-Mehlhorn),
+// result is at most four times the optimal number of pieces
+
+namespace decomposition {
+
+	using Triangle = std::array<size_t, 3>;
+	// indices of polygon points, in the same winding as the polygon
+	using ConvexPiece = std::vector<size_t>;
+
+	float signed_area(const std::vector<sf::Vector2f>& points);
+	std::vector<Triangle> triangulate(const std::vector<sf::Vector2f>& points);
+	std::vector<ConvexPiece> merge_triangles(
+		const std::vector<sf::Vector2f>& points, const std::vector<Triangle>& triangles, size_t max_vertices
+	);
+	// max_vertices is 0 if vertex count is not limited
+	std::vector<ConvexPiece> decompose(const std::vector<sf::Vector2f>& points, size_t max_vertices);
+	// decomposes again only the region covered by pieces that contain moved points,
+	// points have to be at their new positions already, returns false if the region
+	// can't be replaced without touching the rest and everything has to be decomposed,
+	// removed is ascending indices of replaced pieces
+	bool redecompose(
+		const std::vector<sf::Vector2f>& points,
+		const std::vector<ConvexPiece>& pieces,
+		const std::vector<size_t>& moved,
+		size_t max_vertices,
+		std::vector<size_t>& removed,
+		std::vector<ConvexPiece>& added
+	);
+
+}
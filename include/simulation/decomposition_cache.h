@@ -0,0 +1,60 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+struct DecompositionCacheStats {
+	size_t hits = 0;
+	size_t misses = 0;
+	size_t evictions = 0;
+	size_t entries = 0;
+	size_t bytes = 0;
+};
+
+// convex decompositions keyed by polygon points, decomposition algorithm
+// and max vertex count, so identical polygons are decomposed only once,
+// least recently used entries are evicted when the memory limit is exceeded,
+// not thread-safe
+class DecompositionCache {
+public:
+	static const size_t DEFAULT_MAX_BYTES = 8 * 1024 * 1024;
+	struct Piece {
+		std::vector<sf::Vector2f> points;
+		// indices of piece points in the polygon, empty if the algorithm doesn't track them
+		std::vector<size_t> source_indices;
+	};
+
+	DecompositionCache(size_t max_bytes = DEFAULT_MAX_BYTES);
+	// returned pointer is valid until the cache is changed
+	const std::vector<Piece>* find(const std::vector<sf::Vector2f>& points, int algorithm, size_t max_vertices);
+	void insert(std::vector<sf::Vector2f> points, int algorithm, size_t max_vertices, std::vector<Piece> pieces);
+	size_t getMaxBytes() const;
+	void setMaxBytes(size_t max_bytes);
+	const DecompositionCacheStats& getStats() const;
+	void resetStats();
+	void clear();
+
+private:
+	struct Entry {
+		size_t hash = 0;
+		std::vector<sf::Vector2f> points;
+		int algorithm = 0;
+		size_t max_vertices = 0;
+		std::vector<Piece> pieces;
+		size_t bytes = 0;
+	};
+	using EntryList = std::list<Entry>;
+	EntryList entries; // most recently used first
+	std::unordered_multimap<size_t, EntryList::iterator> index;
+	size_t max_bytes = DEFAULT_MAX_BYTES;
+	DecompositionCacheStats stats;
+
+	static size_t hashKey(const std::vector<sf::Vector2f>& points, int algorithm, size_t max_vertices);
+	static size_t entryBytes(const Entry& entry);
+	EntryList::iterator findEntry(const std::vector<sf::Vector2f>& points, int algorithm, size_t max_vertices, size_t hash);
+	void removeEntry(EntryList::iterator it);
+	void evict();
+
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <set>
+#include <span>
 #include <SFML/Graphics.hpp>
 #include <box2d/box2d.h>
 #include "serializer.h"
@@ -8,24 +9,47 @@
 #include "shapes.h"
 #include "joint.h"
 #include "gameobject_transform.h"
+#include "vertex_grid.h"
+#include "common/batch_geometry.h"
 #include "common/compvector.h"
 #include "common/utils.h"
 
+class BackgroundDecomposer;
+struct DecompositionResult;
+
 struct BodyDef {
 	b2BodyDef body_def;
 	std::vector<b2FixtureDef> fixture_defs;
 };
 
-class EditableVertex {
+// vertex positions of an object with editing state kept in separate arrays,
+// selection is a bitset and positions from before a drag are only stored
+// from the first offset until savePositions
+class EditableVertices {
 public:
-	b2Vec2 pos = b2Vec2(0.0f, 0.0f);
-	b2Vec2 orig_pos = b2Vec2(0.0f, 0.0f);
-	bool selected = false;
-
-	EditableVertex(b2Vec2 pos);
-	bool operator==(const EditableVertex& other) const;
+	size_t size() const;
+	bool empty() const;
+	const b2Vec2& operator[](size_t index) const;
+	const b2Vec2& front() const;
+	const std::vector<b2Vec2>& getPositions() const;
+	void setPos(size_t index, const b2Vec2& pos);
+	// position from before the drag, or the current one if there is no drag
+	const b2Vec2& getSavedPos(size_t index) const;
+	void offset(size_t index, const b2Vec2& offset);
+	void savePositions();
+	bool isSelected(size_t index) const;
+	void setSelected(size_t index, bool selected);
+	void setAllSelected(bool selected);
+	void insert(size_t index, const b2Vec2& pos);
+	void erase(size_t index);
+	void push_back(const b2Vec2& pos);
+	void assign(const std::vector<b2Vec2>& positions);
+	bool operator==(const EditableVertices& other) const;
 
 private:
+	std::vector<b2Vec2> positions;
+	std::vector<b2Vec2> saved_positions; // empty if there is no drag
+	std::vector<bool> selected;
 };
 
 class GameObjectList;
@@ -77,6 +101,9 @@ public:
 	CompVector<GameObject*> getParentChain() const;
 	const CompVector<GameObject*>& getChildren() const;
 	CompVector<GameObject*> getAllChildren() const;
+	std::span<GameObject* const> getSubtree() const;
+	size_t getDepth() const;
+	bool isAncestorOf(const GameObject* object) const;
 	GameObject* getChild(size_t index) const;
 	size_t getIndex() const;
 	const CompVector<Joint*>& getJoints() const;
@@ -118,12 +145,17 @@ public:
 	size_t indexLoop(ptrdiff_t index) const;
 	size_t getVertexCount() const;
 	size_t getEdgeCount() const;
-	const EditableVertex& getVertex(size_t index) const;
-	const std::vector<EditableVertex>& getVertices() const;
+	const b2Vec2& getVertexPos(size_t index) const;
+	const b2Vec2& getSavedVertexPos(size_t index) const;
+	const std::vector<b2Vec2>& getVertices() const;
 	b2Vec2 getGlobalVertexPos(size_t index);
+	utils::batch::Points getGlobalVertices() const;
+	const VertexGrid& getVertexGrid() const;
+	std::vector<size_t> getVerticesInRect(const b2AABB& global_aabb) const;
 	void setGlobalVertexPos(size_t index, const b2Vec2& new_pos);
 	bool tryDeleteVertex(ptrdiff_t index);
 	void addVertexGlobal(size_t index, const b2Vec2& pos);
+	void setVertices(const std::vector<b2Vec2>& positions);
 	void selectVertex(size_t index);
 	bool isVertexSelected(size_t index) const;
 	void selectAllVertices();
@@ -147,14 +179,14 @@ protected:
 	std::string name = "<unnamed>";
 	b2Body* rigid_body = nullptr;
 	CompVector<Joint*> joints;
-	std::vector<EditableVertex> vertices;
+	EditableVertices vertices;
 	GameObject* parent = nullptr;
 	GameObjectList* object_list = nullptr;
 	sf::Color color;
 	bool draw_varray = false;
 
 	virtual void drawMask(const std::function<void(const sf::Drawable& drawable)>& draw_func) = 0;
-	std::vector<b2Vec2> getPositions() const;
+	const std::vector<b2Vec2>& getPositions() const;
 	void setVisualPosition(const sf::Vector2f& pos);
 	void setVisualRotation(float angle);
 	void vertexSet(size_t index, const b2Vec2& new_pos);
@@ -166,9 +198,17 @@ private:
 	friend class GameObjectTransform;
 	ptrdiff_t new_id = -1;
 	CompVector<GameObject*> children;
+	// position in GameObjectList hierarchy order, valid while the hierarchy is valid
+	mutable size_t hierarchy_index = 0;
+	mutable size_t subtree_size = 1;
+	mutable size_t depth = 0;
 	GameObjectTransform transform = GameObjectTransform(this);
+	// built on first use, then updated by vertex editing functions
+	mutable VertexGrid vertex_grid;
+	mutable bool vertex_grid_valid = false;
 
 	b2AABB getAABB(bool exact) const;
+	void updateVertexGrid(size_t index);
 
 };
 
@@ -228,11 +268,14 @@ public:
 		GameObjectList* object_list,
 		b2BodyDef def,
 		const std::vector<b2Vec2>& vertices,
-		const sf::Color& color
+		const sf::Color& color,
+		SplittablePolygon::DecompositionAlgorithm decomposition_algorithm = SplittablePolygon::BEST_CUT
 	);
 	GameObjectType getType() const;
 	bool isClosed() const override;
 	SplittablePolygon* getSplittablePolygon() const;
+	SplittablePolygon::DecompositionAlgorithm getDecompositionAlgorithm() const;
+	void setDecompositionAlgorithm(SplittablePolygon::DecompositionAlgorithm algorithm);
 	sf::Drawable* getDrawable() const override;
 	sf::Transformable* getTransformable() const override;
 	void drawMask(const std::function<void(const sf::Drawable& drawable)>& draw_func) override;
@@ -242,10 +285,21 @@ public:
 	static dp::DataPointerUnique<PolygonObject> deserialize(const std::string& str, GameObjectList* object_list);
 	static dp::DataPointerUnique<PolygonObject> deserialize(TokenReader& tr, GameObjectList* object_list);
 	void internalSyncVertices() override;
+	// outline is updated right away, convex polygons and fixtures
+	// are replaced when the result is applied
+	void syncVerticesDeferred(BackgroundDecomposer& decomposer);
+	bool isDecompositionPending() const;
+	bool applyDecomposition(const DecompositionResult& result);
 	bool isEqual(const GameObject* other) const;
 
 private:
 	dp::DataPointerUnique<SplittablePolygon> polygon;
+	std::vector<b2Fixture*> convex_fixtures; // one for each convex polygon, null if it's rejected by box2d
+	bool decomposition_pending = false;
+
+	b2FixtureDef getConvexFixtureDef() const;
+	b2Fixture* createConvexFixture(const SplittablePolygon& convex_polygon, b2FixtureDef def);
+	bool syncMovedVertices();
 };
 
 class ChainObject : public GameObject {
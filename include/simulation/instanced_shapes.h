@@ -0,0 +1,46 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <map>
+#include <vector>
+#include "simulation/shapes.h"
+
+// balls and boxes drawn from shared unit meshes, circles with the same point count
+// use one mesh that is scaled by radius, every added shape is expanded into
+// triangles with its own transform and colors, and everything added between
+// clears is drawn with a few draw calls in the order it was added
+class InstancedShapes : public sf::Drawable {
+public:
+	// more vertices are split into several draw calls, always at whole triangles
+	static const size_t MAX_BATCH_VERTICES = 3 * 256 * 1024;
+
+	// adds the drawable if it is a shape that can be instanced, returns false otherwise
+	bool add(const sf::Drawable& drawable);
+	void add(const CircleNotchShape& shape);
+	void add(const sf::RectangleShape& shape);
+	void clear();
+	bool empty() const;
+	size_t getInstanceCount() const;
+	size_t getMeshCount() const;
+	size_t getBatchCount() const;
+	const std::vector<sf::Vertex>& getVertices() const;
+
+private:
+	struct Mesh {
+		// triangles of the shape with size 1, part selects which color the vertex gets
+		std::vector<sf::Vector2f> positions;
+		std::vector<size_t> parts;
+	};
+	// meshes are kept between clears
+	std::map<std::pair<size_t, size_t>, Mesh> circle_meshes;
+	Mesh rect_mesh;
+	std::vector<sf::Vertex> vertices;
+	size_t instance_count = 0;
+
+	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+	const Mesh& getCircleMesh(size_t point_count, size_t notch_segment_count);
+	const Mesh& getRectMesh();
+	void addInstance(const Mesh& mesh, const sf::Transform& transform, const sf::Color* colors);
+	static void addTriangleFan(Mesh& mesh, const sf::VertexArray& fan, size_t part);
+
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include "simulation.h"
+
+// entry for one "object ... /object" block of a level file,
+// offset and length are in bytes from the start of the file
+struct LevelIndexEntry {
+	size_t id = 0;
+	ptrdiff_t parent_id = -1;
+	std::string type;
+	size_t offset = 0;
+	size_t length = 0;
+	b2AABB aabb;
+
+	bool operator==(const LevelIndexEntry& other) const;
+};
+
+// per-object offset index of a serialized level,
+// built by scanning the text without tokenizing or creating any bodies
+class LevelIndex {
+public:
+	LevelIndex();
+	LevelIndex(const std::string& str);
+	size_t size() const;
+	size_t getSourceSize() const;
+	ptrdiff_t getSourceTime() const;
+	void setSourceTime(ptrdiff_t time);
+	const std::vector<LevelIndexEntry>& getEntries() const;
+	const LevelIndexEntry* find(size_t id) const;
+	std::vector<const LevelIndexEntry*> query(const b2AABB& region) const;
+	void build(const std::string& str);
+	void clear();
+	std::string serialize() const;
+	TokenWriter& serialize(TokenWriter& tw) const;
+	void deserialize(const std::string& str);
+	void deserialize(TokenReader& tr);
+	bool operator==(const LevelIndex& other) const;
+
+private:
+	std::vector<LevelIndexEntry> entries;
+	std::map<size_t, size_t> ids;
+	size_t source_size = 0;
+	ptrdiff_t source_time = 0;
+
+	void addEntry(const LevelIndexEntry& entry);
+
+};
+
+// level file with a sidecar index ("<level>.index"),
+// objects can be loaded one by one or by region instead of loading the whole level
+class LevelFile {
+public:
+	LevelFile(const std::filesystem::path& path);
+	const std::filesystem::path& getPath() const;
+	const LevelIndex& getIndex() const;
+	void open();
+	std::string readBlock(size_t id) const;
+	GameObject* loadObject(size_t id, GameObjectList* object_list);
+	std::vector<GameObject*> loadRegion(const b2AABB& region, GameObjectList* object_list);
+	static void save(const std::string& str, const std::filesystem::path& path);
+	static LevelIndex writeIndex(const std::filesystem::path& path);
+	static std::filesystem::path getIndexPath(const std::filesystem::path& path);
+
+private:
+	std::filesystem::path path;
+	LevelIndex index;
+
+	static std::string readFile(const std::filesystem::path& path);
+	static ptrdiff_t getFileTime(const std::filesystem::path& path);
+
+};
@@ -4,11 +4,14 @@
 #include "common/compvector.h"
 #include "common/event.h"
 #include "common/searchindex.h"
+#include "common/name_index.h"
 #include "common/utils.h"
 
 class GameObjectList {
 public:
 	dp::DataPointerUnique<b2World> world;
+	// duplicating and loading objects batches OnObjectAdded, OnSetParent and OnObjectMoved,
+	// batch handlers of these events get them in that order
 	Event<GameObject*> OnObjectAdded;
 	Event<GameObject*> OnBeforeObjectRemoved;
 	Event<GameObject*> OnAfterObjectRemoved;
@@ -24,12 +27,14 @@ public:
 	GameObject* getFromAll(size_t i) const;
 	GameObject* getById(size_t id) const;
 	GameObject* getByName(const std::string& name) const;
+	std::vector<GameObject*> findByName(const std::string& pattern) const;
 	bool contains(GameObject* object) const;
 	ptrdiff_t getTopIndex(GameObject* object) const;
 	ptrdiff_t getAllIndex(GameObject* object) const;
 	Joint* getJoint(size_t i) const;
 	const CompVector<GameObject*>& getTopObjects() const;
 	const CompVector<GameObject*>& getAllObjects() const;
+	const std::vector<GameObject*>& getHierarchy() const;
 	ptrdiff_t getMaxId() const;
 	GameObject* add(dp::DataPointerUnique<GameObject> object, bool assign_new_id);
 	Joint* addJoint(dp::DataPointerUnique<Joint> joint);
@@ -37,6 +42,10 @@ public:
 	CompVector<GameObject*> duplicate(const CompVector<GameObject*>& old_objects);
 	void transformFromRigidbody();
 	void moveObjectToIndex(GameObject* object, size_t index);
+	// these move objects relative to their orig_pos and orig_angle in one pass,
+	// updating each rigid body once, objects shouldn't contain each other's descendants
+	void offsetObjects(const CompVector<GameObject*>& objects, const b2Vec2& offset);
+	void rotateObjects(const CompVector<GameObject*>& objects, const b2Vec2& pivot, float angle);
 	void remove(GameObject* object, bool remove_children);
 	void removeJoint(Joint* joint);
 	void clear();
@@ -47,10 +56,18 @@ private:
 	CompVectorUptr<GameObject> all_objects;
 	CompVector<GameObject*> top_objects;
 	CompVectorUptr<Joint> joints;
-	SearchIndexUnique<size_t, GameObject*> ids;
-	SearchIndexMultiple<std::string, GameObject*> names;
+	SearchIndexDense<size_t, GameObject*> ids;
+	NameIndex<GameObject*> names;
+	// all objects in pre-order, subtree of an object is a contiguous range starting at it,
+	// rebuilt lazily after the hierarchy changes
+	mutable std::vector<GameObject*> hierarchy;
+	mutable bool hierarchy_valid = false;
 
 	GameObject* duplicateObject(const GameObject* object);
 	Joint* duplicateJoint(const Joint* joint, GameObject* new_object_a, GameObject* new_object_b);
+	void setGlobalTransformBatched(GameObject* object, const b2Transform& transform);
+	void invalidateHierarchy();
+	void updateHierarchy() const;
+	bool isInHierarchy(const GameObject* object) const;
 
 };
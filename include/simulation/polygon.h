@@ -2,6 +2,9 @@
 
 #include <SFML/Graphics.hpp>
 #include "logger/logger.h"
+#include "convex_decomposition.h"
+#include "decomposition_cache.h"
+#include "common/batch_geometry.h"
 #include "common/utils.h"
 
 extern sf::Text vertex_text;
@@ -44,6 +47,10 @@ public:
 		MAX_DIST,
 		MIN_ANGLE,
 	};
+	enum DecompositionAlgorithm {
+		BEST_CUT,
+		EAR_CLIPPING,
+	};
 	bool draw_varray = false;
 
 	SplittablePolygon();
@@ -56,10 +63,12 @@ public:
 	sf::FloatRect getLocalBounds() const;
 	sf::FloatRect getGlobalBounds() const;
 	sf::Color getFillColor() const;
-	std::vector<SplittablePolygon> getConvexPolygons() const;
+	const std::vector<SplittablePolygon>& getConvexPolygons() const;
 	sf::Transform getParentGlobalTransform() const;
 	sf::Transform getGlobalTransform() const;
 	bool isConvex() const;
+	DecompositionAlgorithm getDecompositionAlgorithm() const;
+	void setDecompositionAlgorithm(DecompositionAlgorithm algorithm);
 	void setPoint(size_t index, const sf::Vector2f& point);
 	void setLineColor(const sf::Color& color);
 	void setFillColor(const sf::Color& color);
@@ -70,10 +79,23 @@ public:
 	std::vector<SplittablePolygon> getCutPolygons(const CutInfo& cut) const;
 	std::vector<SplittablePolygon> cutWithBestCut(bool cut_convex);
 	std::vector<SplittablePolygon> cutIntoConvex(size_t max_vertices = 0);
+	std::vector<SplittablePolygon> decomposeIntoConvex(size_t max_vertices = 0) const;
 	void resetVarray(size_t vertex_count);
 	void recenter();
 	void recut();
+	bool recutMovedPoints(
+		const std::vector<size_t>& indices,
+		const std::vector<sf::Vector2f>& positions,
+		std::vector<size_t>& removed_polygons,
+		size_t& added_count
+	);
+	// moves points, current convex polygons are kept for drawing
+	// until they're replaced with setConvexPieces or recut
+	void setOutline(const std::vector<sf::Vector2f>& points);
+	void setConvexPieces(const std::vector<decomposition::ConvexPiece>& pieces);
 	static SplittablePolygon createRect(sf::Vector2f size);
+	// shared by all polygons, recut takes convex polygons from it when points are the same
+	static DecompositionCache& getDecompositionCache();
 private:
 	sf::VertexArray varray;
 	sf::VertexArray triangle_fan;
@@ -85,11 +107,17 @@ private:
 	std::vector<CutInfo> potential_cuts;
 	bool cuts_valid = false;
 	bool is_convex = false;
+	DecompositionAlgorithm decomposition_algorithm = BEST_CUT;
+	std::vector<size_t> source_indices; // for convex polygons, indices of their points in the parent
 
 	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 	bool isConvexVertex(size_t index) const;
-	bool intersectsEdge(const sf::Vector2f& v1, const sf::Vector2f& v2, size_t& intersect) const;
+	bool intersectsEdge(
+		const utils::batch::Points& points, const sf::Vector2f& v1, const sf::Vector2f& v2, size_t& intersect
+	) const;
 	size_t indexLoop(ptrdiff_t index) const;
 	void createCutsVarray();
 	void setCutsValid(bool value);
+	void movePoint(size_t index, const sf::Vector2f& point);
+	void initConvexPolygon(SplittablePolygon& polygon);
 };
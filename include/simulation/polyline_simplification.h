@@ -0,0 +1,20 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// Douglas-Peucker simplification of open polylines, used for level of detail
+// of long chains, one pass ranks all points so that simplifications at any
+// number of tolerances can be taken from it without running it again
+
+namespace simplification {
+
+	// for each point, the largest tolerance at which Douglas-Peucker still keeps it,
+	// first and last points are always kept and have infinite importance,
+	// points kept at a tolerance are also kept at every smaller one
+	std::vector<float> douglas_peucker_importance(const std::vector<sf::Vector2f>& points);
+	// ascending indices of points with importance above the tolerance
+	std::vector<size_t> simplify(const std::vector<float>& importance, float tolerance);
+	std::vector<size_t> douglas_peucker(const std::vector<sf::Vector2f>& points, float tolerance);
+
+}
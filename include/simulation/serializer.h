@@ -39,6 +39,7 @@ public:
 	bool fail() const;
 	void reset();
 	size_t getLine(ptrdiff_t offset = 0) const;
+	const std::vector<WordToken>& getTokens() const;
 private:
 	std::vector<WordToken> internal_tokens;
 	const std::vector<WordToken>* tokens;
@@ -1,22 +1,56 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <vector>
 
 class LineStripShape : public sf::Drawable, public sf::Transformable {
 public:
+	// shorter strips are always drawn in full
+	static const size_t LOD_MIN_VERTICES = 1024;
+	// how far in pixels a simplified strip can be from the full one
+	static constexpr float LOD_PIXEL_TOLERANCE = 0.5f;
+
 	explicit LineStripShape();
 	explicit LineStripShape(sf::VertexArray& varray);
 	void setLineColor(sf::Color color);
 	sf::VertexArray varray;
+	// with level of detail, simplified strip is drawn when zoomed out
+	// and only the parts in view are drawn, levels are rebuilt
+	// on next draw after invalidateLod, which is needed after varray is changed
+	void setLodEnabled(bool enabled);
+	void invalidateLod();
+	size_t getLodLevelCount() const;
+	size_t getDrawnVertexCount() const;
 	void drawMask(sf::RenderTarget& mask, sf::RenderStates states = sf::RenderStates::Default);
 private:
+	struct LodLevel {
+		float tolerance = 0.0f;
+		std::vector<sf::Vertex> vertices; // empty for the full strip, it is drawn from varray
+		std::vector<sf::FloatRect> chunk_bounds;
+	};
+	static const size_t LOD_CHUNK_SEGMENTS = 128;
+	static const size_t LOD_MAX_LEVELS = 24;
+	bool lod_enabled = false;
+	mutable bool lod_valid = false;
+	mutable std::vector<LodLevel> lod_levels;
+	mutable size_t drawn_vertex_count = 0;
+
 	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+	void drawLod(sf::RenderTarget& target, const sf::RenderStates& states) const;
+	void buildLod() const;
+	const sf::Vertex* getLodVertices(const LodLevel& level) const;
+	size_t getLodVertexCount(const LodLevel& level) const;
 	sf::Color line_color;
 };
 
 class CircleNotchShape : public sf::Drawable, public sf::Transformable {
 public:
 	explicit CircleNotchShape(float radius, size_t point_count, size_t notch_segment_count);
+	float getRadius() const;
+	size_t getPointCount() const;
+	size_t getNotchSegmentCount() const;
+	const sf::VertexArray& getCircleVarray() const;
+	const sf::VertexArray& getNotchVarray() const;
 	const sf::Color& getCircleColor() const;
 	const sf::Color& getNotchColor() const;
 	void setCircleColor(const sf::Color& color);
@@ -24,6 +58,9 @@ public:
 	void drawMask(sf::RenderTarget& mask, sf::RenderStates states = sf::RenderStates::Default);
 private:
 	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+	float radius = 0.0f;
+	size_t point_count = 0;
+	size_t notch_segment_count = 0;
 	sf::VertexArray varray_circle;
 	sf::VertexArray varray_notch;
 	sf::Color circle_color;
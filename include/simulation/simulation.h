@@ -15,6 +15,7 @@ public:
 	TokenWriter& serialize(TokenWriter& tw) const;
 	void deserialize(const std::string& str);
 	void deserialize(TokenReader& tr);
+	static dp::DataPointerUnique<GameObject> deserializeObject(TokenReader& tr, GameObjectList* object_list);
 	BoxObject* createBox(
 		const std::string& name,
 		const b2Vec2& pos,
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <box2d/box2d.h>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// uniform grid over vertex positions of an object in its local space,
+// cells are only allocated where there are vertices,
+// moving a vertex only touches its old and new cell
+class VertexGrid {
+public:
+	void build(const std::vector<b2Vec2>& positions);
+	void clear();
+	size_t size() const;
+	float getCellSize() const;
+	const b2Vec2& getPosition(size_t index) const;
+	void move(size_t index, const b2Vec2& pos);
+	// inserting and erasing shift indices of the following vertices, like in the vertex list
+	void insert(size_t index, const b2Vec2& pos);
+	void erase(size_t index);
+	// indices of vertices inside the aabb, bounds included, in ascending order
+	std::vector<size_t> query(const b2AABB& aabb) const;
+
+private:
+	using CellKey = uint64_t;
+	float cell_size = 1.0f;
+	std::vector<b2Vec2> positions;
+	std::unordered_map<CellKey, std::vector<size_t>> cells;
+
+	int32_t getCellCoord(float value) const;
+	static CellKey getCellKey(int32_t x, int32_t y);
+	CellKey getCellKey(const b2Vec2& pos) const;
+	void addToCell(size_t index);
+	void removeFromCell(size_t index);
+	void shiftIndices(size_t from_index, ptrdiff_t offset);
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/compvector.h"
+#include "common/indexed_compvector.h"
 #include "test_lib/test.h"
 
 class CompVectorTests : public test::TestModule {
@@ -10,4 +11,5 @@ public:
 protected:
 	void createCompVectorList(test::TestModule* list);
 	void createCompVectorUptrList(test::TestModule* list);
+	void createIndexedCompVectorList(test::TestModule* list);
 };
@@ -9,4 +9,11 @@ public:
 	static void checkDataBlock(test::Test& test, void* p_block, size_t p_size);
 	static void checkNoDataBlock(test::Test& test, void* p_block);
 
+private:
+	void trackingDisabledTest(test::Test& test);
+	void threadsTest(test::Test& test);
+	void memoryStatsTest(test::Test& test);
+	void internedNamesTest(test::Test& test);
+	void trackingCompiledOutTest(test::Test& test);
+
 };
@@ -22,9 +22,19 @@ private:
 	void moveTest(test::Test& test);
 	void panMoveTest(test::Test& test);
 	void serializeEmptyTest(test::Test& test);
+	void autosaveTest(test::Test& test);
+	void undoMoveTest(test::Test& test);
+	void undoDeleteTest(test::Test& test);
+	void undoHierarchyTest(test::Test& test);
+	void undoSpillTest(test::Test& test);
+	void outlinerFilterTest(test::Test& test);
+	void memoryOverlayTest(test::Test& test);
+	void outlinerBatchTest(test::Test& test);
 
 	void clickMouse(Editor& editor, const sf::Vector2f& pos);
 	void clickObject(Editor& editor, GameObject* object, bool shift = false, bool ctrl = false);
 	void tapKey(Editor& editor, sf::Keyboard::Key key);
+	void undo(Editor& editor);
+	void redo(Editor& editor);
 
 };
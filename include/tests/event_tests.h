@@ -20,5 +20,12 @@ private:
 	void copyMultiTest(test::Test& test);
 	void copyChainTest(test::Test& test);
 	void clearTest(test::Test& test);
+	void largeCaptureTest(test::Test& test);
+	void addDuringDispatchTest(test::Test& test);
+	void removeDuringDispatchTest(test::Test& test);
+	void batchTest(test::Test& test);
+	void batchArgsTest(test::Test& test);
+	void batchScopeTest(test::Test& test);
+	void batchScopeExceptionTest(test::Test& test);
 
 };
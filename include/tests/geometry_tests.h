@@ -0,0 +1,19 @@
+#pragma once
+
+#include "common/batch_geometry.h"
+#include "test_lib/test.h"
+
+class GeometryTests : public test::TestModule {
+public:
+	GeometryTests(const std::string& name, test::TestModule* parent, const std::vector<TestNode*>& required_nodes = { });
+
+private:
+	void linesTest(test::Test& test);
+	void intersectTest(test::Test& test);
+	void transformTest(test::Test& test);
+	void containsTest(test::Test& test);
+	void instructionSetsTest(test::Test& test);
+
+	static utils::batch::Points createPoints(size_t count);
+
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "test_lib/test.h"
+
+class HistoryTests : public test::TestModule {
+public:
+	HistoryTests(const std::string& name, test::TestModule* manager, const std::vector<TestNode*>& required_nodes = { });
+
+private:
+	void stringDeltaBasicTest(test::Test& test);
+	void stringDeltaEditsTest(test::Test& test);
+	void stringDeltaSerializeTest(test::Test& test);
+	void compressionBasicTest(test::Test& test);
+	void basicTest(test::Test& test);
+	void undoRedoTest(test::Test& test);
+	void keyframesTest(test::Test& test);
+	void updateCurrentTest(test::Test& test);
+	void memoryLimitTest(test::Test& test);
+	void actionTest(test::Test& test);
+	void spillTest(test::Test& test);
+	void spillCodecTest(test::Test& test);
+	void spillCopyTest(test::Test& test);
+	void spillActionTest(test::Test& test);
+
+	static std::string createLevelString(size_t line_count, size_t changed_line);
+
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/searchindex.h"
+#include "common/name_index.h"
 #include "test_lib/test.h"
 
 class SearchIndexTests : public test::TestModule {
@@ -10,5 +11,7 @@ public:
 protected:
 	void createTestListUnique(test::TestModule* list);
 	void createTestListMultiple(test::TestModule* list);
+	void createTestListDense(test::TestModule* list);
+	void createTestListNames(test::TestModule* list);
 
 };
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "simulation/background_decomposer.h"
+#include "simulation/instanced_shapes.h"
+#include "simulation/level_index.h"
+#include "simulation/polyline_simplification.h"
 #include "simulation/simulation.h"
 #include "test_lib/test.h"
 
@@ -12,7 +16,14 @@ private:
 	void boxTest(test::Test& test);
 	void ballTest(test::Test& test);
 	void polygonTest(test::Test& test);
+	void polygonEarClippingTest(test::Test& test);
+	void polygonPartialRecutTest(test::Test& test);
+	void polygonDeferredRecutTest(test::Test& test);
+	void decompositionCacheTest(test::Test& test);
 	void chainTest(test::Test& test);
+	void chainVertexGridTest(test::Test& test);
+	void polylineSimplificationTest(test::Test& test);
+	void instancedShapesTest(test::Test& test);
 	void revoluteJointTest(test::Test& test);
 	void carTest(test::Test& test);
 	void serializeTest(test::Test& test);
@@ -26,10 +37,14 @@ private:
 	void saveloadTest(test::Test& test);
 	void boxStackTest(test::Test& test);
 	void movingCarTest(test::Test& test);
+	void levelIndexTest(test::Test& test);
+	void levelFileTest(test::Test& test);
 
 	void setParentTwoTest(test::Test& test);
 	void setParentThreeTest(test::Test& test);
 	void parentLoopTest(test::Test& test);
+	void hierarchyTest(test::Test& test);
+	void transformObjectsTest(test::Test& test);
 	void setPositionTwoTest(test::Test& test);
 	void setPositionThreeTest(test::Test& test);
 	void setAngleTest(test::Test& test);
@@ -53,6 +68,7 @@ private:
 
 	static std::string colorToStr(const sf::Color& color);
 	static std::string b2Vec2ToStr(const b2Vec2& vec);
+	static std::string indicesToStr(const std::vector<size_t>& indices);
 	BoxObject* createBox(Simulation& simulation, const std::string& name, const b2Vec2& pos) const;
 	void objCmpCommon(test::Test& test, const GameObject* objA, const GameObject* objB, bool cmp_id = true);
 	void boxCmp(test::Test& test, BoxObject* boxA, BoxObject* boxB, bool cmp_id = true);
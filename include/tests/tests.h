@@ -3,6 +3,8 @@
 #include "compvector_tests.h"
 #include "searchindex_tests.h"
 #include "event_tests.h"
+#include "geometry_tests.h"
+#include "history_tests.h"
 #include "simulation_tests.h"
 #include "widget_tests/widget_tests.h"
 #include "widget_tests/widget_tests_application.h"
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "rectangle_widget.h"
+#include "common/memory_stats.h"
 #include <filesystem>
 
 namespace fw {
@@ -34,6 +35,7 @@ namespace fw {
 	protected:
 		sf::RenderTexture texture;
 		sf::View view;
+		dp::ExternalMemoryBlock texture_memory = dp::ExternalMemoryBlock(dp::MemoryCategory::TEXTURES);
 
 	private:
 		void intenalDraw(const sf::Drawable& drawable, ColorType color_type, const sf::RenderStates& states);
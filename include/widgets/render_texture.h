@@ -1,6 +1,7 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include "common/memory_stats.h"
 
 // If logical texture size is at least this smaller than physical size,
 // texture is reallocated
@@ -21,5 +22,6 @@ private:
 	unsigned int height = 0;
 	sf::RenderTexture render_texture;
 	sf::RenderTexture render_texture_premultiplied;
+	dp::ExternalMemoryBlock memory = dp::ExternalMemoryBlock(dp::MemoryCategory::TEXTURES);
 
 };
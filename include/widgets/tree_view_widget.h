@@ -44,6 +44,7 @@ namespace fw {
 		TreeViewEntry* getTargetHighlightEntry(const sf::Vector2f& global_pos) const;
 		void putTargetHighlight();
 		void removeEntry(TreeViewEntry* entry, bool with_children);
+		void removeEntries(const std::vector<TreeViewEntry*>& entries);
 		void clear();
 		TreeViewWidget* clone(bool with_children = true) override;
 
@@ -192,8 +192,7 @@ namespace fw {
 	inline T* WidgetList::duplicateWidget(T* widget, bool with_children) {
 		wAssert(!isLocked());
 		std::string name = widget->getName() + " copy";
-		dp::DataPointerUnique<T> uptr = dp::make_data_pointer<T>(name, *widget);
-		uptr.setName(name);
+		dp::DataPointerUnique<T> uptr = dp::make_data_pointer<T>("Widget " + name, *widget);
 		T* ptr = uptr.get();
 		widgets.add(std::move(uptr));
 		ptr->setParent(widget->parent);
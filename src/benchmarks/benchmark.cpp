@@ -0,0 +1,188 @@
+#include "benchmarks/benchmark.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <iostream>
+
+#ifndef B2E_GIT_COMMIT
+#define B2E_GIT_COMMIT ""
+#endif
+
+namespace bench {
+
+	Benchmark::Benchmark(const std::string& name, BenchmarkModule* module) {
+		this->name = name;
+		this->module = module;
+	}
+
+	const std::string& Benchmark::getName() const {
+		return name;
+	}
+
+	const std::vector<BenchmarkResult>& Benchmark::getResults() const {
+		return results;
+	}
+
+	double Benchmark::measure(const std::function<void(void)>& func) {
+		return measure(func, module->getSettings().min_runs);
+	}
+
+	double Benchmark::measure(const std::function<void(void)>& func, size_t min_runs) {
+		return measure(nullptr, func, min_runs);
+	}
+
+	double Benchmark::measureWithSetup(const std::function<void(void)>& setup, const std::function<void(void)>& func) {
+		return measure(setup, func, module->getSettings().min_runs);
+	}
+
+	double Benchmark::measure(
+		const std::function<void(void)>& setup, const std::function<void(void)>& func, size_t min_runs
+	) {
+		const BenchmarkSettings& settings = module->getSettings();
+		std::vector<double> times;
+		std::chrono::duration<double> total_time(0.0);
+		while (
+			times.size() < settings.max_runs
+			&& (times.size() < min_runs || total_time.count() < settings.min_time)
+		) {
+			if (setup) {
+				setup();
+			}
+			std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+			func();
+			std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+			std::chrono::duration<double> time = t2 - t1;
+			times.push_back(time.count());
+			total_time += time;
+		}
+		// median is less sensitive to occasional hiccups than mean
+		std::sort(times.begin(), times.end());
+		return times[times.size() / 2];
+	}
+
+	void Benchmark::report(const std::string& metric, double value, const std::string& unit) {
+		BenchmarkResult result;
+		result.module = module->getName();
+		result.benchmark = name;
+		result.metric = metric;
+		result.value = value;
+		result.unit = unit;
+		results.push_back(result);
+		std::cout << "    " << metric << ": " << value << " " << unit << "\n";
+	}
+
+	void Benchmark::reportTime(const std::string& stage, double seconds) {
+		report(stage + "_time", seconds * 1000.0, "ms");
+	}
+
+	void Benchmark::reportThroughput(const std::string& stage, double seconds, size_t bytes, size_t objects) {
+		reportTime(stage, seconds);
+		report(stage + "_throughput", bytes / seconds / 1024.0 / 1024.0, "MB/s");
+		report(stage + "_objects", objects / seconds, "objects/s");
+	}
+
+	void Benchmark::reportRate(const std::string& stage, double seconds, size_t operations) {
+		reportTime(stage, seconds);
+		report(stage + "_rate", operations / seconds, "ops/s");
+	}
+
+	BenchmarkModule::BenchmarkModule(const std::string& name, const BenchmarkSettings& settings) {
+		this->name = name;
+		this->settings = settings;
+	}
+
+	BenchmarkModule::~BenchmarkModule() { }
+
+	const std::string& BenchmarkModule::getName() const {
+		return name;
+	}
+
+	const BenchmarkSettings& BenchmarkModule::getSettings() const {
+		return settings;
+	}
+
+	void BenchmarkModule::addBenchmark(const std::string& name, BenchmarkFunc func) {
+		benchmarks.push_back(Entry { name, func });
+	}
+
+	std::vector<BenchmarkResult> BenchmarkModule::run() {
+		std::vector<BenchmarkResult> results;
+		beforeRunModule();
+		for (const Entry& entry : benchmarks) {
+			std::string full_name = name + "/" + entry.name;
+			if (settings.filter.size() > 0 && full_name.find(settings.filter) == std::string::npos) {
+				continue;
+			}
+			std::cout << full_name << "\n";
+			Benchmark benchmark(entry.name, this);
+			try {
+				entry.func(benchmark);
+			} catch (std::exception exc) {
+				std::cout << "    ERROR: " << exc.what() << "\n";
+			}
+			const std::vector<BenchmarkResult>& benchmark_results = benchmark.getResults();
+			results.insert(results.end(), benchmark_results.begin(), benchmark_results.end());
+		}
+		afterRunModule();
+		return results;
+	}
+
+	void BenchmarkModule::beforeRunModule() { }
+
+	void BenchmarkModule::afterRunModule() { }
+
+	static std::string json_escape(const std::string& str) {
+		std::string result;
+		for (char c : str) {
+			if (c == '"' || c == '\\') {
+				result += '\\';
+				result += c;
+			} else if (c == '\n') {
+				result += "\\n";
+			} else {
+				result += c;
+			}
+		}
+		return result;
+	}
+
+	std::string results_to_json(const std::vector<BenchmarkResult>& results) {
+		std::stringstream ss;
+		ss << std::setprecision(9);
+		ss << "{\n";
+		ss << "    \"commit\": \"" << json_escape(B2E_GIT_COMMIT) << "\",\n";
+#ifdef NDEBUG
+		ss << "    \"build\": \"release\",\n";
+#else
+		ss << "    \"build\": \"debug\",\n";
+#endif
+		ss << "    \"results\": [\n";
+		for (size_t i = 0; i < results.size(); i++) {
+			const BenchmarkResult& result = results[i];
+			ss << "        { ";
+			ss << "\"module\": \"" << json_escape(result.module) << "\", ";
+			ss << "\"benchmark\": \"" << json_escape(result.benchmark) << "\", ";
+			ss << "\"metric\": \"" << json_escape(result.metric) << "\", ";
+			ss << "\"value\": " << result.value << ", ";
+			ss << "\"unit\": \"" << json_escape(result.unit) << "\"";
+			ss << " }";
+			if (i < results.size() - 1) {
+				ss << ",";
+			}
+			ss << "\n";
+		}
+		ss << "    ]\n";
+		ss << "}\n";
+		return ss.str();
+	}
+
+	void write_results(const std::vector<BenchmarkResult>& results, const std::filesystem::path& path) {
+		std::ofstream ofstream(path);
+		if (!ofstream.is_open()) {
+			throw std::runtime_error("File write error: " + path.string());
+		}
+		ofstream << results_to_json(results);
+	}
+
+}
@@ -0,0 +1,99 @@
+#include "benchmarks/compvector_benchmarks.h"
+#include <algorithm>
+#include <random>
+
+CompVectorBenchmarks::CompVectorBenchmarks(
+	const std::string& name, const bench::BenchmarkSettings& settings
+) : BenchmarkModule(name, settings) {
+	for (size_t value_count : { 100, 1000, 10000 }) {
+		std::string suffix = "_" + std::to_string(value_count);
+		addBenchmark("CompVector" + suffix, [=, this](bench::Benchmark& benchmark) {
+			containerBenchmark<CompVector<int*>>(benchmark, value_count);
+		});
+		addBenchmark("IndexedCompVector" + suffix, [=, this](bench::Benchmark& benchmark) {
+			containerBenchmark<IndexedCompVector<int*>>(benchmark, value_count);
+		});
+	}
+}
+
+template<typename TVec>
+void CompVectorBenchmarks::containerBenchmark(bench::Benchmark& benchmark, size_t value_count) {
+	std::vector<int> storage;
+	std::vector<int*> values = createValues(storage, value_count);
+	// lookups and removals go in a different order than additions
+	std::vector<int*> shuffled = values;
+	std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(1));
+
+	double add_time = benchmark.measure([&]() {
+		TVec vec;
+		for (int* value : values) {
+			vec.add(value);
+		}
+		bench::do_not_optimize(vec);
+	});
+	benchmark.reportRate("add", add_time, value_count);
+
+	TVec vec;
+	for (int* value : values) {
+		vec.add(value);
+	}
+	double contains_time = benchmark.measure([&]() {
+		size_t found = 0;
+		for (int* value : shuffled) {
+			found += vec.contains(value) ? 1 : 0;
+		}
+		bench::do_not_optimize(found);
+	});
+	benchmark.reportRate("contains", contains_time, value_count);
+
+	double get_index_time = benchmark.measure([&]() {
+		ptrdiff_t sum = 0;
+		for (int* value : shuffled) {
+			sum += vec.getIndex(value);
+		}
+		bench::do_not_optimize(sum);
+	});
+	benchmark.reportRate("get_index", get_index_time, value_count);
+
+	TVec remove_vec;
+	auto fill = [&]() {
+		remove_vec = TVec();
+		for (int* value : values) {
+			remove_vec.add(value);
+		}
+	};
+	double remove_time = benchmark.measureWithSetup(fill, [&]() {
+		for (int* value : shuffled) {
+			remove_vec.remove(value);
+		}
+		bench::do_not_optimize(remove_vec);
+	});
+	benchmark.reportRate("remove", remove_time, value_count);
+
+	if constexpr (requires { remove_vec.removeSwap(values[0]); }) {
+		double remove_swap_time = benchmark.measureWithSetup(fill, [&]() {
+			for (int* value : shuffled) {
+				remove_vec.removeSwap(value);
+			}
+			bench::do_not_optimize(remove_vec);
+		});
+		benchmark.reportRate("remove_swap", remove_swap_time, value_count);
+	}
+
+	double move_time = benchmark.measureWithSetup(fill, [&]() {
+		for (size_t i = 0; i < shuffled.size(); i++) {
+			remove_vec.moveValueToIndex(shuffled[i], i);
+		}
+		bench::do_not_optimize(remove_vec);
+	});
+	benchmark.reportRate("move_value_to_index", move_time, value_count);
+}
+
+std::vector<int*> CompVectorBenchmarks::createValues(std::vector<int>& storage, size_t value_count) {
+	storage = std::vector<int>(value_count);
+	std::vector<int*> result;
+	for (size_t i = 0; i < value_count; i++) {
+		result.push_back(&storage[i]);
+	}
+	return result;
+}
@@ -0,0 +1,63 @@
+#include "benchmarks/decomposition_benchmarks.h"
+
+DecompositionBenchmarks::DecompositionBenchmarks(
+	const std::string& name, const bench::BenchmarkSettings& settings
+) : BenchmarkModule(name, settings) {
+	for (size_t vertex_count : { 50, 100, 200, 500 }) {
+		std::string benchmark_name = "terrain_" + std::to_string(vertex_count);
+		addBenchmark(benchmark_name, [=, this](bench::Benchmark& benchmark) { terrainBenchmark(benchmark, vertex_count); });
+	}
+}
+
+void DecompositionBenchmarks::terrainBenchmark(bench::Benchmark& benchmark, size_t vertex_count) {
+	SplittablePolygon terrain = createTerrain(vertex_count);
+	auto run = [&](const std::string& stage, SplittablePolygon::DecompositionAlgorithm algorithm) {
+		SplittablePolygon polygon;
+		// best cut splitting caches potential cuts, so every run starts from a fresh copy,
+		// and decomposition cache is cleared so it doesn't measure cache hits
+		double time = benchmark.measureWithSetup(
+			[&]() {
+				polygon = terrain;
+				polygon.setDecompositionAlgorithm(algorithm);
+				SplittablePolygon::getDecompositionCache().clear();
+			},
+			[&]() {
+				polygon.recut();
+			}
+		);
+		benchmark.reportTime(stage, time);
+		benchmark.report(stage + "_fixtures", static_cast<double>(polygon.getConvexPolygons().size()), "fixtures");
+	};
+	run("best_cut", SplittablePolygon::BEST_CUT);
+	run("ear_clipping", SplittablePolygon::EAR_CLIPPING);
+	// identical polygon is already in the cache
+	SplittablePolygon polygon = terrain;
+	polygon.recut();
+	double time = benchmark.measureWithSetup(
+		[&]() {
+			polygon = terrain;
+		},
+		[&]() {
+			polygon.recut();
+		}
+	);
+	benchmark.reportTime("cached", time);
+	SplittablePolygon::getDecompositionCache().clear();
+}
+
+SplittablePolygon DecompositionBenchmarks::createTerrain(size_t vertex_count) {
+	// flat bottom and a bumpy top, counterclockwise
+	const float STEP = 0.5f;
+	size_t top_count = vertex_count - 2;
+	float width = (top_count - 1) * STEP;
+	SplittablePolygon polygon(vertex_count);
+	polygon.setPoint(0, sf::Vector2f(0.0f, 0.0f));
+	polygon.setPoint(1, sf::Vector2f(width, 0.0f));
+	for (size_t i = 0; i < top_count; i++) {
+		size_t x_index = top_count - 1 - i;
+		float x = x_index * STEP;
+		float height = 10.0f + 3.0f * sin(x_index * 0.37f) + 2.0f * sin(x_index * 1.91f) + sin(x_index * 5.3f);
+		polygon.setPoint(i + 2, sf::Vector2f(x, height));
+	}
+	return polygon;
+}
@@ -0,0 +1,66 @@
+#include "benchmarks/event_benchmarks.h"
+
+EventBenchmarks::EventBenchmarks(
+	const std::string& name, const bench::BenchmarkSettings& settings
+) : BenchmarkModule(name, settings) {
+	for (size_t handler_count : { 0, 1, 8 }) {
+		std::string suffix = "_" + std::to_string(handler_count);
+		addBenchmark("Event" + suffix, [=, this](bench::Benchmark& benchmark) {
+			eventBenchmark<Event<int>>(benchmark, handler_count);
+		});
+		addBenchmark("FunctionList" + suffix, [=, this](bench::Benchmark& benchmark) {
+			eventBenchmark<FunctionListEvent>(benchmark, handler_count);
+		});
+	}
+}
+
+template<typename TEvent>
+void EventBenchmarks::eventBenchmark(bench::Benchmark& benchmark, size_t handler_count) {
+	const size_t CALL_COUNT = 10000;
+	const size_t EVENT_COUNT = 1000;
+	size_t sum = 0;
+	// typical widget handler, captures a pointer or two
+	auto add_handlers = [&](TEvent& event) {
+		for (size_t i = 0; i < handler_count; i++) {
+			event += [&sum, i](int arg) {
+				sum += arg + i;
+			};
+		}
+	};
+
+	if (handler_count > 0) {
+		double subscribe_time = benchmark.measure([&]() {
+			std::vector<TEvent> events(EVENT_COUNT);
+			for (TEvent& event : events) {
+				add_handlers(event);
+			}
+			bench::do_not_optimize(events);
+		});
+		benchmark.reportRate("subscribe", subscribe_time, EVENT_COUNT * handler_count);
+	}
+
+	TEvent event;
+	add_handlers(event);
+	double dispatch_time = benchmark.measure([&]() {
+		for (size_t i = 0; i < CALL_COUNT; i++) {
+			event((int)i);
+		}
+		bench::do_not_optimize(sum);
+	});
+	benchmark.reportRate("dispatch", dispatch_time, CALL_COUNT);
+
+	// widgets have a lot of events, most of them are never subscribed to
+	std::vector<TEvent> events(EVENT_COUNT);
+	if (handler_count > 0) {
+		for (size_t i = 0; i < EVENT_COUNT; i += 10) {
+			add_handlers(events[i]);
+		}
+	}
+	double sparse_dispatch_time = benchmark.measure([&]() {
+		for (size_t i = 0; i < EVENT_COUNT; i++) {
+			events[i]((int)i);
+		}
+		bench::do_not_optimize(sum);
+	});
+	benchmark.reportRate("sparse_dispatch", sparse_dispatch_time, EVENT_COUNT);
+}
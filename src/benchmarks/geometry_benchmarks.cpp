@@ -0,0 +1,210 @@
+#include "benchmarks/geometry_benchmarks.h"
+#include "common/utils.h"
+
+GeometryBenchmarks::GeometryBenchmarks(
+	const std::string& name, const bench::BenchmarkSettings& settings
+) : BenchmarkModule(name, settings) {
+	for (size_t point_count : { 1000, 100000 }) {
+		std::string count_str = std::to_string(point_count);
+		addBenchmark("transform_" + count_str, [=, this](bench::Benchmark& benchmark) { transformBenchmark(benchmark, point_count); });
+		addBenchmark("side_" + count_str, [=, this](bench::Benchmark& benchmark) { sideBenchmark(benchmark, point_count); });
+		addBenchmark("intersect_" + count_str, [=, this](bench::Benchmark& benchmark) { intersectBenchmark(benchmark, point_count); });
+		addBenchmark("vertex_query_" + count_str, [=, this](bench::Benchmark& benchmark) { vertexQueryBenchmark(benchmark, point_count); });
+		addBenchmark("simplify_" + count_str, [=, this](bench::Benchmark& benchmark) { simplifyBenchmark(benchmark, point_count); });
+		addBenchmark("instancing_" + count_str, [=, this](bench::Benchmark& benchmark) { instancingBenchmark(benchmark, point_count); });
+	}
+}
+
+void GeometryBenchmarks::transformBenchmark(bench::Benchmark& benchmark, size_t point_count) {
+	utils::batch::Points points = createPoints(point_count);
+	std::vector<b2Vec2> points_aos(point_count);
+	for (size_t i = 0; i < point_count; i++) {
+		points_aos[i] = points.getb2(i);
+	}
+	b2Transform transform(b2Vec2(3.0f, -2.0f), b2Rot(0.5f));
+	std::vector<b2Vec2> result_aos(point_count);
+	utils::batch::Points result(point_count);
+
+	double per_point_time = benchmark.measure([&]() {
+		for (size_t i = 0; i < point_count; i++) {
+			result_aos[i] = b2Mul(transform, points_aos[i]);
+		}
+	});
+	benchmark.reportRate("per_point", per_point_time, point_count);
+	double batched_time = benchmark.measure([&]() {
+		utils::batch::transform_points(points.x, points.y, transform, result.x, result.y);
+	});
+	benchmark.reportRate("batched", batched_time, point_count);
+
+	double rotate_per_point_time = benchmark.measure([&]() {
+		for (size_t i = 0; i < point_count; i++) {
+			result_aos[i] = utils::rotate_point(points_aos[i], b2Vec2(1.0f, 1.0f), 0.5f);
+		}
+	});
+	benchmark.reportRate("rotate_per_point", rotate_per_point_time, point_count);
+	double rotate_batched_time = benchmark.measure([&]() {
+		utils::batch::rotate_points(points.x, points.y, 1.0f, 1.0f, 0.5f, result.x, result.y);
+	});
+	benchmark.reportRate("rotate_batched", rotate_batched_time, point_count);
+}
+
+void GeometryBenchmarks::sideBenchmark(bench::Benchmark& benchmark, size_t point_count) {
+	utils::batch::Points points = createPoints(point_count);
+	std::vector<sf::Vector2f> points_aos(point_count);
+	for (size_t i = 0; i < point_count; i++) {
+		points_aos[i] = points.getsf(i);
+	}
+	sf::Vector2f p1(-1.0f, 0.5f);
+	sf::Vector2f p2(2.0f, 1.5f);
+	std::vector<uint8_t> result(point_count);
+
+	double per_point_time = benchmark.measure([&]() {
+		for (size_t i = 0; i < point_count; i++) {
+			result[i] = utils::right_side(points_aos[i], p1, p2);
+		}
+	});
+	benchmark.reportRate("per_point", per_point_time, point_count);
+	double batched_time = benchmark.measure([&]() {
+		utils::batch::right_side(points.x, points.y, p1.x, p1.y, p2.x, p2.y, result);
+	});
+	benchmark.reportRate("batched", batched_time, point_count);
+}
+
+void GeometryBenchmarks::intersectBenchmark(bench::Benchmark& benchmark, size_t point_count) {
+	// polygon outline with the first point repeated, segment from the center
+	// to a point outside hits nothing until the last edges, so all of them are checked
+	utils::batch::Points points = createPoints(point_count);
+	points.push_back(points.x[0], points.y[0]);
+	std::vector<sf::Vector2f> points_aos(points.size());
+	for (size_t i = 0; i < points.size(); i++) {
+		points_aos[i] = points.getsf(i);
+	}
+	sf::Vector2f v1(0.0f, 0.0f);
+	sf::Vector2f v2(points.x[point_count - 1] * 2.0f, points.y[point_count - 1] * 2.0f);
+	size_t edge_count = point_count;
+	ptrdiff_t found = -1;
+
+	double per_edge_time = benchmark.measure([&]() {
+		found = -1;
+		for (size_t i = 0; i < edge_count; i++) {
+			sf::Vector2f intersection;
+			if (utils::line_intersect(v1, v2, points_aos[i], points_aos[i + 1], 0.000001f, intersection)) {
+				found = i;
+				break;
+			}
+		}
+	});
+	benchmark.reportRate("per_edge", per_edge_time, edge_count);
+	double batched_time = benchmark.measure([&]() {
+		sf::Vector2f intersection;
+		found = utils::batch::line_intersect_first(
+			v1.x, v1.y, v2.x, v2.y,
+			std::span<const float>(points.x.data(), edge_count),
+			std::span<const float>(points.y.data(), edge_count),
+			std::span<const float>(points.x.data() + 1, edge_count),
+			std::span<const float>(points.y.data() + 1, edge_count),
+			0.000001f, intersection
+		);
+	});
+	benchmark.reportRate("batched", batched_time, edge_count);
+}
+
+void GeometryBenchmarks::vertexQueryBenchmark(bench::Benchmark& benchmark, size_t point_count) {
+	const size_t QUERY_COUNT = 100;
+	Simulation simulation;
+	std::vector<b2Vec2> vertices(point_count);
+	for (size_t i = 0; i < point_count; i++) {
+		float x = (float)i * 0.1f;
+		vertices[i] = b2Vec2(x, sin(x * 0.1f) * 10.0f);
+	}
+	ChainObject* chain = simulation.createChain("chain", b2Vec2(0.0f, 0.0f), 0.3f, vertices, sf::Color::White);
+	// small rect, like hover highlight or box select of a few vertices
+	auto get_query_rect = [&](size_t query_i) {
+		b2Vec2 center = chain->getGlobalVertexPos(query_i * point_count / QUERY_COUNT);
+		b2AABB aabb;
+		aabb.lowerBound = center - b2Vec2(0.5f, 0.5f);
+		aabb.upperBound = center + b2Vec2(0.5f, 0.5f);
+		return aabb;
+	};
+	size_t found = 0;
+
+	double linear_time = benchmark.measure([&]() {
+		for (size_t query_i = 0; query_i < QUERY_COUNT; query_i++) {
+			b2AABB aabb = get_query_rect(query_i);
+			sf::FloatRect rect(
+				aabb.lowerBound.x, aabb.lowerBound.y,
+				aabb.upperBound.x - aabb.lowerBound.x, aabb.upperBound.y - aabb.lowerBound.y
+			);
+			utils::batch::Points global_vertices = chain->getGlobalVertices();
+			std::vector<uint8_t> inside(global_vertices.size());
+			utils::batch::contains_point(global_vertices.x, global_vertices.y, rect, inside);
+			for (size_t i = 0; i < inside.size(); i++) {
+				found += inside[i];
+			}
+		}
+	});
+	benchmark.reportRate("linear", linear_time, QUERY_COUNT);
+	double build_time = benchmark.measure([&]() {
+		VertexGrid grid;
+		grid.build(vertices);
+	});
+	benchmark.reportTime("grid_build", build_time);
+	double grid_time = benchmark.measure([&]() {
+		for (size_t query_i = 0; query_i < QUERY_COUNT; query_i++) {
+			found += chain->getVerticesInRect(get_query_rect(query_i)).size();
+		}
+	});
+	benchmark.reportRate("grid", grid_time, QUERY_COUNT);
+}
+
+void GeometryBenchmarks::simplifyBenchmark(bench::Benchmark& benchmark, size_t point_count) {
+	std::vector<sf::Vector2f> points(point_count);
+	for (size_t i = 0; i < point_count; i++) {
+		float x = (float)i * 0.1f;
+		points[i] = sf::Vector2f(x, sin(x * 0.1f) * 10.0f + sin(x * 3.0f) * 0.2f);
+	}
+	std::vector<float> importance;
+	double importance_time = benchmark.measure([&]() {
+		importance = simplification::douglas_peucker_importance(points);
+	});
+	benchmark.reportRate("importance", importance_time, point_count);
+	// same tolerances as chain level of detail, each one simplified from the same importance
+	size_t kept = 0;
+	double levels_time = benchmark.measure([&]() {
+		for (float tolerance = 0.025f; tolerance < 100.0f; tolerance *= 2.0f) {
+			kept += simplification::simplify(importance, tolerance).size();
+		}
+	});
+	benchmark.reportTime("levels", levels_time);
+}
+
+void GeometryBenchmarks::instancingBenchmark(bench::Benchmark& benchmark, size_t shape_count) {
+	std::vector<CircleNotchShape> shapes;
+	shapes.reserve(shape_count);
+	for (size_t i = 0; i < shape_count; i++) {
+		shapes.emplace_back(0.5f + (float)(i % 5) * 0.1f, 30, 4);
+		shapes.back().setPosition((float)(i % 300), (float)(i / 300));
+		shapes.back().setRotation((float)i);
+	}
+	InstancedShapes instanced_shapes;
+	// vertices of all balls in a frame, drawing itself is not measured
+	double expand_time = benchmark.measure([&]() {
+		instanced_shapes.clear();
+		for (const CircleNotchShape& shape : shapes) {
+			instanced_shapes.add(shape);
+		}
+	});
+	benchmark.reportRate("expand", expand_time, shape_count);
+	benchmark.report("batches", static_cast<double>(instanced_shapes.getBatchCount()), "batches");
+}
+
+utils::batch::Points GeometryBenchmarks::createPoints(size_t point_count) {
+	// star shaped outline around the origin
+	utils::batch::Points points(point_count);
+	for (size_t i = 0; i < point_count; i++) {
+		float angle = (float)i / point_count * 2.0f * b2_pi;
+		float radius = i % 2 == 0 ? 10.0f : 8.0f;
+		points.set(i, cos(angle) * radius, sin(angle) * radius);
+	}
+	return points;
+}
@@ -0,0 +1,75 @@
+#include "benchmarks/logging_benchmarks.h"
+#include "benchmarks/decomposition_benchmarks.h"
+#include "benchmarks/serializer_benchmarks.h"
+#include "common/history.h"
+
+LoggingBenchmarks::LoggingBenchmarks(
+	const std::string& name, const bench::BenchmarkSettings& settings
+) : BenchmarkModule(name, settings) {
+	addBenchmark("recut", [this](bench::Benchmark& benchmark) { recutBenchmark(benchmark); });
+	addBenchmark("serialize", [this](bench::Benchmark& benchmark) { serializeBenchmark(benchmark); });
+	addBenchmark("history", [this](bench::Benchmark& benchmark) { historyBenchmark(benchmark); });
+}
+
+void LoggingBenchmarks::recutBenchmark(bench::Benchmark& benchmark) {
+	SplittablePolygon terrain = DecompositionBenchmarks::createTerrain(200);
+	SplittablePolygon polygon;
+	measureStages(benchmark, "recut", [&]() {
+		return benchmark.measureWithSetup(
+			[&]() {
+				polygon = terrain;
+				SplittablePolygon::getDecompositionCache().clear();
+			},
+			[&]() {
+				polygon.recut();
+			}
+		);
+	});
+}
+
+void LoggingBenchmarks::serializeBenchmark(bench::Benchmark& benchmark) {
+	Simulation simulation;
+	simulation.deserialize(SerializerBenchmarks::createSyntheticLevel(1000));
+	measureStages(benchmark, "serialize", [&]() {
+		return benchmark.measure([&]() {
+			std::string str = simulation.serialize();
+			bench::do_not_optimize(str);
+		});
+	});
+}
+
+void LoggingBenchmarks::historyBenchmark(bench::Benchmark& benchmark) {
+	std::string state = "state";
+	History<std::string> history(
+		"Benchmark",
+		[&]() { return state; },
+		[&](const std::string& value) { state = value; }
+	);
+	history.save("Base");
+	measureStages(benchmark, "history", [&]() {
+		return benchmark.measure([&]() {
+			state += "x";
+			history.save("Normal");
+			history.undo();
+		});
+	});
+}
+
+void LoggingBenchmarks::measureStages(
+	bench::Benchmark& benchmark, const std::string& tag, const std::function<double(void)>& measure
+) {
+#if LOGGING
+	{
+		// messages are built and passed to the logger, which drops them by itself,
+		// that's what logging cost before tags were checked first
+		logging::EnableTag enable_tag(tag);
+		benchmark.reportTime("logged", measure());
+	}
+	{
+		logging::DisableTag disable_tag(tag);
+		benchmark.reportTime("tag_disabled", measure());
+	}
+#else
+	benchmark.reportTime("compiled_out", measure());
+#endif
+}
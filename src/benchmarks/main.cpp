@@ -0,0 +1,49 @@
+#include "benchmarks/benchmarks.h"
+#include "common/log.h"
+#include <iostream>
+
+// usage: RUN_BENCHMARKS [output file] [filter]
+// filter is matched against "Module/benchmark" names
+int main(int argc, char* argv[]) {
+    logging::DisableTag disable_serialize_tag("serialize");
+    logging::DisableTag disable_recut_tag("recut");
+    logging::DisableTag disable_saveload_tag("saveload");
+    logging::DisableTag disable_history("history");
+
+    std::filesystem::path output_path = "benchmark_results.json";
+    bench::BenchmarkSettings settings;
+    if (argc > 1) {
+        output_path = argv[1];
+    }
+    if (argc > 2) {
+        settings.filter = argv[2];
+    }
+    std::vector<bench::BenchmarkResult> results;
+    auto run_module = [&](bench::BenchmarkModule& module) {
+        std::vector<bench::BenchmarkResult> module_results = module.run();
+        results.insert(results.end(), module_results.begin(), module_results.end());
+    };
+    CompVectorBenchmarks compvector_benchmarks("CompVector", settings);
+    run_module(compvector_benchmarks);
+    DecompositionBenchmarks decomposition_benchmarks("Decomposition", settings);
+    run_module(decomposition_benchmarks);
+    EventBenchmarks event_benchmarks("Event", settings);
+    run_module(event_benchmarks);
+    std::cout << "Geometry kernels: " << utils::batch::get_instruction_set() << "\n";
+    GeometryBenchmarks geometry_benchmarks("Geometry", settings);
+    run_module(geometry_benchmarks);
+    LoggingBenchmarks logging_benchmarks("Logging", settings);
+    run_module(logging_benchmarks);
+    SerializerBenchmarks serializer_benchmarks("Serializer", settings);
+    run_module(serializer_benchmarks);
+    TransformBenchmarks transform_benchmarks("Transform", settings);
+    run_module(transform_benchmarks);
+    try {
+        bench::write_results(results, output_path);
+        std::cout << "Results written to " << output_path.string() << "\n";
+    } catch (std::exception exc) {
+        std::cout << "ERROR: " << exc.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include "benchmarks/serializer_benchmarks.h"
+#include "simulation/level_index.h"
+#include <algorithm>
+
+SerializerBenchmarks::SerializerBenchmarks(
+	const std::string& name, const bench::BenchmarkSettings& settings
+) : BenchmarkModule(name, settings) {
+	std::vector<std::filesystem::path> level_files;
+	if (std::filesystem::exists("levels")) {
+		for (const auto& entry : std::filesystem::directory_iterator("levels")) {
+			if (entry.is_regular_file() && entry.path().extension() == ".txt") {
+				level_files.push_back(entry.path());
+			}
+		}
+	}
+	std::sort(level_files.begin(), level_files.end());
+	for (const std::filesystem::path& path : level_files) {
+		std::string benchmark_name = "level_" + path.stem().string();
+		addBenchmark(benchmark_name, [=, this](bench::Benchmark& benchmark) { fileBenchmark(benchmark, path); });
+	}
+	for (size_t object_count : { 1000, 10000, 100000 }) {
+		std::string benchmark_name = "synthetic_" + std::to_string(object_count);
+		addBenchmark(benchmark_name, [=, this](bench::Benchmark& benchmark) { syntheticBenchmark(benchmark, object_count); });
+	}
+}
+
+void SerializerBenchmarks::levelBenchmark(bench::Benchmark& benchmark, const std::string& str) {
+	const std::filesystem::path tmp_dir = "tests/tmp";
+	if (!std::filesystem::exists(tmp_dir)) {
+		std::filesystem::create_directories(tmp_dir);
+	}
+	const std::filesystem::path temp_filename = tmp_dir / "serializer_benchmark.txt";
+	TokenReader reader(str);
+	const std::vector<WordToken>& tokens = reader.getTokens();
+	// editor levels start with a camera block that Simulation doesn't know about
+	ptrdiff_t start = findSimulationToken(tokens);
+	Simulation simulation;
+	{
+		TokenReader tr(&tokens, start);
+		simulation.deserialize(tr);
+	}
+	size_t object_count = simulation.getAllSize();
+	std::string serialized = simulation.serialize();
+	benchmark.report("input_size", static_cast<double>(str.size()), "bytes");
+	benchmark.report("object_count", static_cast<double>(object_count), "objects");
+
+	double tokenize_time = benchmark.measure([&]() {
+		TokenReader tr(str);
+		bench::do_not_optimize(tr);
+	});
+	benchmark.reportThroughput("tokenize", tokenize_time, str.size(), object_count);
+
+	double index_time = benchmark.measure([&]() {
+		LevelIndex index(str);
+		bench::do_not_optimize(index);
+	});
+	benchmark.reportThroughput("index", index_time, str.size(), object_count);
+
+	// object deserializers create bodies while reading parameters,
+	// so parsing and building the world can only be measured together
+	Simulation build_simulation;
+	double parse_build_time = benchmark.measureWithSetup(
+		[&]() {
+			build_simulation.reset();
+		},
+		[&]() {
+			TokenReader tr(&tokens, start);
+			build_simulation.deserialize(tr);
+		}
+	);
+	benchmark.reportThroughput("parse_build", parse_build_time, str.size(), object_count);
+
+	double serialize_time = benchmark.measure([&]() {
+		std::string result = simulation.serialize();
+		bench::do_not_optimize(result);
+	});
+	benchmark.reportThroughput("serialize", serialize_time, serialized.size(), object_count);
+
+	double write_time = benchmark.measure([&]() {
+		utils::str_to_file(serialized, temp_filename);
+	});
+	benchmark.reportThroughput("write", write_time, serialized.size(), object_count);
+
+	double load_time = tokenize_time + parse_build_time;
+	benchmark.reportThroughput("load_total", load_time, str.size(), object_count);
+	double save_time = serialize_time + write_time;
+	benchmark.reportThroughput("save_total", save_time, serialized.size(), object_count);
+	std::filesystem::remove(temp_filename);
+}
+
+void SerializerBenchmarks::fileBenchmark(bench::Benchmark& benchmark, const std::filesystem::path& path) {
+	std::string str = utils::file_to_str(path);
+	levelBenchmark(benchmark, str);
+}
+
+void SerializerBenchmarks::syntheticBenchmark(bench::Benchmark& benchmark, size_t object_count) {
+	std::string str = createSyntheticLevel(object_count);
+	levelBenchmark(benchmark, str);
+}
+
+std::string SerializerBenchmarks::createSyntheticLevel(size_t object_count) {
+	Simulation simulation;
+	size_t row_size = static_cast<size_t>(std::ceil(std::sqrt(static_cast<float>(object_count))));
+	std::vector<b2Vec2> chain_vertices = {
+		b2Vec2(-1.0f, 0.0f),
+		b2Vec2(0.0f, -0.5f),
+		b2Vec2(1.0f, 0.0f),
+	};
+	GameObject* parent = nullptr;
+	for (size_t i = 0; i < object_count; i++) {
+		std::string name = "object" + std::to_string(i);
+		b2Vec2 pos = b2Vec2((i % row_size) * 3.0f, (i / row_size) * 3.0f);
+		float angle = utils::to_radians(static_cast<float>(i % 360));
+		GameObject* object = nullptr;
+		switch (i % 4) {
+			case 0:
+				object = simulation.createBox(name, pos, angle, b2Vec2(1.0f, 0.5f), sf::Color::Green);
+				break;
+			case 1:
+				object = simulation.createBall(name, pos, 0.5f, sf::Color::Yellow, sf::Color::Black);
+				break;
+			case 2:
+				object = simulation.createRegularPolygon(name, pos, angle, 6, 1.0f, sf::Color::Red);
+				break;
+			case 3:
+				object = simulation.createChain(name, pos, angle, chain_vertices, sf::Color::White);
+				break;
+		}
+		// some of the objects are parented to have parent_id in the output
+		if (i % 10 == 0) {
+			parent = object;
+		} else if (i % 10 == 1) {
+			object->setParent(parent);
+		}
+	}
+	return simulation.serialize();
+}
+
+ptrdiff_t SerializerBenchmarks::findSimulationToken(const std::vector<WordToken>& tokens) {
+	for (size_t i = 0; i < tokens.size(); i++) {
+		if (tokens[i].str == "simulation") {
+			return i;
+		}
+	}
+	throw std::runtime_error("Simulation block not found");
+}
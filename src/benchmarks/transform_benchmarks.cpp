@@ -0,0 +1,71 @@
+#include "benchmarks/transform_benchmarks.h"
+
+TransformBenchmarks::TransformBenchmarks(
+	const std::string& name, const bench::BenchmarkSettings& settings
+) : BenchmarkModule(name, settings) {
+	for (size_t object_count : { 500, 5000 }) {
+		std::string benchmark_name = "selection_" + std::to_string(object_count);
+		addBenchmark(benchmark_name, [=, this](bench::Benchmark& benchmark) { transformBenchmark(benchmark, object_count); });
+	}
+}
+
+void TransformBenchmarks::transformBenchmark(bench::Benchmark& benchmark, size_t object_count) {
+	const size_t GROUP_SIZE = 4;
+	const size_t FRAME_COUNT = 10;
+	Simulation simulation;
+	// groups of a parent with children, only parents are moved, like in the editor
+	CompVector<GameObject*> selected;
+	GameObject* group_parent = nullptr;
+	for (size_t i = 0; i < object_count; i++) {
+		b2Vec2 pos((float)(i % 100), (float)(i / 100));
+		GameObject* box = simulation.createBox("box" + std::to_string(i), pos, 0.0f, b2Vec2(0.5f, 0.5f), sf::Color::White);
+		if (i % GROUP_SIZE == 0) {
+			group_parent = box;
+			selected.add(box);
+		} else {
+			box->setParent(group_parent);
+		}
+	}
+	for (GameObject* object : selected) {
+		object->orig_pos = object->getGlobalPosition();
+		object->orig_angle = object->getGlobalRotation();
+	}
+	b2Vec2 pivot(50.0f, (float)(object_count / 200));
+
+	// what the move and rotate tools did before, one object at a time
+	double move_per_object_time = benchmark.measure([&]() {
+		for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+			b2Vec2 offset(0.1f * frame, 0.0f);
+			for (GameObject* object : selected) {
+				object->setGlobalPosition(object->orig_pos + offset);
+			}
+		}
+	});
+	benchmark.reportRate("move_per_object", move_per_object_time, FRAME_COUNT * object_count);
+	double move_batched_time = benchmark.measure([&]() {
+		for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+			b2Vec2 offset(0.1f * frame, 0.0f);
+			simulation.offsetObjects(selected, offset);
+		}
+	});
+	benchmark.reportRate("move_batched", move_batched_time, FRAME_COUNT * object_count);
+
+	double rotate_per_object_time = benchmark.measure([&]() {
+		for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+			float angle = 0.1f * frame;
+			for (GameObject* object : selected) {
+				b2Vec2 new_pos = utils::rotate_point(object->orig_pos, pivot, angle);
+				object->setGlobalPosition(new_pos);
+				object->setGlobalAngle(object->orig_angle + angle);
+			}
+		}
+	});
+	benchmark.reportRate("rotate_per_object", rotate_per_object_time, FRAME_COUNT * object_count);
+	double rotate_batched_time = benchmark.measure([&]() {
+		for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+			float angle = 0.1f * frame;
+			simulation.rotateObjects(selected, pivot, angle);
+		}
+	});
+	benchmark.reportRate("rotate_batched", rotate_batched_time, FRAME_COUNT * object_count);
+}
@@ -0,0 +1,325 @@
+#include "common/batch_geometry.h"
+#include "common/batch_geometry_kernels.h"
+#include <cassert>
+#include <cmath>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace utils::batch {
+
+	static bool cpu_supports_avx2() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		// AVX2 flag, and OS saving AVX registers on context switches
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) {
+			return false;
+		}
+		__cpuid(info, 1);
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) {
+			return false;
+		}
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+		return __builtin_cpu_supports("avx2");
+#else
+		return false;
+#endif
+	}
+
+	static const Kernels* get_kernels(InstructionSet instruction_set) {
+		switch (instruction_set) {
+			case InstructionSet::SSE2: return get_sse2_kernels();
+			case InstructionSet::AVX2: return cpu_supports_avx2() ? get_avx2_kernels() : nullptr;
+			default: return nullptr;
+		}
+	}
+
+	struct KernelsState {
+		InstructionSet instruction_set = InstructionSet::SCALAR;
+		// null for scalar, then only the scalar loops run
+		const Kernels* kernels = nullptr;
+	};
+
+	static KernelsState& get_state() {
+		static KernelsState state = []() {
+			std::vector<InstructionSet> supported = get_supported_instruction_sets();
+			KernelsState best;
+			best.instruction_set = supported.back();
+			best.kernels = get_kernels(best.instruction_set);
+			return best;
+		}();
+		return state;
+	}
+
+	Points::Points(size_t size) {
+		resize(size);
+	}
+
+	size_t Points::size() const {
+		return x.size();
+	}
+
+	void Points::resize(size_t size) {
+		x.resize(size);
+		y.resize(size);
+	}
+
+	void Points::set(size_t index, float px, float py) {
+		x[index] = px;
+		y[index] = py;
+	}
+
+	void Points::push_back(float px, float py) {
+		x.push_back(px);
+		y.push_back(py);
+	}
+
+	b2Vec2 Points::getb2(size_t index) const {
+		return b2Vec2(x[index], y[index]);
+	}
+
+	sf::Vector2f Points::getsf(size_t index) const {
+		return sf::Vector2f(x[index], y[index]);
+	}
+
+	const char* get_instruction_set() {
+		switch (get_state().instruction_set) {
+			case InstructionSet::SSE2: return "SSE2";
+			case InstructionSet::AVX2: return "AVX2";
+			default: return "scalar";
+		}
+	}
+
+	std::vector<InstructionSet> get_supported_instruction_sets() {
+		std::vector<InstructionSet> result = { InstructionSet::SCALAR };
+		for (InstructionSet instruction_set : { InstructionSet::SSE2, InstructionSet::AVX2 }) {
+			if (get_kernels(instruction_set)) {
+				result.push_back(instruction_set);
+			}
+		}
+		return result;
+	}
+
+	bool set_instruction_set(InstructionSet instruction_set) {
+		const Kernels* kernels = get_kernels(instruction_set);
+		if (!kernels && instruction_set != InstructionSet::SCALAR) {
+			return false;
+		}
+		KernelsState& state = get_state();
+		state.instruction_set = instruction_set;
+		state.kernels = kernels;
+		return true;
+	}
+
+	void get_line_D(
+		std::span<const float> x, std::span<const float> y,
+		float p1x, float p1y, float p2x, float p2y,
+		std::span<float> result
+	) {
+		assert(x.size() == y.size() && result.size() >= x.size());
+		size_t count = x.size();
+		float dx = p2x - p1x;
+		float dy = p2y - p1y;
+		size_t i = 0;
+		if (const Kernels* kernels = get_state().kernels) {
+			i = kernels->get_line_D(x.data(), y.data(), count, p1x, p1y, p2x, p2y, result.data());
+		}
+		for (; i < count; i++) {
+			result[i] = dx * (y[i] - p1y) - dy * (x[i] - p1x);
+		}
+	}
+
+	// D > 0 or D < 0 depending on the sign
+	static void line_side(
+		std::span<const float> x, std::span<const float> y,
+		float p1x, float p1y, float p2x, float p2y,
+		bool left, std::span<uint8_t> result
+	) {
+		assert(x.size() == y.size() && result.size() >= x.size());
+		size_t count = x.size();
+		float dx = p2x - p1x;
+		float dy = p2y - p1y;
+		size_t i = 0;
+		if (const Kernels* kernels = get_state().kernels) {
+			i = kernels->line_side(x.data(), y.data(), count, p1x, p1y, p2x, p2y, left, result.data());
+		}
+		for (; i < count; i++) {
+			float D = dx * (y[i] - p1y) - dy * (x[i] - p1x);
+			result[i] = left ? D > 0 : D < 0;
+		}
+	}
+
+	void left_side(
+		std::span<const float> x, std::span<const float> y,
+		float p1x, float p1y, float p2x, float p2y,
+		std::span<uint8_t> result
+	) {
+		line_side(x, y, p1x, p1y, p2x, p2y, true, result);
+	}
+
+	void right_side(
+		std::span<const float> x, std::span<const float> y,
+		float p1x, float p1y, float p2x, float p2y,
+		std::span<uint8_t> result
+	) {
+		line_side(x, y, p1x, p1y, p2x, p2y, false, result);
+	}
+
+	void distance_to_line(
+		std::span<const float> x, std::span<const float> y,
+		float p1x, float p1y, float p2x, float p2y,
+		std::span<float> result
+	) {
+		assert(x.size() == y.size() && result.size() >= x.size());
+		size_t count = x.size();
+		float dx = p2x - p1x;
+		float dy = p2y - p1y;
+		float length = b2Vec2(dx, dy).Length();
+		size_t i = 0;
+		if (const Kernels* kernels = get_state().kernels) {
+			i = kernels->distance_to_line(x.data(), y.data(), count, p1x, p1y, p2x, p2y, length, result.data());
+		}
+		for (; i < count; i++) {
+			float D = dx * (y[i] - p1y) - dy * (x[i] - p1x);
+			result[i] = std::abs(D) / length;
+		}
+	}
+
+	void line_project(
+		std::span<const float> x, std::span<const float> y,
+		float p1x, float p1y, float p2x, float p2y,
+		std::span<float> result_x, std::span<float> result_y
+	) {
+		assert(x.size() == y.size() && result_x.size() >= x.size() && result_y.size() >= x.size());
+		size_t count = x.size();
+		float bx = p2x - p1x;
+		float by = p2y - p1y;
+		float bb = bx * bx + by * by;
+		size_t i = 0;
+		if (const Kernels* kernels = get_state().kernels) {
+			i = kernels->line_project(x.data(), y.data(), count, p1x, p1y, p2x, p2y, result_x.data(), result_y.data());
+		}
+		for (; i < count; i++) {
+			float ax = x[i] - p1x;
+			float ay = y[i] - p1y;
+			float t = (ax * bx + ay * by) / bb;
+			result_x[i] = p1x + t * bx;
+			result_y[i] = p1y + t * by;
+		}
+	}
+
+	ptrdiff_t line_intersect_first(
+		float v1x, float v1y, float v2x, float v2y,
+		std::span<const float> x1, std::span<const float> y1,
+		std::span<const float> x2, std::span<const float> y2,
+		float epsilon, sf::Vector2f& intersection
+	) {
+		assert(x1.size() == y1.size() && x2.size() >= x1.size() && y2.size() >= x1.size());
+		size_t count = x1.size();
+		float rx = v2x - v1x;
+		float ry = v2y - v1y;
+		float abs_epsilon = std::abs(epsilon);
+		if (std::sqrt(rx * rx + ry * ry) <= abs_epsilon) {
+			return -1;
+		}
+		float t_min = 0.0f + epsilon;
+		float t_max = 1.0f - epsilon;
+		auto hit_scalar = [&](size_t i, float& t) {
+			float sx = x2[i] - x1[i];
+			float sy = y2[i] - y1[i];
+			if (std::sqrt(sx * sx + sy * sy) <= abs_epsilon) {
+				return false;
+			}
+			float qpx = x1[i] - v1x;
+			float qpy = y1[i] - v1y;
+			float rs = rx * sy - ry * sx;
+			float qps = qpx * sy - qpy * sx;
+			float qpr = qpx * ry - qpy * rx;
+			t = qps / rs;
+			float u = qpr / rs;
+			return std::abs(rs) >= epsilon && t >= t_min && t <= t_max && u >= t_min && u <= t_max;
+		};
+		size_t i = 0;
+		if (const Kernels* kernels = get_state().kernels) {
+			// first hit is found by the scalar loop below
+			i = kernels->line_intersect_first(v1x, v1y, v2x, v2y, x1.data(), y1.data(), x2.data(), y2.data(), count, epsilon);
+		}
+		for (; i < count; i++) {
+			float t;
+			if (hit_scalar(i, t)) {
+				intersection = sf::Vector2f(v1x + t * rx, v1y + t * ry);
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	void rotate_points(
+		std::span<const float> x, std::span<const float> y,
+		float pivot_x, float pivot_y, float angle,
+		std::span<float> result_x, std::span<float> result_y
+	) {
+		assert(x.size() == y.size() && result_x.size() >= x.size() && result_y.size() >= x.size());
+		size_t count = x.size();
+		float c = std::cos(angle);
+		float s = std::sin(angle);
+		size_t i = 0;
+		if (const Kernels* kernels = get_state().kernels) {
+			i = kernels->rotate_points(x.data(), y.data(), count, pivot_x, pivot_y, c, s, result_x.data(), result_y.data());
+		}
+		for (; i < count; i++) {
+			float rx = x[i] - pivot_x;
+			float ry = y[i] - pivot_y;
+			result_x[i] = (c * rx - s * ry) + pivot_x;
+			result_y[i] = (s * rx + c * ry) + pivot_y;
+		}
+	}
+
+	void transform_points(
+		std::span<const float> x, std::span<const float> y,
+		const b2Transform& transform,
+		std::span<float> result_x, std::span<float> result_y
+	) {
+		assert(x.size() == y.size() && result_x.size() >= x.size() && result_y.size() >= x.size());
+		size_t count = x.size();
+		float c = transform.q.c;
+		float s = transform.q.s;
+		float px = transform.p.x;
+		float py = transform.p.y;
+		size_t i = 0;
+		if (const Kernels* kernels = get_state().kernels) {
+			i = kernels->transform_points(x.data(), y.data(), count, c, s, px, py, result_x.data(), result_y.data());
+		}
+		for (; i < count; i++) {
+			result_x[i] = (c * x[i] - s * y[i]) + px;
+			result_y[i] = (s * x[i] + c * y[i]) + py;
+		}
+	}
+
+	void contains_point(
+		std::span<const float> x, std::span<const float> y,
+		const sf::FloatRect& rect,
+		std::span<uint8_t> result
+	) {
+		assert(x.size() == y.size() && result.size() >= x.size());
+		size_t count = x.size();
+		float left = rect.left;
+		float right = rect.left + rect.width;
+		float top = rect.top;
+		float bottom = rect.top + rect.height;
+		size_t i = 0;
+		if (const Kernels* kernels = get_state().kernels) {
+			i = kernels->contains_point(x.data(), y.data(), count, left, right, top, bottom, result.data());
+		}
+		for (; i < count; i++) {
+			result[i] = x[i] >= left && x[i] <= right && y[i] >= top && y[i] <= bottom;
+		}
+	}
+
+}
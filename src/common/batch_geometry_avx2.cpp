@@ -0,0 +1,50 @@
+#include "common/batch_geometry_simd.h"
+
+// compiled with AVX2 enabled when B2E_AVX2 is on, the kernels are
+// only called if the CPU supports AVX2, which is checked in batch_geometry.cpp
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BATCH_AVX2
+#endif
+
+namespace utils::batch {
+
+#if defined(BATCH_AVX2)
+
+	namespace {
+
+		struct Avx2 {
+			using vfloat = __m256;
+			static const size_t WIDTH = 8;
+			static inline vfloat vload(const float* ptr) { return _mm256_loadu_ps(ptr); }
+			static inline void vstore(float* ptr, vfloat v) { _mm256_storeu_ps(ptr, v); }
+			static inline vfloat vset(float value) { return _mm256_set1_ps(value); }
+			static inline vfloat vadd(vfloat a, vfloat b) { return _mm256_add_ps(a, b); }
+			static inline vfloat vsub(vfloat a, vfloat b) { return _mm256_sub_ps(a, b); }
+			static inline vfloat vmul(vfloat a, vfloat b) { return _mm256_mul_ps(a, b); }
+			static inline vfloat vdiv(vfloat a, vfloat b) { return _mm256_div_ps(a, b); }
+			static inline vfloat vsqrt(vfloat a) { return _mm256_sqrt_ps(a); }
+			static inline vfloat vabs(vfloat a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+			static inline vfloat vand(vfloat a, vfloat b) { return _mm256_and_ps(a, b); }
+			static inline vfloat vgt(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+			static inline vfloat vlt(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+			static inline vfloat vge(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+			static inline vfloat vle(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+			static inline int vmask(vfloat a) { return _mm256_movemask_ps(a); }
+		};
+
+	}
+
+	const Kernels* get_avx2_kernels() {
+		return make_kernels<Avx2>();
+	}
+
+#else
+
+	const Kernels* get_avx2_kernels() {
+		return nullptr;
+	}
+
+#endif
+
+}
@@ -0,0 +1,48 @@
+#include "common/batch_geometry_simd.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BATCH_SSE2
+#endif
+
+namespace utils::batch {
+
+#if defined(BATCH_SSE2)
+
+	namespace {
+
+		struct Sse2 {
+			using vfloat = __m128;
+			static const size_t WIDTH = 4;
+			static inline vfloat vload(const float* ptr) { return _mm_loadu_ps(ptr); }
+			static inline void vstore(float* ptr, vfloat v) { _mm_storeu_ps(ptr, v); }
+			static inline vfloat vset(float value) { return _mm_set1_ps(value); }
+			static inline vfloat vadd(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+			static inline vfloat vsub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+			static inline vfloat vmul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+			static inline vfloat vdiv(vfloat a, vfloat b) { return _mm_div_ps(a, b); }
+			static inline vfloat vsqrt(vfloat a) { return _mm_sqrt_ps(a); }
+			static inline vfloat vabs(vfloat a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+			static inline vfloat vand(vfloat a, vfloat b) { return _mm_and_ps(a, b); }
+			static inline vfloat vgt(vfloat a, vfloat b) { return _mm_cmpgt_ps(a, b); }
+			static inline vfloat vlt(vfloat a, vfloat b) { return _mm_cmplt_ps(a, b); }
+			static inline vfloat vge(vfloat a, vfloat b) { return _mm_cmpge_ps(a, b); }
+			static inline vfloat vle(vfloat a, vfloat b) { return _mm_cmple_ps(a, b); }
+			static inline int vmask(vfloat a) { return _mm_movemask_ps(a); }
+		};
+
+	}
+
+	const Kernels* get_sse2_kernels() {
+		return make_kernels<Sse2>();
+	}
+
+#else
+
+	const Kernels* get_sse2_kernels() {
+		return nullptr;
+	}
+
+#endif
+
+}
@@ -0,0 +1,144 @@
+#include "common/compression.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace compression {
+
+	const size_t MIN_MATCH = 4;
+	const size_t MAX_OFFSET = 65535;
+	const size_t HASH_BITS = 14;
+	const size_t SIZE_HEADER = 8;
+
+	static uint32_t read32(const char* ptr) {
+		uint32_t result;
+		memcpy(&result, ptr, sizeof(result));
+		return result;
+	}
+
+	static size_t hash(uint32_t value) {
+		return (value * 2654435761u) >> (32 - HASH_BITS);
+	}
+
+	static void write_length(std::string& out, size_t length) {
+		while (length >= 255) {
+			out += (char)255;
+			length -= 255;
+		}
+		out += (char)length;
+	}
+
+	static size_t read_length(const std::string& str, size_t& pos) {
+		size_t length = 0;
+		unsigned char byte;
+		do {
+			if (pos >= str.size()) {
+				throw std::runtime_error("Unexpected end of compressed data");
+			}
+			byte = str[pos++];
+			length += byte;
+		} while (byte == 255);
+		return length;
+	}
+
+	static void write_literals(std::string& out, const std::string& str, size_t start, size_t count, unsigned char match_token) {
+		unsigned char token = (unsigned char)(std::min(count, (size_t)15) << 4) | match_token;
+		out += (char)token;
+		if (count >= 15) {
+			write_length(out, count - 15);
+		}
+		out.append(str, start, count);
+	}
+
+	std::string compress(const std::string& str) {
+		std::string out;
+		out.reserve(str.size() / 2 + SIZE_HEADER);
+		uint64_t size = str.size();
+		for (size_t i = 0; i < SIZE_HEADER; i++) {
+			out += (char)((size >> (i * 8)) & 0xFF);
+		}
+		std::vector<size_t> table((size_t)1 << HASH_BITS, SIZE_MAX);
+		size_t anchor = 0;
+		size_t pos = 0;
+		while (pos + MIN_MATCH <= str.size()) {
+			uint32_t sequence = read32(str.data() + pos);
+			size_t& entry = table[hash(sequence)];
+			size_t candidate = entry;
+			entry = pos;
+			if (candidate == SIZE_MAX || pos - candidate > MAX_OFFSET || read32(str.data() + candidate) != sequence) {
+				pos++;
+				continue;
+			}
+			size_t length = MIN_MATCH;
+			while (pos + length < str.size() && str[candidate + length] == str[pos + length]) {
+				length++;
+			}
+			size_t match_length = length - MIN_MATCH;
+			write_literals(out, str, anchor, pos - anchor, (unsigned char)std::min(match_length, (size_t)15));
+			size_t offset = pos - candidate;
+			out += (char)(offset & 0xFF);
+			out += (char)(offset >> 8);
+			if (match_length >= 15) {
+				write_length(out, match_length - 15);
+			}
+			pos += length;
+			anchor = pos;
+		}
+		// last sequence has only literals
+		write_literals(out, str, anchor, str.size() - anchor, 0);
+		return out;
+	}
+
+	std::string decompress(const std::string& str) {
+		if (str.size() < SIZE_HEADER) {
+			throw std::runtime_error("Compressed data is too short");
+		}
+		uint64_t size = 0;
+		for (size_t i = 0; i < SIZE_HEADER; i++) {
+			size |= (uint64_t)(unsigned char)str[i] << (i * 8);
+		}
+		std::string out;
+		out.reserve(size);
+		size_t pos = SIZE_HEADER;
+		while (pos < str.size()) {
+			unsigned char token = str[pos++];
+			size_t literal_count = token >> 4;
+			if (literal_count == 15) {
+				literal_count += read_length(str, pos);
+			}
+			if (pos + literal_count > str.size()) {
+				throw std::runtime_error("Literals out of range");
+			}
+			out.append(str, pos, literal_count);
+			pos += literal_count;
+			if (pos == str.size()) {
+				break;
+			}
+			if (pos + 2 > str.size()) {
+				throw std::runtime_error("Unexpected end of compressed data");
+			}
+			size_t offset = (unsigned char)str[pos] | ((size_t)(unsigned char)str[pos + 1] << 8);
+			pos += 2;
+			size_t length = (token & 0x0F);
+			if (length == 15) {
+				length += read_length(str, pos);
+			}
+			length += MIN_MATCH;
+			if (offset == 0 || offset > out.size()) {
+				throw std::runtime_error("Match offset out of range");
+			}
+			// match can overlap with the bytes it produces
+			size_t start = out.size() - offset;
+			for (size_t i = 0; i < length; i++) {
+				out += out[start + i];
+			}
+		}
+		if (out.size() != size) {
+			throw std::runtime_error("Decompressed size mismatch");
+		}
+		return out;
+	}
+
+}
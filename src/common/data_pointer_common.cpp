@@ -1,29 +1,271 @@
 #include "common/data_pointer_common.h"
+#include "common/indexed_compvector.h"
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <cstdint>
 
 namespace dp {
 
-	std::map<void*, DataBlock> data_blocks;
+	DataBlockRegistry data_blocks;
+	std::atomic<bool> tracking_flag = true;
 
-	DataBlock::DataBlock(const std::string& name, void* ptr, size_t size) {
+	// names often contain the name of the object, so they are removed
+	// together with the last block using them
+	static std::shared_mutex names_mutex;
+	static std::unordered_map<std::string, std::atomic<size_t>> names;
+
+	static void release_name_shared(const std::string* name);
+
+	// objects are usually created in batches with the same name,
+	// last name holds a reference, so it can't be removed while it's here
+	struct LastName {
+		const std::string* name = nullptr;
+		std::atomic<size_t>* refs = nullptr;
+
+		~LastName() {
+			if (name) {
+				release_name_shared(name);
+			}
+		}
+	};
+	static thread_local LastName last_name;
+
+	// blocks are kept in a vector, so adding one doesn't allocate a node,
+	// the index map finds them by address
+	struct alignas(64) DataBlockRegistry::Shard {
+		mutable std::mutex mutex;
+		std::vector<DataBlock> blocks;
+		CompVectorIndexMap<void*> indices;
+	};
+
+	DataBlock::DataBlock(const std::string* name, void* ptr, size_t size) {
 		this->name = name;
 		this->ptr = ptr;
 		this->size = size;
 	}
 
-	void add_to_data_blocks(const DataBlock& block) {
-		auto inserted = data_blocks.insert({ block.ptr, block });
-		if (!inserted.second) {
+	DataBlockRegistry::DataBlockRegistry() {
+		shards = std::make_unique<Shard[]>(SHARD_COUNT);
+	}
+
+	DataBlockRegistry::~DataBlockRegistry() { }
+
+	void DataBlockRegistry::add(const DataBlock& block) {
+		DataBlock new_block = block;
+		new_block.category = get_memory_category(*block.name);
+		Shard& shard = getShard(block.ptr);
+		std::lock_guard lock(shard.mutex);
+		if (!shard.indices.insert(block.ptr, shard.blocks.size())) {
 			assert(false); // pointer already in data_blocks
+			release_name(block.name);
+			return;
 		}
+		shard.blocks.push_back(new_block);
+		block_count++;
+		memory_stats.add(new_block.category, new_block.size);
 	}
 
-	void add_to_data_blocks(const std::string& name, void* ptr, size_t size) {
+	bool DataBlockRegistry::remove(void* ptr) {
+		const std::string* name = nullptr;
+		{
+			Shard& shard = getShard(ptr);
+			std::lock_guard lock(shard.mutex);
+			ptrdiff_t index = shard.indices.get(ptr);
+			if (index < 0) {
+				return false;
+			}
+			name = shard.blocks[index].name;
+			memory_stats.remove(shard.blocks[index].category, shard.blocks[index].size);
+			shard.indices.erase(ptr);
+			if ((size_t)index != shard.blocks.size() - 1) {
+				shard.blocks[index] = shard.blocks.back();
+				shard.indices.set(shard.blocks[index].ptr, index);
+			}
+			shard.blocks.pop_back();
+			block_count--;
+		}
+		release_name(name);
+		return true;
+	}
+
+	std::optional<DataBlock> DataBlockRegistry::find(void* ptr) const {
+		const Shard& shard = getShard(ptr);
+		std::lock_guard lock(shard.mutex);
+		ptrdiff_t index = shard.indices.get(ptr);
+		if (index < 0) {
+			return std::nullopt;
+		}
+		return shard.blocks[index];
+	}
+
+	bool DataBlockRegistry::contains(void* ptr) const {
+		const Shard& shard = getShard(ptr);
+		std::lock_guard lock(shard.mutex);
+		return shard.indices.get(ptr) >= 0;
+	}
+
+	bool DataBlockRegistry::setName(void* ptr, const std::string* name) {
+		MemoryCategory category = get_memory_category(*name);
+		const std::string* old_name = name;
+		bool found = false;
+		{
+			Shard& shard = getShard(ptr);
+			std::lock_guard lock(shard.mutex);
+			ptrdiff_t index = shard.indices.get(ptr);
+			if (index >= 0) {
+				DataBlock& block = shard.blocks[index];
+				memory_stats.move(block.category, category, block.size);
+				old_name = block.name;
+				block.name = name;
+				block.category = category;
+				found = true;
+			}
+		}
+		// new name is released if it's not used
+		release_name(old_name);
+		return found;
+	}
+
+	size_t DataBlockRegistry::size() const {
+		return block_count.load();
+	}
+
+	std::vector<DataBlock> DataBlockRegistry::getBlocks() const {
+		std::vector<DataBlock> result;
+		for (size_t i = 0; i < SHARD_COUNT; i++) {
+			const Shard& shard = shards[i];
+			std::lock_guard lock(shard.mutex);
+			result.insert(result.end(), shard.blocks.begin(), shard.blocks.end());
+		}
+		std::sort(result.begin(), result.end(), [](const DataBlock& left, const DataBlock& right) {
+			return left.ptr < right.ptr;
+		});
+		return result;
+	}
+
+	void DataBlockRegistry::clear() {
+		for (size_t i = 0; i < SHARD_COUNT; i++) {
+			std::vector<DataBlock> blocks;
+			{
+				Shard& shard = shards[i];
+				std::lock_guard lock(shard.mutex);
+				block_count -= shard.blocks.size();
+				for (const DataBlock& block : shard.blocks) {
+					memory_stats.remove(block.category, block.size);
+				}
+				blocks = std::move(shard.blocks);
+				shard.blocks = std::vector<DataBlock>();
+				shard.indices.clear();
+			}
+			for (const DataBlock& block : blocks) {
+				release_name(block.name);
+			}
+		}
+	}
+
+	DataBlockRegistry::Shard& DataBlockRegistry::getShard(void* ptr) {
+		const DataBlockRegistry* const_this = this;
+		return const_cast<Shard&>(const_this->getShard(ptr));
+	}
+
+	const DataBlockRegistry::Shard& DataBlockRegistry::getShard(void* ptr) const {
+		// low bits are mostly zero because of alignment, so the address is mixed first,
+		// top bits of the hash are taken by the index map, so the shard uses the middle ones
+		uint64_t address = reinterpret_cast<uintptr_t>(ptr);
+		uint64_t hash = address * 11400714819323198485ull;
+		return shards[(hash >> 32) % SHARD_COUNT];
+	}
+
+	void set_tracking_enabled(bool value) {
+		tracking_flag.store(value);
+	}
+
+	const std::string* intern_name(const std::string& name) {
+		if (last_name.name && *last_name.name == name) {
+			last_name.refs->fetch_add(1, std::memory_order_relaxed);
+			return last_name.name;
+		}
+		const std::string* result = nullptr;
+		std::atomic<size_t>* refs = nullptr;
+		{
+			// names are only removed under the unique lock
+			std::shared_lock lock(names_mutex);
+			auto it = names.find(name);
+			if (it != names.end()) {
+				result = &it->first;
+				refs = &it->second;
+				// one for the caller, one for last name
+				refs->fetch_add(2, std::memory_order_relaxed);
+			}
+		}
+		if (!result) {
+			std::unique_lock lock(names_mutex);
+			auto it = names.try_emplace(name, 0).first;
+			result = &it->first;
+			refs = &it->second;
+			refs->fetch_add(2, std::memory_order_relaxed);
+		}
+		if (last_name.name) {
+			release_name_shared(last_name.name);
+		}
+		last_name.name = result;
+		last_name.refs = refs;
+		return result;
+	}
+
+	static void release_name_shared(const std::string* name) {
+		std::string key;
+		{
+			std::shared_lock lock(names_mutex);
+			auto it = names.find(*name);
+			if (it == names.end() || it->second.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+				return;
+			}
+			// name can't be removed by another thread until the shared lock is released
+			key = *name;
+		}
+		std::unique_lock lock(names_mutex);
+		auto it = names.find(key);
+		// might have been interned again or already removed in the meantime
+		if (it != names.end() && it->second.load(std::memory_order_acquire) == 0) {
+			names.erase(it);
+		}
+	}
+
+	void release_name(const std::string* name) {
+		if (!name || name == &UNNAMED_BLOCK_NAME) {
+			return;
+		}
+		// last name holds its own reference, so the count doesn't reach zero here
+		if (name == last_name.name) {
+			last_name.refs->fetch_sub(1, std::memory_order_relaxed);
+			return;
+		}
+		release_name_shared(name);
+	}
+
+	size_t get_interned_name_count() {
+		std::shared_lock lock(names_mutex);
+		return names.size();
+	}
+
+	void add_to_data_blocks(const DataBlock& block) {
+		data_blocks.add(block);
+	}
+
+	void add_to_data_blocks(const std::string* name, void* ptr, size_t size) {
 		add_to_data_blocks(DataBlock(name, ptr, size));
 	}
 
+	void add_to_data_blocks(const std::string& name, void* ptr, size_t size) {
+		add_to_data_blocks(intern_name(name), ptr, size);
+	}
+
 	void remove_from_data_blocks(void* ptr) {
-		assert(data_blocks.contains(ptr));
-		data_blocks.erase(ptr);
+		[[maybe_unused]] bool removed = data_blocks.remove(ptr);
+		assert(removed);
 	}
 
 	std::string pointer_to_str(void* ptr) {
@@ -33,7 +275,11 @@ namespace dp {
 	}
 
 	std::string data_block_to_str(const DataBlock& block) {
-		std::string result = "Name: " + block.name + " ptr: " + pointer_to_str(block.ptr) + " size: " + std::to_string(block.size);
+		std::string result =
+			"Name: " + *block.name
+			+ " category: " + memory_category_to_str(block.category)
+			+ " ptr: " + pointer_to_str(block.ptr)
+			+ " size: " + std::to_string(block.size);
 		return result;
 	}
 
@@ -43,20 +289,17 @@ namespace dp {
 
 	std::string data_block_to_str(void* ptr) {
 		std::string result = "<NOT FOUND>";
-		auto it = data_blocks.find(ptr);
-		if (it != data_blocks.end()) {
-			DataBlock& block = it->second;
-			result = data_block_to_str(block);
+		std::optional<DataBlock> block = data_blocks.find(ptr);
+		if (block.has_value()) {
+			result = data_block_to_str(*block);
 		}
 		return result;
 	}
 
 	void print_data_blocks() {
-		auto it = data_blocks.begin();
-		for (size_t i = 0; i < data_blocks.size(); i++) {
-			DataBlock& block = it->second;
-			std::cout << i << ": " << data_block_to_str(block) << "\n";
-			it++;
+		std::vector<DataBlock> blocks = data_blocks.getBlocks();
+		for (size_t i = 0; i < blocks.size(); i++) {
+			std::cout << i << ": " << data_block_to_str(blocks[i]) << "\n";
 		}
 	}
 
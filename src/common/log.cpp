@@ -0,0 +1,60 @@
+#include "common/log.h"
+
+namespace logging {
+
+	// tags are disabled at startup, before other threads start logging
+	static std::map<std::string, size_t> disabled_tags;
+	static thread_local bool current_enabled = true;
+
+	bool is_tag_disabled(const std::string& tag) {
+		auto it = disabled_tags.find(tag);
+		return it != disabled_tags.end() && it->second > 0;
+	}
+
+	bool is_enabled() {
+		return current_enabled;
+	}
+
+	Tag::Tag(const std::string& tag) : logger_tag(tag) {
+		prev_enabled = current_enabled;
+		current_enabled = !is_tag_disabled(tag);
+	}
+
+	Tag::~Tag() {
+		current_enabled = prev_enabled;
+	}
+
+	DisableTag::DisableTag(const std::string& tag) : logger_disable_tag(tag) {
+		this->tag = tag;
+		disabled_tags[tag]++;
+	}
+
+	DisableTag::~DisableTag() {
+		auto it = disabled_tags.find(tag);
+		if (it != disabled_tags.end() && it->second > 0) {
+			it->second--;
+		}
+	}
+
+	EnableTag::EnableTag(const std::string& tag) {
+		this->tag = tag;
+		auto it = disabled_tags.find(tag);
+		if (it != disabled_tags.end()) {
+			disable_count = it->second;
+			it->second = 0;
+		}
+	}
+
+	EnableTag::~EnableTag() {
+		if (disable_count > 0) {
+			disabled_tags[tag] += disable_count;
+		}
+	}
+
+	Indent::Indent() {
+		if (is_enabled()) {
+			indent.emplace();
+		}
+	}
+
+}
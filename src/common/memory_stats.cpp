@@ -0,0 +1,176 @@
+#include "common/memory_stats.h"
+#include <sstream>
+#include <cassert>
+
+namespace dp {
+
+	MemoryStats memory_stats;
+
+	const MemoryCategoryStats& MemorySnapshot::get(MemoryCategory category) const {
+		return categories[(size_t)category];
+	}
+
+	std::string MemorySnapshot::toJson() const {
+		std::stringstream ss;
+		ss << "{\n";
+		ss << "    \"count\": " << count << ",\n";
+		ss << "    \"bytes\": " << bytes << ",\n";
+		ss << "    \"peak_bytes\": " << peak_bytes << ",\n";
+		ss << "    \"categories\": {\n";
+		for (size_t i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+			const MemoryCategoryStats& stats = categories[i];
+			ss << "        \"" << memory_category_to_str((MemoryCategory)i) << "\": { ";
+			ss << "\"count\": " << stats.count << ", ";
+			ss << "\"bytes\": " << stats.bytes << ", ";
+			ss << "\"peak_bytes\": " << stats.peak_bytes;
+			ss << " }";
+			if (i < MEMORY_CATEGORY_COUNT - 1) {
+				ss << ",";
+			}
+			ss << "\n";
+		}
+		ss << "    }\n";
+		ss << "}\n";
+		return ss.str();
+	}
+
+	void MemoryStats::add(MemoryCategory category, size_t bytes) {
+		Counters& category_counters = counters[(size_t)category];
+		category_counters.count++;
+		size_t category_bytes = category_counters.bytes += bytes;
+		updatePeak(category_counters.peak_bytes, category_bytes);
+		size_t new_total_bytes = total_bytes += bytes;
+		updatePeak(peak_total_bytes, new_total_bytes);
+	}
+
+	void MemoryStats::remove(MemoryCategory category, size_t bytes) {
+		Counters& category_counters = counters[(size_t)category];
+		assert(category_counters.count > 0);
+		category_counters.count--;
+		category_counters.bytes -= bytes;
+		total_bytes -= bytes;
+	}
+
+	void MemoryStats::move(MemoryCategory from, MemoryCategory to, size_t bytes) {
+		if (from == to) {
+			return;
+		}
+		Counters& from_counters = counters[(size_t)from];
+		Counters& to_counters = counters[(size_t)to];
+		from_counters.count--;
+		from_counters.bytes -= bytes;
+		to_counters.count++;
+		size_t to_bytes = to_counters.bytes += bytes;
+		updatePeak(to_counters.peak_bytes, to_bytes);
+	}
+
+	MemorySnapshot MemoryStats::getSnapshot() const {
+		// counters are read one by one, so the snapshot can be slightly off
+		// while other threads are allocating
+		MemorySnapshot snapshot;
+		for (size_t i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+			MemoryCategoryStats& stats = snapshot.categories[i];
+			stats.count = counters[i].count.load();
+			stats.bytes = counters[i].bytes.load();
+			stats.peak_bytes = counters[i].peak_bytes.load();
+			snapshot.count += stats.count;
+		}
+		snapshot.bytes = total_bytes.load();
+		snapshot.peak_bytes = peak_total_bytes.load();
+		return snapshot;
+	}
+
+	void MemoryStats::resetPeaks() {
+		for (Counters& category_counters : counters) {
+			category_counters.peak_bytes = category_counters.bytes.load();
+		}
+		peak_total_bytes = total_bytes.load();
+	}
+
+	void MemoryStats::updatePeak(std::atomic<size_t>& peak, size_t value) {
+		size_t old_peak = peak.load(std::memory_order_relaxed);
+		while (value > old_peak && !peak.compare_exchange_weak(old_peak, value, std::memory_order_relaxed)) { }
+	}
+
+	ExternalMemoryBlock::ExternalMemoryBlock(MemoryCategory category) {
+		this->category = category;
+	}
+
+	ExternalMemoryBlock::ExternalMemoryBlock(const ExternalMemoryBlock& other) {
+		this->category = other.category;
+		setSize(other.size);
+	}
+
+	ExternalMemoryBlock::~ExternalMemoryBlock() {
+		setSize(0);
+	}
+
+	size_t ExternalMemoryBlock::getSize() const {
+		return size;
+	}
+
+	void ExternalMemoryBlock::setSize(size_t new_size) {
+		if (new_size == size) {
+			return;
+		}
+		// empty blocks are not counted
+		if (size > 0) {
+			memory_stats.remove(category, size);
+		}
+		if (new_size > 0) {
+			memory_stats.add(category, new_size);
+		}
+		size = new_size;
+	}
+
+	ExternalMemoryBlock& ExternalMemoryBlock::operator=(const ExternalMemoryBlock& other) {
+		setSize(0);
+		this->category = other.category;
+		setSize(other.size);
+		return *this;
+	}
+
+	MemoryCategory get_memory_category(const std::string& name) {
+		// parts of game objects are named after the object, so they are checked first
+		if (name.ends_with("_shape") || name.ends_with(" SplittablePolygon")) {
+			return MemoryCategory::SHAPES;
+		}
+		if (
+			name.starts_with("BoxObject")
+			|| name.starts_with("BallObject")
+			|| name.starts_with("PolygonObject")
+			|| name.starts_with("ChainObject")
+			|| name.starts_with("RevoluteJoint")
+		) {
+			return MemoryCategory::GAME_OBJECTS;
+		}
+		if (
+			name.starts_with("Widget")
+			|| name.starts_with("TreeViewWidget")
+			|| name.starts_with("EditWindowParameter")
+		) {
+			return MemoryCategory::WIDGETS;
+		}
+		if (name.starts_with("Simulation World")) {
+			return MemoryCategory::WORLD;
+		}
+		return MemoryCategory::OTHER;
+	}
+
+	std::string memory_category_to_str(MemoryCategory category) {
+		switch (category) {
+			case MemoryCategory::WIDGETS: return "widgets";
+			case MemoryCategory::GAME_OBJECTS: return "game_objects";
+			case MemoryCategory::SHAPES: return "shapes";
+			case MemoryCategory::TEXTURES: return "textures";
+			case MemoryCategory::WORLD: return "world";
+			case MemoryCategory::OTHER: return "other";
+			default: return "unknown";
+		}
+	}
+
+	MemorySnapshot get_memory_snapshot() {
+		return memory_stats.getSnapshot();
+	}
+
+}
@@ -0,0 +1,62 @@
+#include "common/spill_file.h"
+#include <atomic>
+
+SpillFile::SpillFile(const std::string& name) {
+	static std::atomic<size_t> counter = 0;
+	std::string filename = "b2e_" + name + "_" + std::to_string(counter++) + ".tmp";
+	path = std::filesystem::temp_directory_path() / filename;
+	open();
+}
+
+SpillFile::~SpillFile() {
+	file.close();
+	std::error_code ec;
+	std::filesystem::remove(path, ec);
+}
+
+const std::filesystem::path& SpillFile::getPath() const {
+	return path;
+}
+
+size_t SpillFile::size() const {
+	return file_size;
+}
+
+size_t SpillFile::append(const std::string& data) {
+	size_t offset = file_size;
+	file.seekp(offset);
+	file.write(data.data(), data.size());
+	if (!file) {
+		throw std::runtime_error(__FUNCTION__": File write error: " + path.string());
+	}
+	file_size += data.size();
+	return offset;
+}
+
+std::string SpillFile::read(size_t offset, size_t size) {
+	if (offset + size > file_size) {
+		throw std::runtime_error(__FUNCTION__": Read out of range: " + std::to_string(offset) + " " + std::to_string(size));
+	}
+	// writes are buffered, so they have to reach the file first
+	file.flush();
+	std::string result(size, '\0');
+	file.seekg(offset);
+	file.read(result.data(), size);
+	if (!file) {
+		throw std::runtime_error(__FUNCTION__": File read error: " + path.string());
+	}
+	return result;
+}
+
+void SpillFile::clear() {
+	file.close();
+	open();
+}
+
+void SpillFile::open() {
+	file.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		throw std::runtime_error(__FUNCTION__": Cannot open file: " + path.string());
+	}
+	file_size = 0;
+}
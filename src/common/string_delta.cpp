@@ -0,0 +1,206 @@
+#include "common/string_delta.h"
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+#include <stdexcept>
+#include <cstdint>
+
+// copies shorter than this are cheaper to store as literals
+const size_t MIN_COPY_LENGTH = 8;
+// limits time spent on lines that repeat a lot, like "}" or empty lines
+const size_t MAX_CANDIDATES = 8;
+
+bool StringDelta::Op::operator==(const Op& other) const {
+	return copy == other.copy && offset == other.offset && length == other.length;
+}
+
+StringDelta::StringDelta() { }
+
+StringDelta StringDelta::create(const std::string& from, const std::string& to) {
+	StringDelta delta;
+	delta.base_size = from.size();
+	delta.result_size = to.size();
+	size_t max_common = std::min(from.size(), to.size());
+	size_t prefix = 0;
+	while (prefix < max_common && from[prefix] == to[prefix]) {
+		prefix++;
+	}
+	size_t suffix = 0;
+	while (suffix < max_common - prefix && from[from.size() - 1 - suffix] == to[to.size() - 1 - suffix]) {
+		suffix++;
+	}
+	delta.addCopy(0, prefix);
+	size_t from_end = from.size() - suffix;
+	size_t to_end = to.size() - suffix;
+	// lines of the changed part of the base string
+	std::unordered_map<std::string_view, std::vector<size_t>> lines;
+	size_t line_start = prefix;
+	while (line_start < from_end) {
+		size_t line_end = from.find('\n', line_start);
+		line_end = line_end == std::string::npos || line_end >= from_end ? from_end : line_end + 1;
+		std::string_view line(from.data() + line_start, line_end - line_start);
+		std::vector<size_t>& positions = lines[line];
+		if (positions.size() < MAX_CANDIDATES) {
+			positions.push_back(line_start);
+		}
+		line_start = line_end;
+	}
+	size_t pos = prefix;
+	while (pos < to_end) {
+		size_t line_end = to.find('\n', pos);
+		line_end = line_end == std::string::npos || line_end >= to_end ? to_end : line_end + 1;
+		std::string_view line(to.data() + pos, line_end - pos);
+		size_t best_offset = 0;
+		size_t best_length = 0;
+		auto it = lines.find(line);
+		if (it != lines.end()) {
+			for (size_t offset : it->second) {
+				size_t length = 0;
+				while (offset + length < from_end && pos + length < to_end && from[offset + length] == to[pos + length]) {
+					length++;
+				}
+				if (length > best_length) {
+					best_offset = offset;
+					best_length = length;
+				}
+			}
+		}
+		if (best_length >= MIN_COPY_LENGTH) {
+			delta.addCopy(best_offset, best_length);
+			pos += best_length;
+		} else {
+			delta.addInsert(to.data() + pos, line_end - pos);
+			pos = line_end;
+		}
+	}
+	delta.addCopy(from_end, suffix);
+	return delta;
+}
+
+std::string StringDelta::apply(const std::string& from) const {
+	if (from.size() != base_size) {
+		throw std::runtime_error(
+			__FUNCTION__": Base string size mismatch: " + std::to_string(from.size()) + " != " + std::to_string(base_size)
+		);
+	}
+	std::string result;
+	result.reserve(result_size);
+	for (const Op& op : ops) {
+		if (op.copy) {
+			result.append(from, op.offset, op.length);
+		} else {
+			result.append(literals, op.offset, op.length);
+		}
+	}
+	return result;
+}
+
+size_t StringDelta::getBaseSize() const {
+	return base_size;
+}
+
+size_t StringDelta::getResultSize() const {
+	return result_size;
+}
+
+size_t StringDelta::getOpCount() const {
+	return ops.size();
+}
+
+size_t StringDelta::getMemorySize() const {
+	return sizeof(StringDelta) + ops.capacity() * sizeof(Op) + literals.capacity();
+}
+
+static void write_u64(std::string& out, uint64_t value) {
+	for (size_t i = 0; i < 8; i++) {
+		out += (char)((value >> (i * 8)) & 0xFF);
+	}
+}
+
+static uint64_t read_u64(const std::string& str, size_t& pos) {
+	if (pos + 8 > str.size()) {
+		throw std::runtime_error("Unexpected end of StringDelta data");
+	}
+	uint64_t value = 0;
+	for (size_t i = 0; i < 8; i++) {
+		value |= (uint64_t)(unsigned char)str[pos + i] << (i * 8);
+	}
+	pos += 8;
+	return value;
+}
+
+void StringDelta::serialize(std::string& out) const {
+	write_u64(out, base_size);
+	write_u64(out, result_size);
+	write_u64(out, ops.size());
+	for (const Op& op : ops) {
+		write_u64(out, op.copy ? 1 : 0);
+		write_u64(out, op.offset);
+		write_u64(out, op.length);
+	}
+	write_u64(out, literals.size());
+	out += literals;
+}
+
+StringDelta StringDelta::deserialize(const std::string& str) {
+	try {
+		StringDelta delta;
+		size_t pos = 0;
+		delta.base_size = read_u64(str, pos);
+		delta.result_size = read_u64(str, pos);
+		size_t op_count = read_u64(str, pos);
+		for (size_t i = 0; i < op_count; i++) {
+			Op op;
+			op.copy = read_u64(str, pos) != 0;
+			op.offset = read_u64(str, pos);
+			op.length = read_u64(str, pos);
+			delta.ops.push_back(op);
+		}
+		size_t literals_size = read_u64(str, pos);
+		if (pos + literals_size > str.size()) {
+			throw std::runtime_error("Literals out of range");
+		}
+		delta.literals = str.substr(pos, literals_size);
+		return delta;
+	} catch (std::exception exc) {
+		throw std::runtime_error(__FUNCTION__": " + std::string(exc.what()));
+	}
+}
+
+bool StringDelta::operator==(const StringDelta& other) const {
+	return base_size == other.base_size
+		&& result_size == other.result_size
+		&& ops == other.ops
+		&& literals == other.literals;
+}
+
+void StringDelta::addCopy(size_t offset, size_t length) {
+	if (length == 0) {
+		return;
+	}
+	if (ops.size() > 0 && ops.back().copy && ops.back().offset + ops.back().length == offset) {
+		ops.back().length += length;
+		return;
+	}
+	Op op;
+	op.copy = true;
+	op.offset = offset;
+	op.length = length;
+	ops.push_back(op);
+}
+
+void StringDelta::addInsert(const char* str, size_t length) {
+	if (length == 0) {
+		return;
+	}
+	if (ops.size() > 0 && !ops.back().copy) {
+		ops.back().length += length;
+	} else {
+		Op op;
+		op.copy = false;
+		op.offset = literals.size();
+		op.length = length;
+		ops.push_back(op);
+	}
+	literals.append(str, length);
+}
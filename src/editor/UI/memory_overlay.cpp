@@ -0,0 +1,106 @@
+#include "editor/UI/memory_overlay.h"
+#include "widgets/text_widget.h"
+#include "editor/editor.h"
+#include <format>
+
+static std::string bytes_to_str(size_t bytes) {
+	if (bytes < 1024) {
+		return std::to_string(bytes) + " B";
+	} else if (bytes < 1024 * 1024) {
+		return std::format("{:.1f} KB", bytes / 1024.0);
+	} else {
+		return std::format("{:.1f} MB", bytes / (1024.0 * 1024.0));
+	}
+}
+
+static std::string bytes_diff_to_str(size_t bytes, size_t base_bytes) {
+	if (bytes >= base_bytes) {
+		return "+" + bytes_to_str(bytes - base_bytes);
+	} else {
+		return "-" + bytes_to_str(base_bytes - bytes);
+	}
+}
+
+MemoryOverlay::MemoryOverlay(fw::WidgetList& widget_list, Editor& p_app)
+	: RectangleWidget(widget_list, 400.0f, 150.0f), app(p_app) {
+	setName("memory overlay");
+	setFillColor(sf::Color(0, 0, 0, 200));
+	setOrigin(Anchor::TOP_LEFT);
+	setParentAnchor(Anchor::TOP_LEFT);
+	setAnchorOffset(0.0f, 40.0f);
+	setClickThrough(true);
+	text_widget = widget_list.createTextWidget();
+	text_widget->setName("memory overlay text");
+	text_widget->setFont(app.console_font);
+	text_widget->setCharacterSize(MEMORY_OVERLAY_TEXT_SIZE);
+	text_widget->setFillColor(sf::Color::White);
+	text_widget->setOrigin(Anchor::TOP_LEFT);
+	text_widget->setParentAnchor(Anchor::TOP_LEFT);
+	text_widget->setAnchorOffset(MEMORY_OVERLAY_PADDING, MEMORY_OVERLAY_PADDING);
+	text_widget->setParent(this);
+	setVisible(false);
+}
+
+const dp::MemorySnapshot& MemoryOverlay::getBaseline() const {
+	return baseline;
+}
+
+void MemoryOverlay::requestBaseline() {
+	// widgets of removed objects are deleted later in the frame,
+	// so the baseline is taken when the frame ends
+	baseline_requested = true;
+}
+
+void MemoryOverlay::updateStats(bool force) {
+	if (baseline_requested) {
+		baseline = dp::get_memory_snapshot();
+		baseline_requested = false;
+	}
+	if (!isVisible() && !force) {
+		return;
+	}
+	if (frames_until_update > 0 && !force) {
+		frames_until_update--;
+		return;
+	}
+	frames_until_update = MEMORY_OVERLAY_UPDATE_FRAMES;
+	text_widget->setString(getTableStr(dp::get_memory_snapshot()));
+	sf::FloatRect bounds = text_widget->getLocalBounds();
+	setSize(bounds.width + MEMORY_OVERLAY_PADDING * 3, bounds.height + MEMORY_OVERLAY_PADDING * 3);
+}
+
+std::string MemoryOverlay::getTableStr(const dp::MemorySnapshot& snapshot) const {
+	auto get_row = [&](
+		const std::string& name, const dp::MemoryCategoryStats& stats, const dp::MemoryCategoryStats& base_stats
+	) {
+		return std::format(
+			"{:<14}{:>8}{:>12}{:>12}{:>12}\n",
+			name,
+			stats.count,
+			bytes_to_str(stats.bytes),
+			bytes_to_str(stats.peak_bytes),
+			bytes_diff_to_str(stats.bytes, base_stats.bytes)
+		);
+	};
+	std::string result = std::format("{:<14}{:>8}{:>12}{:>12}{:>12}\n", "category", "count", "current", "peak", "load");
+	for (size_t i = 0; i < dp::MEMORY_CATEGORY_COUNT; i++) {
+		dp::MemoryCategory category = (dp::MemoryCategory)i;
+		result += get_row(dp::memory_category_to_str(category), snapshot.get(category), baseline.get(category));
+	}
+	dp::MemoryCategoryStats total;
+	total.count = snapshot.count;
+	total.bytes = snapshot.bytes;
+	total.peak_bytes = snapshot.peak_bytes;
+	dp::MemoryCategoryStats base_total;
+	base_total.bytes = baseline.bytes;
+	result += get_row("total", total, base_total);
+	const DecompositionCacheStats& cache_stats = SplittablePolygon::getDecompositionCache().getStats();
+	result += std::format(
+		"\ndecomposition cache: {} entries, {}, {} hits, {} misses\n",
+		cache_stats.entries,
+		bytes_to_str(cache_stats.bytes),
+		cache_stats.hits,
+		cache_stats.misses
+	);
+	return result;
+}
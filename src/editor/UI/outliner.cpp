@@ -33,22 +33,49 @@ Outliner::Outliner(fw::WidgetList& widget_list, float width, float height, Edito
 		app.select_tool.deselectObject(object);
 	};
 	setScrolledWidget(treeview_widget);
-	object_list.OnObjectAdded += [&](GameObject* object) {
-		addObject(object);
+	// search box
+	search_widget = widget_list.createTextBoxWidget(width, OUTLINER_SEARCH_HEIGHT);
+	search_widget->setName("search");
+	search_widget->setFont(app.textbox_font);
+	search_widget->setCharacterSize(12);
+	search_widget->setParentAnchor(Anchor::BOTTOM_LEFT);
+	search_widget->setSizeXPolicy(SizePolicy::PARENT);
+	search_widget->OnValueChanged = [&](const sf::String& value) {
+		setFilter(value);
 	};
+	search_widget->setParent(this);
+	// filter is applied once per frame, since objects usually come in batches
+	OnPreUpdate += [&]() {
+		if (filter_dirty) {
+			applyFilter();
+		}
+	};
+	// list events come in bursts when objects are loaded, duplicated or deleted,
+	// so they are handled in batches
+	object_list.OnObjectAdded.addBatchHandler([&](std::span<GameObject* const> objects) {
+		for (GameObject* object : objects) {
+			addObject(object);
+		}
+		filter_dirty |= filter.size() > 0;
+	});
 	object_list.OnBeforeObjectRemoved += [&](GameObject* object) {
 		LoggerTag outlinerTag("outliner");
 		logger << "RemoveObject: " << object->getId() << " \"" << object->getName() << "\"" << "\n";
 	};
-	object_list.OnAfterObjectRemoved += [&](GameObject* object) {
-		removeObject(object);
-	};
-	object_list.OnSetParent += [&](GameObject* object, GameObject* parent) {
-		setParentToObject(object, parent);
-	};
-	object_list.OnObjectMoved += [&](GameObject* object, size_t index) {
-		moveObject(object, index);
-	};
+	object_list.OnAfterObjectRemoved.addBatchHandler([&](std::span<GameObject* const> objects) {
+		removeObjects(objects);
+	});
+	object_list.OnSetParent.addBatchHandler([&](std::span<const std::tuple<GameObject*, GameObject*>> batch) {
+		for (const auto& [object, parent] : batch) {
+			setParentToObject(object, parent);
+		}
+		filter_dirty |= filter.size() > 0;
+	});
+	object_list.OnObjectMoved.addBatchHandler([&](std::span<const std::tuple<GameObject*, size_t>> batch) {
+		for (const auto& [object, index] : batch) {
+			moveObject(object, index);
+		}
+	});
 	object_list.OnClear += [&]() {
 		clear();
 	};
@@ -63,6 +90,27 @@ Outliner::Outliner(fw::WidgetList& widget_list, float width, float height, Edito
 Outliner::Outliner(fw::WidgetList& widget_list, const sf::Vector2f& size, Editor& p_app)
 	: Outliner(widget_list, size.x, size.y, p_app) { }
 
+const std::string& Outliner::getFilter() const {
+	return filter;
+}
+
+fw::TextBoxWidget* Outliner::getSearchWidget() const {
+	return search_widget;
+}
+
+fw::TreeViewEntry* Outliner::getEntry(GameObject* object) const {
+	auto it = object_entry.find(object);
+	if (it != object_entry.end()) {
+		return it->second;
+	}
+	return nullptr;
+}
+
+void Outliner::setFilter(const std::string& filter) {
+	this->filter = filter;
+	applyFilter();
+}
+
 void Outliner::addObject(GameObject* object) {
 	LoggerTag outlinerTag("outliner");
 	logger << "AddObject: " << object->getId() << " \"" << object->getName() << "\"" << "\n";
@@ -78,14 +126,19 @@ void Outliner::moveObject(GameObject* object, size_t index) {
 	entry->moveToIndex(index);
 }
 
-void Outliner::removeObject(GameObject* object) {
-	auto it = object_entry.find(object);
-	if (it != object_entry.end()) {
-		fw::TreeViewEntry* entry = it->second;
-		treeview_widget->removeEntry(entry, false);
-		object_entry.erase(object);
-		entry_object.erase(entry);
+void Outliner::removeObjects(std::span<GameObject* const> objects) {
+	// objects are already deleted, pointers are only used as keys
+	std::vector<fw::TreeViewEntry*> entries;
+	for (GameObject* object : objects) {
+		auto it = object_entry.find(object);
+		if (it != object_entry.end()) {
+			fw::TreeViewEntry* entry = it->second;
+			entries.push_back(entry);
+			object_entry.erase(it);
+			entry_object.erase(entry);
+		}
 	}
+	treeview_widget->removeEntries(entries);
 }
 
 void Outliner::setParentToObject(GameObject* object, GameObject* parent) {
@@ -120,3 +173,31 @@ void Outliner::clear() {
 	object_entry = std::map<GameObject*, fw::TreeViewEntry*>();
 	entry_object = std::map<fw::TreeViewEntry*, GameObject*>();
 }
+
+void Outliner::applyFilter() {
+	filter_dirty = false;
+	bool show_all = filter.empty();
+	for (auto& [object, entry] : object_entry) {
+		entry->getWidget()->setVisible(show_all);
+	}
+	if (show_all) {
+		return;
+	}
+	// plain text is searched anywhere in the name
+	std::string pattern = filter;
+	if (pattern.find('*') == std::string::npos) {
+		pattern = "*" + pattern + "*";
+	}
+	// parents of found objects are shown too, otherwise the entries can't be seen
+	for (GameObject* object : object_list.findByName(pattern)) {
+		GameObject* current = object;
+		while (current) {
+			fw::TreeViewEntry* entry = getEntry(current);
+			if (!entry || entry->getWidget()->isVisible()) {
+				break;
+			}
+			entry->getWidget()->setVisible(true);
+			current = current->getParent();
+		}
+	}
+}
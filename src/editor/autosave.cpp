@@ -0,0 +1,152 @@
+#include "editor/autosave.h"
+#include <fstream>
+
+BackgroundFileWriter::BackgroundFileWriter() {
+    thread = std::thread([&]() { run(); });
+}
+
+BackgroundFileWriter::~BackgroundFileWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    job_added.notify_all();
+    thread.join();
+}
+
+void BackgroundFileWriter::write(const std::string& tag, std::string str, const std::filesystem::path& path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // only the latest pending write to the same file matters
+        for (Job& job : jobs) {
+            if (job.path == path) {
+                job.tag = tag;
+                job.str = std::move(str);
+                return;
+            }
+        }
+        jobs.push_back(Job { tag, std::move(str), path });
+    }
+    job_added.notify_one();
+}
+
+bool BackgroundFileWriter::isBusy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return busy || jobs.size() > 0;
+}
+
+std::vector<FileWriteResult> BackgroundFileWriter::takeResults() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<FileWriteResult> taken;
+    taken.swap(results);
+    return taken;
+}
+
+void BackgroundFileWriter::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    job_done.wait(lock, [&]() { return !busy && jobs.size() == 0; });
+}
+
+void BackgroundFileWriter::writeAtomic(const std::string& str, const std::filesystem::path& path) {
+    std::filesystem::path temp_path = path;
+    temp_path += ".tmp";
+    {
+        std::ofstream ofstream(temp_path, std::ios::binary);
+        if (!ofstream.is_open()) {
+            throw std::runtime_error("File write error: " + temp_path.string());
+        }
+        ofstream << str;
+        ofstream.flush();
+        if (!ofstream.good()) {
+            throw std::runtime_error("File write error: " + temp_path.string());
+        }
+    }
+    std::filesystem::rename(temp_path, path);
+}
+
+void BackgroundFileWriter::run() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            job_added.wait(lock, [&]() { return stopping || jobs.size() > 0; });
+            if (jobs.size() == 0) {
+                // remaining jobs are finished before stopping
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            busy = true;
+        }
+        FileWriteResult result;
+        result.tag = job.tag;
+        result.path = job.path;
+        try {
+            writeAtomic(job.str, job.path);
+        } catch (std::exception exc) {
+            result.success = false;
+            result.error = exc.what();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            results.push_back(result);
+            busy = false;
+        }
+        job_done.notify_all();
+    }
+}
+
+Autosave::Autosave() { }
+
+Autosave::Autosave(BackgroundFileWriter* writer, std::function<std::string(void)> get) {
+    this->writer = writer;
+    this->get = get;
+}
+
+const std::filesystem::path& Autosave::getPath() const {
+    return path;
+}
+
+void Autosave::setPath(const std::filesystem::path& path) {
+    this->path = path;
+}
+
+float Autosave::getInterval() const {
+    return interval;
+}
+
+void Autosave::setInterval(float seconds) {
+    this->interval = seconds;
+}
+
+bool Autosave::isEnabled() const {
+    return enabled;
+}
+
+void Autosave::setEnabled(bool enabled) {
+    this->enabled = enabled;
+}
+
+bool Autosave::update() {
+    if (!enabled || !writer) {
+        return false;
+    }
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::duration<float> elapsed = now - last_time;
+    if (elapsed.count() < interval) {
+        return false;
+    }
+    last_time = now;
+    std::string snapshot = get();
+    if (snapshot == last_snapshot) {
+        return false;
+    }
+    writer->write("Autosave", snapshot, path);
+    last_snapshot = std::move(snapshot);
+    return true;
+}
+
+void Autosave::reset() {
+    last_time = std::chrono::steady_clock::now();
+    last_snapshot.clear();
+}
@@ -0,0 +1,368 @@
+#include <cstring>
+#include "editor/edit_action.h"
+#include "editor/editor.h"
+
+static void write_u64(std::string& out, uint64_t value) {
+    for (size_t i = 0; i < 8; i++) {
+        out += (char)((value >> (i * 8)) & 0xFF);
+    }
+}
+
+static uint64_t read_u64(const std::string& str, size_t& pos) {
+    if (pos + 8 > str.size()) {
+        throw std::runtime_error("Unexpected end of EditAction data");
+    }
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; i++) {
+        value |= (uint64_t)(unsigned char)str[pos + i] << (i * 8);
+    }
+    pos += 8;
+    return value;
+}
+
+// floats are written bit for bit, so undo restores exactly the same positions
+static void write_float(std::string& out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    write_u64(out, bits);
+}
+
+static float read_float(const std::string& str, size_t& pos) {
+    uint32_t bits = (uint32_t)read_u64(str, pos);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void write_vec2(std::string& out, const b2Vec2& value) {
+    write_float(out, value.x);
+    write_float(out, value.y);
+}
+
+static b2Vec2 read_vec2(const std::string& str, size_t& pos) {
+    float x = read_float(str, pos);
+    float y = read_float(str, pos);
+    return b2Vec2(x, y);
+}
+
+static void write_string(std::string& out, const std::string& value) {
+    write_u64(out, value.size());
+    out += value;
+}
+
+static std::string read_string(const std::string& str, size_t& pos) {
+    size_t size = read_u64(str, pos);
+    if (pos + size > str.size()) {
+        throw std::runtime_error("String out of range");
+    }
+    std::string value = str.substr(pos, size);
+    pos += size;
+    return value;
+}
+
+EditChange::~EditChange() { }
+
+dp::DataPointerUnique<EditChange> EditChange::deserialize(const std::string& str, size_t& pos) {
+    Type type = (Type)read_u64(str, pos);
+    switch (type) {
+        case TRANSFORM: return TransformChange::deserialize(str, pos);
+        case VERTICES: return VerticesChange::deserialize(str, pos);
+        case EXISTENCE: return ExistenceChange::deserialize(str, pos);
+        default: throw std::runtime_error("Unknown change type: " + std::to_string(type));
+    }
+}
+
+GameObject* EditChange::getObject(Editor& editor, ptrdiff_t id) {
+    GameObject* object = editor.simulation.getById(id);
+    if (!object) {
+        throw std::runtime_error("Object not found: " + std::to_string(id));
+    }
+    return object;
+}
+
+void EditChange::removeObject(Editor& editor, GameObject* object) {
+    editor.deleteObject(object, false);
+}
+
+GameObjectList& EditChange::getObjectList(Editor& editor) {
+    return editor.simulation;
+}
+
+TransformChange::TransformChange() { }
+
+TransformChange::TransformChange(GameObject* object, const b2Vec2& before_pos, float before_angle) {
+    this->id = object->getId();
+    this->before_pos = before_pos;
+    this->before_angle = before_angle;
+    this->after_pos = object->getGlobalPosition();
+    this->after_angle = object->getGlobalRotation();
+}
+
+void TransformChange::undo(Editor& editor) {
+    apply(editor, before_pos, before_angle);
+}
+
+void TransformChange::redo(Editor& editor) {
+    apply(editor, after_pos, after_angle);
+}
+
+size_t TransformChange::getMemorySize() const {
+    return sizeof(TransformChange);
+}
+
+void TransformChange::serialize(std::string& out) const {
+    write_u64(out, TRANSFORM);
+    write_u64(out, id);
+    write_vec2(out, before_pos);
+    write_float(out, before_angle);
+    write_vec2(out, after_pos);
+    write_float(out, after_angle);
+}
+
+dp::DataPointerUnique<TransformChange> TransformChange::deserialize(const std::string& str, size_t& pos) {
+    dp::DataPointerUnique<TransformChange> change = dp::make_data_pointer<TransformChange>("Move");
+    change->id = (ptrdiff_t)read_u64(str, pos);
+    change->before_pos = read_vec2(str, pos);
+    change->before_angle = read_float(str, pos);
+    change->after_pos = read_vec2(str, pos);
+    change->after_angle = read_float(str, pos);
+    return change;
+}
+
+void TransformChange::apply(Editor& editor, const b2Vec2& pos, float angle) {
+    GameObject* object = getObject(editor, id);
+    object->setGlobalPosition(pos);
+    object->setGlobalAngle(angle);
+}
+
+VerticesChange::VerticesChange() { }
+
+VerticesChange::VerticesChange(GameObject* object, const std::vector<b2Vec2>& before) {
+    this->id = object->getId();
+    this->before = before;
+    this->after = getPositions(object);
+}
+
+void VerticesChange::undo(Editor& editor) {
+    getObject(editor, id)->setVertices(before);
+}
+
+void VerticesChange::redo(Editor& editor) {
+    getObject(editor, id)->setVertices(after);
+}
+
+size_t VerticesChange::getMemorySize() const {
+    return sizeof(VerticesChange) + (before.capacity() + after.capacity()) * sizeof(b2Vec2);
+}
+
+void VerticesChange::serialize(std::string& out) const {
+    write_u64(out, VERTICES);
+    write_u64(out, id);
+    for (const std::vector<b2Vec2>* positions : { &before, &after }) {
+        write_u64(out, positions->size());
+        for (const b2Vec2& pos : *positions) {
+            write_vec2(out, pos);
+        }
+    }
+}
+
+dp::DataPointerUnique<VerticesChange> VerticesChange::deserialize(const std::string& str, size_t& pos) {
+    dp::DataPointerUnique<VerticesChange> change = dp::make_data_pointer<VerticesChange>("Vertices");
+    change->id = (ptrdiff_t)read_u64(str, pos);
+    for (std::vector<b2Vec2>* positions : { &change->before, &change->after }) {
+        size_t count = read_u64(str, pos);
+        for (size_t i = 0; i < count; i++) {
+            positions->push_back(read_vec2(str, pos));
+        }
+    }
+    return change;
+}
+
+std::vector<b2Vec2> VerticesChange::getPositions(const GameObject* object) {
+    return object->getVertices();
+}
+
+ExistenceChange::ExistenceChange() { }
+
+ExistenceChange::ExistenceChange(GameObject* object, bool added) {
+    this->added = added;
+    this->id = object->getId();
+    this->str = object->serialize();
+    this->index = object->getIndex();
+    for (GameObject* child : object->getChildren()) {
+        children.push_back(child->getId());
+    }
+    for (Joint* joint : object->getJoints()) {
+        JointRecord record;
+        record.object1_id = joint->object1->getId();
+        record.object2_id = joint->object2->getId();
+        record.str = joint->serialize();
+        joints.push_back(record);
+    }
+}
+
+void ExistenceChange::undo(Editor& editor) {
+    if (added) {
+        remove(editor);
+    } else {
+        restore(editor);
+    }
+}
+
+void ExistenceChange::redo(Editor& editor) {
+    if (added) {
+        restore(editor);
+    } else {
+        remove(editor);
+    }
+}
+
+void ExistenceChange::restore(Editor& editor) {
+    try {
+        GameObjectList& object_list = getObjectList(editor);
+        TokenReader tr(str);
+        tr.eat("object");
+        dp::DataPointerUnique<GameObject> uptr = Simulation::deserializeObject(tr, &object_list);
+        GameObject* object = object_list.add(std::move(uptr), false);
+        // siblings which are restored later are not there yet
+        GameObject* parent = object->getParent();
+        size_t sibling_count = parent ? parent->getChildren().size() : object_list.getTopObjects().size();
+        object->moveToIndex(std::min(index, sibling_count));
+        // child which is not restored yet has parent id in its own record
+        // and is linked to this object when it's restored
+        size_t child_index = 0;
+        for (ptrdiff_t child_id : children) {
+            GameObject* child = object_list.getById(child_id);
+            if (!child) {
+                continue;
+            }
+            child->setParent(object);
+            child->moveToIndex(child_index);
+            child_index++;
+        }
+        // joint to an object which is not restored yet
+        // will be restored together with that object
+        for (const JointRecord& record : joints) {
+            GameObject* object1 = object_list.getById(record.object1_id);
+            GameObject* object2 = object_list.getById(record.object2_id);
+            if (!object1 || !object2) {
+                continue;
+            }
+            object_list.addJoint(RevoluteJoint::deserialize(record.str, &object_list));
+        }
+    } catch (std::exception exc) {
+        throw std::runtime_error(__FUNCTION__": " + std::string(exc.what()));
+    }
+}
+
+void ExistenceChange::remove(Editor& editor) {
+    removeObject(editor, getObject(editor, id));
+}
+
+size_t ExistenceChange::getMemorySize() const {
+    size_t result = sizeof(ExistenceChange) + str.capacity();
+    result += children.capacity() * sizeof(ptrdiff_t);
+    result += joints.capacity() * sizeof(JointRecord);
+    for (const JointRecord& record : joints) {
+        result += record.str.capacity();
+    }
+    return result;
+}
+
+void ExistenceChange::serialize(std::string& out) const {
+    write_u64(out, EXISTENCE);
+    write_u64(out, added ? 1 : 0);
+    write_u64(out, id);
+    write_string(out, str);
+    write_u64(out, index);
+    write_u64(out, children.size());
+    for (ptrdiff_t child_id : children) {
+        write_u64(out, child_id);
+    }
+    write_u64(out, joints.size());
+    for (const JointRecord& record : joints) {
+        write_u64(out, record.object1_id);
+        write_u64(out, record.object2_id);
+        write_string(out, record.str);
+    }
+}
+
+dp::DataPointerUnique<ExistenceChange> ExistenceChange::deserialize(const std::string& str, size_t& pos) {
+    dp::DataPointerUnique<ExistenceChange> change = dp::make_data_pointer<ExistenceChange>("Existence");
+    change->added = read_u64(str, pos) != 0;
+    change->id = (ptrdiff_t)read_u64(str, pos);
+    change->str = read_string(str, pos);
+    change->index = read_u64(str, pos);
+    size_t child_count = read_u64(str, pos);
+    for (size_t i = 0; i < child_count; i++) {
+        change->children.push_back((ptrdiff_t)read_u64(str, pos));
+    }
+    size_t joint_count = read_u64(str, pos);
+    for (size_t i = 0; i < joint_count; i++) {
+        JointRecord record;
+        record.object1_id = (ptrdiff_t)read_u64(str, pos);
+        record.object2_id = (ptrdiff_t)read_u64(str, pos);
+        record.str = read_string(str, pos);
+        change->joints.push_back(record);
+    }
+    return change;
+}
+
+EditAction::EditAction() { }
+
+size_t EditAction::size() const {
+    return changes.size();
+}
+
+bool EditAction::empty() const {
+    return changes.empty();
+}
+
+void EditAction::add(dp::DataPointerUnique<EditChange> change) {
+    changes.push_back(std::move(change));
+}
+
+void EditAction::undo(Editor& editor) {
+    for (ptrdiff_t i = changes.size() - 1; i >= 0; i--) {
+        changes[i]->undo(editor);
+    }
+}
+
+void EditAction::redo(Editor& editor) {
+    for (size_t i = 0; i < changes.size(); i++) {
+        changes[i]->redo(editor);
+    }
+}
+
+void EditAction::clear() {
+    changes.clear();
+}
+
+size_t EditAction::getMemorySize() const {
+    size_t result = sizeof(EditAction) + changes.capacity() * sizeof(dp::DataPointerUnique<EditChange>);
+    for (const dp::DataPointerUnique<EditChange>& change : changes) {
+        result += change->getMemorySize();
+    }
+    return result;
+}
+
+void EditAction::serialize(std::string& out) const {
+    write_u64(out, changes.size());
+    for (const dp::DataPointerUnique<EditChange>& change : changes) {
+        change->serialize(out);
+    }
+}
+
+EditAction EditAction::deserialize(const std::string& str) {
+    try {
+        EditAction action;
+        size_t pos = 0;
+        size_t count = read_u64(str, pos);
+        for (size_t i = 0; i < count; i++) {
+            action.add(EditChange::deserialize(str, pos));
+        }
+        return action;
+    } catch (std::exception exc) {
+        throw std::runtime_error(__FUNCTION__": " + std::string(exc.what()));
+    }
+}
@@ -6,6 +6,7 @@
 #include "editor/UI/edit_window.h"
 #include "editor/UI/outliner.h"
 #include "editor/UI/menu.h"
+#include "editor/UI/memory_overlay.h"
 #include "common/utils.h"
 #include "common/filedialog.h"
 #include <numbers>
@@ -163,6 +164,10 @@ void Editor::onInit() {
     auto getter = [&]() { return serialize(); };
     auto setter = [&](std::string str) { deserialize(str, false); };
     history = History<std::string>("Editor", getter, setter);
+    history.enableSpill(HISTORY_RAM_WINDOW);
+    // current history entry is already serialized, so taking a snapshot is just a copy
+    auto snapshot_getter = [&]() { return history.getCurrent().value; };
+    autosave = Autosave(&file_writer, snapshot_getter);
 
     assert(tools.size() > 0);
     assert(selected_tool);
@@ -174,16 +179,21 @@ void Editor::onInit() {
 void Editor::onStart() {
     history.clear();
     history.save("Base");
+    autosave.reset();
     fps_counter.init();
 }
 
 void Editor::onFrameBegin() {
     fps_counter.frameBegin();
+    processDecompositionResults();
 }
 
 void Editor::onFrameEnd() {
     int fps = fps_counter.frameEnd();
     fps_text_widget->setString(std::to_string(fps));
+    autosave.update();
+    processFileWriteResults();
+    memory_overlay_widget->updateStats();
 }
 
 void Editor::onProcessWidgets() {
@@ -402,6 +412,9 @@ void Editor::initWidgets() {
     debug_release_widget->setParentAnchor(fw::Widget::Anchor::BOTTOM_RIGHT);
     debug_release_widget->setName("debug_release text");
 
+    // memory overlay
+    memory_overlay_widget = widgets.createWidget<MemoryOverlay>(*this);
+
     edit_tool.edit_window_widget->moveToTop();
 }
 
@@ -441,13 +454,19 @@ void Editor::onProcessKeyboardEvent(const sf::Event& event) {
             trySelectToolByIndex(9);
         } else if (event.key.code == sf::Keyboard::X) {
             if (selected_tool == &select_tool) {
-                CompVector<GameObject*> selected_copy = select_tool.getSelectedObjects();
+                CompVector<GameObject*> selected_copy = select_tool.getSelectedObjects().getVector();
+                // outliner removes all entries at once
+                EventBatchScope batch(simulation.OnAfterObjectRemoved);
                 for (GameObject* obj : selected_copy | std::views::reverse) {
+                    pending_action.add(dp::make_data_pointer<ExistenceChange>("Remove", obj, false));
                     deleteObject(obj, false);
                     commit_action = true;
                 }
+                batch.end();
             } else if (selected_tool == &edit_tool && active_object) {
+                std::vector<b2Vec2> before = VerticesChange::getPositions(active_object);
                 if (active_object->tryDeleteVertex(edit_tool.highlighted_vertex)) {
+                    pending_action.add(dp::make_data_pointer<VerticesChange>("DeleteVertex", active_object, before));
                     commit_action = true;
                 }
             }
@@ -513,8 +532,9 @@ void Editor::onProcessKeyboardEvent(const sf::Event& event) {
         } else if (event.key.code == sf::Keyboard::D) {
             if (isLShiftPressed()) {
                 if (selected_tool == &select_tool && select_tool.selectedCount() > 0) {
-                    CompVector<GameObject*> old_objects = select_tool.getSelectedObjects();
+                    CompVector<GameObject*> old_objects = select_tool.getSelectedObjects().getVector();
                     CompVector<GameObject*> new_objects = simulation.duplicate(old_objects);
+                    recordAdded(new_objects);
                     select_tool.setSelected(new_objects);
                     Tool* s_tool = selected_tool;
                     trySelectTool(&move_tool);
@@ -533,6 +553,13 @@ void Editor::onProcessKeyboardEvent(const sf::Event& event) {
             simulation.advance(timeStep);
         } else if (event.key.code == sf::Keyboard::Slash) {
             viewSelectedObjects();
+        } else if (event.key.code == sf::Keyboard::M) {
+            if (isLCtrlPressed()) {
+                exportMemoryStats("memory_stats.json");
+            } else {
+                memory_overlay_widget->toggleVisible();
+                memory_overlay_widget->updateStats(true);
+            }
         } else if (event.key.code == sf::Keyboard::F) {
             if (follow_object) {
                 follow_object = nullptr;
@@ -557,20 +584,23 @@ void Editor::onProcessKeyboardEvent(const sf::Event& event) {
 void Editor::processLeftPress(const sf::Vector2f& pos) {
     if (selected_tool == &create_tool) {
         std::string id_string = std::to_string(simulation.getMaxId() + 1);
+        GameObject* new_object = nullptr;
         switch (create_tool.type) {
             case CreateTool::BOX:
-                simulation.createBox(
+                new_object = simulation.createBox(
                     "box" + id_string, getMouseWorldPosb2(), 0.0f, NEW_BOX_SIZE, NEW_BOX_COLOR
                 );
-                commit_action = true;
                 break;
             case CreateTool::BALL:
-                simulation.createBall(
+                new_object = simulation.createBall(
                     "ball" + id_string, getMouseWorldPosb2(), NEW_BALL_RADIUS, NEW_BALL_COLOR, NEW_BALL_NOTCH_COLOR
                 );
-                commit_action = true;
                 break;
         }
+        if (new_object) {
+            pending_action.add(dp::make_data_pointer<ExistenceChange>("Create", new_object, true));
+            commit_action = true;
+        }
     } else if (selected_tool == &drag_tool) {
         b2Fixture* grabbed_fixture = getFixtureAt(getMousePosf());
         if (grabbed_fixture) {
@@ -618,10 +648,10 @@ void Editor::processLeftPress(const sf::Vector2f& pos) {
             if (edit_tool.highlighted_vertex != -1) {
                 edit_tool.mode = EditTool::MOVE;
                 edit_tool.grabbed_vertex = edit_tool.highlighted_vertex;
-                const EditableVertex& vertex = active_object->getVertex(edit_tool.grabbed_vertex);
-                edit_tool.grabbed_vertex_offset = vertex.pos - active_object->toLocal(getMouseWorldPosb2());
+                const b2Vec2& vertex_pos = active_object->getVertexPos(edit_tool.grabbed_vertex);
+                edit_tool.grabbed_vertex_offset = vertex_pos - active_object->toLocal(getMouseWorldPosb2());
                 bool shift = isLShiftPressed();
-                if (!vertex.selected && !shift) {
+                if (!active_object->isVertexSelected(edit_tool.grabbed_vertex) && !shift) {
                     active_object->deselectAllVertices();
                 } else if (shift) {
                     active_object->selectVertex(edit_tool.grabbed_vertex);
@@ -635,14 +665,18 @@ void Editor::processLeftPress(const sf::Vector2f& pos) {
                 }
             }
         } else if (edit_tool.mode == EditTool::ADD && edit_tool.edge_vertex != -1) {
+            std::vector<b2Vec2> before = VerticesChange::getPositions(active_object);
             if (edit_tool.edge_vertex == 0) {
                 active_object->addVertexGlobal(0, getMouseWorldPosb2());
             } else if (edit_tool.edge_vertex > 0) {
                 active_object->addVertexGlobal(edit_tool.edge_vertex + 1, getMouseWorldPosb2());
             }
+            pending_action.add(dp::make_data_pointer<VerticesChange>("AddVertex", active_object, before));
             commit_action = true;
         } else if (edit_tool.mode == EditTool::INSERT && edit_tool.highlighted_edge != -1) {
+            std::vector<b2Vec2> before = VerticesChange::getPositions(active_object);
             active_object->addVertexGlobal(edit_tool.highlighted_edge + 1, edit_tool.insertVertexPos);
+            pending_action.add(dp::make_data_pointer<VerticesChange>("InsertVertex", active_object, before));
             commit_action = true;
         }
     }
@@ -667,6 +701,12 @@ void Editor::processGlobalLeftRelease(const sf::Vector2f& pos) {
     }
     if (edit_tool.grabbed_vertex != -1) {
         edit_tool.grabbed_vertex = -1;
+        finishDecomposition(active_object);
+        std::vector<b2Vec2> before(active_object->getVertexCount());
+        for (size_t i = 0; i < before.size(); i++) {
+            before[i] = active_object->getSavedVertexPos(i);
+        }
+        pending_action.add(dp::make_data_pointer<VerticesChange>("MoveVertices", active_object, before));
         active_object->saveOffsets();
         commit_action = true;
         edit_tool.mode = EditTool::HOVER;
@@ -723,20 +763,15 @@ void Editor::processMouse(const sf::Vector2f& pos) {
             }
         }
     } else if (selected_tool == &rotate_tool) {
-        for (size_t i = 0; i < rotate_tool.rotating_objects.size(); i++) {
-            GameObject* obj = rotate_tool.rotating_objects[i];
-            b2Vec2 mouse_vector = getMouseWorldPosb2() - rotate_tool.pivot_pos;
-            float current_mouse_angle = atan2(mouse_vector.y, mouse_vector.x);
-            float offset = current_mouse_angle - rotate_tool.orig_mouse_angle;
-            if (isLCtrlPressed()) {
-                float offset_deg = utils::to_degrees(offset);
-                float quantized_offset = ((int)(offset_deg / ROTATE_ANGLE_STEP)) * ROTATE_ANGLE_STEP;
-                offset = utils::to_radians(quantized_offset);
-            }
-            b2Vec2 new_pos = utils::rotate_point(obj->orig_pos, rotate_tool.pivot_pos, offset);
-            obj->setGlobalPosition(new_pos);
-            obj->setGlobalAngle(obj->orig_angle + offset);
+        b2Vec2 mouse_vector = getMouseWorldPosb2() - rotate_tool.pivot_pos;
+        float current_mouse_angle = atan2(mouse_vector.y, mouse_vector.x);
+        float offset = current_mouse_angle - rotate_tool.orig_mouse_angle;
+        if (isLCtrlPressed()) {
+            float offset_deg = utils::to_degrees(offset);
+            float quantized_offset = ((int)(offset_deg / ROTATE_ANGLE_STEP)) * ROTATE_ANGLE_STEP;
+            offset = utils::to_radians(quantized_offset);
         }
+        simulation.rotateObjects(rotate_tool.rotating_objects, rotate_tool.pivot_pos, offset);
     }
 }
 
@@ -763,11 +798,16 @@ void Editor::processDragGestureLeft(const sf::Vector2f& pos) {
         } else if (edit_tool.mode == EditTool::MOVE) {
             if (edit_tool.grabbed_vertex != -1) {
                 ptrdiff_t index = edit_tool.grabbed_vertex;
-                const EditableVertex& vertex = active_object->getVertex(index);
-                b2Vec2 offset = active_object->toLocal(getMouseWorldPosb2()) + edit_tool.grabbed_vertex_offset - vertex.orig_pos;
+                const b2Vec2& saved_pos = active_object->getSavedVertexPos(index);
+                b2Vec2 offset = active_object->toLocal(getMouseWorldPosb2()) + edit_tool.grabbed_vertex_offset - saved_pos;
                 active_object->offsetVertex(index, offset, false);
                 active_object->offsetSelected(offset, false);
-                active_object->syncVertices();
+                if (PolygonObject* polygon_object = dynamic_cast<PolygonObject*>(active_object)) {
+                    // decomposing large polygons takes longer than a frame
+                    polygon_object->syncVerticesDeferred(decomposer);
+                } else {
+                    active_object->syncVertices();
+                }
             }
         }
     }
@@ -788,15 +828,11 @@ void Editor::onAfterProcessInput() {
     // must be here to avoid a bug in situaltion when
     // the user is using move tool and moving camera at the same time
     if (selected_tool == &move_tool) {
-        for (GameObject* obj : move_tool.moving_objects) {
-            b2Vec2 mouse_pos = getMouseWorldPosb2();
-            b2Vec2 cursor_offset = obj->cursor_offset;
-            b2Vec2 new_pos = mouse_pos + cursor_offset;
-            obj->setGlobalPosition(new_pos);
-        }
+        b2Vec2 offset = getMouseWorldPosb2() - move_tool.orig_cursor_pos;
+        simulation.offsetObjects(move_tool.moving_objects, offset);
     }
     if (commit_action) {
-        history.save("Normal");
+        commitAction("Normal");
         commit_action = false;
     }
     if (quickload_requested) {
@@ -813,6 +849,53 @@ void Editor::onAfterProcessInput() {
     }
 }
 
+void Editor::commitAction(const std::string& tag) {
+    if (pending_action.empty()) {
+        history.save(tag);
+        return;
+    }
+    dp::DataPointerShared<EditAction> action = dp::make_shared_data_pointer<EditAction>(
+        "EditAction " + tag, std::move(pending_action)
+    );
+    pending_action = EditAction();
+    history.save(tag, createHistoryAction(tag, action));
+}
+
+HistoryAction Editor::createHistoryAction(const std::string& tag, const dp::DataPointerShared<EditAction>& action) {
+    HistoryAction history_action;
+    history_action.undo = [action, this]() { applyEditAction(*action, true); };
+    history_action.redo = [action, this]() { applyEditAction(*action, false); };
+    // removed objects are kept in the action, so it's counted and spilled with the entry
+    history_action.memory_size = action->getMemorySize();
+    history_action.encode = [action](std::string& out) { action->serialize(out); };
+    history_action.decode = [tag, this](const std::string& str) {
+        dp::DataPointerShared<EditAction> action = dp::make_shared_data_pointer<EditAction>(
+            "EditAction " + tag, EditAction::deserialize(str)
+        );
+        return createHistoryAction(tag, action);
+    };
+    return history_action;
+}
+
+void Editor::applyEditAction(EditAction& action, bool undo) {
+    // tools might be holding objects and vertices the action is going to change
+    endMove(false);
+    endRotate(false);
+    edit_tool.grabbed_vertex = -1;
+    edit_tool.highlighted_vertex = -1;
+    edit_tool.highlighted_edge = -1;
+    edit_tool.edge_vertex = -1;
+    try {
+        if (undo) {
+            action.undo(*this);
+        } else {
+            action.redo(*this);
+        }
+    } catch (std::exception exc) {
+        throw std::runtime_error(__FUNCTION__": " + std::string(exc.what()));
+    }
+}
+
 void Editor::onProcessWorld() {
     if (!paused) {
         simulation.advance(timeStep);
@@ -832,6 +915,14 @@ void Editor::renderWorld() {
     world_widget->clear(sf::Color::Transparent);
     world_widget->setViewCenter(tosf(camera.getPosition()));
     world_widget->setViewSize(world_widget->getSize().x / camera.getZoom(), -1.0f * world_widget->getSize().y / camera.getZoom());
+    // balls and boxes are collected and drawn together until
+    // some other object is drawn, so drawing order stays the same
+    auto draw_instanced = [&]() {
+        if (!instanced_shapes.empty()) {
+            canvasDraw(world_widget, instanced_shapes);
+            instanced_shapes.clear();
+        }
+    };
     for (size_t i = 0; i < simulation.getTopSize(); i++) {
         GameObject* gameobject = simulation.getFromTop(i);
         gameobject->setDrawVarray(selected_tool == &edit_tool && gameobject == active_object);
@@ -840,10 +931,15 @@ void Editor::renderWorld() {
                 render_object(object->getChild(i));
             }
             object->updateVisual();
-            canvasDraw(world_widget, *object->getDrawable());
+            sf::Drawable* drawable = object->getDrawable();
+            if (!instanced_shapes.add(*drawable)) {
+                draw_instanced();
+                canvasDraw(world_widget, *drawable);
+            }
         };
         render_object(gameobject);
     }
+    draw_instanced();
     world_widget->display();
 
     selection_mask_widget->clear();
@@ -958,9 +1054,10 @@ void Editor::renderUi() {
             edit_tool.vertex_rect.setPosition(ghost_vertex_pos);
             ui_widget->draw(edit_tool.vertex_rect);
         }
+        utils::batch::Points global_vertices = active_object->getGlobalVertices();
         // vertices
-        for (size_t i = 0; i < active_object->getVertexCount(); i++) {
-            edit_tool.vertex_rect.setPosition(worldToScreen(active_object->getGlobalVertexPos(i)));
+        for (size_t i = 0; i < global_vertices.size(); i++) {
+            edit_tool.vertex_rect.setPosition(worldToScreen(global_vertices.getb2(i)));
             bool selected = active_object->isVertexSelected(i);
             sf::Color vertex_color = selected ? sf::Color(255, 255, 0) : sf::Color(255, 0, 0);
             edit_tool.vertex_rect.setFillColor(vertex_color);
@@ -970,8 +1067,8 @@ void Editor::renderUi() {
         for (size_t i = 0; i < active_object->getEdgeCount(); i++) {
             sf::Vector2f norm_v1, norm_v2;
             getScreenNormal(
-                active_object->getGlobalVertexPos(i),
-                active_object->getGlobalVertexPos(active_object->indexLoop(i + 1)),
+                global_vertices.getb2(i),
+                global_vertices.getb2(active_object->indexLoop(i + 1)),
                 norm_v1, 
                 norm_v2
             );
@@ -1011,6 +1108,7 @@ void Editor::deserialize(const std::string& str, bool set_camera) {
         follow_object_id = follow_object->getId();
     }
     initTools();
+    pending_action.clear();
     TokenReader tr(str);
     try {
         while (tr.validRange()) {
@@ -1035,6 +1133,9 @@ void Editor::deserialize(const std::string& str, bool set_camera) {
             GameObject* object = simulation.getById(follow_object_id);
             follow_object = object;
         }
+        if (memory_overlay_widget) {
+            memory_overlay_widget->requestBaseline();
+        }
     } catch (std::exception exc) {
         throw std::runtime_error(__FUNCTION__": Line " + std::to_string(tr.getLine(-1)) + ": " + exc.what());
     }
@@ -1051,9 +1152,44 @@ void Editor::save() {
 void Editor::saveToFile(const std::filesystem::path& path) {
     LoggerTag tag_saveload("saveload");
     std::string str = serialize();
-    utils::str_to_file(str, path);
+    file_writer.write("Save", std::move(str), path);
     save_file_location = path;
-    editor_logger << "Saved to " << path << "\n";
+}
+
+void Editor::processFileWriteResults() {
+    LoggerTag tag_saveload("saveload");
+    std::vector<FileWriteResult> results = file_writer.takeResults();
+    for (const FileWriteResult& result : results) {
+        if (!result.success) {
+            editor_logger << result.tag << " failed: " << result.error << "\n";
+        } else if (result.tag == "Autosave") {
+            logger << "Autosaved to " << result.path.string() << "\n";
+        } else {
+            editor_logger << "Saved to " << result.path << "\n";
+        }
+    }
+}
+
+void Editor::processDecompositionResults() {
+    std::vector<DecompositionResult> results = decomposer.takeResults();
+    for (const DecompositionResult& result : results) {
+        // results for deleted or since changed objects are dropped
+        GameObject* object = simulation.getById(result.object_id);
+        if (PolygonObject* polygon_object = dynamic_cast<PolygonObject*>(object)) {
+            polygon_object->applyDecomposition(result);
+        }
+    }
+}
+
+void Editor::finishDecomposition(GameObject* object) {
+    PolygonObject* polygon_object = dynamic_cast<PolygonObject*>(object);
+    if (!polygon_object || !polygon_object->isDecompositionPending()) {
+        return;
+    }
+    // fixtures are recut right away, so the action that is committed
+    // after releasing the vertices doesn't save stale fixtures
+    decomposer.cancel(polygon_object->getId());
+    polygon_object->syncVertices();
 }
 
 void Editor::requestLoad(const std::filesystem::path& path) {
@@ -1068,9 +1204,12 @@ void Editor::loadFromFile(const std::filesystem::path& path) {
         mAssert(false, "Cannot load file in this stage");
     }
     try {
+        file_writer.wait(); // file might be still being written
         std::string str = utils::file_to_str(path);
         deserialize(str, true);
         save_file_location = path;
+        // next autosave is a full interval after loading
+        autosave.reset();
         editor_logger << "Editor loaded from " << path << "\n";
     } catch (std::exception exc) {
         throw std::runtime_error(__FUNCTION__": " + path.string() + ": " + std::string(exc.what()));
@@ -1093,6 +1232,11 @@ void Editor::quickload() {
     }
 }
 
+void Editor::exportMemoryStats(const std::filesystem::path& path) {
+    LoggerTag tag_saveload("saveload");
+    file_writer.write("Memory stats", dp::get_memory_snapshot().toJson(), path);
+}
+
 void Editor::showOpenFileMenu() {
     std::wstring filename = open_file_dialog("levels/");
     endGestureLeft(); // dialog prevents mouse button release
@@ -1275,19 +1419,26 @@ ptrdiff_t Editor::mouseGetObjectVertex() const {
     if (!active_object) {
         return -1;
     }
-    ptrdiff_t closest_vertex_i = 0;
-    sf::Vector2i closest_vertex_pos = worldToPixel(active_object->getGlobalVertexPos(0));
-    float closest_vertex_offset = utils::get_max_offset(closest_vertex_pos, getMousePos());
-    for (size_t i = 1; i < active_object->getVertexCount(); i++) {
+    // only vertices in the square around the mouse can be close enough,
+    // it is a bit larger to account for rounding to pixels
+    float query_distance = EditTool::VERTEX_HIGHLIGHT_DISTANCE + 2.0f;
+    sf::Vector2f mouse_pos = to2f(getMousePos());
+    b2Vec2 corner1 = tob2(screenToWorld(mouse_pos - sf::Vector2f(query_distance, query_distance)));
+    b2Vec2 corner2 = tob2(screenToWorld(mouse_pos + sf::Vector2f(query_distance, query_distance)));
+    b2AABB query_aabb;
+    query_aabb.lowerBound = b2Min(corner1, corner2);
+    query_aabb.upperBound = b2Max(corner1, corner2);
+    ptrdiff_t closest_vertex_i = -1;
+    float closest_vertex_offset = 0.0f;
+    for (size_t i : active_object->getVerticesInRect(query_aabb)) {
         sf::Vector2i vertex_pos = worldToPixel(active_object->getGlobalVertexPos(i));
-        float offset = (float)utils::get_max_offset(vertex_pos, getMousePos());
-        if (offset < closest_vertex_offset) {
+        float offset = utils::get_max_offset(vertex_pos, getMousePos());
+        if (closest_vertex_i == -1 || offset < closest_vertex_offset) {
             closest_vertex_i = i;
-            closest_vertex_pos = vertex_pos;
             closest_vertex_offset = offset;
         }
     }
-    if (closest_vertex_offset <= EditTool::VERTEX_HIGHLIGHT_DISTANCE) {
+    if (closest_vertex_i != -1 && closest_vertex_offset <= EditTool::VERTEX_HIGHLIGHT_DISTANCE) {
         return closest_vertex_i;
     }
     return -1;
@@ -1297,9 +1448,10 @@ ptrdiff_t Editor::mouseGetObjectEdge() const {
     if (!active_object) {
         return -1;
     }
+    utils::batch::Points global_vertices = active_object->getGlobalVertices();
     for (size_t i = 0; i < active_object->getEdgeCount(); i++) {
-        b2Vec2 p1 = active_object->getGlobalVertexPos(i);
-        b2Vec2 p2 = active_object->getGlobalVertexPos(active_object->indexLoop(i + 1));
+        b2Vec2 p1 = global_vertices.getb2(i);
+        b2Vec2 p2 = global_vertices.getb2(active_object->indexLoop(i + 1));
         b2Vec2 dir = p2 - p1;
         b2Vec2 side1_dir = utils::rot90CW(dir);
         b2Vec2 side2_dir = utils::rot90CCW(dir);
@@ -1349,13 +1501,11 @@ void Editor::selectVerticesInRect(const RectangleSelect& rectangle_select) {
     float top = std::min(mpos.y, origin.y);
     float right = std::max(mpos.x, origin.x);
     float bottom = std::max(mpos.y, origin.y);
-    float width = right - left;
-    float height = bottom - top;
-    sf::FloatRect rect(left, top, width, height);
-    for (size_t i = 0; i < active_object->getVertexCount(); i++) {
-        if (utils::contains_point(rect, tosf(active_object->getGlobalVertexPos(i)))) {
-            active_object->selectVertex(i);
-        }
+    b2AABB aabb;
+    aabb.lowerBound = b2Vec2(left, top);
+    aabb.upperBound = b2Vec2(right, bottom);
+    for (size_t i : active_object->getVerticesInRect(aabb)) {
+        active_object->selectVertex(i);
     }
 }
 
@@ -1411,10 +1561,8 @@ void Editor::getScreenNormal(const sf::Vector2i& v1, const sf::Vector2i& v2, sf:
 }
 
 bool Editor::isParentSelected(const GameObject* object) const {
-    CompVector<GameObject*> parents = object->getParentChain();
-    for (size_t i = 0; i < parents.size(); i++) {
-        auto it = select_tool.getSelectedObjects().find(parents[i]);
-        if (it != select_tool.getSelectedObjects().getSet().end()) {
+    for (const GameObject* parent = object->getParent(); parent; parent = parent->getParent()) {
+        if (select_tool.getSelectedObjects().contains(const_cast<GameObject*>(parent))) {
             return true;
         }
     }
@@ -1431,6 +1579,7 @@ void Editor::grabSelected(Tool* selected_tool) {
         }
         move_tool.moving_objects.add(obj);
         obj->orig_pos = obj->getGlobalPosition();
+        obj->orig_angle = obj->getGlobalRotation();
         obj->cursor_offset = obj->getGlobalPosition() - getMouseWorldPosb2();
         obj->was_enabled = obj->getRigidBody()->IsEnabled();
         obj->setEnabled(false, true);
@@ -1465,11 +1614,13 @@ void Editor::rotateSelected(Tool* selected_tool) {
 }
 
 void Editor::endMove(bool confirm) {
+    if (!confirm) {
+        simulation.offsetObjects(move_tool.moving_objects, b2Vec2_zero);
+    }
     for (GameObject* obj : move_tool.moving_objects) {
         if (confirm) {
+            pending_action.add(dp::make_data_pointer<TransformChange>("Move", obj, obj->orig_pos, obj->orig_angle));
             commit_action = true;
-        } else {
-            obj->setGlobalPosition(obj->orig_pos);
         }
         //TODO: remember state for all children
         obj->setEnabled(obj->was_enabled, true);
@@ -1478,12 +1629,13 @@ void Editor::endMove(bool confirm) {
 }
 
 void Editor::endRotate(bool confirm) {
+    if (!confirm) {
+        simulation.rotateObjects(rotate_tool.rotating_objects, rotate_tool.pivot_pos, 0.0f);
+    }
     for (GameObject* obj : rotate_tool.rotating_objects) {
         if (confirm) {
+            pending_action.add(dp::make_data_pointer<TransformChange>("Rotate", obj, obj->orig_pos, obj->orig_angle));
             commit_action = true;
-        } else {
-            obj->setGlobalPosition(obj->orig_pos);
-            obj->setGlobalAngle(obj->orig_angle);
         }
         //TODO: remember state for all children
         obj->setEnabled(obj->was_enabled, true);
@@ -1505,11 +1657,22 @@ void Editor::deleteObject(GameObject* object, bool remove_children) {
     simulation.remove(object, remove_children);
 }
 
+void Editor::recordAdded(const CompVector<GameObject*>& objects) {
+    // parents have to be restored before their children
+    std::vector<GameObject*> sorted = objects.getVector();
+    std::stable_sort(sorted.begin(), sorted.end(), [](GameObject* left, GameObject* right) {
+        return left->getDepth() < right->getDepth();
+    });
+    for (GameObject* obj : sorted) {
+        pending_action.add(dp::make_data_pointer<ExistenceChange>("Create", obj, true));
+    }
+}
+
 void Editor::viewSelectedObjects() {
     if (select_tool.selectedCount() == 0) {
         return;
     }
-    b2AABB aabb = getObjectsAABB(select_tool.getSelectedObjects());
+    b2AABB aabb = getObjectsAABB(select_tool.getSelectedObjects().getVector());
     float sizeX = aabb.upperBound.x - aabb.lowerBound.x;
     float sizeY = aabb.upperBound.y - aabb.lowerBound.y;
     float zoomX = window.getSize().x / sizeX;
@@ -1545,6 +1708,8 @@ void Editor::canvasDraw(fw::CanvasWidget* canvas, const sf::Drawable& drawable,
         canvas->draw(drawable, fw::ColorType::VERTEX);
     } else if (dynamic_cast<const SplittablePolygon*>(&drawable)) {
         canvas->draw(drawable, fw::ColorType::VERTEX);
+    } else if (dynamic_cast<const InstancedShapes*>(&drawable)) {
+        canvas->draw(drawable, fw::ColorType::VERTEX);
     } else {
         mAssert(false, "This Drawable is not implemented yet");
     }
@@ -93,7 +93,7 @@ size_t SelectTool::selectedCount() const {
     return selected_objects.size();
 }
 
-const CompVector<GameObject*>& SelectTool::getSelectedObjects() const {
+const IndexedCompVector<GameObject*>& SelectTool::getSelectedObjects() const {
     return selected_objects;
 }
 
@@ -2,7 +2,7 @@
 #include <iostream>
 #include "editor/editor.h"
 #include "editor/scenes.h"
-#include "logger/logger.h"
+#include "common/log.h"
 #include "widgets/button_widget.h"
 
 namespace fw {
@@ -25,12 +25,12 @@ void execute_app() {
 
 int main() {
 
-    LoggerDisableTag disable_serialize_tag("serialize");
-    LoggerDisableTag disable_recut_tag("recut");
-    LoggerDisableTag disable_set_focused_widget("setFocusedWidget");
-    LoggerDisableTag disable_mouse_gesture("mouseGesture");
-    LoggerDisableTag disable_outliner("outliner");
-    LoggerDisableTag disable_history("history");
+    logging::DisableTag disable_serialize_tag("serialize");
+    logging::DisableTag disable_recut_tag("recut");
+    logging::DisableTag disable_set_focused_widget("setFocusedWidget");
+    logging::DisableTag disable_mouse_gesture("mouseGesture");
+    logging::DisableTag disable_outliner("outliner");
+    logging::DisableTag disable_history("history");
 
     execute_app();
 
@@ -57,7 +57,7 @@ int main() {
     // TODO: Make AbstractHierachy class with methods like setParent, moveToTop, etc.
     // TODO: Editor: render polygon indices
     // TODO: Widgets: make widgets a separate library
-    // TODO: Editor: delay editing polygons with many vertices
+    // TODO: Editor: recut only around moved vertices with best cut decomposition
     // TODO: Editor: joint editor
     // TODO: evolving cars
     // TODO: rename project to EvolvingCars
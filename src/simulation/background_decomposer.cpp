@@ -0,0 +1,89 @@
+#include "simulation/background_decomposer.h"
+
+BackgroundDecomposer::BackgroundDecomposer() {
+	thread = std::thread([&]() { run(); });
+}
+
+BackgroundDecomposer::~BackgroundDecomposer() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+		jobs.clear();
+	}
+	job_added.notify_all();
+	thread.join();
+}
+
+void BackgroundDecomposer::decompose(size_t object_id, std::vector<sf::Vector2f> points, size_t max_vertices) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		cancelLocked(object_id);
+		jobs.push_back(Job { object_id, std::move(points), max_vertices });
+	}
+	job_added.notify_one();
+}
+
+void BackgroundDecomposer::cancel(size_t object_id) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		cancelLocked(object_id);
+	}
+	job_done.notify_all();
+}
+
+bool BackgroundDecomposer::isBusy() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return busy || jobs.size() > 0;
+}
+
+std::vector<DecompositionResult> BackgroundDecomposer::takeResults() {
+	std::lock_guard<std::mutex> lock(mutex);
+	std::vector<DecompositionResult> taken;
+	taken.swap(results);
+	return taken;
+}
+
+void BackgroundDecomposer::wait() {
+	std::unique_lock<std::mutex> lock(mutex);
+	job_done.wait(lock, [&]() { return !busy && jobs.size() == 0; });
+}
+
+void BackgroundDecomposer::cancelLocked(size_t object_id) {
+	std::erase_if(jobs, [&](const Job& job) { return job.object_id == object_id; });
+	std::erase_if(results, [&](const DecompositionResult& result) { return result.object_id == object_id; });
+	if (busy && running_id == object_id) {
+		// can't be interrupted, so the result is dropped when it's done
+		running_cancelled = true;
+	}
+}
+
+void BackgroundDecomposer::run() {
+	while (true) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			job_added.wait(lock, [&]() { return stopping || jobs.size() > 0; });
+			if (stopping) {
+				return;
+			}
+			job = std::move(jobs.front());
+			jobs.pop_front();
+			busy = true;
+			running_id = job.object_id;
+			running_cancelled = false;
+		}
+		// only the logger-free decomposition functions can be used here
+		DecompositionResult result;
+		result.object_id = job.object_id;
+		result.pieces = decomposition::decompose(job.points, job.max_vertices);
+		result.points = std::move(job.points);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!running_cancelled) {
+				results.push_back(std::move(result));
+			}
+			busy = false;
+		}
+		job_done.notify_all();
+	}
+}
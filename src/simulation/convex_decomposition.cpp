@@ -0,0 +1,402 @@
+#include "simulation/convex_decomposition.h"
+#include <cmath>
+#include <map>
+#include <set>
+
+namespace decomposition {
+
+	// positive if a-b-c turns the same way as the polygon winds
+	static float turn(const sf::Vector2f& a, const sf::Vector2f& b, const sf::Vector2f& c, float winding) {
+		sf::Vector2f ab = b - a;
+		sf::Vector2f bc = c - b;
+		return (ab.x * bc.y - ab.y * bc.x) * winding;
+	}
+
+	static bool in_triangle(
+		const sf::Vector2f& p, const sf::Vector2f& a, const sf::Vector2f& b, const sf::Vector2f& c, float winding
+	) {
+		if (p == a || p == b || p == c) {
+			return false;
+		}
+		return turn(a, b, p, winding) >= 0.0f && turn(b, c, p, winding) >= 0.0f && turn(c, a, p, winding) >= 0.0f;
+	}
+
+	// only proper crossings count, touching at an endpoint doesn't
+	static bool segments_cross(
+		const sf::Vector2f& a1, const sf::Vector2f& a2, const sf::Vector2f& b1, const sf::Vector2f& b2
+	) {
+		float d1 = turn(a1, a2, b1, 1.0f);
+		float d2 = turn(a1, a2, b2, 1.0f);
+		float d3 = turn(b1, b2, a1, 1.0f);
+		float d4 = turn(b1, b2, a2, 1.0f);
+		return ((d1 > 0.0f && d2 < 0.0f) || (d1 < 0.0f && d2 > 0.0f))
+			&& ((d3 > 0.0f && d4 < 0.0f) || (d3 < 0.0f && d4 > 0.0f));
+	}
+
+	static float piece_area(const std::vector<sf::Vector2f>& points, const ConvexPiece& piece) {
+		float sum = 0.0f;
+		for (size_t i = 0; i < piece.size(); i++) {
+			const sf::Vector2f& p1 = points[piece[i]];
+			const sf::Vector2f& p2 = points[piece[(i + 1) % piece.size()]];
+			sum += p1.x * p2.y - p2.x * p1.y;
+		}
+		return sum / 2.0f;
+	}
+
+	float signed_area(const std::vector<sf::Vector2f>& points) {
+		float sum = 0.0f;
+		for (size_t i = 0; i < points.size(); i++) {
+			const sf::Vector2f& p1 = points[i];
+			const sf::Vector2f& p2 = points[(i + 1) % points.size()];
+			sum += p1.x * p2.y - p2.x * p1.y;
+		}
+		return sum / 2.0f;
+	}
+
+	std::vector<Triangle> triangulate(const std::vector<sf::Vector2f>& points) {
+		std::vector<Triangle> result;
+		size_t count = points.size();
+		if (count < 3) {
+			return result;
+		}
+		result.reserve(count - 2);
+		float winding = signed_area(points) >= 0.0f ? 1.0f : -1.0f;
+		std::vector<size_t> prev(count);
+		std::vector<size_t> next(count);
+		for (size_t i = 0; i < count; i++) {
+			prev[i] = (i + count - 1) % count;
+			next[i] = (i + 1) % count;
+		}
+		auto vertex_turn = [&](size_t i) {
+			return turn(points[prev[i]], points[i], points[next[i]], winding);
+		};
+		// only reflex vertices can be inside an ear, collinear ones are checked too
+		// since they can lie on its edge
+		auto is_ear = [&](size_t i) {
+			const sf::Vector2f& a = points[prev[i]];
+			const sf::Vector2f& b = points[i];
+			const sf::Vector2f& c = points[next[i]];
+			for (size_t j = next[next[i]]; j != prev[i]; j = next[j]) {
+				if (vertex_turn(j) <= 0.0f && in_triangle(points[j], a, b, c, winding)) {
+					return false;
+				}
+			}
+			return true;
+		};
+		size_t remaining = count;
+		size_t current = 0;
+		size_t checked = 0;
+		while (remaining > 3) {
+			float current_turn = vertex_turn(current);
+			// polygon is self-intersecting or degenerate if a whole loop
+			// didn't find an ear, so any convex vertex is clipped, then any vertex at all
+			bool stuck = checked >= remaining;
+			bool clip = false;
+			bool add_triangle = false;
+			if (current_turn == 0.0f) {
+				clip = true;
+			} else if (current_turn > 0.0f && (stuck || is_ear(current))) {
+				clip = true;
+				add_triangle = true;
+			} else if (checked >= remaining * 2) {
+				clip = true;
+			}
+			if (clip) {
+				if (add_triangle) {
+					result.push_back({ prev[current], current, next[current] });
+				}
+				next[prev[current]] = next[current];
+				prev[next[current]] = prev[current];
+				remaining--;
+				checked = 0;
+				// previous vertex is the one most likely to become an ear
+				current = prev[current];
+			} else {
+				current = next[current];
+				checked++;
+			}
+		}
+		if (vertex_turn(current) > 0.0f) {
+			result.push_back({ prev[current], current, next[current] });
+		}
+		return result;
+	}
+
+	std::vector<ConvexPiece> merge_triangles(
+		const std::vector<sf::Vector2f>& points, const std::vector<Triangle>& triangles, size_t max_vertices
+	) {
+		float winding = signed_area(points) >= 0.0f ? 1.0f : -1.0f;
+		std::vector<ConvexPiece> pieces;
+		pieces.reserve(triangles.size());
+		for (const Triangle& triangle : triangles) {
+			pieces.push_back(ConvexPiece(triangle.begin(), triangle.end()));
+		}
+		// merged pieces are stored in the place of one of them,
+		// this finds where a triangle ended up
+		std::vector<size_t> merged_into(triangles.size());
+		for (size_t i = 0; i < merged_into.size(); i++) {
+			merged_into[i] = i;
+		}
+		auto find_piece = [&](size_t triangle_index) {
+			size_t index = triangle_index;
+			while (merged_into[index] != index) {
+				merged_into[index] = merged_into[merged_into[index]];
+				index = merged_into[index];
+			}
+			return index;
+		};
+		struct Diagonal {
+			size_t from;
+			size_t to;
+			size_t triangle_from_to;
+			size_t triangle_to_from;
+		};
+		std::map<std::pair<size_t, size_t>, size_t> edges;
+		for (size_t i = 0; i < triangles.size(); i++) {
+			for (size_t j = 0; j < 3; j++) {
+				edges[{ triangles[i][j], triangles[i][(j + 1) % 3] }] = i;
+			}
+		}
+		std::vector<Diagonal> diagonals;
+		for (size_t i = 0; i < triangles.size(); i++) {
+			for (size_t j = 0; j < 3; j++) {
+				size_t from = triangles[i][j];
+				size_t to = triangles[i][(j + 1) % 3];
+				auto it = edges.find({ to, from });
+				if (it != edges.end() && it->second > i) {
+					diagonals.push_back({ from, to, i, it->second });
+				}
+			}
+		}
+		auto find_edge = [](const ConvexPiece& piece, size_t from, size_t to) {
+			for (size_t i = 0; i < piece.size(); i++) {
+				if (piece[i] == from && piece[(i + 1) % piece.size()] == to) {
+					return i;
+				}
+			}
+			return piece.size();
+		};
+		for (const Diagonal& diagonal : diagonals) {
+			size_t index_a = find_piece(diagonal.triangle_from_to);
+			size_t index_b = find_piece(diagonal.triangle_to_from);
+			if (index_a == index_b) {
+				continue;
+			}
+			const ConvexPiece& piece_a = pieces[index_a];
+			const ConvexPiece& piece_b = pieces[index_b];
+			size_t merged_size = piece_a.size() + piece_b.size() - 2;
+			if (max_vertices > 0 && merged_size > max_vertices) {
+				continue;
+			}
+			size_t size_a = piece_a.size();
+			size_t size_b = piece_b.size();
+			size_t edge_a = find_edge(piece_a, diagonal.from, diagonal.to);
+			size_t edge_b = find_edge(piece_b, diagonal.to, diagonal.from);
+			if (edge_a == size_a || edge_b == size_b) {
+				continue;
+			}
+			// diagonal endpoints are the only vertices that can become reflex
+			const sf::Vector2f& from_prev = points[piece_a[(edge_a + size_a - 1) % size_a]];
+			const sf::Vector2f& from_next = points[piece_b[(edge_b + 2) % size_b]];
+			const sf::Vector2f& to_prev = points[piece_b[(edge_b + size_b - 1) % size_b]];
+			const sf::Vector2f& to_next = points[piece_a[(edge_a + 2) % size_a]];
+			bool from_convex = turn(from_prev, points[diagonal.from], from_next, winding) >= 0.0f;
+			bool to_convex = turn(to_prev, points[diagonal.to], to_next, winding) >= 0.0f;
+			if (!from_convex || !to_convex) {
+				continue;
+			}
+			ConvexPiece merged;
+			merged.reserve(merged_size);
+			for (size_t i = 0; i < size_a; i++) {
+				merged.push_back(piece_a[(edge_a + 1 + i) % size_a]);
+			}
+			for (size_t i = 2; i < size_b; i++) {
+				merged.push_back(piece_b[(edge_b + i) % size_b]);
+			}
+			pieces[index_a] = std::move(merged);
+			pieces[index_b].clear();
+			merged_into[index_b] = index_a;
+		}
+		std::vector<ConvexPiece> result;
+		for (ConvexPiece& piece : pieces) {
+			if (piece.size() > 0) {
+				result.push_back(std::move(piece));
+			}
+		}
+		return result;
+	}
+
+	std::vector<ConvexPiece> decompose(const std::vector<sf::Vector2f>& points, size_t max_vertices) {
+		std::vector<Triangle> triangles = triangulate(points);
+		return merge_triangles(points, triangles, max_vertices);
+	}
+
+	bool redecompose(
+		const std::vector<sf::Vector2f>& points,
+		const std::vector<ConvexPiece>& pieces,
+		const std::vector<size_t>& moved,
+		size_t max_vertices,
+		std::vector<size_t>& removed,
+		std::vector<ConvexPiece>& added
+	) {
+		removed.clear();
+		added.clear();
+		size_t count = points.size();
+		std::vector<bool> is_moved(count, false);
+		for (size_t index : moved) {
+			if (index >= count) {
+				return false;
+			}
+			is_moved[index] = true;
+		}
+		std::vector<bool> in_piece(count, false);
+		std::vector<size_t> unaffected;
+		for (size_t i = 0; i < pieces.size(); i++) {
+			bool affected = false;
+			for (size_t index : pieces[i]) {
+				in_piece[index] = true;
+				affected = affected || is_moved[index];
+			}
+			if (affected) {
+				removed.push_back(i);
+			} else {
+				unaffected.push_back(i);
+			}
+		}
+		if (removed.empty() || unaffected.empty()) {
+			return false;
+		}
+		// points dropped by triangulation as collinear stop being collinear
+		// when their neighbors move
+		for (size_t index : moved) {
+			size_t prev = (index + count - 1) % count;
+			size_t next = (index + 1) % count;
+			if (!in_piece[index] || !in_piece[prev] || !in_piece[next]) {
+				return false;
+			}
+		}
+		// unaffected pieces don't move, so they keep the winding
+		float winding = piece_area(points, pieces[unaffected.front()]) >= 0.0f ? 1.0f : -1.0f;
+
+		// region boundary is the edges that are not shared by two removed pieces
+		std::set<std::pair<size_t, size_t>> region_edges;
+		for (size_t piece_index : removed) {
+			const ConvexPiece& piece = pieces[piece_index];
+			for (size_t i = 0; i < piece.size(); i++) {
+				region_edges.insert({ piece[i], piece[(i + 1) % piece.size()] });
+			}
+		}
+		std::map<size_t, size_t> boundary_next;
+		for (const std::pair<size_t, size_t>& edge : region_edges) {
+			if (region_edges.contains({ edge.second, edge.first })) {
+				continue;
+			}
+			bool inserted = boundary_next.insert(edge).second;
+			if (!inserted) {
+				// region touches itself at a point
+				return false;
+			}
+		}
+		std::vector<std::vector<size_t>> regions;
+		std::set<size_t> visited;
+		for (const std::pair<const size_t, size_t>& edge : boundary_next) {
+			if (visited.contains(edge.first)) {
+				continue;
+			}
+			std::vector<size_t> region;
+			size_t current = edge.first;
+			do {
+				if (!visited.insert(current).second) {
+					return false;
+				}
+				region.push_back(current);
+				auto it = boundary_next.find(current);
+				if (it == boundary_next.end()) {
+					return false;
+				}
+				current = it->second;
+			} while (current != edge.first);
+			regions.push_back(region);
+		}
+
+		// moved edges can't cross anything that stays, or the region itself
+		std::vector<std::pair<size_t, size_t>> fixed_edges;
+		for (size_t piece_index : unaffected) {
+			const ConvexPiece& piece = pieces[piece_index];
+			for (size_t i = 0; i < piece.size(); i++) {
+				fixed_edges.push_back({ piece[i], piece[(i + 1) % piece.size()] });
+			}
+		}
+		std::vector<std::pair<size_t, size_t>> region_boundary;
+		std::vector<std::pair<size_t, size_t>> moved_edges;
+		for (const std::vector<size_t>& region : regions) {
+			for (size_t i = 0; i < region.size(); i++) {
+				size_t from = region[i];
+				size_t to = region[(i + 1) % region.size()];
+				region_boundary.push_back({ from, to });
+				if (is_moved[from] || is_moved[to]) {
+					moved_edges.push_back({ from, to });
+				}
+			}
+		}
+		auto crosses_any = [&](
+			const std::pair<size_t, size_t>& edge, const std::vector<std::pair<size_t, size_t>>& edges
+		) {
+			for (const std::pair<size_t, size_t>& other : edges) {
+				bool shares_point = edge.first == other.first || edge.first == other.second
+					|| edge.second == other.first || edge.second == other.second;
+				if (!shares_point && segments_cross(
+					points[edge.first], points[edge.second], points[other.first], points[other.second]
+				)) {
+					return true;
+				}
+			}
+			return false;
+		};
+		for (const std::pair<size_t, size_t>& edge : moved_edges) {
+			if (crosses_any(edge, fixed_edges) || crosses_any(edge, region_boundary)) {
+				return false;
+			}
+		}
+		for (size_t index : moved) {
+			for (size_t piece_index : unaffected) {
+				const ConvexPiece& piece = pieces[piece_index];
+				bool inside = true;
+				for (size_t i = 0; i < piece.size() && inside; i++) {
+					const sf::Vector2f& a = points[piece[i]];
+					const sf::Vector2f& b = points[piece[(i + 1) % piece.size()]];
+					inside = turn(a, b, points[index], winding) > 0.0f;
+				}
+				if (inside) {
+					return false;
+				}
+			}
+		}
+
+		for (const std::vector<size_t>& region : regions) {
+			std::vector<sf::Vector2f> region_points(region.size());
+			for (size_t i = 0; i < region.size(); i++) {
+				region_points[i] = points[region[i]];
+			}
+			float region_area = signed_area(region_points) * winding;
+			if (region_area <= 0.0f) {
+				return false;
+			}
+			std::vector<ConvexPiece> region_pieces = decompose(region_points, max_vertices);
+			float pieces_area = 0.0f;
+			for (ConvexPiece& piece : region_pieces) {
+				pieces_area += piece_area(region_points, piece) * winding;
+				for (size_t& index : piece) {
+					index = region[index];
+				}
+			}
+			// triangulation of a region that is not simple doesn't cover it exactly
+			if (std::abs(pieces_area - region_area) > region_area * 0.001f) {
+				return false;
+			}
+			added.insert(added.end(), region_pieces.begin(), region_pieces.end());
+		}
+		return true;
+	}
+
+}
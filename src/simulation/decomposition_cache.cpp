@@ -0,0 +1,132 @@
+#include "simulation/decomposition_cache.h"
+#include <bit>
+#include <cstdint>
+
+DecompositionCache::DecompositionCache(size_t max_bytes) {
+	this->max_bytes = max_bytes;
+}
+
+const std::vector<DecompositionCache::Piece>* DecompositionCache::find(
+	const std::vector<sf::Vector2f>& points, int algorithm, size_t max_vertices
+) {
+	size_t hash = hashKey(points, algorithm, max_vertices);
+	EntryList::iterator it = findEntry(points, algorithm, max_vertices, hash);
+	if (it == entries.end()) {
+		stats.misses++;
+		return nullptr;
+	}
+	stats.hits++;
+	entries.splice(entries.begin(), entries, it);
+	return &it->pieces;
+}
+
+void DecompositionCache::insert(
+	std::vector<sf::Vector2f> points, int algorithm, size_t max_vertices, std::vector<Piece> pieces
+) {
+	size_t hash = hashKey(points, algorithm, max_vertices);
+	EntryList::iterator old_it = findEntry(points, algorithm, max_vertices, hash);
+	if (old_it != entries.end()) {
+		removeEntry(old_it);
+	}
+	Entry entry;
+	entry.hash = hash;
+	entry.points = std::move(points);
+	entry.algorithm = algorithm;
+	entry.max_vertices = max_vertices;
+	entry.pieces = std::move(pieces);
+	entry.bytes = entryBytes(entry);
+	if (entry.bytes > max_bytes) {
+		return;
+	}
+	entries.push_front(std::move(entry));
+	index.insert({ hash, entries.begin() });
+	stats.entries++;
+	stats.bytes += entries.front().bytes;
+	evict();
+}
+
+size_t DecompositionCache::getMaxBytes() const {
+	return max_bytes;
+}
+
+void DecompositionCache::setMaxBytes(size_t max_bytes) {
+	this->max_bytes = max_bytes;
+	evict();
+}
+
+const DecompositionCacheStats& DecompositionCache::getStats() const {
+	return stats;
+}
+
+void DecompositionCache::resetStats() {
+	stats.hits = 0;
+	stats.misses = 0;
+	stats.evictions = 0;
+}
+
+void DecompositionCache::clear() {
+	entries.clear();
+	index.clear();
+	stats.entries = 0;
+	stats.bytes = 0;
+}
+
+size_t DecompositionCache::hashKey(const std::vector<sf::Vector2f>& points, int algorithm, size_t max_vertices) {
+	// FNV-1a over bit patterns of the coordinates
+	uint64_t hash = 14695981039346656037ull;
+	auto add = [&](uint64_t value) {
+		hash ^= value;
+		hash *= 1099511628211ull;
+	};
+	add((uint64_t)algorithm);
+	add((uint64_t)max_vertices);
+	add((uint64_t)points.size());
+	for (const sf::Vector2f& point : points) {
+		add(std::bit_cast<uint32_t>(point.x));
+		add(std::bit_cast<uint32_t>(point.y));
+	}
+	return (size_t)hash;
+}
+
+size_t DecompositionCache::entryBytes(const Entry& entry) {
+	size_t bytes = sizeof(Entry) + entry.points.capacity() * sizeof(sf::Vector2f);
+	for (const Piece& piece : entry.pieces) {
+		bytes += sizeof(Piece);
+		bytes += piece.points.capacity() * sizeof(sf::Vector2f);
+		bytes += piece.source_indices.capacity() * sizeof(size_t);
+	}
+	return bytes;
+}
+
+DecompositionCache::EntryList::iterator DecompositionCache::findEntry(
+	const std::vector<sf::Vector2f>& points, int algorithm, size_t max_vertices, size_t hash
+) {
+	auto range = index.equal_range(hash);
+	for (auto it = range.first; it != range.second; it++) {
+		const Entry& entry = *it->second;
+		if (entry.algorithm == algorithm && entry.max_vertices == max_vertices && entry.points == points) {
+			return it->second;
+		}
+	}
+	return entries.end();
+}
+
+void DecompositionCache::removeEntry(EntryList::iterator it) {
+	auto range = index.equal_range(it->hash);
+	for (auto index_it = range.first; index_it != range.second; index_it++) {
+		if (index_it->second == it) {
+			index.erase(index_it);
+			break;
+		}
+	}
+	stats.entries--;
+	stats.bytes -= it->bytes;
+	entries.erase(it);
+}
+
+void DecompositionCache::evict() {
+	while (stats.bytes > max_bytes && !entries.empty()) {
+		removeEntry(std::prev(entries.end()));
+		stats.evictions++;
+	}
+}
@@ -1,18 +1,97 @@
 #include <numbers>
 #include "simulation/gameobject.h"
+#include "simulation/background_decomposer.h"
 #include "simulation/objectlist.h"
 
 const auto tob2 = utils::tob2;
 const auto tosf = utils::tosf;
 
-EditableVertex::EditableVertex(b2Vec2 pos) {
-	this->pos = pos;
-	this->orig_pos = pos;
-	this->selected = false;
+size_t EditableVertices::size() const {
+	return positions.size();
 }
 
-bool EditableVertex::operator==(const EditableVertex& other) const {
-	return pos == other.pos;
+bool EditableVertices::empty() const {
+	return positions.empty();
+}
+
+const b2Vec2& EditableVertices::operator[](size_t index) const {
+	return positions[index];
+}
+
+const b2Vec2& EditableVertices::front() const {
+	return positions.front();
+}
+
+const std::vector<b2Vec2>& EditableVertices::getPositions() const {
+	return positions;
+}
+
+void EditableVertices::setPos(size_t index, const b2Vec2& pos) {
+	positions[index] = pos;
+	if (!saved_positions.empty()) {
+		saved_positions[index] = pos;
+	}
+}
+
+const b2Vec2& EditableVertices::getSavedPos(size_t index) const {
+	if (saved_positions.empty()) {
+		return positions[index];
+	}
+	return saved_positions[index];
+}
+
+void EditableVertices::offset(size_t index, const b2Vec2& offset) {
+	if (saved_positions.empty()) {
+		saved_positions = positions;
+	}
+	positions[index] = saved_positions[index] + offset;
+}
+
+void EditableVertices::savePositions() {
+	saved_positions.clear();
+	saved_positions.shrink_to_fit();
+}
+
+bool EditableVertices::isSelected(size_t index) const {
+	return selected[index];
+}
+
+void EditableVertices::setSelected(size_t index, bool selected) {
+	this->selected[index] = selected;
+}
+
+void EditableVertices::setAllSelected(bool selected) {
+	this->selected.assign(positions.size(), selected);
+}
+
+void EditableVertices::insert(size_t index, const b2Vec2& pos) {
+	positions.insert(positions.begin() + index, pos);
+	if (!saved_positions.empty()) {
+		saved_positions.insert(saved_positions.begin() + index, pos);
+	}
+	selected.insert(selected.begin() + index, false);
+}
+
+void EditableVertices::erase(size_t index) {
+	positions.erase(positions.begin() + index);
+	if (!saved_positions.empty()) {
+		saved_positions.erase(saved_positions.begin() + index);
+	}
+	selected.erase(selected.begin() + index);
+}
+
+void EditableVertices::push_back(const b2Vec2& pos) {
+	insert(positions.size(), pos);
+}
+
+void EditableVertices::assign(const std::vector<b2Vec2>& positions) {
+	this->positions = positions;
+	saved_positions.clear();
+	selected.assign(positions.size(), false);
+}
+
+bool EditableVertices::operator==(const EditableVertices& other) const {
+	return positions == other.positions;
 }
 
 GameObject::GameObject() { }
@@ -117,14 +196,67 @@ const CompVector<GameObject*>& GameObject::getChildren() const {
 
 CompVector<GameObject*> GameObject::getAllChildren() const {
 	CompVector<GameObject*> result;
-	result.insert(result.end(), children.begin(), children.end());
-	for (size_t i = 0; i < children.size(); i++) {
-		const CompVector<GameObject*>& child_children = children[i]->getAllChildren();
-		result.insert(result.end(), child_children.begin(), child_children.end());
+	if (object_list) {
+		std::span<GameObject* const> subtree = getSubtree();
+		// object might not be in the hierarchy yet
+		if (subtree.empty()) {
+			return result;
+		}
+		result.insert(result.end(), subtree.begin() + 1, subtree.end());
+	} else {
+		for (size_t i = 0; i < children.size(); i++) {
+			result.add(children[i]);
+			const CompVector<GameObject*>& child_children = children[i]->getAllChildren();
+			result.insert(result.end(), child_children.begin(), child_children.end());
+		}
 	}
 	return result;
 }
 
+std::span<GameObject* const> GameObject::getSubtree() const {
+	mAssert(object_list);
+	object_list->updateHierarchy();
+	if (!object_list->isInHierarchy(this)) {
+		return std::span<GameObject* const>();
+	}
+	return std::span<GameObject* const>(object_list->hierarchy).subspan(hierarchy_index, subtree_size);
+}
+
+size_t GameObject::getDepth() const {
+	if (object_list) {
+		object_list->updateHierarchy();
+		if (object_list->isInHierarchy(this)) {
+			return depth;
+		}
+	}
+	size_t result = 0;
+	for (const GameObject* cur_obj = parent; cur_obj; cur_obj = cur_obj->parent) {
+		result++;
+	}
+	return result;
+}
+
+bool GameObject::isAncestorOf(const GameObject* object) const {
+	if (!object || object == this) {
+		return false;
+	}
+	// hierarchy is not rebuilt here so that setParent in a loop stays linear,
+	// walking up is used until something else rebuilds it
+	if (
+		object_list && object_list->hierarchy_valid
+		&& object_list->isInHierarchy(this) && object_list->isInHierarchy(object)
+	) {
+		return object->hierarchy_index > hierarchy_index
+			&& object->hierarchy_index < hierarchy_index + subtree_size;
+	}
+	for (const GameObject* cur_obj = object->parent; cur_obj; cur_obj = cur_obj->parent) {
+		if (cur_obj == this) {
+			return true;
+		}
+	}
+	return false;
+}
+
 GameObject* GameObject::getChild(size_t index) const {
 	return children[index];
 }
@@ -250,8 +382,8 @@ void GameObject::setParent(GameObject* new_parent) {
 		if (new_parent == this) {
 			throw std::runtime_error("Cannot parent object to itself: id " + std::to_string(id));
 		}
-		CompVector<GameObject*> parent_chain = new_parent->getParentChain();
-		if (parent_chain.contains(this)) {
+		if (isAncestorOf(new_parent)) {
+			CompVector<GameObject*> parent_chain = new_parent->getParentChain();
 			std::string chain_str;
 			chain_str += std::to_string(id);
 			chain_str += " -> " + std::to_string(new_parent->id);
@@ -285,6 +417,7 @@ void GameObject::setParent(GameObject* new_parent) {
 			} else {
 				object_list->top_objects.add(this);
 			}
+			object_list->invalidateHierarchy();
 			object_list->OnSetParent(this, new_parent);
 		}
 	} catch (std::exception exc) {
@@ -435,20 +568,23 @@ void GameObject::moveToIndex(size_t index) {
 void GameObject::moveChildToIndex(GameObject* child, size_t index) {
 	mAssert(children.contains(child));
 	children.moveValueToIndex(child, index);
+	if (object_list) {
+		object_list->invalidateHierarchy();
+	}
 }
 
 void GameObject::moveVertices(const std::vector<size_t>& index_list, const b2Vec2& offset) {
 	for (size_t i = 0; i < index_list.size(); i++) {
 		size_t index = index_list[i];
-		EditableVertex vertex = vertices[index];
-		vertex.pos += offset;
-		vertex.orig_pos = vertex.pos;
+		vertices.setPos(index, vertices[index] + offset);
+		updateVertexGrid(index);
 	}
 	syncVertices();
 }
 
 void GameObject::offsetVertex(size_t index, const b2Vec2& offset, bool sync) {
-	vertices[index].pos = vertices[index].orig_pos + offset;
+	vertices.offset(index, offset);
+	updateVertexGrid(index);
 	if (sync) {
 		syncVertices();
 	}
@@ -456,8 +592,9 @@ void GameObject::offsetVertex(size_t index, const b2Vec2& offset, bool sync) {
 
 void GameObject::offsetSelected(const b2Vec2& offset, bool sync) {
 	for (size_t i = 0; i < vertices.size(); i++) {
-		if (vertices[i].selected) {
-			vertices[i].pos = vertices[i].orig_pos + offset;
+		if (vertices.isSelected(i)) {
+			vertices.offset(i, offset);
+			updateVertexGrid(i);
 		}
 	}
 	if (sync) {
@@ -466,9 +603,7 @@ void GameObject::offsetSelected(const b2Vec2& offset, bool sync) {
 }
 
 void GameObject::saveOffsets() {
-	for (size_t i = 0; i < vertices.size(); i++) {
-		vertices[i].orig_pos = vertices[i].pos;
-	}
+	vertices.savePositions();
 }
 
 size_t GameObject::indexLoop(ptrdiff_t index) const {
@@ -487,16 +622,71 @@ size_t GameObject::getEdgeCount() const {
 	}
 }
 
-const EditableVertex& GameObject::getVertex(size_t index) const {
+const b2Vec2& GameObject::getVertexPos(size_t index) const {
 	return vertices[index];
 }
 
-const std::vector<EditableVertex>& GameObject::getVertices() const {
-	return vertices;
+const b2Vec2& GameObject::getSavedVertexPos(size_t index) const {
+	return vertices.getSavedPos(index);
+}
+
+const std::vector<b2Vec2>& GameObject::getVertices() const {
+	return vertices.getPositions();
 }
 
 b2Vec2 GameObject::getGlobalVertexPos(size_t index) {
-	return toGlobal(vertices[index].pos);
+	return toGlobal(vertices[index]);
+}
+
+utils::batch::Points GameObject::getGlobalVertices() const {
+	utils::batch::Points local_vertices(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++) {
+		local_vertices.set(i, vertices[i].x, vertices[i].y);
+	}
+	utils::batch::Points global_vertices(vertices.size());
+	utils::batch::transform_points(
+		local_vertices.x, local_vertices.y, getGlobalTransform(), global_vertices.x, global_vertices.y
+	);
+	return global_vertices;
+}
+
+const VertexGrid& GameObject::getVertexGrid() const {
+	if (!vertex_grid_valid || vertex_grid.size() != vertices.size()) {
+		vertex_grid.build(getPositions());
+		vertex_grid_valid = true;
+	}
+	return vertex_grid;
+}
+
+std::vector<size_t> GameObject::getVerticesInRect(const b2AABB& global_aabb) const {
+	// local aabb of the rect corners contains the rect whatever the rotation is,
+	// vertices from it are then checked in global coordinates
+	b2Transform gt = getGlobalTransform();
+	b2Vec2 corners[4] = {
+		global_aabb.lowerBound,
+		b2Vec2(global_aabb.upperBound.x, global_aabb.lowerBound.y),
+		global_aabb.upperBound,
+		b2Vec2(global_aabb.lowerBound.x, global_aabb.upperBound.y),
+	};
+	b2AABB local_aabb;
+	local_aabb.lowerBound = b2MulT(gt, corners[0]);
+	local_aabb.upperBound = local_aabb.lowerBound;
+	for (size_t i = 1; i < 4; i++) {
+		b2Vec2 local_corner = b2MulT(gt, corners[i]);
+		local_aabb.lowerBound = b2Min(local_aabb.lowerBound, local_corner);
+		local_aabb.upperBound = b2Max(local_aabb.upperBound, local_corner);
+	}
+	std::vector<size_t> result;
+	for (size_t index : getVertexGrid().query(local_aabb)) {
+		b2Vec2 global_pos = b2Mul(gt, vertices[index]);
+		if (
+			global_pos.x >= global_aabb.lowerBound.x && global_pos.x <= global_aabb.upperBound.x
+			&& global_pos.y >= global_aabb.lowerBound.y && global_pos.y <= global_aabb.upperBound.y
+		) {
+			result.push_back(index);
+		}
+	}
+	return result;
 }
 
 void GameObject::setGlobalVertexPos(size_t index, const b2Vec2& new_pos) {
@@ -512,35 +702,43 @@ bool GameObject::tryDeleteVertex(ptrdiff_t index) {
 	if (vertices.size() <= 2) {
 		return false;
 	}
-	vertices.erase(vertices.begin() + index);
+	vertices.erase(index);
+	if (vertex_grid_valid) {
+		vertex_grid.erase(index);
+	}
 	syncVertices();
 	return true;
 }
 
 void GameObject::addVertexGlobal(size_t index, const b2Vec2& pos) {
 	b2Vec2 local_pos = toLocal(pos);
-	vertices.insert(vertices.begin() + index, local_pos);
+	vertices.insert(index, local_pos);
+	if (vertex_grid_valid) {
+		vertex_grid.insert(index, local_pos);
+	}
+	syncVertices();
+}
+
+void GameObject::setVertices(const std::vector<b2Vec2>& positions) {
+	vertices.assign(positions);
+	vertex_grid_valid = false;
 	syncVertices();
 }
 
 void GameObject::selectVertex(size_t index) {
-	vertices[index].selected = true;
+	vertices.setSelected(index, true);
 }
 
 bool GameObject::isVertexSelected(size_t index) const {
-	return vertices[index].selected;
+	return vertices.isSelected(index);
 }
 
 void GameObject::selectAllVertices() {
-	for (size_t i = 0; i < vertices.size(); i++) {
-		vertices[i].selected = true;
-	}
+	vertices.setAllSelected(true);
 }
 
 void GameObject::deselectAllVertices() {
-	for (size_t i = 0; i < vertices.size(); i++) {
-		vertices[i].selected = false;
-	}
+	vertices.setAllSelected(false);
 }
 
 void GameObject::syncVertices(bool save_velocities) {
@@ -577,18 +775,13 @@ std::string GameObject::serialize() const {
 	return tw.toStr();
 }
 
-std::vector<b2Vec2> GameObject::getPositions() const {
-	std::vector<b2Vec2> b2vertices(vertices.size());
-	for (size_t i = 0; i < vertices.size(); i++) {
-		b2vertices[i] = vertices[i].pos;
-	}
-	return b2vertices;
+const std::vector<b2Vec2>& GameObject::getPositions() const {
+	return vertices.getPositions();
 }
 
 void GameObject::vertexSet(size_t index, const b2Vec2& new_pos) {
-	EditableVertex& vertex = vertices[index];
-	vertex.pos = new_pos;
-	vertex.orig_pos = vertex.pos;
+	vertices.setPos(index, new_pos);
+	updateVertexGrid(index);
 }
 
 void GameObject::destroyFixtures() {
@@ -623,6 +816,12 @@ b2AABB GameObject::getAABB(bool exact) const {
 	return result;
 }
 
+void GameObject::updateVertexGrid(size_t index) {
+	if (vertex_grid_valid) {
+		vertex_grid.move(index, vertices[index]);
+	}
+}
+
 TokenWriter& GameObject::serializeBody(TokenWriter& tw, b2Body* body) {
 	tw << "body" << "\n";
 	{
@@ -782,7 +981,7 @@ BoxObject::BoxObject(GameObjectList* object_list, b2BodyDef def, b2Vec2 size, sf
 	this->object_list = object_list;
 	this->color = color;
 	rigid_body = object_list->world->CreateBody(&def);
-	vertices.push_back(EditableVertex(0.5f * size));
+	vertices.push_back(0.5f * size);
 	syncVertices(true);
 	transformFromRigidbody();
 	rigid_body->GetUserData().pointer = reinterpret_cast<uintptr_t>(this);
@@ -881,7 +1080,7 @@ dp::DataPointerUnique<BoxObject> BoxObject::deserialize(TokenReader& tr, GameObj
 }
 
 void BoxObject::internalSyncVertices() {
-	size = b2Vec2(abs(vertices.front().pos.x) * 2.0f, abs(vertices.front().pos.y) * 2.0f);
+	size = b2Vec2(abs(vertices.front().x) * 2.0f, abs(vertices.front().y) * 2.0f);
 	b2Fixture* old_fixture = rigid_body->GetFixtureList();
 	if (old_fixture) {
 		rigid_body->DestroyFixture(old_fixture);
@@ -911,7 +1110,7 @@ BallObject::BallObject(GameObjectList* object_list, b2BodyDef def, float radius,
 	this->color = color;
 	this->notch_color = notch_color;
 	rigid_body = object_list->world->CreateBody(&def);
-	vertices.push_back(EditableVertex(b2Vec2(radius, 0.0f)));
+	vertices.push_back(b2Vec2(radius, 0.0f));
 	syncVertices(true);
 	transformFromRigidbody();
 	rigid_body->GetUserData().pointer = reinterpret_cast<uintptr_t>(this);
@@ -1022,7 +1221,7 @@ dp::DataPointerUnique<BallObject> BallObject::deserialize(TokenReader& tr, GameO
 }
 
 void BallObject::internalSyncVertices() {
-	radius = vertices.front().pos.Length();
+	radius = vertices.front().Length();
 	b2Fixture* old_fixture = rigid_body->GetFixtureList();
 	if (old_fixture) {
 		rigid_body->DestroyFixture(old_fixture);
@@ -1050,15 +1249,15 @@ PolygonObject::PolygonObject(
 	GameObjectList* object_list,
 	b2BodyDef def,
 	const std::vector<b2Vec2>& vertices,
-	const sf::Color& color
+	const sf::Color& color,
+	SplittablePolygon::DecompositionAlgorithm decomposition_algorithm
 ) {
 	this->object_list = object_list;
 	this->color = color;
 	rigid_body = object_list->world->CreateBody(&def);
-	for (size_t i = 0; i < vertices.size(); i++) {
-		this->vertices.push_back(EditableVertex(vertices[i]));
-	}
+	this->vertices.assign(vertices);
 	polygon = dp::make_data_pointer<SplittablePolygon>("PolygonObject " + name + " SplittablePolygon");
+	polygon->setDecompositionAlgorithm(decomposition_algorithm);
 	syncVertices(true);
 	transformFromRigidbody();
 	polygon->setFillColor(color);
@@ -1077,6 +1276,26 @@ SplittablePolygon* PolygonObject::getSplittablePolygon() const {
 	return polygon.get();
 }
 
+SplittablePolygon::DecompositionAlgorithm PolygonObject::getDecompositionAlgorithm() const {
+	return polygon->getDecompositionAlgorithm();
+}
+
+void PolygonObject::setDecompositionAlgorithm(SplittablePolygon::DecompositionAlgorithm algorithm) {
+	if (algorithm == polygon->getDecompositionAlgorithm()) {
+		return;
+	}
+	// fixtures are recreated, so their parameters have to be restored
+	b2Fixture* fixture = rigid_body->GetFixtureList();
+	float density = fixture ? fixture->GetDensity() : 1.0f;
+	float friction = fixture ? fixture->GetFriction() : 0.2f;
+	float restitution = fixture ? fixture->GetRestitution() : 0.0f;
+	polygon->setDecompositionAlgorithm(algorithm);
+	syncVertices(true);
+	setDensity(density, false);
+	setFriction(friction, false);
+	setRestitution(restitution, false);
+}
+
 sf::Drawable* PolygonObject::getDrawable() const {
 	return polygon.get();
 }
@@ -1108,10 +1327,13 @@ TokenWriter& PolygonObject::serialize(TokenWriter& tw) const {
 		tw.writeQuotedStringParam("name", name);
 		tw << "vertices";
 		for (size_t i = 0; i < vertices.size(); i++) {
-			tw << vertices[i].pos;
+			tw << vertices[i];
 		}
 		tw << "\n";
 		tw.writeColorParam("color", color);
+		if (polygon->getDecompositionAlgorithm() == SplittablePolygon::EAR_CLIPPING) {
+			tw.writeStringParam("decomposition", "ear_clipping");
+		}
 		serializeBody(tw, rigid_body) << "\n";
 	}
 	tw << "/object";
@@ -1131,6 +1353,7 @@ dp::DataPointerUnique<PolygonObject> PolygonObject::deserialize(TokenReader& tr,
 		std::string name = "<unnamed>";
 		sf::Color color = sf::Color::White;
 		std::vector<b2Vec2> vertices;
+		SplittablePolygon::DecompositionAlgorithm decomposition = SplittablePolygon::BEST_CUT;
 		BodyDef body_def;
 		if (tr.tryEat("object")) {
 			tr.eat("polygon");
@@ -1147,6 +1370,15 @@ dp::DataPointerUnique<PolygonObject> PolygonObject::deserialize(TokenReader& tr,
 				vertices = tr.readb2Vec2Arr();
 			} else if (pname == "color") {
 				color = tr.readColor();
+			} else if (pname == "decomposition") {
+				std::string decomposition_str = tr.readString();
+				if (decomposition_str == "ear_clipping") {
+					decomposition = SplittablePolygon::EAR_CLIPPING;
+				} else if (decomposition_str == "best_cut") {
+					decomposition = SplittablePolygon::BEST_CUT;
+				} else {
+					throw std::runtime_error("Unknown decomposition algorithm: " + decomposition_str);
+				}
 			} else if (pname == "body") {
 				body_def = deserializeBody(tr);
 			} else if (pname == "/object") {
@@ -1157,7 +1389,7 @@ dp::DataPointerUnique<PolygonObject> PolygonObject::deserialize(TokenReader& tr,
 		}
 		b2BodyDef bdef = body_def.body_def;
 		b2FixtureDef fdef = body_def.fixture_defs.front();
-		dp::DataPointerUnique<PolygonObject> car = dp::make_data_pointer<PolygonObject>("PolygonObject(car) " + name, object_list, bdef, vertices, color);
+		dp::DataPointerUnique<PolygonObject> car = dp::make_data_pointer<PolygonObject>("PolygonObject(car) " + name, object_list, bdef, vertices, color, decomposition);
 		car->id = id;
 		car->parent_id = parent_id;
 		car->name = name;
@@ -1171,27 +1403,134 @@ dp::DataPointerUnique<PolygonObject> PolygonObject::deserialize(TokenReader& tr,
 }
 
 void PolygonObject::internalSyncVertices() {
+	decomposition_pending = false;
+	if (syncMovedVertices()) {
+		return;
+	}
 	polygon->resetVarray(vertices.size());
 	for (size_t i = 0; i < vertices.size(); i++) {
-		polygon->setPoint(i, tosf(vertices[i].pos));
+		polygon->setPoint(i, tosf(vertices[i]));
 	}
 	polygon->recut();
 	destroyFixtures();
-	std::vector<SplittablePolygon> convex_polygons = polygon->getConvexPolygons();
+	const std::vector<SplittablePolygon>& convex_polygons = polygon->getConvexPolygons();
+	b2FixtureDef fixture_def;
+	fixture_def.density = 1.0f;
+	convex_fixtures.clear();
 	for (size_t polygon_i = 0; polygon_i < convex_polygons.size(); polygon_i++) {
-		SplittablePolygon& polygon = convex_polygons[polygon_i];
-		std::vector<b2Vec2> b2points;
-		for (size_t vertex_i = 0; vertex_i < polygon.getPointCount(); vertex_i++) {
-			sf::Vector2f point = polygon.getPoint(vertex_i);
-			point = point + polygon.getPosition();
-			b2points.push_back(tob2(point));
+		convex_fixtures.push_back(createConvexFixture(convex_polygons[polygon_i], fixture_def));
+	}
+}
+
+void PolygonObject::syncVerticesDeferred(BackgroundDecomposer& decomposer) {
+	if (vertices.size() != polygon->getPointCount() || polygon->getConvexPolygons().empty()) {
+		// vertex count changed, it's not just dragging
+		decomposer.cancel(getId());
+		syncVertices();
+		return;
+	}
+	std::vector<sf::Vector2f> points(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++) {
+		points[i] = tosf(vertices[i]);
+	}
+	polygon->setOutline(points);
+	decomposer.decompose(getId(), std::move(points), b2_maxPolygonVertices);
+	decomposition_pending = true;
+}
+
+bool PolygonObject::isDecompositionPending() const {
+	return decomposition_pending;
+}
+
+bool PolygonObject::applyDecomposition(const DecompositionResult& result) {
+	if (!decomposition_pending || result.points.size() != polygon->getPointCount()) {
+		return false;
+	}
+	for (size_t i = 0; i < result.points.size(); i++) {
+		if (result.points[i] != polygon->getPoint(i)) {
+			return false;
 		}
-		b2PolygonShape b2polygon;
-		bool valid = b2polygon.Set(b2points.data(), (int32)b2points.size());
-		if (valid) {
-			rigid_body->CreateFixture(&b2polygon, 1.0f);
+	}
+	b2FixtureDef fixture_def = getConvexFixtureDef();
+	polygon->setConvexPieces(result.pieces);
+	destroyFixtures();
+	const std::vector<SplittablePolygon>& convex_polygons = polygon->getConvexPolygons();
+	convex_fixtures.clear();
+	for (size_t polygon_i = 0; polygon_i < convex_polygons.size(); polygon_i++) {
+		convex_fixtures.push_back(createConvexFixture(convex_polygons[polygon_i], fixture_def));
+	}
+	decomposition_pending = false;
+	return true;
+}
+
+b2FixtureDef PolygonObject::getConvexFixtureDef() const {
+	b2FixtureDef fixture_def;
+	fixture_def.density = 1.0f;
+	for (b2Fixture* fixture : convex_fixtures) {
+		if (fixture) {
+			fixture_def.density = fixture->GetDensity();
+			fixture_def.friction = fixture->GetFriction();
+			fixture_def.restitution = fixture->GetRestitution();
+			break;
 		}
 	}
+	return fixture_def;
+}
+
+b2Fixture* PolygonObject::createConvexFixture(const SplittablePolygon& convex_polygon, b2FixtureDef def) {
+	std::vector<b2Vec2> b2points;
+	for (size_t vertex_i = 0; vertex_i < convex_polygon.getPointCount(); vertex_i++) {
+		sf::Vector2f point = convex_polygon.getPoint(vertex_i);
+		point = point + convex_polygon.getPosition();
+		b2points.push_back(tob2(point));
+	}
+	b2PolygonShape b2polygon;
+	bool valid = b2polygon.Set(b2points.data(), (int32)b2points.size());
+	if (!valid) {
+		return nullptr;
+	}
+	def.shape = &b2polygon;
+	return rigid_body->CreateFixture(&def);
+}
+
+bool PolygonObject::syncMovedVertices() {
+	// when only some vertices moved, fixtures are replaced
+	// only for convex polygons around them
+	if (convex_fixtures.empty() || convex_fixtures.size() != polygon->getConvexPolygons().size()) {
+		return false;
+	}
+	if (vertices.size() != polygon->getPointCount()) {
+		return false;
+	}
+	std::vector<size_t> moved;
+	std::vector<sf::Vector2f> positions;
+	for (size_t i = 0; i < vertices.size(); i++) {
+		sf::Vector2f pos = tosf(vertices[i]);
+		if (pos != polygon->getPoint(i)) {
+			moved.push_back(i);
+			positions.push_back(pos);
+		}
+	}
+	if (moved.empty()) {
+		return false;
+	}
+	b2FixtureDef fixture_def = getConvexFixtureDef();
+	std::vector<size_t> removed;
+	size_t added_count = 0;
+	if (!polygon->recutMovedPoints(moved, positions, removed, added_count)) {
+		return false;
+	}
+	for (auto it = removed.rbegin(); it != removed.rend(); it++) {
+		if (convex_fixtures[*it]) {
+			rigid_body->DestroyFixture(convex_fixtures[*it]);
+		}
+		convex_fixtures.erase(convex_fixtures.begin() + *it);
+	}
+	const std::vector<SplittablePolygon>& convex_polygons = polygon->getConvexPolygons();
+	for (size_t polygon_i = convex_polygons.size() - added_count; polygon_i < convex_polygons.size(); polygon_i++) {
+		convex_fixtures.push_back(createConvexFixture(convex_polygons[polygon_i], fixture_def));
+	}
+	return true;
 }
 
 bool PolygonObject::isEqual(const GameObject* other) const {
@@ -1199,6 +1538,9 @@ bool PolygonObject::isEqual(const GameObject* other) const {
 	if (!polygon) {
 		return false;
 	}
+	if (getDecompositionAlgorithm() != polygon->getDecompositionAlgorithm()) {
+		return false;
+	}
 	return true;
 }
 
@@ -1209,10 +1551,10 @@ ChainObject::ChainObject(GameObjectList* object_list, b2BodyDef def, std::vector
 	sf::VertexArray drawable_vertices(sf::LinesStrip, p_vertices.size());
 	for (size_t i = 0; i < p_vertices.size(); i++) {
 		drawable_vertices[i].position = tosf(p_vertices[i]);
-		EditableVertex ev(p_vertices[i]);
-		vertices.push_back(ev);
 	}
+	vertices.assign(p_vertices);
 	line_strip_shape = dp::make_data_pointer<LineStripShape>("ChainObject " + name + " line_strip_shape", drawable_vertices);
+	line_strip_shape->setLodEnabled(true);
 	syncVertices(true);
 	transformFromRigidbody();
 	line_strip_shape->setLineColor(color);
@@ -1331,6 +1673,7 @@ void ChainObject::internalSyncVertices() {
 		line_strip_shape->varray[i].position = tosf(b2vertices[i]);
 		line_strip_shape->varray[i].color = color;
 	}
+	line_strip_shape->invalidateLod();
 }
 
 bool ChainObject::isEqual(const GameObject* other) const {
@@ -0,0 +1,117 @@
+#include "simulation/instanced_shapes.h"
+
+bool InstancedShapes::add(const sf::Drawable& drawable) {
+	if (const CircleNotchShape* circle_notch = dynamic_cast<const CircleNotchShape*>(&drawable)) {
+		add(*circle_notch);
+		return true;
+	}
+	if (const sf::RectangleShape* rect = dynamic_cast<const sf::RectangleShape*>(&drawable)) {
+		if (rect->getTexture() || rect->getOutlineThickness() != 0.0f) {
+			return false;
+		}
+		add(*rect);
+		return true;
+	}
+	return false;
+}
+
+void InstancedShapes::add(const CircleNotchShape& shape) {
+	const Mesh& mesh = getCircleMesh(shape.getPointCount(), shape.getNotchSegmentCount());
+	sf::Transform transform = shape.getTransform();
+	transform.scale(shape.getRadius(), shape.getRadius());
+	sf::Color colors[] = { shape.getCircleColor(), shape.getNotchColor() };
+	addInstance(mesh, transform, colors);
+}
+
+void InstancedShapes::add(const sf::RectangleShape& shape) {
+	const Mesh& mesh = getRectMesh();
+	sf::Transform transform = shape.getTransform();
+	transform.scale(shape.getSize());
+	sf::Color colors[] = { shape.getFillColor() };
+	addInstance(mesh, transform, colors);
+}
+
+void InstancedShapes::clear() {
+	vertices.clear();
+	instance_count = 0;
+}
+
+bool InstancedShapes::empty() const {
+	return instance_count == 0;
+}
+
+size_t InstancedShapes::getInstanceCount() const {
+	return instance_count;
+}
+
+size_t InstancedShapes::getMeshCount() const {
+	return circle_meshes.size() + (rect_mesh.positions.empty() ? 0 : 1);
+}
+
+size_t InstancedShapes::getBatchCount() const {
+	return (vertices.size() + MAX_BATCH_VERTICES - 1) / MAX_BATCH_VERTICES;
+}
+
+const std::vector<sf::Vertex>& InstancedShapes::getVertices() const {
+	return vertices;
+}
+
+void InstancedShapes::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+	for (size_t first = 0; first < vertices.size(); first += MAX_BATCH_VERTICES) {
+		size_t count = vertices.size() - first;
+		if (count > MAX_BATCH_VERTICES) {
+			count = MAX_BATCH_VERTICES;
+		}
+		target.draw(vertices.data() + first, count, sf::Triangles, states);
+	}
+}
+
+const InstancedShapes::Mesh& InstancedShapes::getCircleMesh(size_t point_count, size_t notch_segment_count) {
+	std::pair<size_t, size_t> key(point_count, notch_segment_count);
+	auto it = circle_meshes.find(key);
+	if (it != circle_meshes.end()) {
+		return it->second;
+	}
+	// same vertices as CircleNotchShape, notch is drawn over the circle
+	CircleNotchShape unit_shape(1.0f, point_count, notch_segment_count);
+	Mesh mesh;
+	addTriangleFan(mesh, unit_shape.getCircleVarray(), 0);
+	addTriangleFan(mesh, unit_shape.getNotchVarray(), 1);
+	return circle_meshes.insert({ key, mesh }).first->second;
+}
+
+const InstancedShapes::Mesh& InstancedShapes::getRectMesh() {
+	if (rect_mesh.positions.empty()) {
+		rect_mesh.positions = {
+			sf::Vector2f(0.0f, 0.0f), sf::Vector2f(1.0f, 0.0f), sf::Vector2f(1.0f, 1.0f),
+			sf::Vector2f(0.0f, 0.0f), sf::Vector2f(1.0f, 1.0f), sf::Vector2f(0.0f, 1.0f),
+		};
+		rect_mesh.parts = std::vector<size_t>(rect_mesh.positions.size(), 0);
+	}
+	return rect_mesh;
+}
+
+void InstancedShapes::addInstance(const Mesh& mesh, const sf::Transform& transform, const sf::Color* colors) {
+	// 2d part of the 4x4 matrix, taken out once instead of per vertex
+	const float* matrix = transform.getMatrix();
+	float a = matrix[0], b = matrix[4], tx = matrix[12];
+	float c = matrix[1], d = matrix[5], ty = matrix[13];
+	size_t first = vertices.size();
+	vertices.resize(first + mesh.positions.size());
+	for (size_t i = 0; i < mesh.positions.size(); i++) {
+		const sf::Vector2f& pos = mesh.positions[i];
+		sf::Vertex& vertex = vertices[first + i];
+		vertex.position = sf::Vector2f(a * pos.x + b * pos.y + tx, c * pos.x + d * pos.y + ty);
+		vertex.color = colors[mesh.parts[i]];
+	}
+	instance_count++;
+}
+
+void InstancedShapes::addTriangleFan(Mesh& mesh, const sf::VertexArray& fan, size_t part) {
+	for (size_t i = 1; i + 1 < fan.getVertexCount(); i++) {
+		mesh.positions.push_back(fan[0].position);
+		mesh.positions.push_back(fan[i].position);
+		mesh.positions.push_back(fan[i + 1].position);
+		mesh.parts.insert(mesh.parts.end(), 3, part);
+	}
+}
@@ -0,0 +1,419 @@
+#include <fstream>
+#include "simulation/level_index.h"
+
+struct LevelScanToken {
+	std::string_view str;
+	size_t offset = 0;
+	bool quoted = false;
+};
+
+// splits text into words like TokenReader does,
+// but keeps byte offsets and doesn't copy the words
+class LevelScanner {
+public:
+	LevelScanner(const std::string& str) : str(str) { }
+
+	bool next(LevelScanToken& token) {
+		while (pos < str.size() && isspace(static_cast<unsigned char>(str[pos]))) {
+			pos++;
+		}
+		if (pos >= str.size()) {
+			return false;
+		}
+		token.offset = pos;
+		token.quoted = str[pos] == '"';
+		if (token.quoted) {
+			pos++;
+			size_t start = pos;
+			while (pos < str.size() && str[pos] != '"') {
+				if (str[pos] == '\\') {
+					pos++;
+				}
+				pos++;
+			}
+			size_t end = std::min(pos, str.size());
+			token.str = std::string_view(str).substr(start, end - start);
+			pos = std::min(pos + 1, str.size());
+		} else {
+			size_t start = pos;
+			while (pos < str.size() && !isspace(static_cast<unsigned char>(str[pos]))) {
+				pos++;
+			}
+			token.str = std::string_view(str).substr(start, pos - start);
+		}
+		return true;
+	}
+
+	bool tryReadFloat(float& value) {
+		size_t old_pos = pos;
+		LevelScanToken token;
+		if (next(token) && !token.quoted) {
+			std::string word(token.str);
+			const char* start = word.c_str();
+			char* end;
+			value = std::strtof(start, &end);
+			if (end != start && *end == '\0') {
+				return true;
+			}
+		}
+		pos = old_pos;
+		return false;
+	}
+
+	float readFloat() {
+		float value;
+		if (!tryReadFloat(value)) {
+			throw std::runtime_error("Expected number at offset " + std::to_string(pos));
+		}
+		return value;
+	}
+
+	b2Vec2 readb2Vec2() {
+		b2Vec2 vec;
+		vec.x = readFloat();
+		vec.y = readFloat();
+		return vec;
+	}
+
+	size_t readSizet() {
+		LevelScanToken token;
+		if (next(token) && !token.quoted) {
+			std::string word(token.str);
+			const char* start = word.c_str();
+			char* end;
+			unsigned long long value = std::strtoull(start, &end, 10);
+			if (end != start && *end == '\0') {
+				return value;
+			}
+		}
+		throw std::runtime_error("Expected integer at offset " + std::to_string(pos));
+	}
+
+private:
+	const std::string& str;
+	size_t pos = 0;
+
+};
+
+bool LevelIndexEntry::operator==(const LevelIndexEntry& other) const {
+	return
+		id == other.id
+		&& parent_id == other.parent_id
+		&& type == other.type
+		&& offset == other.offset
+		&& length == other.length
+		&& aabb.lowerBound == other.aabb.lowerBound
+		&& aabb.upperBound == other.aabb.upperBound;
+}
+
+LevelIndex::LevelIndex() { }
+
+LevelIndex::LevelIndex(const std::string& str) {
+	build(str);
+}
+
+size_t LevelIndex::size() const {
+	return entries.size();
+}
+
+size_t LevelIndex::getSourceSize() const {
+	return source_size;
+}
+
+ptrdiff_t LevelIndex::getSourceTime() const {
+	return source_time;
+}
+
+void LevelIndex::setSourceTime(ptrdiff_t time) {
+	this->source_time = time;
+}
+
+const std::vector<LevelIndexEntry>& LevelIndex::getEntries() const {
+	return entries;
+}
+
+const LevelIndexEntry* LevelIndex::find(size_t id) const {
+	auto it = ids.find(id);
+	if (it == ids.end()) {
+		return nullptr;
+	}
+	return &entries[it->second];
+}
+
+std::vector<const LevelIndexEntry*> LevelIndex::query(const b2AABB& region) const {
+	std::vector<const LevelIndexEntry*> result;
+	for (const LevelIndexEntry& entry : entries) {
+		if (b2TestOverlap(entry.aabb, region)) {
+			result.push_back(&entry);
+		}
+	}
+	return result;
+}
+
+void LevelIndex::build(const std::string& str) {
+	clear();
+	source_size = str.size();
+	LevelScanner scanner(str);
+	LevelScanToken token;
+	try {
+		while (scanner.next(token)) {
+			if (token.quoted || token.str != "object") {
+				continue;
+			}
+			LevelIndexEntry entry;
+			entry.offset = token.offset;
+			if (!scanner.next(token)) {
+				throw std::runtime_error("Object type expected at offset " + std::to_string(entry.offset));
+			}
+			entry.type = token.str;
+			bool id_found = false;
+			bool closed = false;
+			b2Vec2 position = b2Vec2(0.0f, 0.0f);
+			// distance from the body origin to the farthest point,
+			// gives a bounding box that stays valid for any angle
+			float extent = 0.0f;
+			while (scanner.next(token)) {
+				if (token.quoted) {
+					continue;
+				}
+				if (token.str == "/object") {
+					entry.length = token.offset + token.str.size() - entry.offset;
+					closed = true;
+					break;
+				} else if (token.str == "id") {
+					entry.id = scanner.readSizet();
+					id_found = true;
+				} else if (token.str == "parent_id") {
+					entry.parent_id = scanner.readSizet();
+				} else if (token.str == "position") {
+					position = scanner.readb2Vec2();
+				} else if (token.str == "size") {
+					b2Vec2 size = scanner.readb2Vec2();
+					extent = std::max(extent, size.Length() / 2.0f);
+				} else if (token.str == "radius") {
+					extent = std::max(extent, scanner.readFloat());
+				} else if (token.str == "vertices") {
+					float x, y;
+					while (scanner.tryReadFloat(x)) {
+						y = scanner.readFloat();
+						extent = std::max(extent, b2Vec2(x, y).Length());
+					}
+				}
+			}
+			if (!closed) {
+				throw std::runtime_error("Object block is not closed, offset " + std::to_string(entry.offset));
+			}
+			if (!id_found) {
+				throw std::runtime_error("Object id not found, offset " + std::to_string(entry.offset));
+			}
+			entry.aabb.lowerBound = position - b2Vec2(extent, extent);
+			entry.aabb.upperBound = position + b2Vec2(extent, extent);
+			addEntry(entry);
+		}
+	} catch (std::exception exc) {
+		throw std::runtime_error(__FUNCTION__": " + std::string(exc.what()));
+	}
+}
+
+void LevelIndex::clear() {
+	entries.clear();
+	ids.clear();
+	source_size = 0;
+	source_time = 0;
+}
+
+std::string LevelIndex::serialize() const {
+	TokenWriter tw;
+	serialize(tw);
+	return tw.toStr();
+}
+
+TokenWriter& LevelIndex::serialize(TokenWriter& tw) const {
+	tw << "level_index" << "\n";
+	{
+		TokenWriterIndent index_indent(tw);
+		tw.writeSizetParam("source_size", source_size);
+		tw.writePtrdiffParam("source_time", source_time);
+		for (const LevelIndexEntry& entry : entries) {
+			tw << "object" << entry.id << entry.parent_id << entry.type << entry.offset << entry.length;
+			tw << entry.aabb.lowerBound << entry.aabb.upperBound << "\n";
+		}
+	}
+	tw << "/level_index";
+	return tw;
+}
+
+void LevelIndex::deserialize(const std::string& str) {
+	TokenReader tr(str);
+	deserialize(tr);
+}
+
+void LevelIndex::deserialize(TokenReader& tr) {
+	clear();
+	try {
+		tr.eat("level_index");
+		while (tr.validRange()) {
+			std::string pname = tr.readString();
+			if (pname == "source_size") {
+				source_size = tr.readULL();
+			} else if (pname == "source_time") {
+				source_time = tr.readLL();
+			} else if (pname == "object") {
+				LevelIndexEntry entry;
+				entry.id = tr.readULL();
+				entry.parent_id = tr.readLL();
+				entry.type = tr.readString();
+				entry.offset = tr.readULL();
+				entry.length = tr.readULL();
+				entry.aabb.lowerBound = tr.readb2Vec2();
+				entry.aabb.upperBound = tr.readb2Vec2();
+				addEntry(entry);
+			} else if (pname == "/level_index") {
+				break;
+			} else {
+				throw std::runtime_error("Unknown LevelIndex parameter name: " + pname);
+			}
+		}
+		if (tr.fail()) {
+			throw std::runtime_error("Unexpected end of index");
+		}
+	} catch (std::exception exc) {
+		throw std::runtime_error(__FUNCTION__": Line " + std::to_string(tr.getLine(-1)) + ": " + exc.what());
+	}
+}
+
+bool LevelIndex::operator==(const LevelIndex& other) const {
+	return entries == other.entries && source_size == other.source_size;
+}
+
+void LevelIndex::addEntry(const LevelIndexEntry& entry) {
+	bool inserted = ids.insert({ entry.id, entries.size() }).second;
+	if (!inserted) {
+		throw std::runtime_error("Duplicate object id: " + std::to_string(entry.id));
+	}
+	entries.push_back(entry);
+}
+
+LevelFile::LevelFile(const std::filesystem::path& path) {
+	this->path = path;
+}
+
+const std::filesystem::path& LevelFile::getPath() const {
+	return path;
+}
+
+const LevelIndex& LevelFile::getIndex() const {
+	return index;
+}
+
+void LevelFile::open() {
+	LoggerTag tag_saveload("saveload");
+	try {
+		if (!std::filesystem::exists(path)) {
+			throw std::runtime_error("File not found: " + path.string());
+		}
+		std::filesystem::path index_path = getIndexPath(path);
+		if (std::filesystem::exists(index_path)) {
+			index.deserialize(utils::file_to_str(index_path));
+			bool size_matches = index.getSourceSize() == std::filesystem::file_size(path);
+			bool time_matches = index.getSourceTime() == getFileTime(path);
+			if (size_matches && time_matches) {
+				return;
+			}
+			logger << "Index is out of date: " << index_path.string() << "\n";
+		}
+		index = writeIndex(path);
+	} catch (std::exception exc) {
+		throw std::runtime_error(__FUNCTION__": " + path.string() + ": " + std::string(exc.what()));
+	}
+}
+
+std::string LevelFile::readBlock(size_t id) const {
+	const LevelIndexEntry* entry = index.find(id);
+	if (!entry) {
+		throw std::runtime_error(__FUNCTION__": Object not found in index: " + std::to_string(id));
+	}
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		throw std::runtime_error(__FUNCTION__": File read error: " + path.string());
+	}
+	std::string block(entry->length, '\0');
+	file.seekg(entry->offset);
+	file.read(block.data(), entry->length);
+	if (static_cast<size_t>(file.gcount()) != entry->length) {
+		throw std::runtime_error(__FUNCTION__": Unexpected end of file: " + path.string());
+	}
+	return block;
+}
+
+GameObject* LevelFile::loadObject(size_t id, GameObjectList* object_list) {
+	try {
+		GameObject* existing = object_list->getById(id);
+		if (existing) {
+			return existing;
+		}
+		const LevelIndexEntry* entry = index.find(id);
+		if (!entry) {
+			throw std::runtime_error("Object not found in index: " + std::to_string(id));
+		}
+		// parent has to be added first, otherwise GameObjectList::add won't find it
+		if (entry->parent_id >= 0) {
+			loadObject(entry->parent_id, object_list);
+		}
+		TokenReader tr(readBlock(id));
+		tr.eat("object");
+		dp::DataPointerUnique<GameObject> gameobject = Simulation::deserializeObject(tr, object_list);
+		return object_list->add(std::move(gameobject), false);
+	} catch (std::exception exc) {
+		throw std::runtime_error(__FUNCTION__": " + std::string(exc.what()));
+	}
+}
+
+std::vector<GameObject*> LevelFile::loadRegion(const b2AABB& region, GameObjectList* object_list) {
+	std::vector<GameObject*> result;
+	std::vector<const LevelIndexEntry*> entries = index.query(region);
+	for (const LevelIndexEntry* entry : entries) {
+		result.push_back(loadObject(entry->id, object_list));
+	}
+	return result;
+}
+
+void LevelFile::save(const std::string& str, const std::filesystem::path& path) {
+	{
+		// binary mode, offsets in the index have to match the bytes on disk
+		std::ofstream ofstream(path, std::ios::binary);
+		if (!ofstream.is_open()) {
+			throw std::runtime_error(__FUNCTION__": File write error: " + path.string());
+		}
+		ofstream << str;
+	}
+	writeIndex(path);
+}
+
+LevelIndex LevelFile::writeIndex(const std::filesystem::path& path) {
+	LevelIndex index(readFile(path));
+	index.setSourceTime(getFileTime(path));
+	std::string index_str = index.serialize();
+	utils::str_to_file(index_str, getIndexPath(path));
+	return index;
+}
+
+std::filesystem::path LevelFile::getIndexPath(const std::filesystem::path& path) {
+	std::filesystem::path index_path = path;
+	index_path += ".index";
+	return index_path;
+}
+
+std::string LevelFile::readFile(const std::filesystem::path& path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		throw std::runtime_error(__FUNCTION__": File read error: " + path.string());
+	}
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	return buffer.str();
+}
+
+ptrdiff_t LevelFile::getFileTime(const std::filesystem::path& path) {
+	return static_cast<ptrdiff_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+}
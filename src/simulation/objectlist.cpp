@@ -32,6 +32,10 @@ GameObject* GameObjectList::getByName(const std::string& name) const {
     return names.find(name);
 }
 
+std::vector<GameObject*> GameObjectList::findByName(const std::string& pattern) const {
+    return names.match(pattern);
+}
+
 bool GameObjectList::contains(GameObject* object) const {
     return all_objects.contains(object);
 }
@@ -56,6 +60,11 @@ const CompVector<GameObject*>& GameObjectList::getAllObjects() const {
     return all_objects.getCompVector();
 }
 
+const std::vector<GameObject*>& GameObjectList::getHierarchy() const {
+    updateHierarchy();
+    return hierarchy;
+}
+
 ptrdiff_t GameObjectList::getMaxId() const {
     if (ids.size() > 0) {
         return ids.max();
@@ -91,6 +100,7 @@ GameObject* GameObjectList::add(dp::DataPointerUnique<GameObject> object, bool a
         } else {
             top_objects.add(ptr);
         }
+        invalidateHierarchy();
         names.add(ptr->name, ptr);
         all_objects.add(std::move(object));
         OnObjectAdded(ptr);
@@ -126,6 +136,7 @@ GameObject* GameObjectList::duplicate(const GameObject* object, bool with_childr
 }
 
 CompVector<GameObject*> GameObjectList::duplicate(const CompVector<GameObject*>& old_objects) {
+    EventBatchScope batch(OnObjectAdded, OnSetParent, OnObjectMoved);
     CompVector<GameObject*> new_objects;
     std::set<Joint*> checked_joints;
     // copy objects
@@ -159,6 +170,7 @@ CompVector<GameObject*> GameObjectList::duplicate(const CompVector<GameObject*>&
             checked_joints.insert(joint);
         }
     }
+    batch.end();
     return new_objects;
 }
 
@@ -208,9 +220,31 @@ void GameObjectList::transformFromRigidbody() {
 void GameObjectList::moveObjectToIndex(GameObject* object, size_t index) {
     mAssert(top_objects.contains(object));
     top_objects.moveValueToIndex(object, index);
+    invalidateHierarchy();
     OnObjectMoved(object, index);
 }
 
+void GameObjectList::offsetObjects(const CompVector<GameObject*>& objects, const b2Vec2& offset) {
+    for (size_t i = 0; i < objects.size(); i++) {
+        GameObject* object = objects[i];
+        // rotation is kept as is, so that moving doesn't accumulate rounding errors in it
+        b2Transform transform(object->orig_pos + offset, object->getGlobalTransform().q);
+        setGlobalTransformBatched(object, transform);
+    }
+}
+
+void GameObjectList::rotateObjects(const CompVector<GameObject*>& objects, const b2Vec2& pivot, float angle) {
+    b2Rot rot(angle);
+    for (size_t i = 0; i < objects.size(); i++) {
+        GameObject* object = objects[i];
+        // written as an offset from orig_pos, so that zero angle gives orig_pos exactly
+        b2Vec2 rel_pos = object->orig_pos - pivot;
+        b2Vec2 new_pos = object->orig_pos + (b2Mul(rot, rel_pos) - rel_pos);
+        b2Transform transform(new_pos, b2Rot(object->orig_angle + angle));
+        setGlobalTransformBatched(object, transform);
+    }
+}
+
 void GameObjectList::remove(GameObject* object, bool remove_children) {
     mAssert(object);
     mAssert(all_objects.contains(object));
@@ -236,12 +270,69 @@ void GameObjectList::remove(GameObject* object, bool remove_children) {
         }
     }
     top_objects.remove(object);
+    invalidateHierarchy();
     ids.remove(object->id);
     names.remove(object->name, object);
     all_objects.remove(object);
     OnAfterObjectRemoved(object);
 }
 
+void GameObjectList::setGlobalTransformBatched(GameObject* object, const b2Transform& transform) {
+    object->transform.setGlobalTransform(transform);
+    for (size_t i = 0; i < object->children.size(); i++) {
+        object->children[i]->transform.invalidateGlobalTransform();
+    }
+    // pre-order, so every global transform is recalculated once from the parent's one
+    for (GameObject* subtree_object : object->getSubtree()) {
+        const b2Transform& global_transform = subtree_object->getGlobalTransform();
+        subtree_object->rigid_body->SetTransform(global_transform.p, global_transform.q.GetAngle());
+    }
+}
+
+void GameObjectList::invalidateHierarchy() {
+    hierarchy_valid = false;
+}
+
+void GameObjectList::updateHierarchy() const {
+    if (hierarchy_valid) {
+        return;
+    }
+    hierarchy.clear();
+    hierarchy.reserve(all_objects.size());
+    // iterative so deep hierarchies don't overflow the stack
+    struct Frame {
+        GameObject* object;
+        size_t next_child;
+    };
+    std::vector<Frame> stack;
+    auto enter = [&](GameObject* object) {
+        object->hierarchy_index = hierarchy.size();
+        object->depth = stack.size();
+        hierarchy.push_back(object);
+        stack.push_back({ object, 0 });
+    };
+    for (size_t i = 0; i < top_objects.size(); i++) {
+        enter(top_objects[i]);
+        while (!stack.empty()) {
+            GameObject* object = stack.back().object;
+            size_t child_index = stack.back().next_child;
+            if (child_index < object->children.size()) {
+                stack.back().next_child++;
+                enter(object->children[child_index]);
+            } else {
+                object->subtree_size = hierarchy.size() - object->hierarchy_index;
+                stack.pop_back();
+            }
+        }
+    }
+    hierarchy_valid = true;
+}
+
+bool GameObjectList::isInHierarchy(const GameObject* object) const {
+    // object can be missing if it was added but not attached to its parent yet
+    return object->hierarchy_index < hierarchy.size() && hierarchy[object->hierarchy_index] == object;
+}
+
 void GameObjectList::removeJoint(Joint* joint) {
     mAssert(joint);
     joint->object1->joints.remove(joint);
@@ -253,6 +344,7 @@ void GameObjectList::clear() {
     joints.clear();
     all_objects.clear();
     top_objects.clear();
+    invalidateHierarchy();
     ids.clear();
     names.clear();
     OnClear();
@@ -1,5 +1,7 @@
 #include <cassert>
 #include "simulation/polygon.h"
+#include "simulation/convex_decomposition.h"
+#include "common/log.h"
 
 sf::Text vertex_text;
 
@@ -114,7 +116,7 @@ sf::Color SplittablePolygon::getFillColor() const {
 	return fill_color;
 }
 
-std::vector<SplittablePolygon> SplittablePolygon::getConvexPolygons() const {
+const std::vector<SplittablePolygon>& SplittablePolygon::getConvexPolygons() const {
 	return convex_polygons;
 }
 
@@ -138,15 +140,22 @@ bool SplittablePolygon::isConvex() const {
 	return true;
 }
 
+SplittablePolygon::DecompositionAlgorithm SplittablePolygon::getDecompositionAlgorithm() const {
+	return decomposition_algorithm;
+}
+
+void SplittablePolygon::setDecompositionAlgorithm(DecompositionAlgorithm algorithm) {
+	if (algorithm == decomposition_algorithm) {
+		return;
+	}
+	decomposition_algorithm = algorithm;
+	setCutsValid(false);
+}
+
 void SplittablePolygon::setPoint(size_t index, const sf::Vector2f& point) {
 	assert(index < getPointCount());
 	setCutsValid(false);
-	varray[index].position = point;
-	if (index == 0) {
-		varray[varray.getVertexCount() - 1].position = point;
-	} else if (index == varray.getVertexCount() - 1) {
-		varray[0].position = point;
-	}
+	movePoint(index, point);
 }
 
 void SplittablePolygon::setLineColor(const sf::Color& color) {
@@ -170,24 +179,34 @@ void SplittablePolygon::setFillColor(const sf::Color& color) {
 }
 
 void SplittablePolygon::calcPotentialCuts(bool consider_convex_vertices) {
-	logger << __FUNCTION__"\n";
-	LoggerIndent polygon_object_indent;
+	LOG(__FUNCTION__"\n");
+	LOG_INDENT();
 	std::vector<std::vector<CutInfo>> result(getPointCount());
 	std::vector<bool> is_convex_vertex(getPointCount());
 	for (size_t vert_i = 0; vert_i < getPointCount(); vert_i++) {
 		is_convex_vertex[vert_i] = isConvexVertex(vert_i);
 	}
+	// first point is repeated at the end, so edge i goes from point i to point i + 1
+	utils::batch::Points points(getPointCount() + 1);
+	for (size_t i = 0; i < points.size(); i++) {
+		sf::Vector2f point = getPoint(i % getPointCount());
+		points.set(i, point.x, point.y);
+	}
+	std::span<const float> points_x(points.x.data(), getPointCount());
+	std::span<const float> points_y(points.y.data(), getPointCount());
+	std::vector<uint8_t> right_side_1(getPointCount());
+	std::vector<uint8_t> right_side_2(getPointCount());
 	for (size_t vert_i = 0; vert_i < getPointCount(); vert_i++) {
 		sf::Vector2f vertex = getPoint(vert_i);
 		if (is_convex_vertex[vert_i]) {
-			logger << "Vertex: " << vert_i << ", pos: " << vertex << ", convex" << "\n";
+			LOG("Vertex: " << vert_i << ", pos: " << vertex << ", convex" << "\n");
 			if (!consider_convex_vertices) {
 				continue;
 			}
 		} else {
-			logger << "Vertex: " << vert_i << ", pos: " << vertex << ", concave" << "\n";
+			LOG("Vertex: " << vert_i << ", pos: " << vertex << ", concave" << "\n");
 		}
-		LoggerIndent vertex_indent;
+		LOG_INDENT();
 		sf::Vector2f prev_vertex = getPoint(indexLoop(vert_i - 1));
 		sf::Vector2f next_vertex = getPoint(indexLoop(vert_i + 1));
 		sf::Vector2f side1_dir = utils::normalize(vertex - prev_vertex);
@@ -195,33 +214,37 @@ void SplittablePolygon::calcPotentialCuts(bool consider_convex_vertices) {
 		sf::Vector2f side1_dir_rot = utils::rot90CCW(side1_dir);
 		sf::Vector2f side2_dir_rot = utils::rot90CW(side2_dir);
 		sf::Vector2f vertex_normal = utils::normalize(side1_dir_rot + side2_dir_rot);
+		utils::batch::right_side(
+			points_x, points_y, prev_vertex.x, prev_vertex.y, vertex.x, vertex.y, right_side_1
+		);
+		utils::batch::right_side(
+			points_x, points_y, vertex.x, vertex.y, next_vertex.x, next_vertex.y, right_side_2
+		);
 		for (size_t cut_i = 0; cut_i < getPointCount(); cut_i++) {
 			bool prev = cut_i == indexLoop(vert_i - 1);
 			bool curr = cut_i == indexLoop(vert_i);
 			bool next = cut_i == indexLoop(vert_i + 1);
 			if (prev || curr || next) {
-				logger << "Vertex cut " << vert_i << "-" << cut_i << " is adjacent edge" << "\n";
+				LOG("Vertex cut " << vert_i << "-" << cut_i << " is adjacent edge" << "\n");
 				continue;
 			}
 			sf::Vector2f vertex_cut = getPoint(cut_i);
-			bool right_side_1 = utils::right_side(vertex_cut, prev_vertex, vertex);
-			bool right_side_2 = utils::right_side(vertex_cut, vertex, next_vertex);
-			bool red_zone = right_side_1 && right_side_2;
+			bool red_zone = right_side_1[cut_i] && right_side_2[cut_i];
 			if (red_zone) {
-				logger << "Vertex cut " << vert_i << "-" << cut_i << " is in red zone" << "\n";
+				LOG("Vertex cut " << vert_i << "-" << cut_i << " is in red zone" << "\n");
 				continue;
 			}
 			size_t edge_index;
-			if (intersectsEdge(vertex, vertex_cut, edge_index)) {
-				logger << "Vertex cut " << vert_i << "-" << cut_i << " intersects edge " << edge_index << "\n";
+			if (intersectsEdge(points, vertex, vertex_cut, edge_index)) {
+				LOG("Vertex cut " << vert_i << "-" << cut_i << " intersects edge " << edge_index << "\n");
 				continue;
 			}
-			bool green_zone = !right_side_1 && !right_side_2;
+			bool green_zone = !right_side_1[cut_i] && !right_side_2[cut_i];
 			bool to_concave = !is_convex_vertex[cut_i];
 			{
 				std::string green_zone_str = green_zone ? ", green zone" : ", yellow zone";
 				std::string to_concave_str = to_concave ? ", to concave" : "";
-				logger << "Vertex cut " << vert_i << "-" << cut_i << " OK" << green_zone_str << to_concave_str << "\n";
+				LOG("Vertex cut " << vert_i << "-" << cut_i << " OK" << green_zone_str << to_concave_str << "\n");
 			}
 			sf::Vector2f cut_vector = vertex_cut - vertex;
 			CutInfo pv;
@@ -239,11 +262,11 @@ void SplittablePolygon::calcPotentialCuts(bool consider_convex_vertices) {
 			pv.score = pv.angle_diff * 100.0f + sqrt(pv.sqr_dist);
 			result[vert_i].push_back(pv);
 		}
-		logger << "Potential cuts: ";
+		LOG("Potential cuts: ");
 		for (size_t pv_i = 0; pv_i < result[vert_i].size(); pv_i++) {
-			logger << result[vert_i][pv_i].to << " ";
+			LOG(result[vert_i][pv_i].to << " ");
 		}
-		logger << "\n";
+		LOG("\n");
 	}
 
 	std::vector<CutInfo> cuts;
@@ -252,8 +275,8 @@ void SplittablePolygon::calcPotentialCuts(bool consider_convex_vertices) {
 			cuts.push_back(result[vert_i][cut_i]);
 		}
 	}
-	logger << "Finding reciprocal cuts\n";
-	LoggerIndent reciprocal_cuts_indent;
+	LOG("Finding reciprocal cuts\n");
+	LOG_INDENT();
 	for (size_t i = 0; i < cuts.size(); i++) {
 		CutInfo& cut1 = cuts[i];
 		if (cut1.has_reciprocal) {
@@ -264,7 +287,7 @@ void SplittablePolygon::calcPotentialCuts(bool consider_convex_vertices) {
 			if (cut1.to == cut2.from && cut2.to == cut1.from) {
 				std::string cut1_str = cut1.green_zone ? "green" : "yellow";
 				std::string cut2_str = cut2.green_zone ? "green" : "yellow";
-				logger << cut1.from << "-" << cut1.to << ", " << cut1_str << "-" << cut2_str << "\n";
+				LOG(cut1.from << "-" << cut1.to << ", " << cut1_str << "-" << cut2_str << "\n");
 				cut1.has_reciprocal = true;
 				cut2.has_reciprocal = true;
 				cut1.green_reciprocal = cut2.green_zone;
@@ -288,11 +311,11 @@ void SplittablePolygon::drawPotentialCuts(sf::RenderTarget& target) {
 }
 
 CutInfo SplittablePolygon::getBestCut(BestCutCriterion criterion) const {
-	logger << __FUNCTION__"\n";
-	LoggerIndent get_best_cut_indent;
+	LOG(__FUNCTION__"\n");
+	LOG_INDENT();
 	std::vector<CutInfo> cuts(potential_cuts);
 	auto cmp = [&](const CutInfo& left, const CutInfo& right) {
-		LoggerIndent cmp_indent;
+		LOG_INDENT();
 		CutInfo::CutType left_type = left.getType();
 		CutInfo::CutType right_type = right.getType();
 		if (left_type != right_type) {
@@ -311,44 +334,44 @@ CutInfo SplittablePolygon::getBestCut(BestCutCriterion criterion) const {
 		}
 	};
 	std::sort(cuts.begin(), cuts.end(), cmp);
-	logger << "Sorted cuts:\n";
-	LoggerIndent sorted_cuts_indent;
+	LOG("Sorted cuts:\n");
+	LOG_INDENT();
 	for (size_t i = 0; i < cuts.size(); i++) {
-		logger << cuts[i].toStr() << "\n";
+		LOG(cuts[i].toStr() << "\n");
 	}
 	return cuts[0];
 }
 
 std::vector<SplittablePolygon> SplittablePolygon::getCutPolygons(const CutInfo& cut) const {
-	logger << __FUNCTION__"\n";
-	LoggerIndent polygon_cut_indent;
-	logger << "From: " << cut.from << " to: " << cut.to << "\n";
+	LOG(__FUNCTION__"\n");
+	LOG_INDENT();
+	LOG("From: " << cut.from << " to: " << cut.to << "\n");
 	assert(cut.from != cut.to);
 	std::vector<SplittablePolygon> result(2);
 	size_t lower_index = std::min(cut.from, cut.to);
 	size_t upper_index = std::max(cut.from, cut.to);
 	size_t polygon2_count = upper_index - lower_index + 1;
 	size_t polygon1_count = getPointCount() - polygon2_count + 2;
-	logger << "Polygon 1 count: " << polygon1_count << "\n";
-	logger << "Polygon 2 count: " << polygon2_count << "\n";
+	LOG("Polygon 1 count: " << polygon1_count << "\n");
+	LOG("Polygon 2 count: " << polygon2_count << "\n");
 	SplittablePolygon polygon1(polygon1_count);
 	SplittablePolygon polygon2(polygon2_count);
 	size_t polygon1_cur = 0;
 	size_t polygon2_cur = 0;
 	for (size_t i = 0; i < getPointCount(); i++) {
-		logger << "Vertex " << i << "\n";
-		LoggerIndent setting_point_indent;
+		LOG("Vertex " << i << "\n");
+		LOG_INDENT();
 		if (i <= lower_index || i >= upper_index) {
-			logger << "Setting point in polygon 1: " << polygon1_cur << "\n";
+			LOG("Setting point in polygon 1: " << polygon1_cur << "\n");
 			polygon1.setPoint(polygon1_cur, getPoint(i));
 			polygon1_cur++;
-			logger << "polygon1_cur: " << polygon1_cur << "\n";
+			LOG("polygon1_cur: " << polygon1_cur << "\n");
 		}
 		if (i >= lower_index && i <= upper_index) {
-			logger << "Setting point in polygon 2: " << polygon2_cur << "\n";
+			LOG("Setting point in polygon 2: " << polygon2_cur << "\n");
 			polygon2.setPoint(polygon2_cur, getPoint(i));
 			polygon2_cur++;
-			logger << "polygon2_cur: " << polygon2_cur << "\n";
+			LOG("polygon2_cur: " << polygon2_cur << "\n");
 		}
 	}
 	result[0] = polygon1;
@@ -357,8 +380,8 @@ std::vector<SplittablePolygon> SplittablePolygon::getCutPolygons(const CutInfo&
 }
 
 std::vector<SplittablePolygon> SplittablePolygon::cutWithBestCut(bool cut_convex) {
-	logger << __FUNCTION__"\n";
-	LoggerIndent cut_indent;
+	LOG(__FUNCTION__"\n");
+	LOG_INDENT();
 	std::vector<SplittablePolygon> result;
 	if (!cuts_valid) {
 		calcPotentialCuts(cut_convex);
@@ -376,8 +399,8 @@ std::vector<SplittablePolygon> SplittablePolygon::cutWithBestCut(bool cut_convex
 }
 
 std::vector<SplittablePolygon> SplittablePolygon::cutIntoConvex(size_t max_vertices) {
-	logger << __FUNCTION__"\n";
-	LoggerIndent cut_indent;
+	LOG(__FUNCTION__"\n");
+	LOG_INDENT();
 	std::vector<SplittablePolygon> result;
 	bool is_convex = isConvex();
 	bool vertices_ok = max_vertices == 0 || getPointCount() <= max_vertices;
@@ -393,6 +416,36 @@ std::vector<SplittablePolygon> SplittablePolygon::cutIntoConvex(size_t max_verti
 	return result;
 }
 
+std::vector<SplittablePolygon> SplittablePolygon::decomposeIntoConvex(size_t max_vertices) const {
+	LOG(__FUNCTION__"\n");
+	std::vector<SplittablePolygon> result;
+	bool vertices_ok = max_vertices == 0 || getPointCount() <= max_vertices;
+	if (vertices_ok && isConvex()) {
+		result.push_back(*this);
+		result.back().source_indices.resize(getPointCount());
+		for (size_t i = 0; i < getPointCount(); i++) {
+			result.back().source_indices[i] = i;
+		}
+		return result;
+	}
+	std::vector<sf::Vector2f> points(getPointCount());
+	for (size_t i = 0; i < points.size(); i++) {
+		points[i] = getPoint(i);
+	}
+	std::vector<decomposition::ConvexPiece> pieces = decomposition::decompose(points, max_vertices);
+	LOG("Pieces: " << pieces.size() << "\n");
+	result.reserve(pieces.size());
+	for (const decomposition::ConvexPiece& piece : pieces) {
+		SplittablePolygon polygon(piece.size());
+		for (size_t i = 0; i < piece.size(); i++) {
+			polygon.setPoint(i, points[piece[i]]);
+		}
+		polygon.source_indices = piece;
+		result.push_back(polygon);
+	}
+	return result;
+}
+
 void SplittablePolygon::resetVarray(size_t vertex_count) {
 	assert(vertex_count > 0);
 	varray = sf::VertexArray(sf::LinesStrip, vertex_count + 1);
@@ -409,30 +462,137 @@ void SplittablePolygon::recenter() {
 }
 
 void SplittablePolygon::recut() {
-	LoggerTag tag_recut("recut");
-	logger << __FUNCTION__"\n";
-	LoggerIndent recut_indent;
-	convex_polygons = cutIntoConvex(b2_maxPolygonVertices);
+	LOG_TAG("recut");
+	LOG(__FUNCTION__"\n");
+	LOG_INDENT();
+	std::vector<sf::Vector2f> points(getPointCount());
+	for (size_t i = 0; i < points.size(); i++) {
+		points[i] = getPoint(i);
+	}
+	DecompositionCache& cache = getDecompositionCache();
+	if (const std::vector<DecompositionCache::Piece>* pieces = cache.find(points, decomposition_algorithm, b2_maxPolygonVertices)) {
+		LOG("Cache hit\n");
+		convex_polygons.clear();
+		for (const DecompositionCache::Piece& piece : *pieces) {
+			SplittablePolygon polygon(piece.points.size());
+			for (size_t i = 0; i < piece.points.size(); i++) {
+				polygon.setPoint(i, piece.points[i]);
+			}
+			polygon.source_indices = piece.source_indices;
+			convex_polygons.push_back(polygon);
+		}
+	} else {
+		if (decomposition_algorithm == EAR_CLIPPING) {
+			convex_polygons = decomposeIntoConvex(b2_maxPolygonVertices);
+		} else {
+			convex_polygons = cutIntoConvex(b2_maxPolygonVertices);
+		}
+		std::vector<DecompositionCache::Piece> new_pieces(convex_polygons.size());
+		for (size_t polygon_i = 0; polygon_i < convex_polygons.size(); polygon_i++) {
+			const SplittablePolygon& polygon = convex_polygons[polygon_i];
+			new_pieces[polygon_i].points.resize(polygon.getPointCount());
+			for (size_t i = 0; i < polygon.getPointCount(); i++) {
+				new_pieces[polygon_i].points[i] = polygon.getPoint(i);
+			}
+			new_pieces[polygon_i].source_indices = polygon.source_indices;
+		}
+		cache.insert(std::move(points), decomposition_algorithm, b2_maxPolygonVertices, std::move(new_pieces));
+	}
 	for (size_t polygon_i = 0; polygon_i < convex_polygons.size(); polygon_i++) {
-		SplittablePolygon& polygon = convex_polygons[polygon_i];
-		polygon.recenter();
-		polygon.triangle_fan = sf::VertexArray(sf::TriangleFan, polygon.getPointCount() + 2);
-		auto set_vertex = [&](size_t index, sf::Vector2f pos) {
-			sf::Vertex vertex;
-			vertex.position = pos;
-			vertex.color = fill_color;
-			polygon.triangle_fan[index] = vertex;
-		};
-		set_vertex(0, sf::Vector2f());
-		for (size_t vertex_i = 0; vertex_i < polygon.getPointCount() + 1; vertex_i++) {
-			set_vertex(vertex_i + 1, polygon.getPoint(polygon.indexLoop(vertex_i)));
+		initConvexPolygon(convex_polygons[polygon_i]);
+	}
+}
+
+bool SplittablePolygon::recutMovedPoints(
+	const std::vector<size_t>& indices,
+	const std::vector<sf::Vector2f>& positions,
+	std::vector<size_t>& removed_polygons,
+	size_t& added_count
+) {
+	LOG_TAG("recut");
+	LOG(__FUNCTION__"\n");
+	LOG_INDENT();
+	assert(indices.size() == positions.size());
+	// best cut polygons don't know where their points came from
+	if (decomposition_algorithm != EAR_CLIPPING || convex_polygons.empty()) {
+		return false;
+	}
+	std::vector<decomposition::ConvexPiece> pieces(convex_polygons.size());
+	for (size_t i = 0; i < convex_polygons.size(); i++) {
+		if (convex_polygons[i].source_indices.empty()) {
+			return false;
+		}
+		pieces[i] = convex_polygons[i].source_indices;
+	}
+	std::vector<sf::Vector2f> points(getPointCount());
+	for (size_t i = 0; i < points.size(); i++) {
+		points[i] = getPoint(i);
+	}
+	for (size_t i = 0; i < indices.size(); i++) {
+		points[indices[i]] = positions[i];
+	}
+	std::vector<decomposition::ConvexPiece> added;
+	bool success = decomposition::redecompose(
+		points, pieces, indices, b2_maxPolygonVertices, removed_polygons, added
+	);
+	if (!success) {
+		LOG("Can't recut locally\n");
+		return false;
+	}
+	LOG("Removed: " << removed_polygons.size() << ", added: " << added.size() << "\n");
+	for (size_t i = 0; i < indices.size(); i++) {
+		movePoint(indices[i], positions[i]);
+	}
+	cuts_valid = false;
+	cuts_varray = sf::VertexArray();
+	for (auto it = removed_polygons.rbegin(); it != removed_polygons.rend(); it++) {
+		convex_polygons.erase(convex_polygons.begin() + *it);
+	}
+	for (const decomposition::ConvexPiece& piece : added) {
+		SplittablePolygon polygon(piece.size());
+		for (size_t i = 0; i < piece.size(); i++) {
+			polygon.setPoint(i, points[piece[i]]);
+		}
+		polygon.source_indices = piece;
+		initConvexPolygon(polygon);
+		convex_polygons.push_back(polygon);
+	}
+	added_count = added.size();
+	return true;
+}
+
+void SplittablePolygon::setOutline(const std::vector<sf::Vector2f>& points) {
+	assert(points.size() == getPointCount());
+	for (size_t i = 0; i < points.size(); i++) {
+		movePoint(i, points[i]);
+	}
+	cuts_valid = false;
+	cuts_varray = sf::VertexArray();
+	// old convex polygons don't match the points anymore
+	for (SplittablePolygon& polygon : convex_polygons) {
+		polygon.source_indices.clear();
+	}
+}
+
+void SplittablePolygon::setConvexPieces(const std::vector<decomposition::ConvexPiece>& pieces) {
+	convex_polygons.clear();
+	for (const decomposition::ConvexPiece& piece : pieces) {
+		SplittablePolygon polygon(piece.size());
+		for (size_t i = 0; i < piece.size(); i++) {
+			assert(piece[i] < getPointCount());
+			polygon.setPoint(i, getPoint(piece[i]));
 		}
-		polygon.is_convex = true;
-		polygon.parent = this;
-		polygon.draw_varray = false;
+		polygon.source_indices = piece;
+		initConvexPolygon(polygon);
+		convex_polygons.push_back(polygon);
 	}
 }
 
+DecompositionCache& SplittablePolygon::getDecompositionCache() {
+	static DecompositionCache cache;
+	return cache;
+}
+
 SplittablePolygon SplittablePolygon::createRect(sf::Vector2f size) {
 	SplittablePolygon rect(4);
 	rect.setPoint(0, sf::Vector2f(size.x / 2.0f, size.y / 2.0f));
@@ -464,17 +624,25 @@ bool SplittablePolygon::isConvexVertex(size_t index) const {
 	return !utils::left_side(v2, v1, v3);
 }
 
-bool SplittablePolygon::intersectsEdge(const sf::Vector2f& v1, const sf::Vector2f& v2, size_t& intersect) const {
-	for (size_t i = 0; i < getPointCount(); i++) {
-		sf::Vector2f e1 = getPoint(i);
-		sf::Vector2f e2 = getPoint(indexLoop(i + 1));
-		sf::Vector2f intersection;
-		if (utils::line_intersect(v1, v2, e1, e2, 0.000001f, intersection)) {
-			intersect = i;
-			return true;
-		}
+bool SplittablePolygon::intersectsEdge(
+	const utils::batch::Points& points, const sf::Vector2f& v1, const sf::Vector2f& v2, size_t& intersect
+) const {
+	assert(points.size() == getPointCount() + 1);
+	size_t edge_count = getPointCount();
+	sf::Vector2f intersection;
+	ptrdiff_t index = utils::batch::line_intersect_first(
+		v1.x, v1.y, v2.x, v2.y,
+		std::span<const float>(points.x.data(), edge_count),
+		std::span<const float>(points.y.data(), edge_count),
+		std::span<const float>(points.x.data() + 1, edge_count),
+		std::span<const float>(points.y.data() + 1, edge_count),
+		0.000001f, intersection
+	);
+	if (index < 0) {
+		return false;
 	}
-	return false;
+	intersect = index;
+	return true;
 }
 
 size_t SplittablePolygon::indexLoop(ptrdiff_t index) const {
@@ -504,6 +672,33 @@ void SplittablePolygon::createCutsVarray() {
 	}
 }
 
+void SplittablePolygon::movePoint(size_t index, const sf::Vector2f& point) {
+	varray[index].position = point;
+	if (index == 0) {
+		varray[varray.getVertexCount() - 1].position = point;
+	} else if (index == varray.getVertexCount() - 1) {
+		varray[0].position = point;
+	}
+}
+
+void SplittablePolygon::initConvexPolygon(SplittablePolygon& polygon) {
+	polygon.recenter();
+	polygon.triangle_fan = sf::VertexArray(sf::TriangleFan, polygon.getPointCount() + 2);
+	auto set_vertex = [&](size_t index, sf::Vector2f pos) {
+		sf::Vertex vertex;
+		vertex.position = pos;
+		vertex.color = fill_color;
+		polygon.triangle_fan[index] = vertex;
+	};
+	set_vertex(0, sf::Vector2f());
+	for (size_t vertex_i = 0; vertex_i < polygon.getPointCount() + 1; vertex_i++) {
+		set_vertex(vertex_i + 1, polygon.getPoint(polygon.indexLoop(vertex_i)));
+	}
+	polygon.is_convex = true;
+	polygon.parent = this;
+	polygon.draw_varray = false;
+}
+
 void SplittablePolygon::setCutsValid(bool value) {
 	if (value) {
 		cuts_valid = true;
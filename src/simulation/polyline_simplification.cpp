@@ -0,0 +1,74 @@
+#include "simulation/polyline_simplification.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace simplification {
+
+	static float distance_to_segment(const sf::Vector2f& p, const sf::Vector2f& a, const sf::Vector2f& b) {
+		sf::Vector2f ab = b - a;
+		sf::Vector2f ap = p - a;
+		float ab_sqr = ab.x * ab.x + ab.y * ab.y;
+		float t = 0.0f;
+		if (ab_sqr > 0.0f) {
+			t = std::clamp((ap.x * ab.x + ap.y * ab.y) / ab_sqr, 0.0f, 1.0f);
+		}
+		sf::Vector2f d = ap - t * ab;
+		return std::sqrt(d.x * d.x + d.y * d.y);
+	}
+
+	std::vector<float> douglas_peucker_importance(const std::vector<sf::Vector2f>& points) {
+		const float INF = std::numeric_limits<float>::infinity();
+		std::vector<float> importance(points.size(), 0.0f);
+		if (points.empty()) {
+			return importance;
+		}
+		importance.front() = INF;
+		importance.back() = INF;
+		struct Range {
+			size_t first;
+			size_t last;
+			float parent_importance;
+		};
+		// explicit stack, recursion depth can be as large as the point count
+		std::vector<Range> stack;
+		stack.push_back({ 0, points.size() - 1, INF });
+		while (!stack.empty()) {
+			Range range = stack.back();
+			stack.pop_back();
+			if (range.last - range.first < 2) {
+				continue;
+			}
+			size_t max_index = range.first + 1;
+			float max_distance = -1.0f;
+			for (size_t i = range.first + 1; i < range.last; i++) {
+				float distance = distance_to_segment(points[i], points[range.first], points[range.last]);
+				if (distance > max_distance) {
+					max_distance = distance;
+					max_index = i;
+				}
+			}
+			// point can't outlive the range it splits, that keeps the levels nested
+			float point_importance = std::min(max_distance, range.parent_importance);
+			importance[max_index] = point_importance;
+			stack.push_back({ range.first, max_index, point_importance });
+			stack.push_back({ max_index, range.last, point_importance });
+		}
+		return importance;
+	}
+
+	std::vector<size_t> simplify(const std::vector<float>& importance, float tolerance) {
+		std::vector<size_t> result;
+		for (size_t i = 0; i < importance.size(); i++) {
+			if (importance[i] > tolerance) {
+				result.push_back(i);
+			}
+		}
+		return result;
+	}
+
+	std::vector<size_t> douglas_peucker(const std::vector<sf::Vector2f>& points, float tolerance) {
+		return simplify(douglas_peucker_importance(points), tolerance);
+	}
+
+}
@@ -200,6 +200,10 @@ size_t TokenReader::getLine(ptrdiff_t offset) const {
 	return peek(offset).line;
 }
 
+const std::vector<WordToken>& TokenReader::getTokens() const {
+	return *tokens;
+}
+
 std::vector<WordToken> TokenReader::tokenize(const std::string& str) const {
 	std::vector<WordToken> results;
 	std::string current_word;
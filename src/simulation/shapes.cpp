@@ -1,6 +1,9 @@
 #include "simulation/shapes.h"
+#include "simulation/polyline_simplification.h"
 #include "common/utils.h"
 #include <numbers>
+#include <algorithm>
+#include <cmath>
 
 LineStripShape::LineStripShape() { }
 
@@ -12,23 +15,166 @@ void LineStripShape::setLineColor(sf::Color color) {
 	for (size_t i = 0; i < varray.getVertexCount(); i++) {
 		varray[i].color = color;
 	}
+	for (LodLevel& level : lod_levels) {
+		for (sf::Vertex& vertex : level.vertices) {
+			vertex.color = color;
+		}
+	}
 	line_color = color;
 }
 
+void LineStripShape::setLodEnabled(bool enabled) {
+	lod_enabled = enabled;
+	invalidateLod();
+}
+
+void LineStripShape::invalidateLod() {
+	lod_valid = false;
+	lod_levels.clear();
+}
+
+size_t LineStripShape::getLodLevelCount() const {
+	return lod_levels.size();
+}
+
+size_t LineStripShape::getDrawnVertexCount() const {
+	return drawn_vertex_count;
+}
+
 void LineStripShape::drawMask(sf::RenderTarget& mask, sf::RenderStates states) {
-	states.transform *= getTransform();
 	sf::Color orig_color = line_color;
 	setLineColor(sf::Color::White);
-	mask.draw(varray, states);
+	draw(mask, states);
 	setLineColor(orig_color);
 }
 
 void LineStripShape::draw(sf::RenderTarget& target, sf::RenderStates states) const {
 	states.transform *= getTransform();
-	target.draw(varray, states);
+	if (!lod_enabled || varray.getVertexCount() < LOD_MIN_VERTICES) {
+		target.draw(varray, states);
+		drawn_vertex_count = varray.getVertexCount();
+		return;
+	}
+	drawLod(target, states);
+}
+
+void LineStripShape::drawLod(sf::RenderTarget& target, const sf::RenderStates& states) const {
+	if (!lod_valid) {
+		buildLod();
+	}
+	const sf::View& view = target.getView();
+	sf::Transform inverse = states.transform.getInverse();
+	// size of a pixel in local coordinates decides how simplified the strip can be
+	sf::Vector2f pixel_origin = inverse.transformPoint(target.mapPixelToCoords(sf::Vector2i(0, 0), view));
+	sf::Vector2f pixel_next = inverse.transformPoint(target.mapPixelToCoords(sf::Vector2i(1, 0), view));
+	float tolerance = utils::length(pixel_next - pixel_origin) * LOD_PIXEL_TOLERANCE;
+	const LodLevel* level = &lod_levels.front();
+	for (const LodLevel& lod_level : lod_levels) {
+		if (lod_level.tolerance <= tolerance) {
+			level = &lod_level;
+		}
+	}
+	// chunks outside of view are skipped, consecutive visible ones are drawn in one call
+	sf::FloatRect view_rect = view.getInverseTransform().transformRect(sf::FloatRect(-1.0f, -1.0f, 2.0f, 2.0f));
+	sf::FloatRect local_view_rect = inverse.transformRect(view_rect);
+	const sf::Vertex* vertices = getLodVertices(*level);
+	size_t vertex_count = getLodVertexCount(*level);
+	drawn_vertex_count = 0;
+	auto draw_range = [&](size_t first, size_t last) {
+		target.draw(vertices + first, last - first + 1, sf::LinesStrip, states);
+		drawn_vertex_count += last - first + 1;
+	};
+	bool has_range = false;
+	size_t range_first = 0;
+	size_t range_last = 0;
+	for (size_t chunk_i = 0; chunk_i < level->chunk_bounds.size(); chunk_i++) {
+		size_t first = chunk_i * LOD_CHUNK_SEGMENTS;
+		size_t last = std::min(first + LOD_CHUNK_SEGMENTS, vertex_count - 1);
+		if (!level->chunk_bounds[chunk_i].intersects(local_view_rect)) {
+			continue;
+		}
+		if (has_range && range_last == first) {
+			range_last = last;
+		} else {
+			if (has_range) {
+				draw_range(range_first, range_last);
+			}
+			has_range = true;
+			range_first = first;
+			range_last = last;
+		}
+	}
+	if (has_range) {
+		draw_range(range_first, range_last);
+	}
+}
+
+void LineStripShape::buildLod() const {
+	lod_levels.clear();
+	size_t point_count = varray.getVertexCount();
+	std::vector<sf::Vector2f> points(point_count);
+	float total_length = 0.0f;
+	for (size_t i = 0; i < point_count; i++) {
+		points[i] = varray[i].position;
+		if (i > 0) {
+			total_length += utils::length(points[i] - points[i - 1]);
+		}
+	}
+	auto add_level = [&](float tolerance, std::vector<sf::Vertex> vertices) {
+		LodLevel level;
+		level.tolerance = tolerance;
+		level.vertices = std::move(vertices);
+		const sf::Vertex* level_vertices = getLodVertices(level);
+		size_t level_vertex_count = getLodVertexCount(level);
+		for (size_t first = 0; first + 1 < level_vertex_count; first += LOD_CHUNK_SEGMENTS) {
+			size_t last = std::min(first + LOD_CHUNK_SEGMENTS, level_vertex_count - 1);
+			sf::FloatRect bounds(level_vertices[first].position, sf::Vector2f(0.0f, 0.0f));
+			for (size_t i = first + 1; i <= last; i++) {
+				utils::extend_bounds(bounds, level_vertices[i].position);
+			}
+			level.chunk_bounds.push_back(bounds);
+		}
+		lod_levels.push_back(std::move(level));
+	};
+	add_level(0.0f, { });
+	// tolerance doubles with each level, starting from a fraction of a segment,
+	// levels that don't remove enough vertices are skipped
+	std::vector<float> importance = simplification::douglas_peucker_importance(points);
+	float tolerance = total_length / std::max(point_count - 1, (size_t)1) * 0.25f;
+	size_t prev_count = point_count;
+	while (lod_levels.size() < LOD_MAX_LEVELS && prev_count > 2 && tolerance > 0.0f && std::isfinite(tolerance)) {
+		std::vector<size_t> indices = simplification::simplify(importance, tolerance);
+		if (indices.size() <= prev_count * 3 / 4) {
+			std::vector<sf::Vertex> vertices(indices.size());
+			for (size_t i = 0; i < indices.size(); i++) {
+				vertices[i] = varray[indices[i]];
+			}
+			add_level(tolerance, std::move(vertices));
+			prev_count = indices.size();
+		}
+		tolerance *= 2.0f;
+	}
+	lod_valid = true;
+}
+
+const sf::Vertex* LineStripShape::getLodVertices(const LodLevel& level) const {
+	if (level.vertices.empty()) {
+		return &varray[0];
+	}
+	return level.vertices.data();
+}
+
+size_t LineStripShape::getLodVertexCount(const LodLevel& level) const {
+	if (level.vertices.empty()) {
+		return varray.getVertexCount();
+	}
+	return level.vertices.size();
 }
 
 CircleNotchShape::CircleNotchShape(float radius, size_t point_count, size_t notch_segment_count) {
+	this->radius = radius;
+	this->point_count = point_count;
+	this->notch_segment_count = notch_segment_count;
 	varray_circle = sf::VertexArray(sf::TriangleFan, point_count + 1);
 	varray_notch = sf::VertexArray(sf::TriangleFan, notch_segment_count + 2);
 	float segment_angle = (float)(2 * std::numbers::pi / (float)point_count);
@@ -46,6 +192,26 @@ CircleNotchShape::CircleNotchShape(float radius, size_t point_count, size_t notc
 	}
 }
 
+float CircleNotchShape::getRadius() const {
+	return radius;
+}
+
+size_t CircleNotchShape::getPointCount() const {
+	return point_count;
+}
+
+size_t CircleNotchShape::getNotchSegmentCount() const {
+	return notch_segment_count;
+}
+
+const sf::VertexArray& CircleNotchShape::getCircleVarray() const {
+	return varray_circle;
+}
+
+const sf::VertexArray& CircleNotchShape::getNotchVarray() const {
+	return varray_notch;
+}
+
 const sf::Color& CircleNotchShape::getCircleColor() const {
 	return circle_color;
 }
@@ -1,4 +1,5 @@
 #include "simulation/simulation.h"
+#include "common/log.h"
 
 Simulation::Simulation() {
     reset();
@@ -15,22 +16,22 @@ void Simulation::advance(float time_step) {
 }
 
 void Simulation::load(const std::string& filename) {
-    LoggerTag tag_saveload("saveload");
+    LOG_TAG("saveload");
     try {
         std::string str = utils::file_to_str(filename);
         deserialize(str);
-        logger << "Simulation loaded from " << filename << "\n";
+        LOG("Simulation loaded from " << filename << "\n");
     } catch (std::exception exc) {
         throw std::runtime_error(__FUNCTION__": " + filename + ": " + std::string(exc.what()));
     }
 }
 
 void Simulation::save(const std::string& filename) const {
-    LoggerTag tag_saveload("saveload");
+    LOG_TAG("saveload");
     try {
         std::string str = serialize();
         utils::str_to_file(str, filename);
-        logger << "Simulation saved to " << filename << "\n";
+        LOG("Simulation saved to " << filename << "\n");
     } catch (std::exception exc) {
         throw std::runtime_error(__FUNCTION__": " + filename + ": " + std::string(exc.what()));
     }
@@ -49,12 +50,12 @@ std::string Simulation::serialize() const {
 }
 
 TokenWriter& Simulation::serialize(TokenWriter& tw) const {
-    LoggerTag tag_serialize("serialize");
-    logger << __FUNCTION__"\n";
-    LoggerIndent serialize_indent;
+    LOG_TAG("serialize");
+    LOG(__FUNCTION__"\n");
+    LOG_INDENT();
     size_t index = 0;
     std::function<void(GameObject*)> serialize_obj = [&](GameObject* obj) {
-        logger << "Object: " << obj->getId() << "\n";
+        LOG("Object: " << obj->getId() << "\n");
         if (index > 0) {
             tw << "\n\n";
         }
@@ -63,7 +64,7 @@ TokenWriter& Simulation::serialize(TokenWriter& tw) const {
     };
     std::function<void(GameObject*)> serialize_tree = [&](GameObject* obj) {
         serialize_obj(obj);
-        LoggerIndent children_indent;
+        LOG_INDENT();
         for (size_t i = 0; i < obj->getChildren().size(); i++) {
             serialize_tree(obj->getChild(i));
         }
@@ -73,10 +74,10 @@ TokenWriter& Simulation::serialize(TokenWriter& tw) const {
         tw << "\n\n";
         TokenWriterIndent simulation_indent(tw);
         {
-            logger << "Objects\n";
-            LoggerIndent objects_indent;
+            LOG("Objects\n");
+            LOG_INDENT();
             if (getAllSize() == 0) {
-                logger << "<empty>\n";
+                LOG("<empty>\n");
             }
             for (size_t i = 0; i < getTopSize(); i++) {
                 GameObject* gameobject = getFromTop(i);
@@ -84,10 +85,10 @@ TokenWriter& Simulation::serialize(TokenWriter& tw) const {
             }
         }
         {
-            logger << "Joints\n";
-            LoggerIndent joints_indent;
+            LOG("Joints\n");
+            LOG_INDENT();
             if (getJointsSize() == 0) {
-                logger << "<empty>\n";
+                LOG("<empty>\n");
             } else {
                 tw << "\n\n";
             }
@@ -96,7 +97,7 @@ TokenWriter& Simulation::serialize(TokenWriter& tw) const {
                     tw << "\n\n";
                 }
                 Joint* joint = getJoint(i);
-                logger << "Joint: " << joint->object1->getId() << " " << joint->object2->getId() << "\n";
+                LOG("Joint: " << joint->object1->getId() << " " << joint->object2->getId() << "\n");
                 getJoint(i)->serialize(tw);
             }
         }
@@ -115,24 +116,13 @@ void Simulation::deserialize(const std::string& str) {
 
 void Simulation::deserialize(TokenReader& tr) {
     reset();
+    EventBatchScope batch(OnObjectAdded, OnSetParent, OnObjectMoved);
     try {
         tr.tryEat("simulation");
         while (tr.validRange()) {
             std::string entity = tr.readString();
             if (entity == "object") {
-                dp::DataPointerUnique<GameObject> gameobject;
-                std::string type = tr.readString();
-                if (type == "box") {
-                    gameobject = BoxObject::deserialize(tr, this);
-                } else if (type == "ball") {
-                    gameobject = BallObject::deserialize(tr, this);
-                } else if (type == "polygon") {
-                    gameobject = PolygonObject::deserialize(tr, this);
-                } else if (type == "chain") {
-                    gameobject = ChainObject::deserialize(tr, this);
-                } else {
-                    throw std::runtime_error("Unknown object type: " + type);
-                }
+                dp::DataPointerUnique<GameObject> gameobject = deserializeObject(tr, this);
                 add(std::move(gameobject), false);
             } else if (entity == "joint") {
                 std::string type = tr.readString();
@@ -151,6 +141,24 @@ void Simulation::deserialize(TokenReader& tr) {
     } catch (std::exception exc) {
         throw std::runtime_error(__FUNCTION__": Line " + std::to_string(tr.getLine(-1)) + ": " + exc.what());
     }
+    batch.end();
+}
+
+dp::DataPointerUnique<GameObject> Simulation::deserializeObject(TokenReader& tr, GameObjectList* object_list) {
+    dp::DataPointerUnique<GameObject> gameobject;
+    std::string type = tr.readString();
+    if (type == "box") {
+        gameobject = BoxObject::deserialize(tr, object_list);
+    } else if (type == "ball") {
+        gameobject = BallObject::deserialize(tr, object_list);
+    } else if (type == "polygon") {
+        gameobject = PolygonObject::deserialize(tr, object_list);
+    } else if (type == "chain") {
+        gameobject = ChainObject::deserialize(tr, object_list);
+    } else {
+        throw std::runtime_error("Unknown object type: " + type);
+    }
+    return gameobject;
 }
 
 BoxObject* Simulation::createBox(
@@ -0,0 +1,151 @@
+#include "simulation/vertex_grid.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+void VertexGrid::build(const std::vector<b2Vec2>& positions) {
+	clear();
+	this->positions = positions;
+	// vertices form an outline or a chain, so with cells a couple of edges long
+	// there are only a few vertices in each cell, however large the object is
+	float total_length = 0.0f;
+	for (size_t i = 1; i < positions.size(); i++) {
+		total_length += (positions[i] - positions[i - 1]).Length();
+	}
+	cell_size = 1.0f;
+	if (positions.size() > 1 && std::isfinite(total_length) && total_length > 0.0f) {
+		cell_size = total_length / (positions.size() - 1) * 2.0f;
+	}
+	for (size_t i = 0; i < positions.size(); i++) {
+		addToCell(i);
+	}
+}
+
+void VertexGrid::clear() {
+	positions.clear();
+	cells.clear();
+}
+
+size_t VertexGrid::size() const {
+	return positions.size();
+}
+
+float VertexGrid::getCellSize() const {
+	return cell_size;
+}
+
+const b2Vec2& VertexGrid::getPosition(size_t index) const {
+	return positions[index];
+}
+
+void VertexGrid::move(size_t index, const b2Vec2& pos) {
+	CellKey old_key = getCellKey(positions[index]);
+	CellKey new_key = getCellKey(pos);
+	if (old_key == new_key) {
+		positions[index] = pos;
+		return;
+	}
+	removeFromCell(index);
+	positions[index] = pos;
+	addToCell(index);
+}
+
+void VertexGrid::insert(size_t index, const b2Vec2& pos) {
+	assert(index <= positions.size());
+	shiftIndices(index, 1);
+	positions.insert(positions.begin() + index, pos);
+	addToCell(index);
+}
+
+void VertexGrid::erase(size_t index) {
+	assert(index < positions.size());
+	removeFromCell(index);
+	positions.erase(positions.begin() + index);
+	shiftIndices(index + 1, -1);
+}
+
+std::vector<size_t> VertexGrid::query(const b2AABB& aabb) const {
+	std::vector<size_t> result;
+	auto add_cell = [&](const std::vector<size_t>& cell) {
+		for (size_t index : cell) {
+			const b2Vec2& pos = positions[index];
+			if (
+				pos.x >= aabb.lowerBound.x && pos.x <= aabb.upperBound.x
+				&& pos.y >= aabb.lowerBound.y && pos.y <= aabb.upperBound.y
+			) {
+				result.push_back(index);
+			}
+		}
+	};
+	int32_t min_x = getCellCoord(aabb.lowerBound.x);
+	int32_t min_y = getCellCoord(aabb.lowerBound.y);
+	int32_t max_x = getCellCoord(aabb.upperBound.x);
+	int32_t max_y = getCellCoord(aabb.upperBound.y);
+	if (min_x > max_x || min_y > max_y) {
+		return result;
+	}
+	double range_cells = ((double)max_x - min_x + 1.0) * ((double)max_y - min_y + 1.0);
+	if (range_cells > (double)cells.size()) {
+		// aabb covers more cells than there are allocated, checking all of them is faster
+		for (auto& [key, cell] : cells) {
+			add_cell(cell);
+		}
+	} else {
+		for (int32_t y = min_y; y <= max_y; y++) {
+			for (int32_t x = min_x; x <= max_x; x++) {
+				auto it = cells.find(getCellKey(x, y));
+				if (it != cells.end()) {
+					add_cell(it->second);
+				}
+			}
+		}
+	}
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+int32_t VertexGrid::getCellCoord(float value) const {
+	double coord = std::floor((double)value / cell_size);
+	coord = std::clamp(
+		coord,
+		(double)std::numeric_limits<int32_t>::min(),
+		(double)std::numeric_limits<int32_t>::max()
+	);
+	return (int32_t)coord;
+}
+
+VertexGrid::CellKey VertexGrid::getCellKey(int32_t x, int32_t y) {
+	return ((CellKey)(uint32_t)x << 32) | (CellKey)(uint32_t)y;
+}
+
+VertexGrid::CellKey VertexGrid::getCellKey(const b2Vec2& pos) const {
+	return getCellKey(getCellCoord(pos.x), getCellCoord(pos.y));
+}
+
+void VertexGrid::addToCell(size_t index) {
+	cells[getCellKey(positions[index])].push_back(index);
+}
+
+void VertexGrid::removeFromCell(size_t index) {
+	auto it = cells.find(getCellKey(positions[index]));
+	assert(it != cells.end());
+	std::vector<size_t>& cell = it->second;
+	auto index_it = std::find(cell.begin(), cell.end(), index);
+	assert(index_it != cell.end());
+	*index_it = cell.back();
+	cell.pop_back();
+	if (cell.empty()) {
+		cells.erase(it);
+	}
+}
+
+void VertexGrid::shiftIndices(size_t from_index, ptrdiff_t offset) {
+	for (auto& [key, cell] : cells) {
+		for (size_t& index : cell) {
+			if (index >= from_index) {
+				index += offset;
+			}
+		}
+	}
+}
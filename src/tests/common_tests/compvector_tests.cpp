@@ -7,8 +7,10 @@ CompVectorTests::CompVectorTests(
 ) : TestModule(name, parent, required_nodes) {
 	test::TestModule* compvector_test_list = addModule("CompVector");
 	test::TestModule* compvector_uptr_test_list = addModule("CompVectorUptr");
+	test::TestModule* indexed_compvector_test_list = addModule("IndexedCompVector");
 	createCompVectorList(compvector_test_list);
 	createCompVectorUptrList(compvector_uptr_test_list);
+	createIndexedCompVectorList(indexed_compvector_test_list);
 }
 
 void CompVectorTests::createCompVectorList(test::TestModule* list) {
@@ -177,6 +179,17 @@ void CompVectorTests::createCompVectorList(test::TestModule* list) {
 		vec.removeAt(1);
 		T_CHECK(vec == std::vector<int>({ 1, 3 }));
 	});
+	test::Test* remove_if_test = list->addTest("remove_if", { basic_tests }, [&](test::Test& test) {
+		CompVector<int> vec = { 1, 2, 3, 4, 5 };
+		size_t removed = vec.removeIf([](int value) { return value % 2 == 0; });
+		T_COMPARE(removed, 2);
+		T_CHECK(vec == std::vector<int>({ 1, 3, 5 }));
+		T_CHECK(!vec.contains(2));
+		T_CHECK(!vec.contains(4));
+		T_COMPARE(vec.getSet().size(), 3);
+		vec.add(2);
+		T_CHECK(vec == std::vector<int>({ 1, 3, 5, 2 }));
+	});
 	test::Test* reverse_test = list->addTest("reverse", { basic_tests }, [&](test::Test& test) {
 		CompVector<int> vec = { 1, 2, 3 };
 		vec.reverse();
@@ -435,6 +448,16 @@ void CompVectorTests::createCompVectorUptrList(test::TestModule* list) {
 		T_COMPARE(*vec.front(), 1);
 		T_COMPARE(*vec.back(), 3);
 	});
+	test::Test* remove_if_test = list->addTest("remove_if", { basic_tests }, [&](test::Test& test) {
+		CompVectorUptr<int> vec = { 1, 2, 3, 4, 5 };
+		size_t removed = vec.removeIf([](int* value) { return *value % 2 == 0; });
+		T_COMPARE(removed, 2);
+		T_ASSERT(T_COMPARE(vec.size(), 3));
+		T_COMPARE(*vec[0], 1);
+		T_COMPARE(*vec[1], 3);
+		T_COMPARE(*vec[2], 5);
+		T_COMPARE(vec.getSet().size(), 3);
+	});
 	test::Test* reverse_test = list->addTest("reverse", { basic_tests }, [&](test::Test& test) {
 		CompVectorUptr<int> vec = { 1, 2, 3 };
 		vec.reverse();
@@ -580,3 +603,130 @@ void CompVectorTests::createCompVectorUptrList(test::TestModule* list) {
 		T_COMPARE(*vec[2], 4);
 	});
 }
+
+void CompVectorTests::createIndexedCompVectorList(test::TestModule* list) {
+	test::Test* empty_vector_test = list->addTest("empty_vector", [&](test::Test& test) {
+		IndexedCompVector<int> vec;
+		T_COMPARE(vec.size(), 0);
+		T_CHECK(vec.empty());
+		T_CHECK(!vec.contains(1));
+		T_COMPARE(vec.getIndex(1), -1);
+	});
+	test::Test* multiple_values_test = list->addTest("multiple_values", { empty_vector_test }, [&](test::Test& test) {
+		IndexedCompVector<int> vec = { 1, 2, 3 };
+		T_ASSERT(T_COMPARE(vec.size(), 3));
+		T_COMPARE(vec[0], 1);
+		T_COMPARE(vec[1], 2);
+		T_COMPARE(vec[2], 3);
+		T_COMPARE(vec.front(), 1);
+		T_COMPARE(vec.back(), 3);
+		T_CHECK(vec == std::vector<int>({ 1, 2, 3 }));
+	});
+
+	std::vector<test::TestNode*> basic_tests = list->getChildren();
+
+	test::Test* duplicates_test = list->addTest("duplicates", { basic_tests }, [&](test::Test& test) {
+		IndexedCompVector<int> vec = { 1, 2, 2, 3 };
+		T_CHECK(vec == std::vector<int>({ 1, 2, 3 }));
+		T_CHECK(!vec.add(1));
+	});
+	test::Test* insert_test = list->addTest("insert", { basic_tests }, [&](test::Test& test) {
+		IndexedCompVector<int> vec = { 1, 2, 3 };
+		vec.insert(vec.begin() + 1, 5);
+		T_CHECK(vec == std::vector<int>({ 1, 5, 2, 3 }));
+		T_COMPARE(vec.getIndex(5), 1);
+		T_COMPARE(vec.getIndex(3), 3);
+		std::vector<int> values = { 6, 2, 7 };
+		vec.insert(vec.begin(), values.begin(), values.end());
+		T_CHECK(vec == std::vector<int>({ 6, 7, 1, 5, 2, 3 }));
+		T_COMPARE(vec.getIndex(2), 4);
+	});
+	test::Test* move_test = list->addTest("move", { basic_tests }, [&](test::Test& test) {
+		IndexedCompVector<int> vec = { 1, 2, 3 };
+		vec.moveIndexToIndex(0, 3);
+		T_CHECK(vec == std::vector<int>({ 2, 3, 1 }));
+		vec.moveValueToIndex(1, 0);
+		T_CHECK(vec == std::vector<int>({ 1, 2, 3 }));
+		vec.moveValueToValue(3, 1);
+		T_CHECK(vec == std::vector<int>({ 3, 1, 2 }));
+		for (size_t i = 0; i < vec.size(); i++) {
+			T_COMPARE(vec.getIndex(vec[i]), i);
+		}
+	});
+	test::Test* remove_test = list->addTest("remove", { basic_tests }, [&](test::Test& test) {
+		IndexedCompVector<int> vec = { 1, 2, 3, 4 };
+		T_COMPARE(vec.remove(2), 1);
+		T_CHECK(vec == std::vector<int>({ 1, 3, 4 }));
+		T_COMPARE(vec.getIndex(4), 2);
+		T_COMPARE(vec.remove(5), -1);
+		vec.removeAt(0);
+		T_CHECK(vec == std::vector<int>({ 3, 4 }));
+		T_CHECK(!vec.contains(1));
+		T_COMPARE(vec.getIndex(3), 0);
+	});
+	test::Test* remove_swap_test = list->addTest("remove_swap", { basic_tests }, [&](test::Test& test) {
+		IndexedCompVector<int> vec = { 1, 2, 3, 4 };
+		T_COMPARE(vec.removeSwap(2), 1);
+		T_CHECK(vec == std::vector<int>({ 1, 4, 3 }));
+		T_COMPARE(vec.getIndex(4), 1);
+		T_COMPARE(vec.removeSwap(3), 2);
+		T_CHECK(vec == std::vector<int>({ 1, 4 }));
+		T_COMPARE(vec.removeSwap(3), -1);
+	});
+	test::Test* reverse_test = list->addTest("reverse", { basic_tests }, [&](test::Test& test) {
+		IndexedCompVector<int> vec = { 1, 2, 3 };
+		vec.reverse();
+		T_CHECK(vec == std::vector<int>({ 3, 2, 1 }));
+		T_COMPARE(vec.getIndex(3), 0);
+	});
+	test::Test* clear_test = list->addTest("clear", { basic_tests }, [&](test::Test& test) {
+		IndexedCompVector<int> vec = { 1, 2, 3 };
+		vec.clear();
+		T_ASSERT(T_COMPARE(vec.size(), 0));
+		T_CHECK(!vec.contains(1));
+		vec.add(1);
+		T_COMPARE(vec.getIndex(1), 0);
+	});
+	test::Test* pointers_test = list->addTest("pointers", { basic_tests }, [&](test::Test& test) {
+		std::vector<int> values(100);
+		IndexedCompVector<int*> vec;
+		for (size_t i = 0; i < values.size(); i++) {
+			vec.add(&values[i]);
+		}
+		for (size_t i = 0; i < values.size(); i++) {
+			T_ASSERT(T_COMPARE(vec.getIndex(&values[i]), i));
+		}
+	});
+	test::Test* compare_test = list->addTest("compare_to_compvector", { remove_test, remove_swap_test, insert_test }, [&](test::Test& test) {
+		// same sequence of operations should give the same result as CompVector
+		CompVector<int> cvec;
+		IndexedCompVector<int> ivec;
+		unsigned int seed = 1;
+		auto random = [&]() {
+			seed = seed * 1103515245 + 12345;
+			return (seed >> 16) % 200;
+		};
+		for (size_t i = 0; i < 5000; i++) {
+			int value = random();
+			switch (random() % 4) {
+				case 0:
+				case 1:
+					T_ASSERT(T_COMPARE(ivec.add(value), cvec.add(value)));
+					break;
+				case 2:
+					T_ASSERT(T_COMPARE(ivec.remove(value), cvec.remove(value)));
+					break;
+				case 3:
+					if (cvec.size() > 0) {
+						size_t index = random() % cvec.size();
+						ivec.insert(ivec.begin() + index, value);
+						cvec.insert(cvec.begin() + index, value);
+					}
+					break;
+			}
+			T_ASSERT(T_CHECK(ivec == cvec));
+			T_ASSERT(T_COMPARE(ivec.contains(value), cvec.contains(value)));
+			T_ASSERT(T_COMPARE(ivec.getIndex(value), cvec.getIndex(value)));
+		}
+	});
+}
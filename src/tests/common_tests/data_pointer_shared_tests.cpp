@@ -810,23 +810,23 @@ void DataPointerSharedTests::blockNameTest(test::Test& test) {
 		dp::DataPointerShared<MyStruct> dp2 = dp::make_shared_data_pointer<MyStruct>("m2", 22);
 		MyStruct* m2 = dp2.get();
 		{
-			auto it1 = dp::data_blocks.find(m1);
-			auto it2 = dp::data_blocks.find(m2);
-			T_COMPARE(it1->second.name, "m1");
-			T_COMPARE(it2->second.name, "m2");
+			std::optional<dp::DataBlock> block1 = dp::data_blocks.find(m1);
+			std::optional<dp::DataBlock> block2 = dp::data_blocks.find(m2);
+			T_COMPARE(*block1->name, "m1");
+			T_COMPARE(*block2->name, "m2");
 		}
 
 		dp1.setName("dp1");
 		{
-			auto it = dp::data_blocks.find(m1);
-			T_COMPARE(it->second.name, "dp1");
+			std::optional<dp::DataBlock> block = dp::data_blocks.find(m1);
+			T_COMPARE(*block->name, "dp1");
 		}
 
 		MyStruct* m3 = new MyStruct(33);
 		dp1.reset("m3", m3);
 		{
-			auto it = dp::data_blocks.find(m3);
-			T_COMPARE(it->second.name, "m3");
+			std::optional<dp::DataBlock> block = dp::data_blocks.find(m3);
+			T_COMPARE(*block->name, "m3");
 		}
 	}
 
@@ -837,8 +837,8 @@ void DataPointerSharedTests::blockNameTest(test::Test& test) {
 		dp::DataPointerShared<MyStruct> dp5("m5", m5);
 		dp4 = std::move(dp5);
 		{
-			auto it = dp::data_blocks.find(m5);
-			T_COMPARE(it->second.name, "m5");
+			std::optional<dp::DataBlock> block = dp::data_blocks.find(m5);
+			T_COMPARE(*block->name, "m5");
 		}
 	}
 
@@ -847,8 +847,8 @@ void DataPointerSharedTests::blockNameTest(test::Test& test) {
 		dp::DataPointerShared<MyStruct> dp6("m6", m6);
 		dp::DataPointerShared<MyStruct> dp7(std::move(dp6));
 		{
-			auto it = dp::data_blocks.find(m6);
-			T_COMPARE(it->second.name, "m6");
+			std::optional<dp::DataBlock> block = dp::data_blocks.find(m6);
+			T_COMPARE(*block->name, "m6");
 		}
 	}
 
@@ -859,8 +859,8 @@ void DataPointerSharedTests::blockNameTest(test::Test& test) {
 		dp::DataPointerShared<MyStruct> dp5("m5", m5);
 		dp4 = dp5;
 		{
-			auto it = dp::data_blocks.find(m5);
-			T_COMPARE(it->second.name, "m5");
+			std::optional<dp::DataBlock> block = dp::data_blocks.find(m5);
+			T_COMPARE(*block->name, "m5");
 		}
 	}
 
@@ -869,8 +869,8 @@ void DataPointerSharedTests::blockNameTest(test::Test& test) {
 		dp::DataPointerShared<MyStruct> dp6("m6", m6);
 		dp::DataPointerShared<MyStruct> dp7(dp6);
 		{
-			auto it = dp::data_blocks.find(m6);
-			T_COMPARE(it->second.name, "m6");
+			std::optional<dp::DataBlock> block = dp::data_blocks.find(m6);
+			T_COMPARE(*block->name, "m6");
 		}
 	}
 
@@ -881,10 +881,10 @@ void DataPointerSharedTests::blockNameTest(test::Test& test) {
 		dp::DataPointerShared<MyStruct> dp9("m9", m9);
 		dp8.swap(dp9);
 		{
-			auto it1 = dp::data_blocks.find(m8);
-			auto it2 = dp::data_blocks.find(m9);
-			T_COMPARE(it1->second.name, "m8");
-			T_COMPARE(it2->second.name, "m9");
+			std::optional<dp::DataBlock> block1 = dp::data_blocks.find(m8);
+			std::optional<dp::DataBlock> block2 = dp::data_blocks.find(m9);
+			T_COMPARE(*block1->name, "m8");
+			T_COMPARE(*block2->name, "m9");
 		}
 	}
 }
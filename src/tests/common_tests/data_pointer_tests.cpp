@@ -2,23 +2,39 @@
 #include "tests/data_pointer_unique_tests.h"
 #include "tests/data_pointer_shared_tests.h"
 #include "common/data_pointer_common.h"
+#include "common/data_pointer_unique.h"
+#include "common/data_pointer_shared.h"
 #include "common/utils.h"
+#include <thread>
+
+struct MemoryBlock {
+	char data[100] = { };
+};
 
 DataPointerTests::DataPointerTests(
 	const std::string& name,
 	test::TestModule* parent,
 	const std::vector<TestNode*>& required_nodes
 ) : TestModule(name, parent, required_nodes) {
+#if DATA_POINTER_TRACKING
+	// these check the registry after almost every step
 	DataPointerUniqueTests* unique_tests = addModule<DataPointerUniqueTests>("DataPointerUnique");
 	DataPointerSharedTests* shared_tests = addModule<DataPointerSharedTests>("DataPointerShared");
+	test::Test* tracking_disabled_test = addTest("tracking_disabled", { unique_tests, shared_tests }, [&](test::Test& test) { trackingDisabledTest(test); });
+	test::Test* threads_test = addTest("threads", { unique_tests, shared_tests }, [&](test::Test& test) { threadsTest(test); });
+	test::Test* memory_stats_test = addTest("memory_stats", { unique_tests, shared_tests }, [&](test::Test& test) { memoryStatsTest(test); });
+	test::Test* interned_names_test = addTest("interned_names", { threads_test }, [&](test::Test& test) { internedNamesTest(test); });
+#else
+	test::Test* tracking_compiled_out_test = addTest("tracking_compiled_out", [&](test::Test& test) { trackingCompiledOutTest(test); });
+#endif
 }
 
 void DataPointerTests::checkDataBlock(test::Test& test, void* p_block, size_t p_size) {
 	if (T_CHECK(dp::data_blocks.size() > 0)) {
-		auto it = dp::data_blocks.find(p_block);
-		if (T_CHECK(it != dp::data_blocks.end())) {
-			void* ptr = it->second.ptr;
-			size_t size = it->second.size;
+		std::optional<dp::DataBlock> block = dp::data_blocks.find(p_block);
+		if (T_CHECK(block.has_value())) {
+			void* ptr = block->ptr;
+			size_t size = block->size;
 			T_COMPARE(ptr, p_block, &utils::pointer_to_str);
 			T_COMPARE(size, p_size);
 		}
@@ -26,6 +42,167 @@ void DataPointerTests::checkDataBlock(test::Test& test, void* p_block, size_t p_
 }
 
 void DataPointerTests::checkNoDataBlock(test::Test& test, void* p_block) {
-	auto it = dp::data_blocks.find(p_block);
-	T_CHECK(it == dp::data_blocks.end());
+	std::optional<dp::DataBlock> block = dp::data_blocks.find(p_block);
+	T_CHECK(!block.has_value());
+}
+
+void DataPointerTests::trackingDisabledTest(test::Test& test) {
+	dp::set_tracking_enabled(false);
+	dp::DataPointerUnique<int> untracked_unique = dp::make_data_pointer<int>("untracked_unique", 1);
+	dp::DataPointerShared<int> untracked_shared = dp::make_shared_data_pointer<int>("untracked_shared", 2);
+	dp::DataPointerShared<int> untracked_copy = untracked_shared;
+	T_COMPARE(dp::data_blocks.size(), 0);
+	T_COMPARE(untracked_unique.getName(), dp::UNNAMED_BLOCK_NAME);
+	untracked_unique.setName("renamed");
+	T_COMPARE(dp::data_blocks.size(), 0);
+	dp::set_tracking_enabled(true);
+	dp::DataPointerUnique<int> tracked = dp::make_data_pointer<int>("tracked", 3);
+	T_COMPARE(dp::data_blocks.size(), 1);
+	T_WRAP_CONTAINER(checkDataBlock(test, tracked.get(), sizeof(int)));
+	// pointers that were not added are not removed after tracking is enabled again
+	untracked_unique.reset();
+	untracked_shared.reset();
+	untracked_copy.reset();
+	T_COMPARE(dp::data_blocks.size(), 1);
+	dp::set_tracking_enabled(false);
+	// and the ones that were added are removed after tracking is disabled
+	tracked.reset();
+	T_COMPARE(dp::data_blocks.size(), 0);
+	dp::set_tracking_enabled(true);
+}
+
+void DataPointerTests::threadsTest(test::Test& test) {
+	const size_t THREAD_COUNT = 4;
+	const size_t POINTER_COUNT = 1000;
+	std::vector<std::vector<dp::DataPointerUnique<int>>> pointers(THREAD_COUNT);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < THREAD_COUNT; i++) {
+		threads.push_back(std::thread([&, i]() {
+			for (size_t j = 0; j < POINTER_COUNT; j++) {
+				pointers[i].push_back(dp::make_data_pointer<int>("thread" + std::to_string(i), (int)j));
+			}
+			// half of them are removed while other threads are still adding
+			for (size_t j = 0; j < POINTER_COUNT / 2; j++) {
+				pointers[i][j].reset();
+			}
+		}));
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	T_COMPARE(dp::data_blocks.size(), THREAD_COUNT * POINTER_COUNT / 2);
+	for (size_t i = 0; i < THREAD_COUNT; i++) {
+		std::optional<dp::DataBlock> block = dp::data_blocks.find(pointers[i].back().get());
+		if (T_CHECK(block.has_value())) {
+			T_COMPARE(*block->name, "thread" + std::to_string(i));
+		}
+	}
+	pointers.clear();
+	T_COMPARE(dp::data_blocks.size(), 0);
+}
+
+void DataPointerTests::internedNamesTest(test::Test& test) {
+	// last interned name of the thread is kept
+	size_t name_count = dp::get_interned_name_count();
+	{
+		std::vector<dp::DataPointerUnique<int>> pointers;
+		for (size_t i = 0; i < 100; i++) {
+			pointers.push_back(dp::make_data_pointer<int>("Entry " + std::to_string(i), (int)i));
+		}
+		T_CHECK(dp::get_interned_name_count() >= name_count + 99);
+		pointers[0].setName("Entry renamed");
+		dp::DataPointerShared<int> shared1 = dp::make_shared_data_pointer<int>("Shared", 1);
+		dp::DataPointerShared<int> shared2 = dp::make_shared_data_pointer<int>("Shared", 2);
+		dp::DataPointerShared<int> shared2_copy = shared2;
+		shared1.reset();
+		shared2.reset();
+		// name is still used by the other block
+		std::optional<dp::DataBlock> block = dp::data_blocks.find(shared2_copy.get());
+		if (T_CHECK(block.has_value())) {
+			T_COMPARE(*block->name, "Shared");
+		}
+		T_COMPARE(pointers[0].getName(), "Entry renamed");
+	}
+	T_CHECK(dp::get_interned_name_count() <= name_count + 1);
+	// names are interned and released by different threads
+	const size_t THREAD_COUNT = 4;
+	const size_t POINTER_COUNT = 1000;
+	std::vector<std::vector<dp::DataPointerUnique<int>>> pointers(THREAD_COUNT);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < THREAD_COUNT; i++) {
+		threads.push_back(std::thread([&, i]() {
+			for (size_t j = 0; j < POINTER_COUNT; j++) {
+				pointers[i].push_back(dp::make_data_pointer<int>("Entry " + std::to_string(j % 100), (int)j));
+			}
+		}));
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	T_COMPARE(dp::data_blocks.size(), THREAD_COUNT * POINTER_COUNT);
+	threads.clear();
+	for (size_t i = 0; i < THREAD_COUNT; i++) {
+		threads.push_back(std::thread([&, i]() {
+			pointers[(i + 1) % THREAD_COUNT].clear();
+		}));
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	T_COMPARE(dp::data_blocks.size(), 0);
+	T_CHECK(dp::get_interned_name_count() <= name_count + 1);
+}
+
+void DataPointerTests::memoryStatsTest(test::Test& test) {
+	T_CHECK(dp::get_memory_category("Widget button") == dp::MemoryCategory::WIDGETS);
+	T_CHECK(dp::get_memory_category("BoxObject box0") == dp::MemoryCategory::GAME_OBJECTS);
+	T_CHECK(dp::get_memory_category("BoxObject box0 rect_shape") == dp::MemoryCategory::SHAPES);
+	T_CHECK(dp::get_memory_category("Simulation World") == dp::MemoryCategory::WORLD);
+	T_CHECK(dp::get_memory_category("m1") == dp::MemoryCategory::OTHER);
+	dp::memory_stats.resetPeaks();
+	dp::MemorySnapshot before = dp::get_memory_snapshot();
+	auto widgets_diff = [&]() {
+		return dp::get_memory_snapshot().get(dp::MemoryCategory::WIDGETS).bytes - before.get(dp::MemoryCategory::WIDGETS).bytes;
+	};
+	{
+		dp::DataPointerUnique<MemoryBlock> ptr1 = dp::make_data_pointer<MemoryBlock>("Widget 1");
+		dp::DataPointerUnique<MemoryBlock> ptr2 = dp::make_data_pointer<MemoryBlock>("Widget 2");
+		T_COMPARE(widgets_diff(), sizeof(MemoryBlock) * 2);
+		T_COMPARE(dp::get_memory_snapshot().get(dp::MemoryCategory::WIDGETS).count, before.get(dp::MemoryCategory::WIDGETS).count + 2);
+		ptr2.reset();
+		T_COMPARE(widgets_diff(), sizeof(MemoryBlock));
+		// renamed block moves to another category
+		ptr1.setName("BoxObject 1");
+		T_COMPARE(widgets_diff(), 0);
+		T_COMPARE(
+			dp::get_memory_snapshot().get(dp::MemoryCategory::GAME_OBJECTS).bytes,
+			before.get(dp::MemoryCategory::GAME_OBJECTS).bytes + sizeof(MemoryBlock)
+		);
+	}
+	dp::MemorySnapshot after = dp::get_memory_snapshot();
+	T_COMPARE(after.bytes, before.bytes);
+	T_COMPARE(after.get(dp::MemoryCategory::WIDGETS).peak_bytes, before.get(dp::MemoryCategory::WIDGETS).bytes + sizeof(MemoryBlock) * 2);
+	T_COMPARE(after.peak_bytes, before.bytes + sizeof(MemoryBlock) * 2);
+	{
+		dp::ExternalMemoryBlock texture(dp::MemoryCategory::TEXTURES);
+		texture.setSize(1000);
+		dp::ExternalMemoryBlock texture_copy = texture;
+		T_COMPARE(dp::get_memory_snapshot().get(dp::MemoryCategory::TEXTURES).bytes, before.get(dp::MemoryCategory::TEXTURES).bytes + 2000);
+		texture.setSize(500);
+		T_COMPARE(dp::get_memory_snapshot().get(dp::MemoryCategory::TEXTURES).bytes, before.get(dp::MemoryCategory::TEXTURES).bytes + 1500);
+	}
+	T_COMPARE(dp::get_memory_snapshot().get(dp::MemoryCategory::TEXTURES).bytes, before.get(dp::MemoryCategory::TEXTURES).bytes);
+	std::string json = dp::get_memory_snapshot().toJson();
+	T_CHECK(json.find("\"widgets\": { \"count\": ") != std::string::npos);
+	T_CHECK(json.find("\"peak_bytes\": ") != std::string::npos);
+}
+
+void DataPointerTests::trackingCompiledOutTest(test::Test& test) {
+	dp::set_tracking_enabled(true);
+	T_CHECK(!dp::is_tracking_enabled());
+	dp::DataPointerUnique<int> unique = dp::make_data_pointer<int>("unique", 1);
+	dp::DataPointerShared<int> shared = dp::make_shared_data_pointer<int>("shared", 2);
+	T_COMPARE(dp::data_blocks.size(), 0);
+	T_COMPARE(*unique, 1);
+	T_COMPARE(*shared, 2);
 }
@@ -18,6 +18,13 @@ EventTests::EventTests(
 	test::Test* copy_multi_test = event_list->addTest("copy_multi", { copy_simple_test }, [&](test::Test& test) { copyMultiTest(test); });
 	test::Test* copy_chain_test = event_list->addTest("copy_chain", { copy_simple_test }, [&](test::Test& test) { copyChainTest(test); });
 	test::Test* clear_test = event_list->addTest("clear", { handler_test }, [&](test::Test& test) { clearTest(test); });
+	test::Test* large_capture_test = event_list->addTest("large_capture", { copy_simple_test }, [&](test::Test& test) { largeCaptureTest(test); });
+	test::Test* add_during_dispatch_test = event_list->addTest("add_during_dispatch", { multi_test }, [&](test::Test& test) { addDuringDispatchTest(test); });
+	test::Test* remove_during_dispatch_test = event_list->addTest("remove_during_dispatch", { unsubscribe_func_test }, [&](test::Test& test) { removeDuringDispatchTest(test); });
+	test::Test* batch_test = event_list->addTest("batch", { multi_test }, [&](test::Test& test) { batchTest(test); });
+	test::Test* batch_args_test = event_list->addTest("batch_args", { batch_test }, [&](test::Test& test) { batchArgsTest(test); });
+	test::Test* batch_scope_test = event_list->addTest("batch_scope", { batch_test }, [&](test::Test& test) { batchScopeTest(test); });
+	test::Test* batch_scope_exception_test = event_list->addTest("batch_scope_exception", { batch_scope_test }, [&](test::Test& test) { batchScopeExceptionTest(test); });
 }
 
 void EventTests::basicTest(test::Test& test) {
@@ -227,3 +234,197 @@ void EventTests::clearTest(test::Test& test) {
 	event();
 	T_COMPARE(invoke_count, 3);
 }
+
+void EventTests::largeCaptureTest(test::Test& test) {
+	std::string result;
+	std::string str1 = "abc";
+	std::string str2 = "def";
+	std::string str3 = "ghi";
+	Event<> event;
+	auto small_func = [&]() {
+		result += "0";
+	};
+	auto large_func = [&, str1, str2, str3]() {
+		result += str1 + str2 + str3;
+	};
+	T_CHECK(EventDelegate<>(small_func).isInline());
+	T_CHECK(!EventDelegate<>(large_func).isInline());
+	event += small_func;
+	event += large_func;
+	Event<> copy = event;
+	event.clear();
+	copy();
+	T_COMPARE(result, "0abcdefghi");
+	T_COMPARE(event.size(), 0);
+	T_COMPARE(copy.size(), 2);
+}
+
+void EventTests::addDuringDispatchTest(test::Test& test) {
+	size_t invoke_count_1 = 0;
+	size_t invoke_count_2 = 0;
+	Event<> event;
+	event += [&]() {
+		invoke_count_1++;
+		if (invoke_count_1 == 1) {
+			for (size_t i = 0; i < 100; i++) {
+				event += [&]() {
+					invoke_count_2++;
+				};
+			}
+		}
+	};
+	event();
+	T_COMPARE(invoke_count_1, 1);
+	T_COMPARE(invoke_count_2, 0);
+	T_COMPARE(event.size(), 101);
+	event();
+	T_COMPARE(invoke_count_1, 2);
+	T_COMPARE(invoke_count_2, 100);
+}
+
+void EventTests::removeDuringDispatchTest(test::Test& test) {
+	size_t invoke_count_1 = 0;
+	size_t invoke_count_2 = 0;
+	Event<> event;
+	EventHandlerFunc<> func2([&]() {
+		invoke_count_2++;
+	});
+	EventHandlerFunc<> func1([&]() {
+		invoke_count_1++;
+		event -= func2;
+	});
+	event += func1;
+	event += func2;
+	event();
+	T_COMPARE(invoke_count_1, 1);
+	T_COMPARE(invoke_count_2, 0);
+	T_COMPARE(event.size(), 1);
+	event();
+	T_COMPARE(invoke_count_1, 2);
+	T_COMPARE(invoke_count_2, 0);
+}
+
+void EventTests::batchTest(test::Test& test) {
+	std::vector<int> items;
+	std::vector<std::vector<int>> batches;
+	Event<int> event;
+	event += [&](int value) {
+		items.push_back(value);
+	};
+	event.addBatchHandler([&](std::span<const int> batch) {
+		batches.push_back(std::vector<int>(batch.begin(), batch.end()));
+	});
+	T_COMPARE(event.size(), 2);
+	event(1);
+	T_CHECK(items == std::vector<int>({ 1 }));
+	T_ASSERT(T_COMPARE(batches.size(), 1));
+	T_CHECK(batches[0] == std::vector<int>({ 1 }));
+	event.beginBatch();
+	T_CHECK(event.isBatching());
+	event(2);
+	event(3);
+	event.beginBatch();
+	event(4);
+	event.endBatch();
+	// regular handlers are not affected by batching
+	T_CHECK(items == std::vector<int>({ 1, 2, 3, 4 }));
+	T_COMPARE(batches.size(), 1);
+	event.endBatch();
+	T_CHECK(!event.isBatching());
+	T_ASSERT(T_COMPARE(batches.size(), 2));
+	T_CHECK(batches[1] == std::vector<int>({ 2, 3, 4 }));
+	// empty batches are not delivered
+	event.beginBatch();
+	event.endBatch();
+	T_COMPARE(batches.size(), 2);
+	event.clear();
+	T_COMPARE(event.size(), 0);
+}
+
+void EventTests::batchArgsTest(test::Test& test) {
+	std::string result;
+	Event<int, const std::string&> event;
+	event.addBatchHandler([&](std::span<const std::tuple<int, std::reference_wrapper<const std::string>>> batch) {
+		result += "[";
+		for (const auto& [number, str] : batch) {
+			result += std::to_string(number) + str.get();
+		}
+		result += "]";
+	});
+	std::string str1 = "a";
+	std::string str2 = "b";
+	event(1, str1);
+	event.beginBatch();
+	event(2, str1);
+	event(3, str2);
+	event.endBatch();
+	T_COMPARE(result, "[1a][2a3b]");
+	Event<int, const std::string&> copy = event;
+	copy(4, str2);
+	T_COMPARE(result, "[1a][2a3b][4b]");
+}
+
+void EventTests::batchScopeTest(test::Test& test) {
+	std::string result;
+	Event<int> event1;
+	Event<int> event2;
+	event1.addBatchHandler([&](std::span<const int> batch) {
+		result += "1:" + std::to_string(batch.size()) + " ";
+	});
+	event2.addBatchHandler([&](std::span<const int> batch) {
+		result += "2:" + std::to_string(batch.size()) + " ";
+	});
+	{
+		EventBatchScope batch(event1, event2);
+		event2(1);
+		event1(1);
+		event2(2);
+		T_CHECK(event1.isBatching());
+		T_CHECK(event2.isBatching());
+		T_COMPARE(result, "");
+		batch.end();
+		T_COMPARE(result, "1:1 2:2 ");
+	}
+	T_COMPARE(result, "1:1 2:2 ");
+}
+
+void EventTests::batchScopeExceptionTest(test::Test& test) {
+	std::string result;
+	Event<int> event1;
+	Event<int> event2;
+	event1.addBatchHandler([&](std::span<const int> batch) {
+		result += "1:" + std::to_string(batch.size()) + " ";
+		throw std::runtime_error("handler");
+	});
+	event2.addBatchHandler([&](std::span<const int> batch) {
+		result += "2:" + std::to_string(batch.size()) + " ";
+	});
+	// exception thrown by a handler reaches the caller of end
+	bool caught = false;
+	try {
+		EventBatchScope batch(event1, event2);
+		event1(1);
+		event2(1);
+		batch.end();
+	} catch (std::runtime_error&) {
+		caught = true;
+	}
+	T_CHECK(caught);
+	T_COMPARE(result, "1:1 ");
+	T_CHECK(!event1.isBatching());
+	T_CHECK(!event2.isBatching());
+	// batches are dropped when the scope is left by an exception
+	result = "";
+	try {
+		EventBatchScope batch(event1, event2);
+		event1(1);
+		event2(1);
+		throw std::runtime_error("scope");
+	} catch (std::runtime_error&) { }
+	T_COMPARE(result, "");
+	T_CHECK(!event1.isBatching());
+	T_CHECK(!event2.isBatching());
+	// events work normally afterwards
+	event2(1);
+	T_COMPARE(result, "2:1 ");
+}
@@ -0,0 +1,197 @@
+#include "tests/geometry_tests.h"
+#include "common/utils.h"
+
+GeometryTests::GeometryTests(
+	const std::string& name, test::TestModule* parent, const std::vector<TestNode*>& required_nodes
+) : TestModule(name, parent, required_nodes) {
+	test::TestModule* batch_list = addModule("Batch");
+	test::Test* lines_test = batch_list->addTest("lines", [&](test::Test& test) { linesTest(test); });
+	test::Test* intersect_test = batch_list->addTest("intersect", { lines_test }, [&](test::Test& test) { intersectTest(test); });
+	test::Test* transform_test = batch_list->addTest("transform", [&](test::Test& test) { transformTest(test); });
+	test::Test* contains_test = batch_list->addTest("contains", [&](test::Test& test) { containsTest(test); });
+	std::vector<test::TestNode*> kernel_tests = { intersect_test, transform_test, contains_test };
+	test::Test* instruction_sets_test = batch_list->addTest("instruction_sets", kernel_tests, [&](test::Test& test) { instructionSetsTest(test); });
+}
+
+void GeometryTests::linesTest(test::Test& test) {
+	// sizes that are not a multiple of vector width, so scalar tail is checked too
+	for (size_t count : { 0, 1, 7, 19 }) {
+		utils::batch::Points points = createPoints(count);
+		b2Vec2 p1(-1.0f, 0.5f);
+		b2Vec2 p2(2.0f, 1.5f);
+		std::vector<float> line_D(count);
+		std::vector<uint8_t> left(count);
+		std::vector<uint8_t> right(count);
+		std::vector<float> distance(count);
+		std::vector<float> project_x(count);
+		std::vector<float> project_y(count);
+		utils::batch::get_line_D(points.x, points.y, p1.x, p1.y, p2.x, p2.y, line_D);
+		utils::batch::left_side(points.x, points.y, p1.x, p1.y, p2.x, p2.y, left);
+		utils::batch::right_side(points.x, points.y, p1.x, p1.y, p2.x, p2.y, right);
+		utils::batch::distance_to_line(points.x, points.y, p1.x, p1.y, p2.x, p2.y, distance);
+		utils::batch::line_project(points.x, points.y, p1.x, p1.y, p2.x, p2.y, project_x, project_y);
+		for (size_t i = 0; i < count; i++) {
+			b2Vec2 point = points.getb2(i);
+			T_COMPARE(line_D[i], utils::get_line_D(point, p1, p2));
+			T_COMPARE((bool)left[i], utils::left_side(point, p1, p2));
+			T_COMPARE((bool)right[i], utils::right_side(point, p1, p2));
+			T_APPROX_COMPARE(distance[i], utils::distance_to_line(point, p1, p2));
+			b2Vec2 projected = utils::line_project(point, p1, p2);
+			T_APPROX_COMPARE(project_x[i], projected.x);
+			T_APPROX_COMPARE(project_y[i], projected.y);
+		}
+	}
+}
+
+void GeometryTests::intersectTest(test::Test& test) {
+	// zigzag edges along x axis, segment crosses them at x = 4.5
+	utils::batch::Points points;
+	for (size_t i = 0; i < 12; i++) {
+		points.push_back((float)i, i % 2 == 0 ? -1.0f : 1.0f);
+	}
+	size_t edge_count = points.size() - 1;
+	std::span<const float> x1(points.x.data(), edge_count);
+	std::span<const float> y1(points.y.data(), edge_count);
+	std::span<const float> x2(points.x.data() + 1, edge_count);
+	std::span<const float> y2(points.y.data() + 1, edge_count);
+	{
+		sf::Vector2f intersection;
+		ptrdiff_t index = utils::batch::line_intersect_first(4.5f, -5.0f, 4.5f, 5.0f, x1, y1, x2, y2, 0.000001f, intersection);
+		T_COMPARE(index, 4);
+		sf::Vector2f expected;
+		T_ASSERT(T_CHECK(utils::line_intersect(
+			sf::Vector2f(4.5f, -5.0f), sf::Vector2f(4.5f, 5.0f), points.getsf(4), points.getsf(5), 0.000001f, expected
+		)));
+		T_APPROX_COMPARE(intersection.x, expected.x);
+		T_APPROX_COMPARE(intersection.y, expected.y);
+	}
+	{
+		sf::Vector2f intersection;
+		ptrdiff_t index = utils::batch::line_intersect_first(9.5f, -5.0f, 9.5f, 5.0f, x1, y1, x2, y2, 0.000001f, intersection);
+		T_COMPARE(index, 9);
+	}
+	{
+		sf::Vector2f intersection;
+		ptrdiff_t index = utils::batch::line_intersect_first(-1.0f, -5.0f, -1.0f, 5.0f, x1, y1, x2, y2, 0.000001f, intersection);
+		T_COMPARE(index, -1);
+	}
+}
+
+void GeometryTests::transformTest(test::Test& test) {
+	size_t count = 13;
+	utils::batch::Points points = createPoints(count);
+	b2Transform transform(b2Vec2(3.0f, -2.0f), b2Rot(utils::to_radians(30.0f)));
+	utils::batch::Points transformed(count);
+	utils::batch::transform_points(points.x, points.y, transform, transformed.x, transformed.y);
+	b2Vec2 pivot(1.0f, 1.0f);
+	float angle = utils::to_radians(60.0f);
+	utils::batch::Points rotated(count);
+	utils::batch::rotate_points(points.x, points.y, pivot.x, pivot.y, angle, rotated.x, rotated.y);
+	for (size_t i = 0; i < count; i++) {
+		b2Vec2 expected_transformed = b2Mul(transform, points.getb2(i));
+		T_COMPARE(transformed.x[i], expected_transformed.x);
+		T_COMPARE(transformed.y[i], expected_transformed.y);
+		b2Vec2 expected_rotated = utils::rotate_point(points.getb2(i), pivot, angle);
+		T_APPROX_COMPARE(rotated.x[i], expected_rotated.x);
+		T_APPROX_COMPARE(rotated.y[i], expected_rotated.y);
+	}
+}
+
+void GeometryTests::containsTest(test::Test& test) {
+	size_t count = 21;
+	utils::batch::Points points = createPoints(count);
+	sf::FloatRect rect(-1.0f, -1.0f, 2.0f, 3.0f);
+	std::vector<uint8_t> inside(count);
+	utils::batch::contains_point(points.x, points.y, rect, inside);
+	for (size_t i = 0; i < count; i++) {
+		T_COMPARE((bool)inside[i], utils::contains_point(rect, points.getsf(i)));
+	}
+}
+
+void GeometryTests::instructionSetsTest(test::Test& test) {
+	// every compiled path gives exactly the same results as the scalar loop
+	struct Results {
+		std::vector<float> line_D;
+		std::vector<uint8_t> left;
+		std::vector<uint8_t> right;
+		std::vector<float> distance;
+		utils::batch::Points projected;
+		utils::batch::Points rotated;
+		utils::batch::Points transformed;
+		std::vector<uint8_t> inside;
+		std::vector<ptrdiff_t> intersect_index;
+		std::vector<float> intersect_x;
+		std::vector<float> intersect_y;
+	};
+	b2Vec2 p1(-1.0f, 0.5f);
+	b2Vec2 p2(2.0f, 1.5f);
+	b2Transform transform(b2Vec2(3.0f, -2.0f), b2Rot(utils::to_radians(30.0f)));
+	sf::FloatRect rect(-1.0f, -1.0f, 2.0f, 3.0f);
+	auto calc_results = [&](size_t count) {
+		utils::batch::Points points = createPoints(count);
+		Results results;
+		results.line_D.resize(count);
+		results.left.resize(count);
+		results.right.resize(count);
+		results.distance.resize(count);
+		results.projected.resize(count);
+		results.rotated.resize(count);
+		results.transformed.resize(count);
+		results.inside.resize(count);
+		utils::batch::get_line_D(points.x, points.y, p1.x, p1.y, p2.x, p2.y, results.line_D);
+		utils::batch::left_side(points.x, points.y, p1.x, p1.y, p2.x, p2.y, results.left);
+		utils::batch::right_side(points.x, points.y, p1.x, p1.y, p2.x, p2.y, results.right);
+		utils::batch::distance_to_line(points.x, points.y, p1.x, p1.y, p2.x, p2.y, results.distance);
+		utils::batch::line_project(points.x, points.y, p1.x, p1.y, p2.x, p2.y, results.projected.x, results.projected.y);
+		utils::batch::rotate_points(points.x, points.y, 1.0f, 1.0f, 0.5f, results.rotated.x, results.rotated.y);
+		utils::batch::transform_points(points.x, points.y, transform, results.transformed.x, results.transformed.y);
+		utils::batch::contains_point(points.x, points.y, rect, results.inside);
+		if (count > 1) {
+			size_t edge_count = count - 1;
+			std::span<const float> x1(points.x.data(), edge_count);
+			std::span<const float> y1(points.y.data(), edge_count);
+			std::span<const float> x2(points.x.data() + 1, edge_count);
+			std::span<const float> y2(points.y.data() + 1, edge_count);
+			for (float x : { -3.0f, -0.5f, 0.2f, 1.7f, 3.0f }) {
+				sf::Vector2f intersection;
+				ptrdiff_t index = utils::batch::line_intersect_first(x, -5.0f, x + 0.3f, 5.0f, x1, y1, x2, y2, 0.000001f, intersection);
+				results.intersect_index.push_back(index);
+				results.intersect_x.push_back(intersection.x);
+				results.intersect_y.push_back(intersection.y);
+			}
+		}
+		return results;
+	};
+	std::vector<utils::batch::InstructionSet> instruction_sets = utils::batch::get_supported_instruction_sets();
+	T_ASSERT(T_CHECK(instruction_sets.front() == utils::batch::InstructionSet::SCALAR));
+	for (size_t count = 0; count < 40; count++) {
+		T_ASSERT(T_CHECK(utils::batch::set_instruction_set(utils::batch::InstructionSet::SCALAR)));
+		Results expected = calc_results(count);
+		for (size_t set_i = 1; set_i < instruction_sets.size(); set_i++) {
+			T_ASSERT(T_CHECK(utils::batch::set_instruction_set(instruction_sets[set_i])));
+			Results results = calc_results(count);
+			T_CHECK(results.line_D == expected.line_D);
+			T_CHECK(results.left == expected.left);
+			T_CHECK(results.right == expected.right);
+			T_CHECK(results.distance == expected.distance);
+			T_CHECK(results.projected.x == expected.projected.x && results.projected.y == expected.projected.y);
+			T_CHECK(results.rotated.x == expected.rotated.x && results.rotated.y == expected.rotated.y);
+			T_CHECK(results.transformed.x == expected.transformed.x && results.transformed.y == expected.transformed.y);
+			T_CHECK(results.inside == expected.inside);
+			T_CHECK(results.intersect_index == expected.intersect_index);
+			T_CHECK(results.intersect_x == expected.intersect_x && results.intersect_y == expected.intersect_y);
+		}
+	}
+	// best one is the default
+	T_CHECK(utils::batch::set_instruction_set(instruction_sets.back()));
+}
+
+utils::batch::Points GeometryTests::createPoints(size_t count) {
+	utils::batch::Points points(count);
+	for (size_t i = 0; i < count; i++) {
+		float angle = (float)i * 0.7f;
+		float radius = 0.5f + (float)(i % 5) * 0.5f;
+		points.set(i, cos(angle) * radius, sin(angle) * radius);
+	}
+	return points;
+}
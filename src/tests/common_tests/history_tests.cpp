@@ -0,0 +1,504 @@
+#include "tests/history_tests.h"
+#include "common/history.h"
+#include "common/string_delta.h"
+#include "common/compression.h"
+
+HistoryTests::HistoryTests(
+	const std::string& name, test::TestModule* manager, const std::vector<TestNode*>& required_nodes
+) : TestModule(name, manager, required_nodes) {
+	test::TestModule* string_delta_list = addModule("StringDelta");
+	test::Test* string_delta_basic_test = string_delta_list->addTest("basic", [&](test::Test& test) { stringDeltaBasicTest(test); });
+	test::Test* string_delta_edits_test = string_delta_list->addTest("edits", { string_delta_basic_test }, [&](test::Test& test) { stringDeltaEditsTest(test); });
+	test::Test* string_delta_serialize_test = string_delta_list->addTest("serialize", { string_delta_edits_test }, [&](test::Test& test) { stringDeltaSerializeTest(test); });
+	test::TestModule* compression_list = addModule("Compression");
+	test::Test* compression_basic_test = compression_list->addTest("basic", [&](test::Test& test) { compressionBasicTest(test); });
+	test::TestModule* history_list = addModule("History", { string_delta_list, compression_list });
+	test::Test* basic_test = history_list->addTest("basic", [&](test::Test& test) { basicTest(test); });
+	test::Test* undo_redo_test = history_list->addTest("undo_redo", { basic_test }, [&](test::Test& test) { undoRedoTest(test); });
+	test::Test* keyframes_test = history_list->addTest("keyframes", { undo_redo_test }, [&](test::Test& test) { keyframesTest(test); });
+	test::Test* update_current_test = history_list->addTest("update_current", { keyframes_test }, [&](test::Test& test) { updateCurrentTest(test); });
+	test::Test* memory_limit_test = history_list->addTest("memory_limit", { keyframes_test }, [&](test::Test& test) { memoryLimitTest(test); });
+	test::Test* action_test = history_list->addTest("action", { undo_redo_test }, [&](test::Test& test) { actionTest(test); });
+	test::Test* spill_test = history_list->addTest("spill", { update_current_test }, [&](test::Test& test) { spillTest(test); });
+	test::Test* spill_codec_test = history_list->addTest("spill_codec", { spill_test }, [&](test::Test& test) { spillCodecTest(test); });
+	test::Test* spill_copy_test = history_list->addTest("spill_copy", { spill_test }, [&](test::Test& test) { spillCopyTest(test); });
+	test::Test* spill_action_test = history_list->addTest("spill_action", { action_test, memory_limit_test, spill_test }, [&](test::Test& test) { spillActionTest(test); });
+}
+
+void HistoryTests::stringDeltaBasicTest(test::Test& test) {
+	std::string str1 = "line 1\nline 2\nline 3\n";
+	std::string str2 = "line 1\nline 2 changed\nline 3\n";
+	StringDelta delta = StringDelta::create(str1, str2);
+	T_COMPARE(delta.getBaseSize(), str1.size());
+	T_COMPARE(delta.getResultSize(), str2.size());
+	T_COMPARE(delta.apply(str1), str2);
+	StringDelta same_delta = StringDelta::create(str1, str1);
+	T_COMPARE(same_delta.getOpCount(), 1);
+	T_COMPARE(same_delta.apply(str1), str1);
+	StringDelta empty_delta = StringDelta::create("", str1);
+	T_COMPARE(empty_delta.apply(""), str1);
+	StringDelta clear_delta = StringDelta::create(str1, "");
+	T_COMPARE(clear_delta.apply(str1), "");
+	bool thrown = false;
+	try {
+		delta.apply(str2);
+	} catch (std::exception exc) {
+		thrown = true;
+	}
+	T_CHECK(thrown);
+}
+
+void HistoryTests::stringDeltaEditsTest(test::Test& test) {
+	std::string base = createLevelString(1000, 1000);
+	std::string changed = createLevelString(1000, 500);
+	StringDelta delta = StringDelta::create(base, changed);
+	T_COMPARE(delta.apply(base), changed);
+	T_CHECK(delta.getMemorySize() < base.size() / 10);
+	// lines moved around
+	std::string line_a = "object id 1 type box position 1.0 2.0\n";
+	std::string line_b = "object id 2 type ball position 3.0 4.0\n";
+	std::string line_c = "object id 3 type chain position 5.0 6.0\n";
+	std::string moved_from = line_a + line_b + line_c;
+	std::string moved_to = line_c + line_a + line_b;
+	StringDelta moved_delta = StringDelta::create(moved_from, moved_to);
+	T_COMPARE(moved_delta.apply(moved_from), moved_to);
+	// lines inserted and removed
+	std::string inserted = line_a + "new line\n" + line_b + line_c;
+	StringDelta inserted_delta = StringDelta::create(moved_from, inserted);
+	T_COMPARE(inserted_delta.apply(moved_from), inserted);
+	std::string removed = line_a + line_c;
+	StringDelta removed_delta = StringDelta::create(moved_from, removed);
+	T_COMPARE(removed_delta.apply(moved_from), removed);
+}
+
+void HistoryTests::stringDeltaSerializeTest(test::Test& test) {
+	std::string base = createLevelString(100, 100);
+	std::string changed = createLevelString(100, 50);
+	StringDelta delta = StringDelta::create(base, changed);
+	std::string data;
+	delta.serialize(data);
+	StringDelta loaded_delta = StringDelta::deserialize(data);
+	T_CHECK(loaded_delta == delta);
+	T_COMPARE(loaded_delta.apply(base), changed);
+	bool thrown = false;
+	try {
+		StringDelta::deserialize(data.substr(0, data.size() / 2));
+	} catch (std::exception exc) {
+		thrown = true;
+	}
+	T_CHECK(thrown);
+}
+
+void HistoryTests::compressionBasicTest(test::Test& test) {
+	T_COMPARE(compression::decompress(compression::compress("")), "");
+	T_COMPARE(compression::decompress(compression::compress("a")), "a");
+	std::string level = createLevelString(1000, 1000);
+	std::string compressed = compression::compress(level);
+	T_CHECK(compressed.size() < level.size() / 4);
+	T_COMPARE(compression::decompress(compressed), level);
+	std::string binary;
+	for (size_t i = 0; i < 10000; i++) {
+		binary += (char)((i * 7919) % 251);
+	}
+	T_COMPARE(compression::decompress(compression::compress(binary)), binary);
+	bool thrown = false;
+	try {
+		compression::decompress(compressed.substr(0, compressed.size() / 2));
+	} catch (std::exception exc) {
+		thrown = true;
+	}
+	T_CHECK(thrown);
+}
+
+void HistoryTests::basicTest(test::Test& test) {
+	std::string value = "a";
+	History<std::string> history(
+		"Test",
+		[&]() { return value; },
+		[&](const std::string& str) { value = str; }
+	);
+	history.save("Base");
+	T_COMPARE(history.size(), 1);
+	T_CHECK(history.isAtBase());
+	T_COMPARE(history.getCurrent().value, "a");
+	T_COMPARE(history.getCurrent().tag, "Base");
+	value = "b";
+	history.save("Normal");
+	T_COMPARE(history.size(), 2);
+	T_CHECK(!history.isAtBase());
+	T_COMPARE(history.getCurrent().value, "b");
+	T_COMPARE(history.getCurrent().tag, "Normal");
+	history.clear();
+	T_COMPARE(history.size(), 1);
+	T_CHECK(history.isAtBase());
+	T_COMPARE(history.getCurrent().value, "a");
+}
+
+void HistoryTests::undoRedoTest(test::Test& test) {
+	std::string value;
+	History<std::string> history(
+		"Test",
+		[&]() { return value; },
+		[&](const std::string& str) { value = str; }
+	);
+	for (size_t i = 0; i < 5; i++) {
+		value = createLevelString(100, i);
+		history.save("Normal");
+	}
+	for (ptrdiff_t i = 3; i >= 0; i--) {
+		history.undo();
+		T_COMPARE(value, createLevelString(100, i));
+		T_COMPARE(history.getCurrent().value, value);
+	}
+	history.undo();
+	T_COMPARE(value, createLevelString(100, 0));
+	for (size_t i = 1; i < 5; i++) {
+		history.redo();
+		T_COMPARE(value, createLevelString(100, i));
+		T_COMPARE(history.getCurrent().value, value);
+	}
+	history.undo();
+	history.undo();
+	value = "new value";
+	history.save("Normal");
+	T_COMPARE(history.size(), 4);
+	history.redo();
+	T_COMPARE(value, "new value");
+	history.undo();
+	T_COMPARE(value, createLevelString(100, 2));
+}
+
+void HistoryTests::keyframesTest(test::Test& test) {
+	std::string value;
+	History<std::string> history(
+		"Test",
+		[&]() { return value; },
+		[&](const std::string& str) { value = str; }
+	);
+	history.setKeyframeInterval(4);
+	T_COMPARE(history.getKeyframeInterval(), 4);
+	std::vector<std::string> values;
+	for (size_t i = 0; i < 20; i++) {
+		value = createLevelString(1000, i);
+		values.push_back(value);
+		history.save("Normal");
+	}
+	// full copies are only stored for every 4th entry
+	T_CHECK(history.getMemorySize() < values[0].size() * 8);
+	for (ptrdiff_t i = 18; i >= 0; i--) {
+		history.undo();
+		T_ASSERT(T_COMPARE(value, values[i]));
+	}
+	for (size_t i = 1; i < 20; i++) {
+		history.redo();
+		T_ASSERT(T_COMPARE(value, values[i]));
+	}
+}
+
+void HistoryTests::updateCurrentTest(test::Test& test) {
+	std::string value;
+	History<std::string> history(
+		"Test",
+		[&]() { return value; },
+		[&](const std::string& str) { value = str; }
+	);
+	history.setKeyframeInterval(4);
+	std::vector<std::string> values;
+	for (size_t i = 0; i < 10; i++) {
+		value = createLevelString(100, i);
+		values.push_back(value);
+		history.save("Normal");
+	}
+	for (size_t i = 0; i < 4; i++) {
+		history.undo();
+	}
+	value = "updated\n" + value;
+	values[5] = value;
+	history.updateCurrent();
+	T_COMPARE(history.getCurrent().value, values[5]);
+	for (size_t i = 6; i < 10; i++) {
+		history.redo();
+		T_ASSERT(T_COMPARE(value, values[i]));
+	}
+	for (ptrdiff_t i = 8; i >= 0; i--) {
+		history.undo();
+		T_ASSERT(T_COMPARE(value, values[i]));
+	}
+}
+
+void HistoryTests::memoryLimitTest(test::Test& test) {
+	std::string value;
+	History<std::string> history(
+		"Test",
+		[&]() { return value; },
+		[&](const std::string& str) { value = str; }
+	);
+	history.setKeyframeInterval(4);
+	std::vector<std::string> values;
+	for (size_t i = 0; i < 20; i++) {
+		value = createLevelString(1000, i);
+		values.push_back(value);
+		history.save("Normal");
+	}
+	size_t limit = values[0].size() * 2;
+	history.setMemoryLimit(limit);
+	T_COMPARE(history.getMemoryLimit(), limit);
+	T_CHECK(history.getMemorySize() <= limit);
+	T_CHECK(history.size() < 20);
+	T_COMPARE(history.getCurrent().value, values[19]);
+	size_t size = history.size();
+	for (size_t i = 1; i < size; i++) {
+		history.undo();
+		T_ASSERT(T_COMPARE(value, values[19 - i]));
+	}
+	T_CHECK(history.isAtBase());
+	history.undo();
+	T_COMPARE(value, values[20 - size]);
+}
+
+void HistoryTests::actionTest(test::Test& test) {
+	std::string value = "a";
+	size_t set_count = 0;
+	size_t undo_count = 0;
+	size_t redo_count = 0;
+	History<std::string> history(
+		"Test",
+		[&]() { return value; },
+		[&](const std::string& str) { value = str; set_count++; }
+	);
+	history.save("Base");
+	value = "b";
+	HistoryAction action;
+	action.undo = [&]() { value = "a"; undo_count++; };
+	action.redo = [&]() { value = "b"; redo_count++; };
+	history.save("Normal", action);
+	value = "c";
+	history.save("Normal");
+	history.undo();
+	T_COMPARE(value, "b");
+	T_COMPARE(set_count, 1);
+	history.undo();
+	T_COMPARE(value, "a");
+	T_COMPARE(history.getCurrent().value, "a");
+	T_COMPARE(set_count, 1);
+	T_COMPARE(undo_count, 1);
+	history.redo();
+	T_COMPARE(value, "b");
+	T_COMPARE(history.getCurrent().value, "b");
+	T_COMPARE(set_count, 1);
+	T_COMPARE(redo_count, 1);
+	// action no longer matches the entry after it was updated
+	value = "d";
+	history.updateCurrent();
+	history.undo();
+	T_COMPARE(value, "a");
+	T_COMPARE(set_count, 2);
+	T_COMPARE(undo_count, 1);
+}
+
+void HistoryTests::spillTest(test::Test& test) {
+	std::string value;
+	History<std::string> history(
+		"Test",
+		[&]() { return value; },
+		[&](const std::string& str) { value = str; }
+	);
+	history.setKeyframeInterval(4);
+	history.enableSpill(3);
+	T_COMPARE(history.getSpillWindow(), 3);
+	std::vector<std::string> values;
+	for (size_t i = 0; i < 20; i++) {
+		value = createLevelString(1000, i);
+		values.push_back(value);
+		history.save("Normal");
+	}
+	T_COMPARE(history.size(), 20);
+	T_COMPARE(history.getSpilledCount(), 16);
+	T_CHECK(history.getMemorySize() < values[0].size() * 3);
+	for (ptrdiff_t i = 18; i >= 0; i--) {
+		history.undo();
+		T_ASSERT(T_COMPARE(value, values[i]));
+	}
+	T_CHECK(history.isAtBase());
+	T_COMPARE(history.getSpilledCount(), 16);
+	for (size_t i = 1; i < 10; i++) {
+		history.redo();
+		T_ASSERT(T_COMPARE(value, values[i]));
+	}
+	// spilled entries after the current one are dropped
+	value = "changed";
+	history.save("Normal");
+	T_COMPARE(history.size(), 11);
+	T_COMPARE(history.getSpilledCount(), 7);
+	for (ptrdiff_t i = 9; i >= 0; i--) {
+		history.undo();
+		T_ASSERT(T_COMPARE(value, values[i]));
+	}
+	history.clear();
+	T_COMPARE(history.size(), 1);
+	T_COMPARE(history.getSpilledCount(), 0);
+	T_COMPARE(history.getCurrent().value, values[0]);
+}
+
+void HistoryTests::spillCopyTest(test::Test& test) {
+	std::string value;
+	std::vector<std::string> values;
+	History<std::string> copy;
+	{
+		History<std::string> history(
+			"Test",
+			[&]() { return value; },
+			[&](const std::string& str) { value = str; }
+		);
+		history.setKeyframeInterval(4);
+		history.enableSpill(3);
+		for (size_t i = 0; i < 20; i++) {
+			value = createLevelString(1000, i);
+			values.push_back(value);
+			history.save("Normal");
+		}
+		T_COMPARE(history.getSpilledCount(), 16);
+		copy = history;
+	}
+	// original is destroyed along with its spill file
+	T_COMPARE(copy.size(), 20);
+	T_COMPARE(copy.getSpilledCount(), 16);
+	for (ptrdiff_t i = 18; i >= 0; i--) {
+		copy.undo();
+		T_ASSERT(T_COMPARE(value, values[i]));
+	}
+	T_CHECK(copy.isAtBase());
+}
+
+void HistoryTests::spillCodecTest(test::Test& test) {
+	struct Entry {
+		std::string str;
+		int number = 0;
+	};
+	Entry value;
+	History<Entry> history(
+		"Test",
+		[&]() { return value; },
+		[&](const Entry& entry) { value = entry; }
+	);
+	bool thrown = false;
+	try {
+		history.enableSpill(2);
+	} catch (std::exception exc) {
+		thrown = true;
+	}
+	T_CHECK(thrown);
+	HistoryCodec<Entry> codec;
+	codec.encode = [](const Entry& entry, std::string& out) {
+		out += std::to_string(entry.number) + " " + entry.str;
+	};
+	codec.decode = [](const std::string& str) {
+		Entry entry;
+		size_t space = str.find(' ');
+		entry.number = std::stoi(str.substr(0, space));
+		entry.str = str.substr(space + 1);
+		return entry;
+	};
+	history.enableSpill(2, codec);
+	for (int i = 0; i < 10; i++) {
+		value.number = i;
+		value.str = "entry " + std::to_string(i);
+		history.save("Normal");
+	}
+	T_COMPARE(history.getSpilledCount(), 7);
+	for (int i = 8; i >= 0; i--) {
+		history.undo();
+		T_ASSERT(T_COMPARE(value.number, i));
+		T_ASSERT(T_COMPARE(value.str, "entry " + std::to_string(i)));
+	}
+	for (int i = 1; i < 10; i++) {
+		history.redo();
+		T_ASSERT(T_COMPARE(value.number, i));
+	}
+}
+
+void HistoryTests::spillActionTest(test::Test& test) {
+	const size_t PAYLOAD_SIZE = 10000;
+	std::string value;
+	std::vector<std::string> values;
+	// action keeps a big payload, like removed objects kept by edit actions
+	std::vector<std::weak_ptr<std::string>> payloads;
+	size_t decode_count = 0;
+	std::function<HistoryAction(const std::string&)> make_action = [&](const std::string& data) {
+		std::shared_ptr<std::string> payload = std::make_shared<std::string>(data);
+		payloads.push_back(payload);
+		size_t index = std::stoull(data.substr(0, data.find(' ')));
+		HistoryAction action;
+		action.undo = [&, index, payload]() { value = values[index - 1]; };
+		action.redo = [&, index, payload]() { value = values[index]; };
+		action.memory_size = payload->capacity();
+		action.encode = [payload](std::string& out) { out += *payload; };
+		action.decode = [&](const std::string& str) { decode_count++; return make_action(str); };
+		return action;
+	};
+	auto fill = [&](History<std::string>& history) {
+		values.clear();
+		payloads.clear();
+		value = "0";
+		values.push_back(value);
+		history.save("Base");
+		for (size_t i = 1; i < 10; i++) {
+			value = std::to_string(i);
+			values.push_back(value);
+			history.save("Normal", make_action(std::to_string(i) + " " + std::string(PAYLOAD_SIZE, 'x')));
+		}
+	};
+	{
+		History<std::string> history(
+			"Test",
+			[&]() { return value; },
+			[&](const std::string& str) { value = str; }
+		);
+		fill(history);
+		T_CHECK(history.getMemorySize() > PAYLOAD_SIZE * 9);
+		// actions are dropped with their entries
+		history.setMemoryLimit(PAYLOAD_SIZE * 4);
+		T_CHECK(history.getMemorySize() <= PAYLOAD_SIZE * 4);
+		T_CHECK(history.size() < 5);
+	}
+	{
+		History<std::string> history(
+			"Test",
+			[&]() { return value; },
+			[&](const std::string& str) { value = str; }
+		);
+		history.enableSpill(2);
+		fill(history);
+		T_COMPARE(history.getSpilledCount(), 7);
+		// only actions of the entries around the current one are in memory
+		T_CHECK(history.getMemorySize() < PAYLOAD_SIZE * 4);
+		size_t expired_count = 0;
+		for (const std::weak_ptr<std::string>& payload : payloads) {
+			if (payload.expired()) {
+				expired_count++;
+			}
+		}
+		T_COMPARE(expired_count, 6);
+		for (ptrdiff_t i = 8; i >= 0; i--) {
+			history.undo();
+			T_ASSERT(T_COMPARE(value, values[i]));
+		}
+		T_CHECK(decode_count > 0);
+		for (size_t i = 1; i < 10; i++) {
+			history.redo();
+			T_ASSERT(T_COMPARE(value, values[i]));
+		}
+	}
+}
+
+std::string HistoryTests::createLevelString(size_t line_count, size_t changed_line) {
+	std::string result;
+	for (size_t i = 0; i < line_count; i++) {
+		result += "object id " + std::to_string(i) + " type box position 1.0 2.0";
+		if (i == changed_line) {
+			result += " changed";
+		}
+		result += "\n";
+	}
+	return result;
+}
@@ -7,8 +7,12 @@ SearchIndexTests::SearchIndexTests(
 ) : TestModule(name, parent, required_nodes) {
 	test::TestModule* test_list_unique = addModule("SearchIndexUnique");
 	test::TestModule* test_list_multiple = addModule("SearchIndexMultiple");
+	test::TestModule* test_list_dense = addModule("SearchIndexDense");
+	test::TestModule* test_list_names = addModule("NameIndex");
 	createTestListUnique(test_list_unique);
 	createTestListMultiple(test_list_multiple);
+	createTestListDense(test_list_dense);
+	createTestListNames(test_list_names);
 }
 
 void SearchIndexTests::createTestListUnique(test::TestModule* list) {
@@ -216,3 +220,253 @@ void SearchIndexTests::createTestListMultiple(test::TestModule* list) {
 		T_CHECK(sindex.find(8) == nullptr);
 	});
 }
+
+void SearchIndexTests::createTestListDense(test::TestModule* list) {
+	test::Test* basic_test = list->addTest("basic", [&](test::Test& test) {
+		SearchIndexDense<int, MyClass*> sindex;
+		T_COMPARE(sindex.size(), 0);
+		T_CHECK(!sindex.contains(0));
+	});
+	test::Test* add_test = list->addTest("add", { basic_test }, [&](test::Test& test) {
+		SearchIndexDense<int, MyClass*> sindex;
+		MyClass mc1;
+		MyClass mc2;
+		MyClass mc3;
+		T_CHECK(sindex.add(5, &mc1));
+		T_CHECK(sindex.add(6, &mc2));
+		T_CHECK(!sindex.add(6, &mc2));
+		T_CHECK(sindex.add(7, &mc3));
+		T_CHECK(!sindex.add(-1, &mc3));
+		T_ASSERT(T_COMPARE(sindex.size(), 3));
+		T_CHECK(sindex.contains(5));
+		T_CHECK(sindex.contains(6));
+		T_CHECK(sindex.contains(7));
+		T_CHECK(!sindex.contains(4));
+		T_CHECK(!sindex.contains(8));
+		T_CHECK(!sindex.contains(-1));
+	});
+	test::Test* find_test = list->addTest("find", { add_test }, [&](test::Test& test) {
+		SearchIndexDense<size_t, MyClass*> sindex;
+		MyClass mc1;
+		MyClass mc2;
+		sindex.add(0, &mc1);
+		sindex.add(3, &mc2);
+		T_CHECK(sindex.find(0) == &mc1);
+		T_CHECK(sindex.find(3) == &mc2);
+		T_CHECK(sindex.find(1) == nullptr);
+		T_CHECK(sindex.find(100) == nullptr);
+		T_CHECK(sindex.find((size_t)-1) == nullptr);
+	});
+	test::Test* min_max_test = list->addTest("min_max", { add_test }, [&](test::Test& test) {
+		SearchIndexDense<int, MyClass*> sindex;
+		MyClass mc1;
+		MyClass mc2;
+		MyClass mc3;
+		sindex.add(6, &mc2);
+		sindex.add(5, &mc1);
+		sindex.add(9, &mc3);
+		T_COMPARE(sindex.min(), 5);
+		T_COMPARE(sindex.max(), 9);
+		sindex.remove(9);
+		T_COMPARE(sindex.max(), 6);
+		sindex.remove(5);
+		T_COMPARE(sindex.min(), 6);
+		T_COMPARE(sindex.max(), 6);
+	});
+	test::Test* remove_test = list->addTest("remove", { find_test }, [&](test::Test& test) {
+		SearchIndexDense<int, MyClass*> sindex;
+		MyClass mc1;
+		MyClass mc2;
+		sindex.add(5, &mc1);
+		sindex.add(6, &mc2);
+		sindex.remove(5);
+		sindex.remove(8);
+		T_ASSERT(T_COMPARE(sindex.size(), 1));
+		T_CHECK(sindex.find(5) == nullptr);
+		T_CHECK(sindex.find(6) == &mc2);
+		T_CHECK(sindex.add(5, &mc2));
+		T_CHECK(sindex.find(5) == &mc2);
+	});
+	test::Test* handle_test = list->addTest("handle", { remove_test }, [&](test::Test& test) {
+		SearchIndexDense<int, MyClass*> sindex;
+		MyClass mc1;
+		MyClass mc2;
+		sindex.add(5, &mc1);
+		SearchIndexDense<int, MyClass*>::Handle handle = sindex.getHandle(5);
+		T_CHECK(sindex.isValid(handle));
+		T_CHECK(sindex.find(handle) == &mc1);
+		sindex.remove(5);
+		T_CHECK(!sindex.isValid(handle));
+		T_CHECK(sindex.find(handle) == nullptr);
+		// same key is reused by another value
+		sindex.add(5, &mc2);
+		T_CHECK(!sindex.isValid(handle));
+		T_CHECK(sindex.find(handle) == nullptr);
+		T_CHECK(sindex.find(sindex.getHandle(5)) == &mc2);
+	});
+	test::Test* clear_test = list->addTest("clear", { handle_test }, [&](test::Test& test) {
+		SearchIndexDense<int, MyClass*> sindex;
+		MyClass mc1;
+		MyClass mc2;
+		sindex.add(5, &mc1);
+		sindex.add(6, &mc2);
+		SearchIndexDense<int, MyClass*>::Handle handle = sindex.getHandle(6);
+		sindex.clear();
+		T_ASSERT(T_COMPARE(sindex.size(), 0));
+		T_CHECK(sindex.find(5) == nullptr);
+		T_CHECK(sindex.find(6) == nullptr);
+		sindex.add(6, &mc2);
+		T_CHECK(!sindex.isValid(handle));
+		T_COMPARE(sindex.min(), 6);
+		T_COMPARE(sindex.max(), 6);
+	});
+	test::Test* huge_key_test = list->addTest("huge_key", { clear_test }, [&](test::Test& test) {
+		// corrupt id from a level file shouldn't allocate an array up to it
+		SearchIndexDense<size_t, MyClass*> sindex;
+		MyClass mc1;
+		MyClass mc2;
+		MyClass mc3;
+		T_CHECK(sindex.add(3, &mc1));
+		T_CHECK(sindex.add(4000000000, &mc2));
+		T_CHECK(!sindex.add(4000000000, &mc2));
+		T_CHECK(sindex.add(5000, &mc3));
+		T_ASSERT(T_COMPARE(sindex.size(), 3));
+		T_CHECK(sindex.find(3) == &mc1);
+		T_CHECK(sindex.find(4000000000) == &mc2);
+		T_CHECK(sindex.find(5000) == &mc3);
+		T_CHECK(sindex.find(3999999999) == nullptr);
+		T_COMPARE(sindex.min(), 3);
+		T_COMPARE(sindex.max(), 4000000000);
+		SearchIndexDense<size_t, MyClass*>::Handle handle = sindex.getHandle(4000000000);
+		T_CHECK(sindex.find(handle) == &mc2);
+		sindex.remove(4000000000);
+		T_CHECK(!sindex.isValid(handle));
+		T_CHECK(sindex.find(4000000000) == nullptr);
+		T_COMPARE(sindex.max(), 5000);
+		T_CHECK(sindex.add(4000000000, &mc2));
+		T_CHECK(!sindex.isValid(handle));
+		sindex.remove(3);
+		sindex.remove(5000);
+		T_COMPARE(sindex.min(), 4000000000);
+		T_COMPARE(sindex.max(), 4000000000);
+	});
+}
+
+void SearchIndexTests::createTestListNames(test::TestModule* list) {
+	test::Test* add_test = list->addTest("add", [&](test::Test& test) {
+		NameIndex<MyClass*> sindex;
+		MyClass mc1;
+		MyClass mc2;
+		MyClass mc3;
+		T_CHECK(sindex.add("wheel", &mc1));
+		T_CHECK(sindex.add("wheel", &mc2));
+		T_CHECK(!sindex.add("wheel", &mc2));
+		T_CHECK(sindex.add("car", &mc3));
+		T_ASSERT(T_COMPARE(sindex.size(), 3));
+		T_CHECK(sindex.contains("wheel"));
+		T_CHECK(sindex.contains("car"));
+		T_CHECK(!sindex.contains("whee"));
+		T_CHECK(sindex.find("car") == &mc3);
+		T_CHECK(sindex.find("bus") == nullptr);
+		T_COMPARE(sindex.min(), "car");
+		T_COMPARE(sindex.max(), "wheel");
+	});
+	test::Test* remove_test = list->addTest("remove", { add_test }, [&](test::Test& test) {
+		NameIndex<MyClass*> sindex;
+		MyClass mc1;
+		MyClass mc2;
+		sindex.add("wheel", &mc1);
+		sindex.add("wheel", &mc2);
+		sindex.remove("wheel", &mc1);
+		sindex.remove("wheel", &mc1);
+		sindex.remove("car", &mc1);
+		T_ASSERT(T_COMPARE(sindex.size(), 1));
+		T_CHECK(sindex.find("wheel") == &mc2);
+		sindex.remove("wheel", &mc2);
+		T_ASSERT(T_COMPARE(sindex.size(), 0));
+		T_CHECK(!sindex.contains("wheel"));
+		T_COMPARE(sindex.findSubstring("whe").size(), 0);
+	});
+	test::Test* prefix_test = list->addTest("prefix", { add_test }, [&](test::Test& test) {
+		NameIndex<MyClass*> sindex;
+		MyClass mc1;
+		MyClass mc2;
+		MyClass mc3;
+		sindex.add("wheel_left", &mc1);
+		sindex.add("Wheel_right", &mc2);
+		sindex.add("car_wheel", &mc3);
+		T_COMPARE(sindex.findPrefix("wheel").size(), 2);
+		T_COMPARE(sindex.findPrefix("WHEEL_L").size(), 1);
+		T_COMPARE(sindex.findPrefix("w").size(), 2);
+		T_COMPARE(sindex.findPrefix("").size(), 3);
+		T_COMPARE(sindex.findPrefix("wheels").size(), 0);
+		T_COMPARE(sindex.findSuffix("wheel").size(), 1);
+		T_COMPARE(sindex.findSuffix("t").size(), 2);
+	});
+	test::Test* substring_test = list->addTest("substring", { add_test }, [&](test::Test& test) {
+		NameIndex<MyClass*> sindex;
+		MyClass mc1;
+		MyClass mc2;
+		MyClass mc3;
+		sindex.add("wheel_left", &mc1);
+		sindex.add("Wheel_right", &mc2);
+		sindex.add("car_wheel", &mc3);
+		T_COMPARE(sindex.findSubstring("heel").size(), 3);
+		T_COMPARE(sindex.findSubstring("_").size(), 3);
+		T_COMPARE(sindex.findSubstring("l_r").size(), 1);
+		T_COMPARE(sindex.findSubstring("lwh").size(), 0);
+		T_COMPARE(sindex.findSubstring("xyz").size(), 0);
+		// all trigrams are present, but not in this order
+		T_COMPARE(sindex.findSubstring("eel_whe").size(), 0);
+	});
+	test::Test* match_test = list->addTest("match", { prefix_test, substring_test }, [&](test::Test& test) {
+		NameIndex<MyClass*> sindex;
+		MyClass mc1;
+		MyClass mc2;
+		MyClass mc3;
+		sindex.add("wheel_left", &mc1);
+		sindex.add("wheel_right", &mc2);
+		sindex.add("car_wheel", &mc3);
+		T_COMPARE(sindex.match("wheel*").size(), 2);
+		T_COMPARE(sindex.match("*wheel").size(), 1);
+		T_COMPARE(sindex.match("*wheel*").size(), 3);
+		T_COMPARE(sindex.match("car_wheel").size(), 1);
+		T_COMPARE(sindex.match("car").size(), 0);
+		T_COMPARE(sindex.match("*").size(), 3);
+	});
+	list->addTest("match_case", { match_test }, [&](test::Test& test) {
+		NameIndex<MyClass*> sindex;
+		MyClass mc1;
+		MyClass mc2;
+		MyClass mc3;
+		sindex.add("Wheel", &mc1);
+		sindex.add("wheel", &mc2);
+		sindex.add("Car", &mc3);
+		T_COMPARE(sindex.match("wheel").size(), 2);
+		T_COMPARE(sindex.match("WHEEL").size(), 2);
+		T_ASSERT(T_COMPARE(sindex.match("car").size(), 1));
+		T_CHECK(sindex.match("car")[0] == &mc3);
+		T_COMPARE(sindex.match("ca").size(), 0);
+		T_COMPARE(sindex.match("CAR*").size(), sindex.match("car").size());
+		// exact lookups stay case-sensitive
+		T_CHECK(!sindex.contains("car"));
+		T_CHECK(sindex.find("wheel") == &mc2);
+	});
+	test::Test* rename_test = list->addTest("rename", { remove_test, match_test }, [&](test::Test& test) {
+		// removed names are cleaned up after a while, results should stay the same
+		NameIndex<MyClass*> sindex;
+		std::vector<MyClass> objects(5000);
+		for (size_t i = 0; i < objects.size(); i++) {
+			sindex.add("object" + std::to_string(i), &objects[i]);
+		}
+		for (size_t i = 0; i < objects.size(); i++) {
+			sindex.remove("object" + std::to_string(i), &objects[i]);
+			sindex.add((i % 2 == 0 ? "wheel" : "box") + std::to_string(i), &objects[i]);
+		}
+		T_ASSERT(T_COMPARE(sindex.size(), objects.size()));
+		T_COMPARE(sindex.match("wheel*").size(), objects.size() / 2);
+		T_COMPARE(sindex.match("object*").size(), 0);
+		T_COMPARE(sindex.match("*123*").size(), 15);
+		T_CHECK(sindex.find("box4999") == &objects[4999]);
+	});
+}
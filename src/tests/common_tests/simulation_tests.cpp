@@ -6,13 +6,20 @@ SimulationTests::SimulationTests(const std::string& name, test::TestModule* pare
     test::Test* box_test = simulation_list->addTest("box", { basic_test }, [&](test::Test& test) { boxTest(test); });
     test::Test* ball_test = simulation_list->addTest("ball", { basic_test }, [&](test::Test& test) { ballTest(test); });
     test::Test* polygon_test = simulation_list->addTest("polygon", { basic_test }, [&](test::Test& test) { polygonTest(test); });
+    test::Test* polygon_ear_clipping_test = simulation_list->addTest("polygon_ear_clipping", { polygon_test }, [&](test::Test& test) { polygonEarClippingTest(test); });
+    test::Test* polygon_partial_recut_test = simulation_list->addTest("polygon_partial_recut", { polygon_ear_clipping_test }, [&](test::Test& test) { polygonPartialRecutTest(test); });
+    test::Test* polygon_deferred_recut_test = simulation_list->addTest("polygon_deferred_recut", { polygon_ear_clipping_test }, [&](test::Test& test) { polygonDeferredRecutTest(test); });
+    test::Test* decomposition_cache_test = simulation_list->addTest("decomposition_cache", { polygon_test }, [&](test::Test& test) { decompositionCacheTest(test); });
     test::Test* chain_test = simulation_list->addTest("chain", { basic_test }, [&](test::Test& test) { chainTest(test); });
+    test::Test* chain_vertex_grid_test = simulation_list->addTest("chain_vertex_grid", { chain_test }, [&](test::Test& test) { chainVertexGridTest(test); });
+    test::Test* polyline_simplification_test = simulation_list->addTest("polyline_simplification", [&](test::Test& test) { polylineSimplificationTest(test); });
+    test::Test* instanced_shapes_test = simulation_list->addTest("instanced_shapes", [&](test::Test& test) { instancedShapesTest(test); });
     test::Test* revolute_joint_test = simulation_list->addTest("revolute_joint", { box_test }, [&](test::Test& test) { revoluteJointTest(test); });
     test::Test* car_test = simulation_list->addTest("car", { ball_test, polygon_test, revolute_joint_test }, [&](test::Test& test) { carTest(test); });
     test::Test* serialize_test = simulation_list->addTest("serialize", { basic_test }, [&](test::Test& test) { serializeTest(test); });
     test::Test* box_serialize_test = simulation_list->addTest("box_serialize", { box_test }, [&](test::Test& test) { boxSerializeTest(test); });
     test::Test* ball_serialize_test = simulation_list->addTest("ball_serialize", { ball_test }, [&](test::Test& test) { ballSerializeTest(test); });
-    test::Test* polygon_serialize_test = simulation_list->addTest("polygon_serialize", { polygon_test }, [&](test::Test& test) { polygonSerializeTest(test); });
+    test::Test* polygon_serialize_test = simulation_list->addTest("polygon_serialize", { polygon_test, polygon_ear_clipping_test }, [&](test::Test& test) { polygonSerializeTest(test); });
     test::Test* chain_serialize_test = simulation_list->addTest("chain_serialize", { chain_test }, [&](test::Test& test) { chainSerializeTest(test); });
     test::Test* revolute_joint_serialize_test = simulation_list->addTest("revolute_joint_serialize", { revolute_joint_test }, [&](test::Test& test) { revoluteJointSerializeTest(test); });
     std::vector<test::TestNode*> serialize_tests = { car_test, ball_serialize_test, polygon_serialize_test, revolute_joint_serialize_test };
@@ -21,14 +28,18 @@ SimulationTests::SimulationTests(const std::string& name, test::TestModule* pare
     test::Test* saveload_test = simulation_list->addTest("saveload", { box_test, box_serialize_test }, [&](test::Test& test) { saveloadTest(test); });
     test::Test* box_stack_test = simulation_list->addTest("box_stack", { advance_test, saveload_test }, [&](test::Test& test) { boxStackTest(test); });
     test::Test* moving_car_test = simulation_list->addTest("moving_car", { advance_test, saveload_test, car_serialize_test }, [&](test::Test& test) { movingCarTest(test); });
+    test::Test* level_index_test = simulation_list->addTest("level_index", serialize_tests, [&](test::Test& test) { levelIndexTest(test); });
+    test::Test* level_file_test = simulation_list->addTest("level_file", { level_index_test, saveload_test }, [&](test::Test& test) { levelFileTest(test); });
 
     test::TestModule* gameobject_list = addModule("GameObject", { simulation_list });
     test::Test* set_parent_two_test = gameobject_list->addTest("set_parent_two", [&](test::Test& test) { setParentTwoTest(test); });
     test::Test* set_parent_three_test = gameobject_list->addTest("set_parent_three", { set_parent_two_test }, [&](test::Test& test) { setParentThreeTest(test); });
     test::Test* parent_loop_test = gameobject_list->addTest("parent_loop", { set_parent_three_test }, [&](test::Test& test) { parentLoopTest(test); });
+    test::Test* hierarchy_test = gameobject_list->addTest("hierarchy", { set_parent_three_test }, [&](test::Test& test) { hierarchyTest(test); });
     test::Test* set_position_two_test = gameobject_list->addTest("set_position_two", { set_parent_two_test }, [&](test::Test& test) { setPositionTwoTest(test); });
     test::Test* set_position_three_test = gameobject_list->addTest("set_position_three", { set_parent_two_test, set_position_two_test }, [&](test::Test& test) { setPositionThreeTest(test); });
     test::Test* set_angle_test = gameobject_list->addTest("set_angle", { set_parent_three_test, }, [&](test::Test& test) { setAngleTest(test); });
+    test::Test* transform_objects_test = gameobject_list->addTest("transform_objects", { hierarchy_test, set_angle_test }, [&](test::Test& test) { transformObjectsTest(test); });
     test::Test* set_vertex_pos_test = gameobject_list->addTest("set_vertex_pos", [&](test::Test& test) { setVertexPosTest(test); });
     test::Test* add_vertex_test = gameobject_list->addTest("add_vertex", { set_vertex_pos_test }, [&](test::Test& test) { addVertexTest(test); });
     test::Test* delete_vertex_test = gameobject_list->addTest("delete_vertex", { set_vertex_pos_test }, [&](test::Test& test) { deleteVertexTest(test); });
@@ -95,6 +106,216 @@ void SimulationTests::polygonTest(test::Test& test) {
     T_APPROX_COMPARE(polygon->getGlobalRotation(), utils::to_radians(45.0f));
 }
 
+void SimulationTests::polygonEarClippingTest(test::Test& test) {
+    Simulation simulation;
+    // comb with teeth on top, counterclockwise
+    std::vector<b2Vec2> vertices = { b2Vec2(0.0f, 0.0f), b2Vec2(10.0f, 0.0f) };
+    for (size_t i = 0; i <= 10; i++) {
+        float height = i % 2 == 0 ? 2.0f : 1.0f;
+        vertices.push_back(b2Vec2(10.0f - i, height));
+    }
+    float area = 0.0f;
+    for (size_t i = 0; i < vertices.size(); i++) {
+        area += b2Cross(vertices[i], vertices[(i + 1) % vertices.size()]) / 2.0f;
+    }
+    PolygonObject* polygon = simulation.createPolygon(
+        "polygon0", b2Vec2(0.0f, 0.0f), 0.0f, vertices, sf::Color::Green
+    );
+    polygon->setDensity(2.0f, false);
+    polygon->setDecompositionAlgorithm(SplittablePolygon::EAR_CLIPPING);
+    T_CHECK(polygon->getDecompositionAlgorithm() == SplittablePolygon::EAR_CLIPPING);
+    size_t fixture_count = 0;
+    float fixture_area = 0.0f;
+    for (b2Fixture* fixture = polygon->getRigidBody()->GetFixtureList(); fixture; fixture = fixture->GetNext()) {
+        b2PolygonShape* shape = dynamic_cast<b2PolygonShape*>(fixture->GetShape());
+        T_ASSERT(T_CHECK(shape));
+        T_CHECK(shape->m_count <= b2_maxPolygonVertices);
+        T_APPROX_COMPARE(fixture->GetDensity(), 2.0f);
+        b2MassData mass_data;
+        shape->ComputeMass(&mass_data, 1.0f);
+        fixture_area += mass_data.mass;
+        fixture_count++;
+    }
+    T_CHECK(fixture_count > 1);
+    T_CHECK(fixture_count == polygon->getSplittablePolygon()->getConvexPolygons().size());
+    T_CHECK(std::abs(fixture_area - area) < 0.001f);
+    std::string str = polygon->serialize();
+    dp::DataPointerUnique<PolygonObject> uptr = PolygonObject::deserialize(str, &simulation);
+    T_CHECK(uptr->getDecompositionAlgorithm() == SplittablePolygon::EAR_CLIPPING);
+    polygonCmp(test, polygon, uptr.get());
+}
+
+void SimulationTests::polygonPartialRecutTest(test::Test& test) {
+    Simulation simulation;
+    std::vector<b2Vec2> vertices = { b2Vec2(0.0f, 0.0f), b2Vec2(10.0f, 0.0f) };
+    for (size_t i = 0; i <= 10; i++) {
+        float height = i % 2 == 0 ? 2.0f : 1.0f;
+        vertices.push_back(b2Vec2(10.0f - i, height));
+    }
+    PolygonObject* polygon = simulation.createPolygon(
+        "polygon0", b2Vec2(0.0f, 0.0f), 0.0f, vertices, sf::Color::Green
+    );
+    polygon->setDecompositionAlgorithm(SplittablePolygon::EAR_CLIPPING);
+    polygon->setDensity(2.0f, false);
+    auto get_fixtures = [&]() {
+        std::vector<b2Fixture*> result;
+        for (b2Fixture* fixture = polygon->getRigidBody()->GetFixtureList(); fixture; fixture = fixture->GetNext()) {
+            result.push_back(fixture);
+        }
+        return result;
+    };
+    auto check_fixtures = [&]() {
+        float area = 0.0f;
+        for (size_t i = 0; i < polygon->getVertexCount(); i++) {
+            b2Vec2 v1 = polygon->getVertexPos(i);
+            b2Vec2 v2 = polygon->getVertexPos((i + 1) % polygon->getVertexCount());
+            area += b2Cross(v1, v2) / 2.0f;
+        }
+        std::vector<b2Fixture*> fixtures = get_fixtures();
+        T_CHECK(fixtures.size() == polygon->getSplittablePolygon()->getConvexPolygons().size());
+        float fixture_area = 0.0f;
+        for (b2Fixture* fixture : fixtures) {
+            b2PolygonShape* shape = dynamic_cast<b2PolygonShape*>(fixture->GetShape());
+            T_ASSERT(T_CHECK(shape));
+            T_APPROX_COMPARE(fixture->GetDensity(), 2.0f);
+            b2MassData mass_data;
+            shape->ComputeMass(&mass_data, 1.0f);
+            fixture_area += mass_data.mass;
+        }
+        T_CHECK(std::abs(fixture_area - area) < 0.001f);
+    };
+    std::vector<b2Fixture*> old_fixtures = get_fixtures();
+    // tip of a tooth
+    polygon->offsetVertex(4, b2Vec2(0.0f, 0.5f));
+    check_fixtures();
+    std::vector<b2Fixture*> new_fixtures = get_fixtures();
+    size_t kept_count = 0;
+    for (b2Fixture* fixture : new_fixtures) {
+        if (std::find(old_fixtures.begin(), old_fixtures.end(), fixture) != old_fixtures.end()) {
+            kept_count++;
+        }
+    }
+    T_CHECK(kept_count > 0);
+    T_CHECK(kept_count < old_fixtures.size());
+    polygon->offsetVertex(4, b2Vec2(0.0f, -0.5f));
+    check_fixtures();
+    // moving all vertices recuts everything
+    for (size_t i = 0; i < polygon->getVertexCount(); i++) {
+        polygon->offsetVertex(i, b2Vec2(1.0f, 0.0f), false);
+    }
+    polygon->syncVertices();
+    check_fixtures();
+}
+
+void SimulationTests::polygonDeferredRecutTest(test::Test& test) {
+    Simulation simulation;
+    BackgroundDecomposer decomposer;
+    std::vector<b2Vec2> vertices = { b2Vec2(0.0f, 0.0f), b2Vec2(10.0f, 0.0f) };
+    for (size_t i = 0; i <= 10; i++) {
+        float height = i % 2 == 0 ? 2.0f : 1.0f;
+        vertices.push_back(b2Vec2(10.0f - i, height));
+    }
+    PolygonObject* polygon = simulation.createPolygon(
+        "polygon0", b2Vec2(0.0f, 0.0f), 0.0f, vertices, sf::Color::Green
+    );
+    polygon->setDecompositionAlgorithm(SplittablePolygon::EAR_CLIPPING);
+    polygon->setDensity(2.0f, false);
+    b2Fixture* old_fixture = polygon->getRigidBody()->GetFixtureList();
+    // newer job replaces the older one
+    polygon->offsetVertex(4, b2Vec2(0.0f, 0.5f), false);
+    polygon->syncVerticesDeferred(decomposer);
+    polygon->offsetVertex(4, b2Vec2(0.0f, 1.0f), false);
+    polygon->syncVerticesDeferred(decomposer);
+    T_CHECK(polygon->isDecompositionPending());
+    T_VEC2_APPROX_COMPARE(polygon->getSplittablePolygon()->getPoint(4), sf::Vector2f(8.0f, 3.0f));
+    T_CHECK(polygon->getRigidBody()->GetFixtureList() == old_fixture);
+    decomposer.wait();
+    std::vector<DecompositionResult> results = decomposer.takeResults();
+    T_ASSERT(T_CHECK(results.size() == 1));
+    T_CHECK(polygon->applyDecomposition(results[0]));
+    T_CHECK(!polygon->isDecompositionPending());
+    float area = 0.0f;
+    for (size_t i = 0; i < polygon->getVertexCount(); i++) {
+        b2Vec2 v1 = polygon->getVertexPos(i);
+        b2Vec2 v2 = polygon->getVertexPos((i + 1) % polygon->getVertexCount());
+        area += b2Cross(v1, v2) / 2.0f;
+    }
+    size_t fixture_count = 0;
+    float fixture_area = 0.0f;
+    for (b2Fixture* fixture = polygon->getRigidBody()->GetFixtureList(); fixture; fixture = fixture->GetNext()) {
+        b2PolygonShape* shape = dynamic_cast<b2PolygonShape*>(fixture->GetShape());
+        T_ASSERT(T_CHECK(shape));
+        T_APPROX_COMPARE(fixture->GetDensity(), 2.0f);
+        b2MassData mass_data;
+        shape->ComputeMass(&mass_data, 1.0f);
+        fixture_area += mass_data.mass;
+        fixture_count++;
+    }
+    T_CHECK(fixture_count == polygon->getSplittablePolygon()->getConvexPolygons().size());
+    T_CHECK(std::abs(fixture_area - area) < 0.001f);
+    // vertices synced in the meantime make the result stale
+    polygon->offsetVertex(4, b2Vec2(0.0f, 0.5f), false);
+    polygon->syncVerticesDeferred(decomposer);
+    polygon->syncVertices();
+    decomposer.wait();
+    results = decomposer.takeResults();
+    T_ASSERT(T_CHECK(results.size() == 1));
+    T_CHECK(!polygon->applyDecomposition(results[0]));
+}
+
+void SimulationTests::decompositionCacheTest(test::Test& test) {
+    Simulation simulation;
+    std::vector<b2Vec2> vertices = { b2Vec2(0.0f, 0.0f), b2Vec2(10.0f, 0.0f) };
+    for (size_t i = 0; i <= 10; i++) {
+        float height = i % 2 == 0 ? 2.0f : 1.0f;
+        vertices.push_back(b2Vec2(10.0f - i, height));
+    }
+    DecompositionCache& shared_cache = SplittablePolygon::getDecompositionCache();
+    shared_cache.clear();
+    PolygonObject* polygon0 = simulation.createPolygon(
+        "polygon0", b2Vec2(0.0f, 0.0f), 0.0f, vertices, sf::Color::Green
+    );
+    size_t hits_before = shared_cache.getStats().hits;
+    PolygonObject* polygon1 = simulation.createPolygon(
+        "polygon1", b2Vec2(20.0f, 5.0f), 1.0f, vertices, sf::Color::Green
+    );
+    T_COMPARE(shared_cache.getStats().hits, hits_before + 1);
+    T_COMPARE(shared_cache.getStats().entries, 1);
+    const std::vector<SplittablePolygon>& convex0 = polygon0->getSplittablePolygon()->getConvexPolygons();
+    const std::vector<SplittablePolygon>& convex1 = polygon1->getSplittablePolygon()->getConvexPolygons();
+    T_ASSERT(T_COMPARE(convex1.size(), convex0.size()));
+    for (size_t i = 0; i < convex0.size(); i++) {
+        T_ASSERT(T_COMPARE(convex1[i].getPointCount(), convex0[i].getPointCount()));
+        for (size_t j = 0; j < convex0[i].getPointCount(); j++) {
+            T_VEC2_APPROX_COMPARE(convex1[i].getPoint(j), convex0[i].getPoint(j));
+        }
+    }
+    shared_cache.clear();
+
+    DecompositionCache cache;
+    std::vector<sf::Vector2f> points0 = { sf::Vector2f(0.0f, 0.0f), sf::Vector2f(1.0f, 0.0f), sf::Vector2f(0.0f, 1.0f) };
+    std::vector<sf::Vector2f> points1 = { sf::Vector2f(0.0f, 0.0f), sf::Vector2f(2.0f, 0.0f), sf::Vector2f(0.0f, 2.0f) };
+    DecompositionCache::Piece piece0 = { points0, { 0, 1, 2 } };
+    DecompositionCache::Piece piece1 = { points1, { 0, 1, 2 } };
+    cache.insert(points0, 0, 8, { piece0 });
+    T_CHECK(cache.find(points0, 0, 8));
+    T_CHECK(!cache.find(points0, 1, 8));
+    T_CHECK(!cache.find(points0, 0, 6));
+    T_CHECK(!cache.find(points1, 0, 8));
+    T_COMPARE(cache.getStats().hits, 1);
+    T_COMPARE(cache.getStats().misses, 3);
+    // room for only one entry
+    cache.setMaxBytes(cache.getStats().bytes);
+    cache.insert(points1, 0, 8, { piece1 });
+    T_COMPARE(cache.getStats().entries, 1);
+    T_COMPARE(cache.getStats().evictions, 1);
+    T_CHECK(cache.getStats().bytes <= cache.getMaxBytes());
+    T_CHECK(!cache.find(points0, 0, 8));
+    const std::vector<DecompositionCache::Piece>* pieces = cache.find(points1, 0, 8);
+    T_ASSERT(T_CHECK(pieces));
+    T_CHECK(pieces->front().points == points1);
+}
+
 void SimulationTests::chainTest(test::Test& test) {
     Simulation simulation;
     std::vector<b2Vec2> vertices = {
@@ -115,6 +336,155 @@ void SimulationTests::chainTest(test::Test& test) {
     T_APPROX_COMPARE(chain->getGlobalRotation(), utils::to_radians(45.0f));
 }
 
+void SimulationTests::chainVertexGridTest(test::Test& test) {
+    Simulation simulation;
+    std::vector<b2Vec2> vertices;
+    for (size_t i = 0; i < 1000; i++) {
+        float x = (float)i * 0.5f;
+        vertices.push_back(b2Vec2(x, sin(x * 0.1f) * 10.0f));
+    }
+    ChainObject* chain = simulation.createChain(
+        "chain0", b2Vec2(1.0f, 1.0f), utils::to_radians(30.0f), vertices, sf::Color(255, 255, 255)
+    );
+    auto check_rect = [&](const b2Vec2& lower, const b2Vec2& upper) {
+        b2AABB aabb;
+        aabb.lowerBound = lower;
+        aabb.upperBound = upper;
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < chain->getVertexCount(); i++) {
+            b2Vec2 pos = chain->getGlobalVertexPos(i);
+            if (pos.x >= lower.x && pos.x <= upper.x && pos.y >= lower.y && pos.y <= upper.y) {
+                expected.push_back(i);
+            }
+        }
+        T_COMPARE(chain->getVerticesInRect(aabb), expected, &SimulationTests::indicesToStr);
+    };
+    check_rect(b2Vec2(50.0f, 20.0f), b2Vec2(120.0f, 90.0f));
+    check_rect(b2Vec2(-1000.0f, -1000.0f), b2Vec2(1000.0f, 1000.0f));
+    check_rect(b2Vec2(-10.0f, -10.0f), b2Vec2(-5.0f, -5.0f));
+    // moved, inserted and deleted vertices are found without rebuilding
+    chain->saveOffsets();
+    chain->offsetVertex(10, b2Vec2(300.0f, 0.0f));
+    check_rect(b2Vec2(250.0f, -50.0f), b2Vec2(350.0f, 50.0f));
+    chain->addVertexGlobal(20, b2Vec2(-20.0f, -20.0f));
+    check_rect(b2Vec2(-21.0f, -21.0f), b2Vec2(-19.0f, -19.0f));
+    check_rect(b2Vec2(50.0f, 20.0f), b2Vec2(120.0f, 90.0f));
+    chain->tryDeleteVertex(5);
+    check_rect(b2Vec2(-21.0f, -21.0f), b2Vec2(-19.0f, -19.0f));
+    check_rect(b2Vec2(-1000.0f, -1000.0f), b2Vec2(1000.0f, 1000.0f));
+}
+
+void SimulationTests::polylineSimplificationTest(test::Test& test) {
+    {
+        // points on a straight line are all removed
+        std::vector<sf::Vector2f> points;
+        for (size_t i = 0; i < 100; i++) {
+            points.push_back(sf::Vector2f((float)i, (float)i * 2.0f));
+        }
+        std::vector<size_t> expected = { 0, 99 };
+        T_COMPARE(simplification::douglas_peucker(points, 0.01f), expected, &SimulationTests::indicesToStr);
+    }
+    {
+        // zigzag is kept below its height and removed above it
+        std::vector<sf::Vector2f> points;
+        for (size_t i = 0; i < 9; i++) {
+            points.push_back(sf::Vector2f((float)i, i % 2 == 0 ? 0.0f : 1.0f));
+        }
+        T_COMPARE(simplification::douglas_peucker(points, 0.5f).size(), 9);
+        std::vector<size_t> expected = { 0, 8 };
+        T_COMPARE(simplification::douglas_peucker(points, 1.5f), expected, &SimulationTests::indicesToStr);
+    }
+    {
+        // larger tolerance keeps a subset of points kept by a smaller one
+        std::vector<sf::Vector2f> points;
+        for (size_t i = 0; i < 2000; i++) {
+            float x = (float)i * 0.1f;
+            points.push_back(sf::Vector2f(x, sin(x) * 5.0f + sin(x * 7.0f)));
+        }
+        std::vector<float> importance = simplification::douglas_peucker_importance(points);
+        std::vector<size_t> prev_indices;
+        for (float tolerance : { 0.01f, 0.1f, 1.0f, 10.0f }) {
+            std::vector<size_t> indices = simplification::simplify(importance, tolerance);
+            T_ASSERT(T_CHECK(indices.size() >= 2));
+            T_COMPARE(indices.front(), 0);
+            T_COMPARE(indices.back(), points.size() - 1);
+            // removed points are not farther than tolerance from the simplified line
+            float max_distance = 0.0f;
+            for (size_t i = 0; i + 1 < indices.size(); i++) {
+                sf::Vector2f p1 = points[indices[i]];
+                sf::Vector2f p2 = points[indices[i + 1]];
+                for (size_t j = indices[i] + 1; j < indices[i + 1]; j++) {
+                    float distance = abs(utils::get_line_D(points[j], p1, p2)) / utils::length(p2 - p1);
+                    max_distance = std::max(max_distance, distance);
+                }
+            }
+            T_CHECK(max_distance <= tolerance);
+            if (!prev_indices.empty()) {
+                T_CHECK(indices.size() <= prev_indices.size());
+                T_CHECK(std::includes(prev_indices.begin(), prev_indices.end(), indices.begin(), indices.end()));
+            }
+            prev_indices = indices;
+        }
+    }
+}
+
+void SimulationTests::instancedShapesTest(test::Test& test) {
+    CircleNotchShape circle_shape(2.0f, 30, 4);
+    circle_shape.setPosition(3.0f, 4.0f);
+    circle_shape.setRotation(30.0f);
+    circle_shape.setCircleColor(sf::Color::Red);
+    circle_shape.setNotchColor(sf::Color::Blue);
+    CircleNotchShape small_circle_shape(0.5f, 30, 4);
+    small_circle_shape.setCircleColor(sf::Color::Yellow);
+    small_circle_shape.setNotchColor(sf::Color::Magenta);
+    sf::RectangleShape rect_shape(sf::Vector2f(2.0f, 1.0f));
+    rect_shape.setOrigin(1.0f, 0.5f);
+    rect_shape.setPosition(-5.0f, 1.0f);
+    rect_shape.setRotation(45.0f);
+    rect_shape.setFillColor(sf::Color::Green);
+    sf::RectangleShape outlined_rect_shape(sf::Vector2f(1.0f, 1.0f));
+    outlined_rect_shape.setOutlineThickness(0.1f);
+    InstancedShapes instanced_shapes;
+    T_CHECK(instanced_shapes.empty());
+    T_CHECK(instanced_shapes.add((const sf::Drawable&)circle_shape));
+    T_CHECK(instanced_shapes.add((const sf::Drawable&)small_circle_shape));
+    T_CHECK(instanced_shapes.add((const sf::Drawable&)rect_shape));
+    T_CHECK(!instanced_shapes.add((const sf::Drawable&)outlined_rect_shape));
+    T_COMPARE(instanced_shapes.getInstanceCount(), 3);
+    // circles with different radius share the mesh
+    T_COMPARE(instanced_shapes.getMeshCount(), 2);
+    T_COMPARE(instanced_shapes.getBatchCount(), 1);
+    // vertices are the same as triangles of the shapes themselves
+    std::vector<sf::Vertex> expected;
+    auto add_fan = [&](const sf::VertexArray& fan, const sf::Transform& transform) {
+        for (size_t i = 1; i + 1 < fan.getVertexCount(); i++) {
+            for (size_t j : { (size_t)0, i, i + 1 }) {
+                expected.push_back(sf::Vertex(transform.transformPoint(fan[j].position), fan[j].color));
+            }
+        }
+    };
+    add_fan(circle_shape.getCircleVarray(), circle_shape.getTransform());
+    add_fan(circle_shape.getNotchVarray(), circle_shape.getTransform());
+    add_fan(small_circle_shape.getCircleVarray(), small_circle_shape.getTransform());
+    add_fan(small_circle_shape.getNotchVarray(), small_circle_shape.getTransform());
+    sf::VertexArray rect_fan(sf::TriangleFan, rect_shape.getPointCount());
+    for (size_t i = 0; i < rect_shape.getPointCount(); i++) {
+        rect_fan[i] = sf::Vertex(rect_shape.getPoint(i), rect_shape.getFillColor());
+    }
+    add_fan(rect_fan, rect_shape.getTransform());
+    const std::vector<sf::Vertex>& vertices = instanced_shapes.getVertices();
+    T_ASSERT(T_COMPARE(vertices.size(), expected.size()));
+    for (size_t i = 0; i < vertices.size(); i++) {
+        T_APPROX_COMPARE(vertices[i].position.x, expected[i].position.x);
+        T_APPROX_COMPARE(vertices[i].position.y, expected[i].position.y);
+        T_CHECK(vertices[i].color == expected[i].color);
+    }
+    instanced_shapes.clear();
+    T_CHECK(instanced_shapes.empty());
+    T_COMPARE(instanced_shapes.getVertices().size(), 0);
+    T_COMPARE(instanced_shapes.getMeshCount(), 2);
+}
+
 void SimulationTests::revoluteJointTest(test::Test& test) {
     Simulation simulation;
     BoxObject* box0 = createBox(simulation, "box0", b2Vec2(0.0f, 0.0f));
@@ -354,6 +724,74 @@ void SimulationTests::movingCarTest(test::Test& test) {
     simCmp(test, simulationA, simulationB);
 }
 
+void SimulationTests::levelIndexTest(test::Test& test) {
+    Simulation simulation;
+    BoxObject* box0 = createBox(simulation, "box0", b2Vec2(0.0f, 0.0f));
+    BallObject* ball0 = simulation.createBall("ball \"object\"", b2Vec2(10.0f, 0.0f), 2.0f, sf::Color::Red);
+    ball0->setParent(box0);
+    std::string str = simulation.serialize();
+    LevelIndex index(str);
+    T_ASSERT(T_COMPARE(index.size(), 2));
+    T_COMPARE(index.getSourceSize(), str.size());
+    const LevelIndexEntry* box_entry = index.find(box0->getId());
+    const LevelIndexEntry* ball_entry = index.find(ball0->getId());
+    T_ASSERT(T_CHECK(box_entry != nullptr));
+    T_ASSERT(T_CHECK(ball_entry != nullptr));
+    T_CHECK(index.find(100) == nullptr);
+    T_COMPARE(box_entry->type, "box");
+    T_COMPARE(box_entry->parent_id, -1);
+    T_COMPARE(ball_entry->type, "ball");
+    T_COMPARE(ball_entry->parent_id, box0->getId());
+    T_COMPARE(str.substr(box_entry->offset, box_entry->length), box0->serialize());
+    T_COMPARE(str.substr(ball_entry->offset, ball_entry->length), ball0->serialize());
+    T_APPROX_COMPARE(ball_entry->aabb.lowerBound.x, 8.0f);
+    T_APPROX_COMPARE(ball_entry->aabb.upperBound.x, 12.0f);
+    b2AABB region;
+    region.lowerBound = b2Vec2(9.0f, -1.0f);
+    region.upperBound = b2Vec2(11.0f, 1.0f);
+    std::vector<const LevelIndexEntry*> found = index.query(region);
+    T_ASSERT(T_COMPARE(found.size(), 1));
+    T_COMPARE(found[0]->id, ball0->getId());
+    LevelIndex indexB;
+    indexB.deserialize(index.serialize());
+    T_CHECK(indexB == index);
+}
+
+void SimulationTests::levelFileTest(test::Test& test) {
+    Simulation simulationA;
+    BoxObject* box0 = createBox(simulationA, "box0", b2Vec2(0.0f, 0.0f));
+    BoxObject* box1 = createBox(simulationA, "box1", b2Vec2(10.0f, 0.0f));
+    BoxObject* box2 = createBox(simulationA, "box2", b2Vec2(20.0f, 0.0f));
+    box2->setParent(box1);
+    const std::filesystem::path tmp_dir = "tests/tmp";
+    if (!std::filesystem::exists(tmp_dir)) {
+        std::filesystem::create_directory(tmp_dir);
+    }
+    const std::filesystem::path temp_filename = tmp_dir / "level_file.txt";
+    LevelFile::save(simulationA.serialize(), temp_filename);
+    T_CHECK(std::filesystem::exists(LevelFile::getIndexPath(temp_filename)));
+    LevelFile file(temp_filename);
+    file.open();
+    T_ASSERT(T_COMPARE(file.getIndex().size(), 3));
+    {
+        Simulation simulationB;
+        GameObject* object = file.loadObject(box2->getId(), &simulationB);
+        T_ASSERT(T_COMPARE(simulationB.getAllSize(), 2));
+        T_ASSERT(T_CHECK(simulationB.getById(box1->getId()) != nullptr));
+        boxCmp(test, box2, dynamic_cast<BoxObject*>(object));
+        boxCmp(test, box1, dynamic_cast<BoxObject*>(simulationB.getById(box1->getId())));
+    }
+    {
+        Simulation simulationB;
+        b2AABB region;
+        region.lowerBound = b2Vec2(-1.0f, -1.0f);
+        region.upperBound = b2Vec2(1.0f, 1.0f);
+        std::vector<GameObject*> objects = file.loadRegion(region, &simulationB);
+        T_ASSERT(T_COMPARE(objects.size(), 1));
+        boxCmp(test, box0, dynamic_cast<BoxObject*>(objects[0]));
+    }
+}
+
 void SimulationTests::setParentTwoTest(test::Test& test) {
     Simulation simulation;
     BoxObject* box0 = createBox(simulation, "box0", b2Vec2(0.0f, 0.6f));
@@ -435,6 +873,45 @@ void SimulationTests::parentLoopTest(test::Test& test) {
     T_CHECK(exception);
 }
 
+void SimulationTests::hierarchyTest(test::Test& test) {
+    Simulation simulation;
+    BoxObject* box0 = createBox(simulation, "box0", b2Vec2(0.0f, 0.0f));
+    BoxObject* box1 = createBox(simulation, "box1", b2Vec2(1.0f, 0.0f));
+    BoxObject* box2 = createBox(simulation, "box2", b2Vec2(2.0f, 0.0f));
+    BoxObject* box3 = createBox(simulation, "box3", b2Vec2(3.0f, 0.0f));
+    BoxObject* box4 = createBox(simulation, "box4", b2Vec2(4.0f, 0.0f));
+    box1->setParent(box0);
+    box2->setParent(box1);
+    box4->setParent(box0);
+    T_CHECK(simulation.getHierarchy() == std::vector<GameObject*>({ box0, box1, box2, box4, box3 }));
+    std::span<GameObject* const> box0_subtree = box0->getSubtree();
+    T_CHECK(std::vector<GameObject*>(box0_subtree.begin(), box0_subtree.end()) == std::vector<GameObject*>({ box0, box1, box2, box4 }));
+    T_CHECK(box0->getAllChildren() == std::vector<GameObject*>({ box1, box2, box4 }));
+    T_COMPARE(box3->getSubtree().size(), 1);
+    T_COMPARE(box0->getDepth(), 0);
+    T_COMPARE(box1->getDepth(), 1);
+    T_COMPARE(box2->getDepth(), 2);
+    T_COMPARE(box4->getDepth(), 1);
+    T_CHECK(box0->isAncestorOf(box2));
+    T_CHECK(box1->isAncestorOf(box2));
+    T_CHECK(!box2->isAncestorOf(box1));
+    T_CHECK(!box1->isAncestorOf(box4));
+    T_CHECK(!box3->isAncestorOf(box2));
+    T_CHECK(!box0->isAncestorOf(box0));
+    box1->setParent(box3);
+    T_CHECK(box3->isAncestorOf(box2));
+    T_CHECK(!box0->isAncestorOf(box2));
+    T_CHECK(simulation.getHierarchy() == std::vector<GameObject*>({ box0, box4, box3, box1, box2 }));
+    T_CHECK(box3->isAncestorOf(box2));
+    T_CHECK(!box0->isAncestorOf(box2));
+    T_COMPARE(box2->getDepth(), 2);
+    box3->moveToIndex(0);
+    T_CHECK(simulation.getHierarchy() == std::vector<GameObject*>({ box3, box1, box2, box0, box4 }));
+    simulation.remove(box1, false);
+    T_CHECK(simulation.getHierarchy() == std::vector<GameObject*>({ box3, box2, box0, box4 }));
+    T_COMPARE(box2->getDepth(), 1);
+}
+
 void SimulationTests::setPositionTwoTest(test::Test& test) {
     Simulation simulation;
     b2Vec2 box0_initial_pos = b2Vec2(0.5f, 0.5f);
@@ -513,6 +990,38 @@ void SimulationTests::setAngleTest(test::Test& test) {
     T_APPROX_COMPARE(box2->getGlobalRotation(), box0_new_angle + box1_new_angle);
 }
 
+void SimulationTests::transformObjectsTest(test::Test& test) {
+    Simulation simulation;
+    BoxObject* box0 = createBox(simulation, "box0", b2Vec2(0.0f, 0.0f));
+    BoxObject* box1 = createBox(simulation, "box1", b2Vec2(1.0f, 0.0f));
+    BoxObject* box2 = createBox(simulation, "box2", b2Vec2(5.0f, 0.0f));
+    box1->setParent(box0);
+    CompVector<GameObject*> objects = { box0, box2 };
+    for (GameObject* object : objects) {
+        object->orig_pos = object->getGlobalPosition();
+        object->orig_angle = object->getGlobalRotation();
+    }
+    simulation.offsetObjects(objects, b2Vec2(1.0f, 2.0f));
+    T_VEC2_APPROX_COMPARE(box0->getGlobalPosition(), b2Vec2(1.0f, 2.0f));
+    T_VEC2_APPROX_COMPARE(box1->getGlobalPosition(), b2Vec2(2.0f, 2.0f));
+    T_VEC2_APPROX_COMPARE(box2->getGlobalPosition(), b2Vec2(6.0f, 2.0f));
+    T_VEC2_APPROX_COMPARE(box1->getPosition(), b2Vec2(1.0f, 0.0f));
+    T_VEC2_APPROX_COMPARE(box1->getRigidBody()->GetPosition(), b2Vec2(2.0f, 2.0f));
+    float angle = utils::to_radians(90.0f);
+    simulation.rotateObjects(objects, b2Vec2(0.0f, 0.0f), angle);
+    T_VEC2_APPROX_COMPARE(box0->getGlobalPosition(), b2Vec2(0.0f, 0.0f));
+    T_VEC2_APPROX_COMPARE(box1->getGlobalPosition(), b2Vec2(0.0f, 1.0f));
+    T_VEC2_APPROX_COMPARE(box2->getGlobalPosition(), b2Vec2(0.0f, 5.0f));
+    T_APPROX_COMPARE(box1->getGlobalRotation(), angle);
+    T_VEC2_APPROX_COMPARE(box1->getRigidBody()->GetPosition(), b2Vec2(0.0f, 1.0f));
+    T_APPROX_COMPARE(box1->getRigidBody()->GetAngle(), angle);
+    simulation.rotateObjects(objects, b2Vec2(3.0f, 3.0f), 0.0f);
+    T_CHECK(box0->getGlobalPosition() == b2Vec2(0.0f, 0.0f));
+    T_CHECK(box2->getGlobalPosition() == b2Vec2(5.0f, 0.0f));
+    T_VEC2_APPROX_COMPARE(box1->getRigidBody()->GetPosition(), b2Vec2(1.0f, 0.0f));
+    T_APPROX_COMPARE(box1->getRigidBody()->GetAngle(), 0.0f);
+}
+
 void SimulationTests::setVertexPosTest(test::Test& test) {
     Simulation simulation;
     PolygonObject* polygon = simulation.createRegularPolygon(
@@ -539,20 +1048,20 @@ void SimulationTests::deleteVertexTest(test::Test& test) {
     PolygonObject* polygon = simulation.createRegularPolygon(
         "polygon", b2Vec2(0.0f, 0.0f), 0.0f, 6, 1.0f, sf::Color::Red
     );
-    std::vector<EditableVertex> vertices = polygon->getVertices();
+    std::vector<b2Vec2> vertices = polygon->getVertices();
     polygon->tryDeleteVertex(5);
     T_ASSERT(T_COMPARE(polygon->getVertexCount(), 5));
-    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(0), vertices[0].pos);
-    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(1), vertices[1].pos);
-    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(2), vertices[2].pos);
-    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(3), vertices[3].pos);
-    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(4), vertices[4].pos);
+    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(0), vertices[0]);
+    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(1), vertices[1]);
+    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(2), vertices[2]);
+    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(3), vertices[3]);
+    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(4), vertices[4]);
     polygon->tryDeleteVertex(2);
     T_ASSERT(T_COMPARE(polygon->getVertexCount(), 4));
-    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(0), vertices[0].pos);
-    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(1), vertices[1].pos);
-    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(2), vertices[3].pos);
-    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(3), vertices[4].pos);
+    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(0), vertices[0]);
+    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(1), vertices[1]);
+    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(2), vertices[3]);
+    T_VEC2_APPROX_COMPARE(polygon->getGlobalVertexPos(3), vertices[4]);
 }
 
 void SimulationTests::objectsTest(test::Test& test) {
@@ -946,6 +1455,17 @@ std::string SimulationTests::b2Vec2ToStr(const b2Vec2& vec) {
     return "(" + utils::vec_to_str(vec) + ")";
 }
 
+std::string SimulationTests::indicesToStr(const std::vector<size_t>& indices) {
+    std::string result = "[";
+    for (size_t i = 0; i < indices.size(); i++) {
+        if (i > 0) {
+            result += " ";
+        }
+        result += std::to_string(indices[i]);
+    }
+    return result + "]";
+}
+
 BoxObject* SimulationTests::createBox(Simulation& simulation, const std::string& name, const b2Vec2& pos) const {
     BoxObject* box = simulation.createBox(
         name,
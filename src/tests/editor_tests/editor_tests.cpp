@@ -1,5 +1,6 @@
 #include "tests/editor_tests.h"
 #include "editor/UI/outliner.h"
+#include "editor/UI/memory_overlay.h"
 
 EditorTests::EditorTests(
 	const std::string& name, test::TestModule* parent, const std::vector<TestNode*>& required_nodes
@@ -14,6 +15,14 @@ EditorTests::EditorTests(
 	test::Test* move_test = list->addTest("move", { select_test }, [&](test::Test& test) { moveTest(test); });
 	test::Test* pan_move_test = list->addTest("pan_move", { pan_test, move_test }, [&](test::Test& test) { panMoveTest(test); });
 	test::Test* serialize_empty_test = list->addTest("serialize_empty", { advance_test }, [&](test::Test& test) { serializeEmptyTest(test); });
+	test::Test* autosave_test = list->addTest("autosave", { advance_test }, [&](test::Test& test) { autosaveTest(test); });
+	test::Test* undo_move_test = list->addTest("undo_move", { move_test }, [&](test::Test& test) { undoMoveTest(test); });
+	test::Test* undo_delete_test = list->addTest("undo_delete", { select_test }, [&](test::Test& test) { undoDeleteTest(test); });
+	test::Test* undo_hierarchy_test = list->addTest("undo_hierarchy", { undo_delete_test }, [&](test::Test& test) { undoHierarchyTest(test); });
+	test::Test* undo_spill_test = list->addTest("undo_spill", { undo_move_test, undo_delete_test }, [&](test::Test& test) { undoSpillTest(test); });
+	test::Test* outliner_filter_test = list->addTest("outliner_filter", { advance_test }, [&](test::Test& test) { outlinerFilterTest(test); });
+	test::Test* memory_overlay_test = list->addTest("memory_overlay", { advance_test }, [&](test::Test& test) { memoryOverlayTest(test); });
+	test::Test* outliner_batch_test = list->addTest("outliner_batch", { outliner_filter_test }, [&](test::Test& test) { outlinerBatchTest(test); });
 }
 
 void EditorTests::beforeRunModule() {
@@ -93,7 +102,7 @@ void EditorTests::selectTest(test::Test& test) {
 	BoxObject* box2 = editor.getSimulation().createBox(
 		"box2", b2Vec2(2.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
 	);
-	const CompVector<GameObject*>& selected_objects = editor.getSelectTool().getSelectedObjects();
+	const IndexedCompVector<GameObject*>& selected_objects = editor.getSelectTool().getSelectedObjects();
 	T_ASSERT(T_COMPARE(selected_objects.size(), 0));
 
 	sf::Vector2f box_0_pos = editor.getObjectScreenPos(box0);
@@ -143,7 +152,7 @@ void EditorTests::multiSelectTest(test::Test& test) {
 	BoxObject* box2 = editor.getSimulation().createBox(
 		"box2", b2Vec2(2.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
 	);
-	const CompVector<GameObject*>& selected_objects = editor.getSelectTool().getSelectedObjects();
+	const IndexedCompVector<GameObject*>& selected_objects = editor.getSelectTool().getSelectedObjects();
 	T_ASSERT(T_COMPARE(selected_objects.size(), 0));
 
 	clickObject(editor, box0);
@@ -306,3 +315,395 @@ void EditorTests::tapKey(Editor& editor, sf::Keyboard::Key key) {
 	editor.keyRelease(key);
 	editor.advance();
 }
+
+void EditorTests::undo(Editor& editor) {
+	editor.keyPress(sf::Keyboard::LControl);
+	tapKey(editor, sf::Keyboard::Z);
+	editor.keyRelease(sf::Keyboard::LControl);
+	editor.advance();
+}
+
+void EditorTests::redo(Editor& editor) {
+	editor.keyPress(sf::Keyboard::LControl);
+	editor.keyPress(sf::Keyboard::LShift);
+	tapKey(editor, sf::Keyboard::Z);
+	editor.keyRelease(sf::Keyboard::LShift);
+	editor.keyRelease(sf::Keyboard::LControl);
+	editor.advance();
+}
+
+void EditorTests::autosaveTest(test::Test& test) {
+	Editor editor(window);
+	editor.init(test.name, false);
+	editor.start(true);
+	editor.advance();
+
+	const std::filesystem::path tmp_dir = "tests/tmp";
+	if (!std::filesystem::exists(tmp_dir)) {
+		std::filesystem::create_directory(tmp_dir);
+	}
+	const std::filesystem::path autosave_path = tmp_dir / "autosave.txt";
+	std::filesystem::remove(autosave_path);
+	editor.autosave.setPath(autosave_path);
+	editor.autosave.setInterval(0.0f);
+	editor.createBox("box0", b2Vec2(0.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green);
+	editor.commit_action = true;
+	editor.advance();
+	editor.file_writer.wait();
+	std::filesystem::path temp_path = autosave_path;
+	temp_path += ".tmp";
+	T_ASSERT(T_CHECK(std::filesystem::exists(autosave_path)));
+	T_CHECK(!std::filesystem::exists(temp_path));
+	T_COMPARE(utils::file_to_str(autosave_path), editor.history.getCurrent().value);
+}
+
+void EditorTests::undoMoveTest(test::Test& test) {
+	Editor editor(window);
+	editor.init(test.name, false);
+	editor.start(true);
+	editor.outliner_widget->setSize(150.0f, 100.0f);
+	editor.advance();
+
+	BoxObject* box0 = editor.getSimulation().createBox(
+		"box0", b2Vec2(0.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	BoxObject* box1 = editor.getSimulation().createBox(
+		"box1", b2Vec2(5.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	editor.commit_action = true;
+	editor.advance();
+	clickObject(editor, box0);
+	b2Vec2 box_world_pos_1 = box0->getGlobalPosition();
+	sf::Vector2f box_pos_1 = editor.getObjectScreenPos(box0);
+	sf::Vector2f box_pos_2 = box_pos_1 - sf::Vector2f(100.0f, 50.0f);
+	editor.mouseMove(box_pos_1);
+	tapKey(editor, sf::Keyboard::G);
+	editor.mouseMove(box_pos_2);
+	editor.advance();
+	editor.mouseLeftPress();
+	editor.advance();
+	editor.mouseLeftRelease();
+	editor.advance();
+	b2Vec2 box_world_pos_2 = box0->getGlobalPosition();
+	undo(editor);
+	// only the moved object is touched, so pointers and selection stay valid
+	T_ASSERT(T_COMPARE(editor.getAllObjects().size(), 2));
+	T_CHECK(editor.getSimulation().getById(box0->getId()) == box0);
+	T_CHECK(editor.getSimulation().getById(box1->getId()) == box1);
+	T_VEC2_APPROX_COMPARE(box0->getGlobalPosition(), box_world_pos_1);
+	T_CHECK(editor.getSelectTool().getSelectedObjects().contains(box0));
+	redo(editor);
+	T_VEC2_APPROX_COMPARE(box0->getGlobalPosition(), box_world_pos_2);
+	T_CHECK(editor.getSelectTool().getSelectedObjects().contains(box0));
+}
+
+void EditorTests::undoDeleteTest(test::Test& test) {
+	Editor editor(window);
+	editor.init(test.name, false);
+	editor.start(true);
+	editor.outliner_widget->setSize(150.0f, 100.0f);
+	editor.advance();
+
+	BoxObject* box0 = editor.getSimulation().createBox(
+		"box0", b2Vec2(0.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	BoxObject* box1 = editor.getSimulation().createBox(
+		"box1", b2Vec2(5.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	BoxObject* box2 = editor.getSimulation().createBox(
+		"box2", b2Vec2(10.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	box2->setParent(box1);
+	editor.getSimulation().createRevoluteJoint(box0, box1, b2Vec2(2.5f, 0.0f));
+	editor.commit_action = true;
+	editor.advance();
+	std::string before_str = editor.serialize();
+	ptrdiff_t box1_id = box1->getId();
+	clickObject(editor, box1);
+	tapKey(editor, sf::Keyboard::X);
+	T_ASSERT(T_COMPARE(editor.getAllObjects().size(), 2));
+	T_CHECK(box2->getParent() == nullptr);
+	T_COMPARE(editor.getSimulation().getJointsSize(), 0);
+	undo(editor);
+	T_ASSERT(T_COMPARE(editor.getAllObjects().size(), 3));
+	T_CHECK(editor.getSimulation().getById(box0->getId()) == box0);
+	T_CHECK(editor.getSimulation().getById(box2->getId()) == box2);
+	GameObject* restored_box1 = editor.getSimulation().getById(box1_id);
+	T_ASSERT(T_CHECK(restored_box1));
+	T_COMPARE(restored_box1->getName(), "box1");
+	T_CHECK(box2->getParent() == restored_box1);
+	T_COMPARE(editor.getSimulation().getJointsSize(), 1);
+	T_COMPARE(editor.serialize(), before_str);
+	redo(editor);
+	T_COMPARE(editor.getAllObjects().size(), 2);
+	T_COMPARE(editor.getSimulation().getJointsSize(), 0);
+}
+
+void EditorTests::undoHierarchyTest(test::Test& test) {
+	Editor editor(window);
+	editor.init(test.name, false);
+	editor.start(true);
+	editor.outliner_widget->setSize(150.0f, 100.0f);
+	editor.advance();
+
+	BoxObject* box0 = editor.getSimulation().createBox(
+		"box0", b2Vec2(0.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	BoxObject* box1 = editor.getSimulation().createBox(
+		"box1", b2Vec2(5.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	box1->setParent(box0);
+	ptrdiff_t box0_id = box0->getId();
+	ptrdiff_t box1_id = box1->getId();
+	editor.commit_action = true;
+	editor.advance();
+	std::string before_str = editor.serialize();
+	auto count_children = [&]() {
+		size_t result = 0;
+		for (GameObject* object : editor.getAllObjects()) {
+			if (object->getParent()) {
+				result++;
+			}
+		}
+		return result;
+	};
+
+	// duplicate copies are restored parent first, child copy is not there yet
+	clickObject(editor, box0);
+	clickObject(editor, box1, true);
+	editor.keyPress(sf::Keyboard::LShift);
+	tapKey(editor, sf::Keyboard::D);
+	editor.keyRelease(sf::Keyboard::LShift);
+	editor.advance();
+	editor.mouseLeftPress();
+	editor.advance();
+	editor.mouseLeftRelease();
+	editor.advance();
+	T_ASSERT(T_COMPARE(editor.getAllObjects().size(), 4));
+	T_COMPARE(count_children(), 2);
+	std::string duplicated_str = editor.serialize();
+	undo(editor);
+	undo(editor);
+	T_ASSERT(T_COMPARE(editor.getAllObjects().size(), 2));
+	T_COMPARE(editor.serialize(), before_str);
+	redo(editor);
+	redo(editor);
+	T_ASSERT(T_COMPARE(editor.getAllObjects().size(), 4));
+	T_COMPARE(count_children(), 2);
+	T_COMPARE(editor.serialize(), duplicated_str);
+	undo(editor);
+	undo(editor);
+	T_ASSERT(T_COMPARE(editor.getAllObjects().size(), 2));
+
+	// deleted in both orders, child before parent and parent before child
+	for (bool child_first : { true, false }) {
+		GameObject* parent = editor.getSimulation().getById(box0_id);
+		GameObject* child = editor.getSimulation().getById(box1_id);
+		T_ASSERT(T_CHECK(parent && child));
+		clickObject(editor, child_first ? parent : child);
+		clickObject(editor, child_first ? child : parent, true);
+		tapKey(editor, sf::Keyboard::X);
+		T_ASSERT(T_COMPARE(editor.getAllObjects().size(), 0));
+		undo(editor);
+		T_ASSERT(T_COMPARE(editor.getAllObjects().size(), 2));
+		GameObject* restored_parent = editor.getSimulation().getById(box0_id);
+		GameObject* restored_child = editor.getSimulation().getById(box1_id);
+		T_ASSERT(T_CHECK(restored_parent && restored_child));
+		T_CHECK(restored_child->getParent() == restored_parent);
+		T_COMPARE(editor.serialize(), before_str);
+		redo(editor);
+		T_COMPARE(editor.getAllObjects().size(), 0);
+		undo(editor);
+	}
+}
+
+void EditorTests::undoSpillTest(test::Test& test) {
+	Editor editor(window);
+	editor.init(test.name, false);
+	editor.start(true);
+	editor.outliner_widget->setSize(150.0f, 100.0f);
+	editor.advance();
+	editor.history.enableSpill(1);
+
+	BoxObject* box0 = editor.getSimulation().createBox(
+		"box0", b2Vec2(0.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	BoxObject* box1 = editor.getSimulation().createBox(
+		"box1", b2Vec2(5.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	editor.getSimulation().createRevoluteJoint(box0, box1, b2Vec2(2.5f, 0.0f));
+	ptrdiff_t box1_id = box1->getId();
+	editor.commit_action = true;
+	editor.advance();
+	std::string before_str = editor.serialize();
+	clickObject(editor, box1);
+	size_t memory_before_delete = editor.history.getMemorySize();
+	tapKey(editor, sf::Keyboard::X);
+	// removed object is kept by the action
+	T_CHECK(editor.history.getMemorySize() > memory_before_delete);
+	std::vector<std::string> states;
+	for (size_t i = 0; i < 4; i++) {
+		states.push_back(editor.serialize());
+		clickObject(editor, box0);
+		sf::Vector2f box_pos = editor.getObjectScreenPos(box0);
+		editor.mouseMove(box_pos);
+		tapKey(editor, sf::Keyboard::G);
+		editor.mouseMove(box_pos + sf::Vector2f(10.0f, 0.0f));
+		editor.advance();
+		editor.mouseLeftPress();
+		editor.advance();
+		editor.mouseLeftRelease();
+		editor.advance();
+	}
+	std::string after_str = editor.serialize();
+	T_CHECK(editor.history.getSpilledCount() > 0);
+	// actions are read back from the spill file
+	for (ptrdiff_t i = states.size() - 1; i >= 0; i--) {
+		undo(editor);
+		T_COMPARE(editor.serialize(), states[i]);
+	}
+	undo(editor);
+	T_ASSERT(T_COMPARE(editor.getAllObjects().size(), 2));
+	T_CHECK(editor.getSimulation().getById(box1_id));
+	T_COMPARE(editor.getSimulation().getJointsSize(), 1);
+	T_COMPARE(editor.serialize(), before_str);
+	for (size_t i = 0; i < states.size() + 1; i++) {
+		redo(editor);
+	}
+	T_COMPARE(editor.serialize(), after_str);
+}
+
+void EditorTests::outlinerFilterTest(test::Test& test) {
+	Editor editor(window);
+	editor.init(test.name, false);
+	editor.start(true);
+	editor.outliner_widget->setSize(150.0f, 100.0f);
+	editor.advance();
+
+	BoxObject* wheel_left = editor.getSimulation().createBox(
+		"Wheel_left", b2Vec2(0.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	BoxObject* body = editor.getSimulation().createBox(
+		"body", b2Vec2(5.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	BoxObject* wheel_right = editor.getSimulation().createBox(
+		"wheel_right", b2Vec2(10.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	BoxObject* ground = editor.getSimulation().createBox(
+		"ground", b2Vec2(0.0f, -5.0f), 0.0f, b2Vec2(10.0f, 1.0f), sf::Color::Green
+	);
+	wheel_right->setParent(body);
+	editor.advance();
+	auto is_visible = [&](GameObject* object) {
+		return editor.outliner_widget->getEntry(object)->getWidget()->isVisible();
+	};
+	editor.outliner_widget->setFilter("wheel");
+	T_CHECK(is_visible(wheel_left));
+	T_CHECK(is_visible(wheel_right));
+	T_CHECK(is_visible(body));
+	T_CHECK(!is_visible(ground));
+	editor.outliner_widget->setFilter("*left");
+	T_CHECK(is_visible(wheel_left));
+	T_CHECK(!is_visible(wheel_right));
+	T_CHECK(!is_visible(body));
+	// objects added while the filter is set
+	BoxObject* new_wheel = editor.getSimulation().createBox(
+		"new_wheel_left", b2Vec2(0.0f, 5.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	BoxObject* new_box = editor.getSimulation().createBox(
+		"new_box", b2Vec2(5.0f, 5.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	editor.advance();
+	T_CHECK(is_visible(new_wheel));
+	T_CHECK(!is_visible(new_box));
+	editor.outliner_widget->setFilter("");
+	T_CHECK(is_visible(wheel_right));
+	T_CHECK(is_visible(ground));
+	T_CHECK(is_visible(new_box));
+}
+
+void EditorTests::outlinerBatchTest(test::Test& test) {
+	Editor editor(window);
+	editor.init(test.name, false);
+	editor.start(true);
+	editor.outliner_widget->setSize(150.0f, 100.0f);
+	editor.advance();
+
+	CompVector<GameObject*> objects;
+	for (size_t i = 0; i < 20; i++) {
+		BoxObject* box = editor.getSimulation().createBox(
+			"box" + std::to_string(i), b2Vec2(i * 2.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+		);
+		if (i % 2 == 1) {
+			box->setParent(objects.back());
+		}
+		objects.add(box);
+	}
+	editor.advance();
+	auto entry_parent = [&](GameObject* object) {
+		return editor.outliner_widget->getEntry(object)->getParent();
+	};
+	// duplicated objects are added to the outliner in one batch
+	CompVector<GameObject*> new_objects = editor.getSimulation().duplicate(objects);
+	T_ASSERT(T_COMPARE(new_objects.size(), objects.size()));
+	for (size_t i = 0; i < new_objects.size(); i++) {
+		T_ASSERT(T_CHECK(editor.outliner_widget->getEntry(new_objects[i])));
+		if (i % 2 == 1) {
+			T_CHECK(entry_parent(new_objects[i]) == editor.outliner_widget->getEntry(new_objects[i - 1]));
+		} else {
+			T_CHECK(entry_parent(new_objects[i]) == nullptr);
+		}
+	}
+	editor.advance();
+	// deleted objects are removed from the outliner in one batch
+	editor.select_tool.setSelected(objects);
+	tapKey(editor, sf::Keyboard::X);
+	T_ASSERT(T_COMPARE(editor.getAllObjects().size(), new_objects.size()));
+	for (GameObject* object : objects) {
+		T_CHECK(!editor.outliner_widget->getEntry(object));
+	}
+	for (size_t i = 0; i < new_objects.size(); i++) {
+		T_CHECK(editor.outliner_widget->getEntry(new_objects[i]));
+	}
+	editor.advance();
+	undo(editor);
+	T_ASSERT(T_COMPARE(editor.getAllObjects().size(), objects.size() + new_objects.size()));
+	for (GameObject* object : editor.getAllObjects()) {
+		T_ASSERT(T_CHECK(editor.outliner_widget->getEntry(object)));
+		GameObject* parent = object->getParent();
+		fw::TreeViewEntry* parent_entry = parent ? editor.outliner_widget->getEntry(parent) : nullptr;
+		T_CHECK(entry_parent(object) == parent_entry);
+	}
+}
+
+void EditorTests::memoryOverlayTest(test::Test& test) {
+	Editor editor(window);
+	editor.init(test.name, false);
+	editor.start(true);
+	editor.advance();
+	T_CHECK(!editor.memory_overlay_widget->isVisible());
+	editor.memory_overlay_widget->setVisible(true);
+	size_t objects_before = dp::get_memory_snapshot().get(dp::MemoryCategory::GAME_OBJECTS).count;
+	editor.getSimulation().createBox(
+		"box0", b2Vec2(0.0f, 0.0f), 0.0f, b2Vec2(1.0f, 1.0f), sf::Color::Green
+	);
+	editor.advance();
+	dp::MemorySnapshot snapshot = dp::get_memory_snapshot();
+	T_COMPARE(snapshot.get(dp::MemoryCategory::GAME_OBJECTS).count, objects_before + 1);
+	T_CHECK(snapshot.get(dp::MemoryCategory::SHAPES).count > 0);
+	T_CHECK(snapshot.get(dp::MemoryCategory::WIDGETS).count > 0);
+	T_CHECK(snapshot.get(dp::MemoryCategory::WORLD).count > 0);
+	std::string table = editor.memory_overlay_widget->getTableStr(snapshot);
+	T_CHECK(table.find("game_objects") != std::string::npos);
+	T_CHECK(table.find("total") != std::string::npos);
+	// level reload should not leak anything
+	std::string str = editor.serialize();
+	editor.deserialize(str, true);
+	editor.advance();
+	size_t baseline_bytes = editor.memory_overlay_widget->getBaseline().bytes;
+	for (size_t i = 0; i < 3; i++) {
+		editor.deserialize(str, true);
+		editor.advance();
+	}
+	T_COMPARE(editor.memory_overlay_widget->getBaseline().bytes, baseline_bytes);
+}
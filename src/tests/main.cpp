@@ -8,9 +8,11 @@ void run_tests() {
     CompVectorTests* compvector_module = root_module.addModule<CompVectorTests>("CompVector", { data_pointer_module });
     SearchIndexTests* searchindex_module = root_module.addModule<SearchIndexTests>("SearchIndex", { data_pointer_module });
     EventTests* event_module = root_module.addModule<EventTests>("Event", { data_pointer_module });
-    SimulationTests* simulation_module = root_module.addModule<SimulationTests>("Simulation", { data_pointer_module, compvector_module });
+    GeometryTests* geometry_module = root_module.addModule<GeometryTests>("Geometry", { });
+    HistoryTests* history_module = root_module.addModule<HistoryTests>("History", { data_pointer_module });
+    SimulationTests* simulation_module = root_module.addModule<SimulationTests>("Simulation", { data_pointer_module, compvector_module, geometry_module });
     WidgetTests* widget_module = root_module.addModule<WidgetTests>("Widget", { data_pointer_module, event_module, compvector_module, searchindex_module });
-    EditorTests* editor_module = root_module.addModule<EditorTests>("Editor", { simulation_module, widget_module });
+    EditorTests* editor_module = root_module.addModule<EditorTests>("Editor", { simulation_module, widget_module, history_module });
     root_module.run();
 }
 
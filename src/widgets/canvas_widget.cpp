@@ -45,6 +45,7 @@ namespace fw {
 			return;
 		}
 		texture.create(width, height);
+		texture_memory.setSize((size_t)width * height * 4);
 		rect.setTextureRect(sf::IntRect(sf::Vector2i(0, 0), sf::Vector2i(texture.getSize().x, texture.getSize().y)));
 	}
 
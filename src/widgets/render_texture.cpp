@@ -27,6 +27,8 @@ void RenderTexture::create(unsigned int new_width, unsigned int new_height) {
 		unsigned int new_physical_height = next_height;
 		render_texture.create(new_physical_width, new_physical_height);
 		render_texture_premultiplied.create(new_physical_width, new_physical_height);
+		// both textures are RGBA
+		memory.setSize((size_t)new_physical_width * new_physical_height * 4 * 2);
 	}
 	width = new_width;
 	height = new_height;
@@ -213,6 +213,43 @@ namespace fw {
 		all_entries.remove(entry);
 	}
 
+	void TreeViewWidget::removeEntries(const std::vector<TreeViewEntry*>& entries) {
+		// entries are dropped from the lists in one pass, since removing them one by one is quadratic,
+		// pending ones are dropped earlier if indices of the remaining entries are needed,
+		// children are moved to the parent so every entry stays valid until its turn
+		std::set<TreeViewEntry*> pending;
+		auto flush = [&]() {
+			if (pending.empty()) {
+				return;
+			}
+			auto is_pending = [&](TreeViewEntry* entry) {
+				return pending.contains(entry);
+			};
+			top_entries.removeIf(is_pending);
+			all_entries.removeIf(is_pending);
+			pending.clear();
+		};
+		for (TreeViewEntry* entry : entries) {
+			wAssert(all_entries.contains(entry));
+			TreeViewEntry* parent = entry->getParent();
+			if (entry->getChildrenCount() > 0) {
+				flush();
+				size_t index = entry->getIndex();
+				CompVector<TreeViewEntry*> children_copy = entry->getChildren();
+				for (size_t i = 0; i < children_copy.size(); i++) {
+					TreeViewEntry* child = children_copy[i];
+					child->setParent(parent);
+					child->moveToIndex(index + i);
+				}
+			}
+			if (parent) {
+				parent->removeChild(entry);
+			}
+			pending.insert(entry);
+		}
+		flush();
+	}
+
 	void TreeViewWidget::clear() {
 		for (ptrdiff_t i = top_entries.size() - 1; i >= 0; i--) {
 			TreeViewEntry* entry = top_entries[i];